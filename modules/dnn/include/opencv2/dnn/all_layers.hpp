@@ -1067,6 +1067,52 @@ CV__DNN_INLINE_NS_BEGIN
         static Ptr<CumSumLayer> create(const LayerParams& params);
     };
 
+    /** @brief Normalizes the input over the dimensions starting from @p axis:
+     * y = (x - mean) / sqrt(var + epsilon) * scale + bias.
+     *
+     * Scale and bias are the optional blobs of the layer with the shape of the normalized dimensions.
+     */
+    class CV_EXPORTS LayerNormLayer : public Layer
+    {
+    public:
+        int axis;
+        float epsilon;
+
+        static Ptr<LayerNormLayer> create(const LayerParams& params);
+    };
+
+    /** @brief Scaled dot-product attention: softmax(Q * K * scale + mask) * V.
+     *
+     * Takes queries Q of shape [..., S, D], transposed keys K of shape [..., D, L], values V
+     * of shape [..., L, Dv] and an optional additive mask broadcastable to [..., S, L].
+     * The leading dimensions are broadcasted between the inputs. The attention weights are
+     * computed for blocks of queries at a time and are never stored for the whole input.
+     */
+    class CV_EXPORTS AttentionLayer : public Layer
+    {
+    public:
+        float scale;
+
+        static Ptr<AttentionLayer> create(const LayerParams& params);
+    };
+
+    /** @brief Batched matrix multiplication: Y = alpha * op(A) * op(B) + beta * C.
+     *
+     * A has the shape [..., M, K] and B has the shape [..., K, N] (or the transposed ones
+     * if @p transA or @p transB is set), the leading dimensions are broadcasted.
+     * B is either the second input or the first blob of the layer. A constant B is packed
+     * once for the optimized kernels. The optional bias C is the last blob of the layer
+     * and is broadcasted to [M, N].
+     */
+    class CV_EXPORTS MatMulLayer : public Layer
+    {
+    public:
+        bool transA, transB;
+        float alpha, beta;
+
+        static Ptr<MatMulLayer> create(const LayerParams& params);
+    };
+
 //! @}
 //! @}
 CV__DNN_INLINE_NS_END
@@ -435,6 +435,8 @@ CV__DNN_INLINE_NS_BEGIN
         virtual ~Layer();
     };
 
+    class CV_EXPORTS InferRequest;
+
     /** @brief This class allows to create and manipulate comprehensive artificial neural networks.
      *
      * Neural network is presented as directed acyclic graph (DAG), where vertices are Layer instances,
@@ -599,7 +601,12 @@ CV__DNN_INLINE_NS_BEGIN
          *  @details By default runs forward pass for the whole network.
          *
          *  This is an asynchronous version of forward(const String&).
-         *  dnn::DNN_BACKEND_INFERENCE_ENGINE backend is required.
+         *  dnn::DNN_BACKEND_INFERENCE_ENGINE backend or dnn::DNN_BACKEND_OPENCV backend
+         *  with dnn::DNN_TARGET_CPU target is required.
+         *
+         *  On CPU the inputs are captured on the call and several passes may be in flight.
+         *  Layers run on background threads as soon as their inputs are ready,
+         *  so independent branches of the network are computed at the same time.
          */
         CV_WRAP AsyncArray forwardAsync(const String& outputName = String());
 
@@ -624,6 +631,19 @@ CV__DNN_INLINE_NS_BEGIN
         CV_WRAP_AS(forwardAndRetrieve) void forward(CV_OUT std::vector<std::vector<Mat> >& outputBlobs,
                                                     const std::vector<String>& outBlobNames);
 
+        /** @brief Creates an execution context to run the network concurrently with other contexts.
+         *  @param outBlobNames names for layers which outputs are computed by the request.
+         *  If empty, the output of the last layer is computed.
+         *  @details The request shares the layers and their weights with the network and owns
+         *  a separate copy of the intermediate blobs, so several requests can be forwarded
+         *  from different threads at the same time. Inputs must be set to the network
+         *  before the call to define the shapes of the blobs.
+         *  Only dnn::DNN_BACKEND_OPENCV backend with dnn::DNN_TARGET_CPU target is supported.
+         *  @note All the requests become invalid after any change of the network (new input shapes,
+         *  backend, target, layers). Create all the requests before they are forwarded concurrently.
+         */
+        InferRequest createInferRequest(const std::vector<String>& outBlobNames = std::vector<String>());
+
         /** @brief Returns a quantized Net from a floating-point Net.
          *  @param calibData Calibration data to compute the quantization parameters.
          *  @param inputsDtype Datatype of quantized net's inputs. Can be CV_32F or CV_8S.
@@ -850,9 +870,25 @@ CV__DNN_INLINE_NS_BEGIN
          *
          * @param[out] timings vector for tick timings for all layers.
          * @return overall ticks for model inference.
+         *
+         * On CPU the independent layers may run concurrently (see OPENCV_DNN_PARALLEL_LAYERS),
+         * then the overall ticks is the wall time of the inference which is less than the sum of the layers timings.
          */
         CV_WRAP int64 getPerfProfile(CV_OUT std::vector<double>& timings);
 
+        /** @brief Returns overall time for inference and timings (in ticks) for layers and branches of the network.
+         *
+         * A branch is a chain of layers where every layer has a single producer and the producer
+         * has no other consumers. The branches which do not depend on each other may run concurrently.
+         *
+         * @param[out] timings vector for tick timings for all layers.
+         * @param[out] branches index of the branch for every layer, indexes correspond to @p timings.
+         * @param[out] branchTimings vector for tick timings for all branches, the sum of their layers timings.
+         * @return overall ticks for model inference.
+         */
+        CV_WRAP int64 getPerfProfile(CV_OUT std::vector<double>& timings, CV_OUT std::vector<int>& branches,
+                                     CV_OUT std::vector<double>& branchTimings);
+
 
         struct Impl;
         inline Impl* getImpl() const { return impl.get(); }
@@ -862,6 +898,50 @@ CV__DNN_INLINE_NS_BEGIN
         Ptr<Impl> impl;
     };
 
+    /** @brief Execution context of a network created by Net::createInferRequest().
+     *
+     * The request keeps its own inputs and intermediate blobs while the layers and their
+     * weights are shared with the network and all the other requests. A single request
+     * must not be used from several threads at the same time, different requests may.
+     *
+     * The requests run these layer types concurrently: Convolution, InnerProduct, Pooling, BatchNorm,
+     * Scale, Eltwise, Concat, Softmax, Reshape, Flatten, Permute, Padding, Slice, Split, Identity,
+     * Dropout, LSTM and the ReLU, ReLU6, Sigmoid, TanH, Swish, Mish, ELU, AbsVal, Power activations.
+     * The other layers may keep the state of a pass in the layer object, so they are run by
+     * one request at a time.
+     */
+    class CV_EXPORTS InferRequest
+    {
+    public:
+        InferRequest();
+
+        /** @brief Returns true if the request is not bound to a network. */
+        bool empty() const;
+
+        /** @brief Sets the new input value for the request.
+         *  @param blob A new blob. Its shape must be the same as the network had on request creation.
+         *  @param name A name of input layer.
+         *  @param scalefactor An optional normalization scale.
+         *  @param mean An optional mean subtraction values.
+         *  @see Net::setInput
+         */
+        void setInput(InputArray blob, const String& name = "",
+                      double scalefactor = 1.0, const Scalar& mean = Scalar());
+
+        /** @brief Runs forward pass and returns the first requested output.
+         *  @details Returned blob refers to the request memory and is overwritten by the next forward call.
+         */
+        Mat forward();
+
+        /** @brief Runs forward pass and returns the first outputs of the requested layers. */
+        void forward(OutputArrayOfArrays outputBlobs);
+
+        struct Impl;
+    protected:
+        Ptr<Impl> impl;
+        friend class Net;
+    };
+
     /** @brief Reads a network model stored in <a href="https://pjreddie.com/darknet/">Darknet</a> model files.
     *  @param cfgFile      path to the .cfg file with text description of the network architecture.
     *  @param darknetModel path to the .weights file with learned network.
@@ -30,6 +30,12 @@ size_t getParam_DNN_NETWORK_DUMP();
 /// This parameter is useful to run with valgrind memory errors detection
 bool getParam_DNN_DISABLE_MEMORY_OPTIMIZATIONS();
 
+/// Run the independent layers concurrently on CPU (disabled by default)
+bool getParam_DNN_PARALLEL_LAYERS();
+
+/// Directory of the prepacked weights cache, empty to disable it
+std::string getParam_DNN_PREPACK_CACHE_DIR();
+
 #ifdef HAVE_OPENCL
 bool getParam_DNN_OPENCL_ALLOW_ALL_DEVICES();
 #endif
@@ -25,6 +25,18 @@ bool getParam_DNN_DISABLE_MEMORY_OPTIMIZATIONS()
     return DNN_DISABLE_MEMORY_OPTIMIZATIONS;
 }
 
+// The value is not cached, it is applied on the next allocation of the network
+bool getParam_DNN_PARALLEL_LAYERS()
+{
+    return utils::getConfigurationParameterBool("OPENCV_DNN_PARALLEL_LAYERS", false);
+}
+
+// The value is not cached, so the cache can be switched at runtime
+std::string getParam_DNN_PREPACK_CACHE_DIR()
+{
+    return utils::getConfigurationParameterString("OPENCV_DNN_PREPACK_CACHE_DIR", "");
+}
+
 #ifdef HAVE_OPENCL
 bool getParam_DNN_OPENCL_ALLOW_ALL_DEVICES()
 {
@@ -0,0 +1,621 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+#include "net_impl.hpp"
+
+#include <opencv2/core/detail/async_promise.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace cv {
+namespace dnn {
+CV__DNN_INLINE_NS_BEGIN
+
+
+struct InferRequest::Impl
+{
+    // execution state of a single layer, the layer instance itself is shared with the network
+    struct Step
+    {
+        int lid;
+        bool skip;
+        Ptr<Layer> layer;
+        Ptr<Mutex> forwardMutex;  // serializes forward() of the layers which are not known to be re-entrant
+        std::vector<Mat*> inputs;
+        std::vector<Mat> outputs;
+        std::vector<Mat> internals;
+    };
+
+    Net::Impl* netImpl;
+    Ptr<Net::Impl> net;  // keeps the network alive, empty for the requests owned by the network
+    int allocationCounter;
+    Ptr<DataLayer> netInputLayer;
+
+    std::vector<Mat> inputsData;
+    std::vector<double> scaleFactors;
+    std::vector<Scalar> means;
+
+    std::vector<Step> steps;  // steps[0] is the network input layer
+    std::vector<std::pair<int, int> > outputs;  // (step index, output index)
+
+    // Order of the steps for the dependency driven execution. The skipped steps are not included.
+    std::vector<std::vector<int> > successors;
+    std::vector<int> numDependencies;
+    std::vector<int> executedSteps;
+
+    void setInput(InputArray blob, const String& name, double scalefactor, const Scalar& mean)
+    {
+        int oid = name.empty() ? 0 : netInputLayer->outputNameToIndex(name);
+        if (oid < 0 || oid >= (int)inputsData.size())
+            CV_Error(Error::StsObjectNotFound, "Requested blob \"" + name + "\" not found");
+
+        Mat blob_ = blob.getMat();
+        CV_Check(name, shape(blob_) == shape(inputsData[oid]),
+                 "Input shape must be the same as the network had on the request creation");
+        blob_.copyTo(inputsData[oid]);
+        scaleFactors[oid] = scalefactor;
+        means[oid] = mean;
+    }
+
+    void setInputs(const DataLayer& inputLayer)
+    {
+        CV_Assert(inputLayer.inputsData.size() == inputsData.size());
+        for (size_t i = 0; i < inputsData.size(); i++)
+        {
+            CV_Assert(shape(inputLayer.inputsData[i]) == shape(inputsData[i]));
+            inputLayer.inputsData[i].copyTo(inputsData[i]);
+        }
+        scaleFactors = inputLayer.scaleFactors;
+        means = inputLayer.means;
+    }
+
+    void checkNetwork() const
+    {
+        CV_Assert(netImpl);
+        CV_Check(allocationCounter, allocationCounter == netImpl->allocationCounter,
+                 "DNN: the network was reallocated after the request creation, create a new request");
+    }
+
+    void runStep(int i)
+    {
+        Step& step = steps[i];
+        if (i == 0)
+        {
+            DataLayer::convertInputs(inputsData, scaleFactors, means, step.outputs);
+            return;
+        }
+        std::vector<Mat> inps(step.inputs.size());
+        for (size_t j = 0; j < step.inputs.size(); j++)
+            inps[j] = *step.inputs[j];
+        if (step.forwardMutex)
+        {
+            AutoLock lock(*step.forwardMutex);
+            step.layer->forward(inps, step.outputs, step.internals);
+        }
+        else
+            step.layer->forward(inps, step.outputs, step.internals);
+    }
+
+    void forward(std::vector<Mat>& outs)
+    {
+        CV_TRACE_FUNCTION();
+        checkNetwork();
+        FPDenormalsIgnoreHintScope fp_denormals_ignore_scope;
+
+        for (size_t i = 0; i < steps.size(); i++)
+        {
+            if (i == 0 || !steps[i].skip)
+                runStep((int)i);
+        }
+        getOutputs(outs);
+    }
+
+    void getOutputs(std::vector<Mat>& outs) const
+    {
+        outs.resize(outputs.size());
+        for (size_t i = 0; i < outputs.size(); i++)
+            outs[i] = steps[outputs[i].first].outputs[outputs[i].second];
+    }
+
+    void buildDependencies();
+};
+
+
+// Makes the blobs of a separate memory with the same layout as the source ones have.
+// Blobs sharing one allocation (in-place layers, fused concat, planned arena) keep sharing it.
+static void cloneBlobsMemory(const std::vector<Mat*>& src, const std::vector<Mat*>& dst)
+{
+    CV_Assert(src.size() == dst.size());
+    std::map<UMatData*, Mat> buffers;
+    for (size_t i = 0; i < src.size(); i++)
+    {
+        const Mat& m = *src[i];
+        Mat& d = *dst[i];
+        if (m.empty())
+        {
+            d = Mat();
+            continue;
+        }
+        if (!m.u)
+        {
+            d = m.clone();  // user memory
+            continue;
+        }
+
+        Mat& buffer = buffers[m.u];
+        if (buffer.empty())
+        {
+            CV_Assert(m.u->size < (size_t)INT_MAX);
+            buffer.create(1, (int)m.u->size, CV_8U);
+            memcpy(buffer.data, m.u->data, m.u->size);
+        }
+        CV_Assert(m.data >= m.u->data && m.data < m.u->data + m.u->size);
+        size_t offset = m.data - m.u->data;
+
+        d = Mat(m.dims, m.size.p, m.type(), buffer.data + offset, m.step.p);
+        d.u = buffer.u;
+        CV_XADD(&d.u->refcount, 1);
+    }
+}
+
+
+// The layer types whose CPU forward() keeps all the pass state in the outputs, internals and locals
+// once the network ran (the lazy initialization is done by the warm-up pass), so the requests call it
+// concurrently. LSTM keeps the hidden and cell states in the internals. The other layers are run
+// by one request at a time.
+static bool isLayerReentrant(const String& type)
+{
+    static const char* const reentrantTypes[] = {
+        "Convolution", "InnerProduct", "Pooling", "BatchNorm", "Scale", "Eltwise", "Concat",
+        "Softmax", "SoftMax", "Reshape", "Flatten", "Permute", "Padding", "Slice", "Split",
+        "Identity", "Dropout", "LSTM",
+        "ReLU", "ReLU6", "Sigmoid", "TanH", "Swish", "Mish", "ELU", "AbsVal", "Power"
+    };
+    for (size_t i = 0; i < sizeof(reentrantTypes)/sizeof(reentrantTypes[0]); i++)
+    {
+        if (type == reentrantTypes[i])
+            return true;
+    }
+    return false;
+}
+
+
+void InferRequest::Impl::buildDependencies()
+{
+    executedSteps.clear();
+    for (int i = 0; i < (int)steps.size(); i++)
+    {
+        if (i == 0 || !steps[i].skip)
+            executedSteps.push_back(i);
+    }
+
+    const size_t n = executedSteps.size();
+    std::vector<std::vector<const Mat*> > reads(n), writes(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        const Step& step = steps[executedSteps[i]];
+        for (size_t j = 0; j < step.inputs.size(); j++)
+            reads[i].push_back(step.inputs[j]);
+        for (size_t j = 0; j < step.outputs.size(); j++)
+            writes[i].push_back(&step.outputs[j]);
+        for (size_t j = 0; j < step.internals.size(); j++)
+            writes[i].push_back(&step.internals[j]);
+    }
+
+    std::vector<std::vector<int> > deps;
+    std::vector<int> numDeps;
+    buildBlobsDependencies(reads, writes, deps, numDeps);
+
+    successors.assign(steps.size(), std::vector<int>());
+    numDependencies.assign(steps.size(), 0);
+    for (size_t i = 0; i < n; i++)
+    {
+        numDependencies[executedSteps[i]] = numDeps[i];
+        for (size_t j = 0; j < deps[i].size(); j++)
+            successors[executedSteps[i]].push_back(executedSteps[deps[i][j]]);
+    }
+}
+
+
+Ptr<InferRequest::Impl> Net::Impl::createInferRequest(const std::vector<String>& outBlobNames)
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(!empty());
+
+    if (preferableBackend != DNN_BACKEND_OPENCV || preferableTarget != DNN_TARGET_CPU)
+        CV_Error(Error::StsNotImplemented, "DNN: InferRequest supports OpenCV backend with CPU target only");
+
+    std::vector<String> names = outBlobNames;
+    if (names.empty())
+    {
+        std::vector<String> layerNames = getLayerNames();
+        CV_Assert(!layerNames.empty());
+        names.push_back(layerNames.back());
+    }
+
+    std::vector<LayerPin> pins;
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        LayerPin pin = getPinByAlias(names[i]);
+        if (!pin.valid())
+            CV_Error(Error::StsObjectNotFound, "Requested blob \"" + names[i] + "\" not found");
+        pins.push_back(pin);
+    }
+
+    // Run the network once to initialize the lazy state of layers (packed weights)
+    // before the layers are shared between the concurrent requests.
+    // It is done once per allocation: forwardToLayer() runs all the layers up to the given one.
+    setUpNet(pins);
+    const int lastLid = getLatestLayerPin(pins).lid;
+    if (warmupAllocationCounter != allocationCounter || warmupLastLayerId < lastLid)
+    {
+        FPDenormalsIgnoreHintScope fp_denormals_ignore_scope;
+        forwardToLayer(getLayerData(lastLid));
+        warmupAllocationCounter = allocationCounter;
+        warmupLastLayerId = lastLid;
+    }
+
+    Ptr<InferRequest::Impl> req = makePtr<InferRequest::Impl>();
+    req->netImpl = this;
+    req->allocationCounter = allocationCounter;
+    req->netInputLayer = netInputLayer;
+    req->inputsData.resize(netInputLayer->inputsData.size());
+    for (size_t i = 0; i < req->inputsData.size(); i++)
+        netInputLayer->inputsData[i].copyTo(req->inputsData[i]);
+    req->scaleFactors = netInputLayer->scaleFactors;
+    req->means = netInputLayer->means;
+
+    std::map<int, int> lidToStep;
+    std::map<const Mat*, std::pair<int, int> > outputToPin;
+    for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end() && it->first <= lastLid; ++it)
+    {
+        LayerData& ld = it->second;
+        lidToStep[ld.id] = (int)req->steps.size();
+        for (size_t i = 0; i < ld.outputBlobs.size(); i++)
+            outputToPin[&ld.outputBlobs[i]] = std::make_pair((int)req->steps.size(), (int)i);
+
+        InferRequest::Impl::Step step;
+        step.lid = ld.id;
+        step.skip = ld.id == 0 || ld.skip;
+        step.layer = ld.layerInstance;
+        if (!step.skip && !isLayerReentrant(ld.type))
+        {
+            Ptr<Mutex>& m = layerForwardMutexes[ld.id];
+            if (!m)
+                m = makePtr<Mutex>();
+            step.forwardMutex = m;
+        }
+        step.outputs.resize(ld.outputBlobs.size());
+        step.internals.resize(ld.internals.size());
+        req->steps.push_back(step);
+    }
+    CV_Assert(!req->steps.empty() && req->steps[0].lid == 0);
+
+    // the steps are not resized anymore, so the pointers to their blobs are stable
+    std::vector<Mat*> srcBlobs, dstBlobs;
+    size_t stepIdx = 0;
+    for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end() && it->first <= lastLid; ++it, ++stepIdx)
+    {
+        LayerData& ld = it->second;
+        InferRequest::Impl::Step& step = req->steps[stepIdx];
+        for (size_t i = 0; i < ld.outputBlobs.size(); i++)
+        {
+            srcBlobs.push_back(&ld.outputBlobs[i]);
+            dstBlobs.push_back(&step.outputs[i]);
+        }
+        for (size_t i = 0; i < ld.internals.size(); i++)
+        {
+            srcBlobs.push_back(&ld.internals[i]);
+            dstBlobs.push_back(&step.internals[i]);
+        }
+        if (ld.id == 0)
+            continue;
+
+        step.inputs.resize(ld.inputBlobs.size());
+        for (size_t i = 0; i < ld.inputBlobs.size(); i++)
+        {
+            std::map<const Mat*, std::pair<int, int> >::const_iterator from = outputToPin.find(ld.inputBlobs[i]);
+            CV_Assert(from != outputToPin.end());
+            step.inputs[i] = &req->steps[from->second.first].outputs[from->second.second];
+        }
+    }
+    cloneBlobsMemory(srcBlobs, dstBlobs);
+    req->buildDependencies();
+
+    for (size_t i = 0; i < pins.size(); i++)
+    {
+        CV_Assert(lidToStep.count(pins[i].lid));
+        req->outputs.push_back(std::make_pair(lidToStep[pins[i].lid], pins[i].oid));
+    }
+
+    return req;
+}
+
+
+namespace {
+
+// Background workers running the layers of the asynchronous requests.
+// The object is never destroyed to not join the threads on the process exit.
+class AsyncExecutor
+{
+public:
+    static AsyncExecutor& getInstance()
+    {
+        static AsyncExecutor* instance = new AsyncExecutor();
+        return *instance;
+    }
+
+    void submit(const std::function<void()>& task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push_back(task);
+        }
+        cond.notify_one();
+    }
+
+private:
+    AsyncExecutor()
+    {
+        int nthreads = std::max(1, getNumberOfCPUs());
+        for (int i = 0; i < nthreads; i++)
+            workers.push_back(std::thread(&AsyncExecutor::run, this));
+    }
+
+    void run()
+    {
+        for (;;)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cond.wait(lock, [this] { return !tasks.empty(); });
+                task = tasks.front();
+                tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<std::function<void()> > tasks;
+    std::vector<std::thread> workers;
+};
+
+// A single asynchronous forward pass. Steps are submitted to the executor as soon as
+// all their dependencies are finished, so independent branches run at the same time.
+struct AsyncRun
+{
+    Ptr<Net::Impl::AsyncRequests> async;  // the network itself may be destroyed as soon as the promise is set
+    String key;
+    Ptr<InferRequest::Impl> request;
+    AsyncPromise promise;
+
+    std::mutex mutex;
+    std::vector<int> pending;
+    int remaining;
+    bool failed;
+    std::exception_ptr error;
+};
+
+}  // namespace
+
+
+struct Net::Impl::AsyncRequests
+{
+    std::mutex mutex;
+    std::condition_variable done;
+    int inFlight;
+    std::map<String, std::vector<Ptr<InferRequest::Impl> > > idle;  // by the requested outputs
+
+    AsyncRequests() : inFlight(0) {}
+};
+
+
+static void finishAsyncRun(const Ptr<AsyncRun>& run)
+{
+    Mat result;
+    if (!run->failed)
+    {
+        try
+        {
+            std::vector<Mat> outs;
+            run->request->getOutputs(outs);
+            outs[0].copyTo(result);  // the request memory is reused by the next forward pass
+        }
+        catch (...)
+        {
+            run->failed = true;
+            run->error = std::current_exception();
+        }
+    }
+
+    // The result is delivered before the request is given back, so the pass is finished
+    // by the time the waiting ~Net() is woken. The network must not be accessed afterwards.
+    if (run->failed)
+        run->promise.setException(run->error);
+    else
+        run->promise.setValue(result);
+
+    Net::Impl::AsyncRequests& async = *run->async;
+    std::lock_guard<std::mutex> lock(async.mutex);
+    async.idle[run->key].push_back(run->request);
+    run->request.release();
+    async.inFlight--;
+    async.done.notify_all();
+}
+
+
+static void runAsyncStep(const Ptr<AsyncRun>& run, int stepIdx)
+{
+    while (stepIdx >= 0)
+    {
+        bool failed;
+        {
+            std::lock_guard<std::mutex> lock(run->mutex);
+            failed = run->failed;
+        }
+        if (!failed)
+        {
+            try
+            {
+                FPDenormalsIgnoreHintScope fp_denormals_ignore_scope;
+                run->request->runStep(stepIdx);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(run->mutex);
+                if (!run->failed)
+                {
+                    run->failed = true;
+                    run->error = std::current_exception();
+                }
+            }
+        }
+
+        std::vector<int> ready;
+        bool finished;
+        {
+            std::lock_guard<std::mutex> lock(run->mutex);
+            const std::vector<int>& successors = run->request->successors[stepIdx];
+            for (size_t i = 0; i < successors.size(); i++)
+            {
+                if (--run->pending[successors[i]] == 0)
+                    ready.push_back(successors[i]);
+            }
+            finished = --run->remaining == 0;
+        }
+        if (finished)
+        {
+            finishAsyncRun(run);
+            return;
+        }
+
+        // continue with the first ready step in this thread
+        for (size_t i = 1; i < ready.size(); i++)
+        {
+            int next = ready[i];
+            AsyncExecutor::getInstance().submit([run, next] { runAsyncStep(run, next); });
+        }
+        stepIdx = ready.empty() ? -1 : ready[0];
+    }
+}
+
+
+AsyncArray Net::Impl::forwardAsyncCPU(const String& layerName)
+{
+    CV_TRACE_FUNCTION();
+
+    std::vector<String> outBlobNames(1, layerName);
+    setUpNet(std::vector<LayerPin>(1, getPinByAlias(layerName)));
+
+    if (!asyncRequests)
+        asyncRequests = makePtr<AsyncRequests>();
+
+    Ptr<InferRequest::Impl> request;
+    {
+        std::lock_guard<std::mutex> lock(asyncRequests->mutex);
+        std::vector<Ptr<InferRequest::Impl> >& idle = asyncRequests->idle[layerName];
+        while (!idle.empty() && !request)
+        {
+            if (idle.back()->allocationCounter == allocationCounter)
+                request = idle.back();
+            idle.pop_back();
+        }
+    }
+    if (!request)
+        request = createInferRequest(outBlobNames);
+
+    // inputs are captured on the call, the network may get new ones before the request is finished
+    request->setInputs(*netInputLayer);
+
+    Ptr<AsyncRun> run = makePtr<AsyncRun>();
+    run->async = asyncRequests;
+    run->key = layerName;
+    run->request = request;
+    run->pending = request->numDependencies;
+    run->remaining = (int)request->executedSteps.size();
+    run->failed = false;
+    AsyncArray result = run->promise.getArrayResult();
+
+    {
+        std::lock_guard<std::mutex> lock(asyncRequests->mutex);
+        asyncRequests->inFlight++;
+    }
+    for (size_t i = 0; i < request->executedSteps.size(); i++)
+    {
+        int stepIdx = request->executedSteps[i];
+        if (request->numDependencies[stepIdx] == 0)
+            AsyncExecutor::getInstance().submit([run, stepIdx] { runAsyncStep(run, stepIdx); });
+    }
+    return result;
+}
+
+
+void Net::Impl::waitAsyncRequests()
+{
+    if (!asyncRequests)
+        return;
+    std::unique_lock<std::mutex> lock(asyncRequests->mutex);
+    asyncRequests->done.wait(lock, [this] { return asyncRequests->inFlight == 0; });
+}
+
+
+InferRequest Net::createInferRequest(const std::vector<String>& outBlobNames)
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(impl);
+    CV_Assert(!empty());
+    InferRequest request;
+    request.impl = impl->createInferRequest(outBlobNames);
+    request.impl->net = impl;
+    return request;
+}
+
+
+InferRequest::InferRequest()
+{
+}
+
+bool InferRequest::empty() const
+{
+    return !impl;
+}
+
+void InferRequest::setInput(InputArray blob, const String& name, double scalefactor, const Scalar& mean)
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(impl);
+    impl->setInput(blob, name, scalefactor, mean);
+}
+
+Mat InferRequest::forward()
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(impl);
+    std::vector<Mat> outs;
+    impl->forward(outs);
+    return outs[0];
+}
+
+void InferRequest::forward(OutputArrayOfArrays outputBlobs)
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(impl);
+    std::vector<Mat> outs;
+    impl->forward(outs);
+    outputBlobs.create((int)outs.size(), 1, CV_32F/*FIXIT*/, -1);  // allocate vector
+    outputBlobs.assign(outs);
+}
+
+
+CV__DNN_INLINE_NS_END
+}}  // namespace cv::dnn
@@ -4,6 +4,7 @@
 
 #include "../precomp.hpp"
 #include "layers_common.hpp"
+#include "fast_convolution/fast_convolution_int8.hpp"
 
 #include <opencv2/core/utils/logger.hpp>
 
@@ -38,6 +39,8 @@ static inline void v_expand_mul_add(const v_int8x16& a, const v_int8x16& b,
 class BaseConvolutionLayerInt8Impl : public ConvolutionLayerInt8
 {
 public:
+    std::string prepackKey;  // identifies the weights in the prepacked weights cache
+
     BaseConvolutionLayerInt8Impl(const LayerParams &params)
     {
         setParamsFrom(params);
@@ -70,6 +73,10 @@ public:
         for (int i = 0; i < adjust_pads.size(); i++) {
             CV_Assert(adjust_pads[i] < strides[i]);
         }
+
+        std::string modelKey = params.get<String>("prepack_model_key", "");
+        if (!modelKey.empty())
+            prepackKey = modelKey + "/" + name;
     }
 
     virtual void finalize(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr) CV_OVERRIDE
@@ -164,7 +171,9 @@ public:
     std::vector<int> biasvec;
     std::vector<float> outputMultiplier;
     Mat activationLUT;
+    Mat activationLUT8;
     Ptr<ActivationLayerInt8> activ;
+    Ptr<FastConv2dInt8> fastConvImpl;
 
     ConvolutionLayerInt8Impl(const LayerParams &params) : BaseConvolutionLayerInt8Impl(params){}
 
@@ -270,6 +279,7 @@ public:
             biasvec[i] = biasMat.at<int>(i);
             outputMultiplier[i] = outMult.at<float>(i);
         }
+        fastConvImpl.release();
     }
 
     bool setActivation(const Ptr<ActivationLayer>& layer) CV_OVERRIDE
@@ -284,7 +294,10 @@ public:
         {
             activ = activ_int8;
             if (!activ_int8->blobs.empty())
+            {
                 activ_int8->blobs[0].convertTo(activationLUT, CV_32S);
+                activ_int8->blobs[0].convertTo(activationLUT8, CV_8S);
+            }
             return true;
         }
         return false;
@@ -316,6 +329,7 @@ public:
         }
         biasvec[outCn] = biasvec[outCn+1] = biasvec[outCn-1];
         outputMultiplier[outCn] = outputMultiplier[outCn+1] = outputMultiplier[outCn-1];
+        fastConvImpl.release();
     }
 
     virtual Ptr<BackendNode> initTimVX(void* timVXInfo_,
@@ -1382,12 +1396,30 @@ public:
         CV_Assert(outputs[0].size[1] % ngroups == 0);
 
         int nstripes = std::max(getNumThreads(), 1);
-        Mat outputInt32 = Mat(shape(outputs[0]), CV_32S);
 
-        ParallelConv::run(inputs[0], outputInt32, weightsMat, outputMultiplier, biasvec, activationLUT, kernel_size, strides,
-                          pads_begin, pads_end, dilations, activ.get(), ngroups, nstripes, input_zp, output_zp);
+        if (inputs[0].dims == 4)
+        {
+            // 2D convolution: packed weights, int8 output with the requantization and the activation fused in
+            if (!fastConvImpl)
+            {
+                int K = outputs[0].size[1], C = inputs[0].size[1];
+                fastConvImpl = initFastConv2dInt8(ngroups, K, C, (int)kernel_size[0], (int)kernel_size[1],
+                                                  (int)strides[1], (int)strides[0], (int)dilations[1], (int)dilations[0],
+                                                  pads_begin, pads_end, weightsMat, biasvec.data(), outputMultiplier.data(),
+                                                  prepackKey);
+            }
+            runFastConv2dInt8(inputs[0], outputs[0], fastConvImpl, nstripes, input_zp, output_zp,
+                              activ ? activationLUT8 : Mat());
+        }
+        else
+        {
+            Mat outputInt32 = Mat(shape(outputs[0]), CV_32S);
+
+            ParallelConv::run(inputs[0], outputInt32, weightsMat, outputMultiplier, biasvec, activationLUT, kernel_size, strides,
+                              pads_begin, pads_end, dilations, activ.get(), ngroups, nstripes, input_zp, output_zp);
 
-        outputInt32.convertTo(outputs[0], CV_8S);
+            outputInt32.convertTo(outputs[0], CV_8S);
+        }
 
 #if CV_SSE3
         _MM_SET_FLUSH_ZERO_MODE(ftzMode);
@@ -0,0 +1,93 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "../../precomp.hpp"
+#include "fast_convolution_int8.hpp"
+
+namespace cv { namespace dnn {
+
+void runDepthwiseInt8(InputArray _input, OutputArray _output, const Ptr<FastConv2dInt8>& conv, int ntasks,
+                      int inpZp, int outZp, const Mat& activLUT)
+{
+    Mat input = _input.getMat();
+    Mat output = _output.getMat();
+    MatShape inputShape = shape(input);
+    MatShape outputShape = shape(output);
+    CV_Assert(inputShape.size() == 4 && outputShape.size() == 4);
+
+    int N = inputShape[0], C = inputShape[1], Hi = inputShape[2], Wi = inputShape[3];
+    int H0 = outputShape[2], W0 = outputShape[3];
+    CV_CheckEQ(C, conv->C, "");
+    CV_CheckEQ(outputShape[1], C, "");
+
+    const int Hk = conv->Hk, Wk = conv->Wk, ksize = Hk*Wk;
+    const int stride_y = conv->stride_y, stride_x = conv->stride_x;
+    const int dilation_y = conv->dilation_y, dilation_x = conv->dilation_x;
+    const int pad_top = conv->pad_top, pad_left = conv->pad_left;
+    const int y_extent = (Hk - 1)*dilation_y, x_extent = (Wk - 1)*dilation_x;
+
+    std::vector<int> ofstab_(ksize*3, 0);
+    int* ofstab = ofstab_.data();
+    int* yxtab = ofstab + ksize;
+    for (int y = 0; y < Hk; y++)
+        for (int x = 0; x < Wk; x++)
+        {
+            int k = y*Wk + x;
+            int dy = y*dilation_y, dx = x*dilation_x;
+            yxtab[k*2] = dy;
+            yxtab[k*2 + 1] = dx;
+            ofstab[k] = dy*Wi + dx;
+        }
+
+    const int8_t* inp = input.ptr<int8_t>();
+    int8_t* out = output.ptr<int8_t>();
+    const int8_t* lut = activLUT.empty() ? 0 : activLUT.ptr<int8_t>();
+
+    // the output pixels [inner_x0, inner_x1) of the inner rows have all the taps inside the input
+    int inner_x0 = std::min((pad_left + stride_x - 1)/stride_x, W0);
+    int inner_x1 = Wi - 1 - x_extent + pad_left >= 0 ? (Wi - 1 - x_extent + pad_left)/stride_x + 1 : 0;
+    inner_x1 = std::max(std::min(inner_x1, W0), inner_x0);
+
+    parallel_for_(Range(0, N*C), [&](const Range& r0) {
+        AutoBuffer<int> rowbuf_(W0);
+        int* acc = rowbuf_.data();
+
+        for (int nc = r0.start; nc < r0.end; nc++)
+        {
+            int c = nc % C;
+            const int8_t* inptr0 = inp + (size_t)nc*Hi*Wi;
+            int8_t* outptr0 = out + (size_t)nc*H0*W0;
+            const int8_t* weights = conv->weightsBuf.ptr<int8_t>() + (size_t)c*ksize;
+
+            for (int y0 = 0; y0 < H0; y0++)
+            {
+                int yi0 = y0*stride_y - pad_top;
+                bool inner_y = yi0 >= 0 && yi0 + y_extent < Hi;
+                int x0 = 0;
+                while (x0 < W0)
+                {
+                    if (inner_y && x0 == inner_x0 && inner_x0 < inner_x1)
+                    {
+                        int xi0 = x0*stride_x - pad_left;
+                        depthwiseRowInt8(inptr0 + yi0*Wi + xi0, weights, ofstab, ksize, stride_x, x_extent,
+                                         Wi - xi0, acc + x0, inner_x1 - x0);
+                        x0 = inner_x1;
+                        continue;
+                    }
+                    int xi0 = x0*stride_x - pad_left, s = 0;
+                    for (int k = 0; k < ksize; k++)
+                    {
+                        int yi = yi0 + yxtab[k*2], xi = xi0 + yxtab[k*2 + 1];
+                        int v = (unsigned)yi < (unsigned)Hi && (unsigned)xi < (unsigned)Wi ? inptr0[yi*Wi + xi] : inpZp;
+                        s += v*weights[k];
+                    }
+                    acc[x0++] = s;
+                }
+                requantizeInt8(acc, outptr0 + (size_t)y0*W0, W0, conv->biasBuf[c], conv->multiplierBuf[c], outZp, lut);
+            }
+        }
+    }, ntasks);
+}
+
+}} // namespace cv::dnn
@@ -0,0 +1,355 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "../../precomp.hpp"
+#include "fast_convolution_int8.hpp"
+#include "fast_convolution_int8.simd.hpp"
+#include "../../prepack_cache.hpp"
+#include "int8layers/fast_convolution/fast_convolution_int8.simd_declarations.hpp"
+
+namespace cv { namespace dnn {
+
+static void getConvBlockSizeInt8(int& mr, int& nr, bool& unsignedWeights)
+{
+    CV_CPU_DISPATCH(getConvBlockSizeInt8, (mr, nr, unsignedWeights), CV_CPU_DISPATCH_MODES_ALL);
+}
+
+static void convBlocksInt8(int np, int mblocks, int nblocks, const int8_t* a, size_t astep,
+                           const int8_t* b, size_t bstep, int* c, int ldc, bool init_c)
+{
+    CV_CPU_DISPATCH(convBlocksInt8, (np, mblocks, nblocks, a, astep, b, bstep, c, ldc, init_c), CV_CPU_DISPATCH_MODES_ALL);
+}
+
+void depthwiseRowInt8(const int8_t* inptr, const int8_t* weights, const int* ofstab, int ksize,
+                      int stride_x, int x_extent, int width, int* acc, int count)
+{
+    CV_CPU_DISPATCH(depthwiseRowInt8, (inptr, weights, ofstab, ksize, stride_x, x_extent, width, acc, count),
+        CV_CPU_DISPATCH_MODES_ALL);
+}
+
+Ptr<FastConv2dInt8> initFastConv2dInt8(
+        int ngroups,
+        int K, int C, int Hk, int Wk,
+        int stride_x, int stride_y,
+        int dilation_x, int dilation_y,
+        const std::vector<size_t>& pads_begin,
+        const std::vector<size_t>& pads_end,
+        InputArray _weightsMat,
+        const int* srcBias, const float* srcMultiplier,
+        const std::string& prepackKey)
+{
+    Ptr<FastConv2dInt8> conv = makePtr<FastConv2dInt8>();
+
+    CV_Assert(ngroups > 0 && K > 0 && C > 0 && K % ngroups == 0 && C % ngroups == 0);
+    CV_Assert(Hk > 0 && Wk > 0);
+    CV_Assert(stride_y > 0 && stride_x > 0);
+    CV_Assert(dilation_y > 0 && dilation_x > 0);
+    CV_Assert(srcBias && srcMultiplier);
+
+    conv->K = K; conv->C = C; conv->Hk = Hk; conv->Wk = Wk;  // [K, iC, kH, kW]
+    conv->stride_y = stride_y;
+    conv->stride_x = stride_x;
+    conv->dilation_y = dilation_y;
+    conv->dilation_x = dilation_x;
+
+    conv->ngroups = ngroups;
+    conv->pad_top = (int)pads_begin[0];
+    conv->pad_bottom = (int)pads_end[0];
+    conv->pad_left = (int)pads_begin[1];
+    conv->pad_right = (int)pads_end[1];
+    getConvBlockSizeInt8(conv->mr, conv->nr, conv->unsignedWeights);
+    conv->isDepthwise = ngroups > 1 && ngroups == K && ngroups == C;
+
+    Mat weightsMat = _weightsMat.getMat();
+    CV_CheckTypeEQ(weightsMat.type(), CV_8S, "");
+    CV_CheckEQ(weightsMat.rows, K, "");
+    const size_t wstep = weightsMat.step1();
+    const int8_t* srcWeights = weightsMat.ptr<int8_t>();
+
+    if (conv->isDepthwise)
+    {
+        // depth-wise convolutions are computed directly on NCHW data, the weights are kept in KCHW layout
+        int ksize = Hk*Wk;
+        conv->weightsBuf.create(C, ksize, CV_8S);
+        for (int c = 0; c < C; c++)
+            memcpy(conv->weightsBuf.ptr<int8_t>(c), srcWeights + c*wstep, ksize);
+    }
+    else
+    {
+        // The weights are packed as
+        // ngroups x ceil((K/ngroups)/MR) x ceil(Cg*Hk*Wk/4) x MR x 4 tensor,
+        // i.e. each micro-kernel step multiplies MR rows by 4 consecutive elements of the kernel.
+        const int MR = conv->mr;
+        const int Kg = K/ngroups, Cg = C/ngroups;
+        const int ksize = Cg*Hk*Wk, np = (ksize + 3)/4;
+        const int numStripsMR = (Kg + MR - 1)/MR;
+        const int8_t wbias = conv->unsignedWeights ? (int8_t)0x80 : (int8_t)0;
+        const int nweights = ngroups*numStripsMR*np*MR*4;
+
+        PrepackCacheKey cacheKey("FastConv2dInt8");
+        if (isPrepackCacheEnabled())
+        {
+            cacheKey << ngroups << K << C << Hk << Wk << MR << (int)conv->unsignedWeights;
+            cacheKey.addWeights(prepackKey, weightsMat);
+            std::vector<Mat> cached;
+            if (loadPrepackedBuffers(cacheKey, cached) && cached.size() == 1 &&
+                cached[0].type() == CV_8S && cached[0].total() == (size_t)nweights)
+            {
+                conv->weightsBuf = cached[0];
+            }
+        }
+
+        if (conv->weightsBuf.empty())
+        {
+            conv->weightsBuf.create(1, nweights, CV_8S);
+            int8_t* weightsBufPtr = conv->weightsBuf.ptr<int8_t>();
+
+            parallel_for_(Range(0, ngroups*numStripsMR), [&](const Range& r0) {
+            for (int gsi = r0.start; gsi < r0.end; gsi++)
+            {
+                int g = gsi / numStripsMR;
+                int startK = (gsi - g*numStripsMR)*MR;
+                int8_t* packed_wptr = weightsBufPtr + (size_t)gsi*np*MR*4;
+                for (int p = 0; p < np; p++)
+                    for (int k = 0; k < MR; k++)
+                        for (int t = 0; t < 4; t++, packed_wptr++)
+                        {
+                            int q = p*4 + t;
+                            int8_t w = startK + k < Kg && q < ksize ? srcWeights[(g*Kg + startK + k)*wstep + q] : (int8_t)0;
+                            *packed_wptr = w ^ wbias;
+                        }
+            }});
+
+            savePrepackedBuffers(cacheKey, std::vector<Mat>(1, conv->weightsBuf));
+        }
+    }
+
+    conv->biasBuf.assign(srcBias, srcBias + K);
+    conv->multiplierBuf.assign(srcMultiplier, srcMultiplier + K);
+    return conv;
+}
+
+void requantizeInt8(const int* acc, int8_t* out, int len, int bias, float multiplier,
+                    int outZp, const int8_t* lut)
+{
+    int i = 0;
+#if CV_SIMD
+    const int VECSZ = v_int8::nlanes, NLANES = v_int32::nlanes;
+    v_int32 vbias = vx_setall_s32(bias), voutzp = vx_setall_s32(outZp);
+    v_float32 vmult = vx_setall_f32(multiplier);
+    for (; i <= len - VECSZ; i += VECSZ)
+    {
+        v_int32 s0 = voutzp + v_round(v_cvt_f32(vx_load(acc + i) + vbias)*vmult);
+        v_int32 s1 = voutzp + v_round(v_cvt_f32(vx_load(acc + i + NLANES) + vbias)*vmult);
+        v_int32 s2 = voutzp + v_round(v_cvt_f32(vx_load(acc + i + NLANES*2) + vbias)*vmult);
+        v_int32 s3 = voutzp + v_round(v_cvt_f32(vx_load(acc + i + NLANES*3) + vbias)*vmult);
+        // the saturating packs clip the result to [-128, 127]
+        v_store(out + i, v_pack(v_pack(s0, s1), v_pack(s2, s3)));
+    }
+#endif
+    for (; i < len; i++)
+        out[i] = saturate_cast<schar>(outZp + cvRound((acc[i] + bias)*multiplier));
+
+    if (lut)
+    {
+        for (i = 0; i < len; i++)
+            out[i] = lut[out[i] + 128];
+    }
+}
+
+// Packs Cg*Hk*Wk x ncols slice of the im2col matrix into column blocks of nr elements,
+// each kernel step takes 4 consecutive rows. The zero point is used for the padded pixels.
+static void packInputInt8(const int8_t* inp, int8_t* inpbuf, int yx0, int ncols, int nblocks, int p0, int pn,
+                          const Ptr<FastConv2dInt8>& conv, const int* ofstab, const int* yxtab,
+                          int Hi, int Wi, int W0, int ksize, bool fast_1x1, int inpZp)
+{
+    const int NR = conv->nr;
+    const size_t bstep = (size_t)pn*NR*4;
+
+    if (fast_1x1)
+    {
+        // 1x1 convolution with unit strides and no padding: interleave 4 feature planes at a time
+        const size_t planesize = (size_t)Hi*Wi;
+        for (int nb = 0; nb < nblocks; nb++)
+        {
+            const int jmax = std::min(NR, ncols - nb*NR);
+            for (int pp = 0; pp < pn; pp++)
+            {
+                int8_t* dst = inpbuf + nb*bstep + (size_t)pp*NR*4;
+                const int c = (p0 + pp)*4;
+                const int8_t* src = inp + c*planesize + yx0 + nb*NR;
+                int j = 0;
+#if CV_SIMD128
+                if (c + 3 < ksize)
+                {
+                    for (; j <= jmax - 16; j += 16)
+                    {
+                        v_int8x16 r0 = v_load(src + j), r1 = v_load(src + planesize + j);
+                        v_int8x16 r2 = v_load(src + planesize*2 + j), r3 = v_load(src + planesize*3 + j);
+                        v_int8x16 t0, t1, t2, t3;
+                        v_zip(r0, r1, t0, t1);
+                        v_zip(r2, r3, t2, t3);
+                        v_int16x8 u0, u1, u2, u3;
+                        v_zip(v_reinterpret_as_s16(t0), v_reinterpret_as_s16(t2), u0, u1);
+                        v_zip(v_reinterpret_as_s16(t1), v_reinterpret_as_s16(t3), u2, u3);
+                        v_store(dst + j*4, v_reinterpret_as_s8(u0));
+                        v_store(dst + j*4 + 16, v_reinterpret_as_s8(u1));
+                        v_store(dst + j*4 + 32, v_reinterpret_as_s8(u2));
+                        v_store(dst + j*4 + 48, v_reinterpret_as_s8(u3));
+                    }
+                }
+#endif
+                for (; j < NR; j++)
+                    for (int t = 0; t < 4; t++)
+                        dst[j*4 + t] = j < jmax && c + t < ksize ? src[t*planesize + j] : (int8_t)0;
+            }
+        }
+        return;
+    }
+
+    const int Hk = conv->Hk, Wk = conv->Wk;
+    const int stride_y = conv->stride_y, stride_x = conv->stride_x;
+    const int pad_top = conv->pad_top, pad_left = conv->pad_left;
+    const int y_extent = (Hk - 1)*conv->dilation_y, x_extent = (Wk - 1)*conv->dilation_x;
+    const int q0 = p0*4, q1 = std::min((p0 + pn)*4, ksize);
+
+    for (int j = 0; j < nblocks*NR; j++)
+    {
+        int8_t* dst = inpbuf + (j/NR)*bstep + (j%NR)*4;
+        if (j >= ncols)
+        {
+            for (int pp = 0; pp < pn; pp++, dst += NR*4)
+                memset(dst, 0, 4);
+            continue;
+        }
+        int yx = yx0 + j;
+        int y0 = yx / W0, x0 = yx - y0*W0;
+        int yi = y0*stride_y - pad_top, xi = x0*stride_x - pad_left;
+        const int8_t* inptr = inp + (ptrdiff_t)yi*Wi + xi;
+        int q = q0;
+
+        if (yi >= 0 && yi + y_extent < Hi && xi >= 0 && xi + x_extent < Wi)
+        {
+            for (; q < q1; q++)
+                dst[(q - q0)/4*NR*4 + (q & 3)] = inptr[ofstab[q]];
+        }
+        else
+        {
+            for (; q < q1; q++)
+            {
+                int yy = yi + yxtab[q*2], xx = xi + yxtab[q*2 + 1];
+                dst[(q - q0)/4*NR*4 + (q & 3)] = (unsigned)yy < (unsigned)Hi && (unsigned)xx < (unsigned)Wi ?
+                                                 inptr[ofstab[q]] : (int8_t)inpZp;
+            }
+        }
+        for (; q < q0 + pn*4; q++)
+            dst[(q - q0)/4*NR*4 + (q & 3)] = 0;
+    }
+}
+
+void runFastConv2dInt8(InputArray _input, OutputArray _output, const Ptr<FastConv2dInt8>& conv, int ntasks,
+                       int inpZp, int outZp, const Mat& activLUT)
+{
+    Mat input = _input.getMat();
+    Mat output = _output.getMat();
+
+    MatShape inputShape = shape(input);
+    MatShape outputShape = shape(output);
+    CV_Assert(inputShape.size() == 4 && outputShape.size() == 4);
+    CV_CheckTypeEQ(input.type(), CV_8S, "");
+    CV_CheckTypeEQ(output.type(), CV_8S, "");
+    CV_Assert(input.isContinuous() && output.isContinuous());
+    CV_Assert(activLUT.empty() || (activLUT.type() == CV_8S && activLUT.total() == 256));
+
+    if (conv->isDepthwise)
+        return runDepthwiseInt8(input, output, conv, ntasks, inpZp, outZp, activLUT);
+
+    int N = inputShape[0], C = inputShape[1], Hi = inputShape[2], Wi = inputShape[3];  // [N, C, H, W]
+    int K = conv->K, Hk = conv->Hk, Wk = conv->Wk;
+    int H0 = outputShape[2], W0 = outputShape[3], ngroups = conv->ngroups;
+    int Cg = C/ngroups, Kg = K/ngroups;
+    CV_CheckEQ(C, conv->C, "");
+    CV_CheckEQ(outputShape[1], K, "");
+
+    const int MR = conv->mr, NR = conv->nr;
+    const int ksize = Cg*Hk*Wk, np = (ksize + 3)/4;
+    const size_t inp_planesize = (size_t)Hi*Wi;
+    const int out_planesize = H0*W0;
+    const bool fast_1x1 = Hk == 1 && Wk == 1 && conv->stride_y == 1 && conv->stride_x == 1 &&
+                          conv->pad_top == 0 && conv->pad_left == 0 && H0 == Hi && W0 == Wi;
+
+    // Friendly to L1/L2 cache: a task computes up to NR_BLOCKS*NR output pixels,
+    // the im2col matrix is packed by P_BLOCK_SIZE*4 rows at once.
+    const int NR_BLOCKS = 4;
+    const int P_BLOCK_SIZE = 256;
+    const int YX_TILE = NR*NR_BLOCKS;
+
+    const int Kg_nblocks = (Kg + MR - 1)/MR;
+    const int yx_ntiles = (out_planesize + YX_TILE - 1)/YX_TILE;
+    const size_t ntiles = (size_t)N*ngroups*yx_ntiles;
+
+    // split the output channels as well if there are not enough spatial tiles to keep all the threads busy
+    int k_ntiles = 1;
+    if (ntiles < (size_t)ntasks*2)
+        k_ntiles = (int)std::min((size_t)Kg_nblocks, ((size_t)ntasks*2 + ntiles - 1)/ntiles);
+    const int k_tile_blocks = (Kg_nblocks + k_ntiles - 1)/k_ntiles;
+    k_ntiles = (Kg_nblocks + k_tile_blocks - 1)/k_tile_blocks;
+
+    std::vector<int> ofstab_(ksize*3, 0);
+    int* ofstab = ofstab_.data();
+    int* yxtab = ofstab + ksize;
+    for (int c = 0, q = 0; c < Cg; c++)
+        for (int y = 0; y < Hk; y++)
+            for (int x = 0; x < Wk; x++, q++)
+            {
+                int dy = y*conv->dilation_y, dx = x*conv->dilation_x;
+                yxtab[q*2] = dy;
+                yxtab[q*2 + 1] = dx;
+                ofstab[q] = (int)(c*inp_planesize) + dy*Wi + dx;
+            }
+
+    const int8_t* inp = input.ptr<int8_t>();
+    int8_t* out = output.ptr<int8_t>();
+    const int8_t* lut = activLUT.empty() ? 0 : activLUT.ptr<int8_t>();
+    const size_t wstep = (size_t)np*MR*4;
+
+    parallel_for_(Range(0, (int)(ntiles*k_ntiles)), [&](const Range& r0) {
+        AutoBuffer<int8_t> inpbuf_((size_t)NR_BLOCKS*P_BLOCK_SIZE*NR*4);
+        AutoBuffer<int> cbuf_((size_t)k_tile_blocks*MR*YX_TILE);
+        int8_t* inpbuf = inpbuf_.data();
+        int* cbuf = cbuf_.data();
+
+        for (int task = r0.start; task < r0.end; task++)
+        {
+            int kt = task % k_ntiles, t = task / k_ntiles;
+            int yxt = t % yx_ntiles, ng = t / yx_ntiles;
+            int n = ng / ngroups, g = ng - n*ngroups;
+            int yx0 = yxt*YX_TILE, ncols = std::min(YX_TILE, out_planesize - yx0);
+            int nblocks = (ncols + NR - 1)/NR;
+            int mb0 = kt*k_tile_blocks, mb1 = std::min(mb0 + k_tile_blocks, Kg_nblocks);
+
+            const int8_t* inptr = inp + (size_t)(n*C + g*Cg)*inp_planesize;
+            const int8_t* wptr = conv->weightsBuf.ptr<int8_t>() + (size_t)(g*Kg_nblocks + mb0)*wstep;
+
+            for (int p0 = 0; p0 < np; p0 += P_BLOCK_SIZE)
+            {
+                int pn = std::min(P_BLOCK_SIZE, np - p0);
+                packInputInt8(inptr, inpbuf, yx0, ncols, nblocks, p0, pn, conv, ofstab, yxtab,
+                              Hi, Wi, W0, ksize, fast_1x1, inpZp);
+                convBlocksInt8(pn, mb1 - mb0, nblocks, wptr + (size_t)p0*MR*4, wstep,
+                               inpbuf, (size_t)pn*NR*4, cbuf, YX_TILE, p0 == 0);
+            }
+
+            int k1 = std::min(mb1*MR, Kg);
+            for (int k = mb0*MR; k < k1; k++)
+            {
+                int kidx = g*Kg + k;
+                requantizeInt8(cbuf + (k - mb0*MR)*YX_TILE, out + ((size_t)n*K + kidx)*out_planesize + yx0, ncols,
+                               conv->biasBuf[kidx], conv->multiplierBuf[kidx], outZp, lut);
+            }
+        }
+    }, ntasks);
+}
+
+}} // namespace cv::dnn
@@ -0,0 +1,60 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_FAST_CONVOLUTION_INT8_HPP
+#define OPENCV_FAST_CONVOLUTION_INT8_HPP
+
+#include "opencv2/core/hal/intrin.hpp"
+
+namespace cv {
+namespace dnn {
+
+struct FastConv2dInt8
+{
+    int ngroups;
+    int K, C, Hk, Wk;
+    int stride_y, stride_x;
+    int dilation_y, dilation_x;
+    int pad_top, pad_bottom, pad_left, pad_right;
+
+    int mr, nr;                     // size of the block computed by the dispatched micro-kernel
+    bool unsignedWeights;           // the weights are stored as w + 128 for the u8 x s8 kernels
+    bool isDepthwise;
+
+    Mat weightsBuf;                 // packed weights, or KCHW weights for depth-wise convolution
+    std::vector<int> biasBuf;
+    std::vector<float> multiplierBuf;
+};
+
+// return a FastConv2dInt8 instance.
+Ptr<FastConv2dInt8> initFastConv2dInt8(
+        int ngroups,
+        int K, int C, int Hk, int Wk,
+        int stride_x, int stride_y,
+        int dilation_x, int dilation_y,
+        const std::vector<size_t>& pads_begin,
+        const std::vector<size_t>& pads_end,
+        InputArray weightsMat,
+        const int* srcBias, const float* srcMultiplier,
+        const std::string& prepackKey);  // the model key and the layer name, see PrepackCacheKey
+
+// Computes the int8 output with the requantization and the activation lookup table (if not empty) fused in.
+void runFastConv2dInt8(InputArray _input, OutputArray _output, const Ptr<FastConv2dInt8>& conv, int ntasks,
+                       int inpZp, int outZp, const Mat& activLUT);
+
+void runDepthwiseInt8(InputArray _input, OutputArray _output, const Ptr<FastConv2dInt8>& conv, int ntasks,
+                      int inpZp, int outZp, const Mat& activLUT);
+
+// computes the depth-wise convolution accumulators of the output row pixels which have all the taps inside the input
+void depthwiseRowInt8(const int8_t* inptr, const int8_t* weights, const int* ofstab, int ksize,
+                      int stride_x, int x_extent, int width, int* acc, int count);
+
+// out[i] = lut(saturate_cast<schar>(outZp + round((acc[i] + bias)*multiplier)))
+void requantizeInt8(const int* acc, int8_t* out, int len, int bias, float multiplier,
+                    int outZp, const int8_t* lut);
+
+} // namespace dnn
+} // namespace cv
+
+#endif //OPENCV_FAST_CONVOLUTION_INT8_HPP
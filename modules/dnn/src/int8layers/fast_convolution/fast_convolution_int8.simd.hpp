@@ -0,0 +1,319 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "opencv2/core/hal/intrin.hpp"
+
+namespace cv {
+namespace dnn {
+CV_CPU_OPTIMIZATION_NAMESPACE_BEGIN
+
+// Returns the size of the block computed by the micro-kernel (mr x nr) and whether the weights
+// must be stored biased by 128, i.e. as unsigned 8-bit values, for the u8 x s8 dot products.
+void getConvBlockSizeInt8(int& mr, int& nr, bool& unsignedWeights);
+
+// C[mblocks*mr x nblocks*nr] = A * B (+ C), where A is packed by mr rows as [mblocks][np][mr][4]
+// and B is packed by nr columns as [nblocks][np][nr][4].
+// astep and bstep are the distances (in bytes) between the consecutive row and column blocks.
+void convBlocksInt8(int np, int mblocks, int nblocks, const int8_t* a, size_t astep,
+                    const int8_t* b, size_t bstep, int* c, int ldc, bool init_c);
+
+// acc[j] = sum_k weights[k]*inptr[j*stride_x + ofstab[k]], j < count, for the pixels of a depth-wise
+// convolution row that have all the taps inside the input; width is the number of the valid pixels in inptr row.
+void depthwiseRowInt8(const int8_t* inptr, const int8_t* weights, const int* ofstab, int ksize,
+                      int stride_x, int x_extent, int width, int* acc, int count);
+
+#ifndef CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+void depthwiseRowInt8(const int8_t* inptr, const int8_t* weights, const int* ofstab, int ksize,
+                      int stride_x, int x_extent, int width, int* acc, int count)
+{
+    int j = 0;
+#if CV_SIMD256 || CV_SIMD128
+    // the products of 8-bit values fit 16-bit lanes; 256-bit vectors are used for AVX-512 too,
+    // since the feature maps of the depth-wise convolutions are usually narrow
+#if CV_SIMD256
+    typedef v_int16x16 v_int16_dw;
+    typedef v_int32x8 v_int32_dw;
+#define CONV_INT8_DW(name) v256_##name
+#else
+    typedef v_int16x8 v_int16_dw;
+    typedef v_int32x4 v_int32_dw;
+#define CONV_INT8_DW(name) v_##name
+#endif
+    const int VECSZ = v_int16_dw::nlanes;
+    if (stride_x <= 2)
+    {
+        for (; j < count; j += VECSZ)
+        {
+            // the tail is processed by the block overlapping with the previous one
+            if (j + VECSZ > count)
+            {
+                if (j == 0)
+                    break;
+                j = count - VECSZ;
+            }
+            if ((j + VECSZ)*stride_x + x_extent > width)
+                break;
+            const int8_t* ptr = inptr + j*stride_x;
+            v_int32_dw s0 = CONV_INT8_DW(setzero_s32)(), s1 = s0;
+            for (int k = 0; k < ksize; k++)
+            {
+                v_int16_dw x;
+                if (stride_x == 1)
+                    x = CONV_INT8_DW(load_expand)(ptr + ofstab[k]);
+                else
+                {
+                    // sign-extend the even bytes
+                    x = v_reinterpret_as_s16(CONV_INT8_DW(load)(ptr + ofstab[k]));
+                    x = (x << 8) >> 8;
+                }
+                v_int32_dw t0, t1;
+                v_expand(v_mul_wrap(x, CONV_INT8_DW(setall_s16)(weights[k])), t0, t1);
+                s0 += t0;
+                s1 += t1;
+            }
+            v_store(acc + j, s0);
+            v_store(acc + j + VECSZ/2, s1);
+        }
+    }
+#undef CONV_INT8_DW
+#endif
+    for (; j < count; j++)
+    {
+        const int8_t* ptr = inptr + j*stride_x;
+        int s = 0;
+        for (int k = 0; k < ksize; k++)
+            s += ptr[ofstab[k]]*weights[k];
+        acc[j] = s;
+    }
+    vx_cleanup();
+}
+
+#if CV_AVX_512VNNI
+
+enum { CONV_INT8_MR = 4, CONV_INT8_NR = 48 };
+
+// vpdpbusd multiplies unsigned bytes by signed bytes, so the weights are stored as w + 128
+// and the excessive 128*sum(b) is subtracted from each column of the block.
+static void convBlockInt8(int np, const int8_t* a, const int8_t* b, int* c, int ldc,
+                          bool init_c, const __m512i* bsum)
+{
+    __m512i c00 = _mm512_setzero_si512(), c01 = c00, c02 = c00;
+    __m512i c10 = c00, c11 = c00, c12 = c00;
+    __m512i c20 = c00, c21 = c00, c22 = c00;
+    __m512i c30 = c00, c31 = c00, c32 = c00;
+
+    for (int p = 0; p < np; p++, a += CONV_INT8_MR*4, b += CONV_INT8_NR*4)
+    {
+        __m512i b0 = _mm512_loadu_si512((const __m512i*)b);
+        __m512i b1 = _mm512_loadu_si512((const __m512i*)(b + 64));
+        __m512i b2 = _mm512_loadu_si512((const __m512i*)(b + 128));
+        __m512i a0 = _mm512_set1_epi32(*(const int*)a), a1 = _mm512_set1_epi32(*(const int*)(a + 4));
+
+        c00 = _mm512_dpbusd_epi32(c00, a0, b0);
+        c01 = _mm512_dpbusd_epi32(c01, a0, b1);
+        c02 = _mm512_dpbusd_epi32(c02, a0, b2);
+        c10 = _mm512_dpbusd_epi32(c10, a1, b0);
+        c11 = _mm512_dpbusd_epi32(c11, a1, b1);
+        c12 = _mm512_dpbusd_epi32(c12, a1, b2);
+
+        a0 = _mm512_set1_epi32(*(const int*)(a + 8)), a1 = _mm512_set1_epi32(*(const int*)(a + 12));
+
+        c20 = _mm512_dpbusd_epi32(c20, a0, b0);
+        c21 = _mm512_dpbusd_epi32(c21, a0, b1);
+        c22 = _mm512_dpbusd_epi32(c22, a0, b2);
+        c30 = _mm512_dpbusd_epi32(c30, a1, b0);
+        c31 = _mm512_dpbusd_epi32(c31, a1, b1);
+        c32 = _mm512_dpbusd_epi32(c32, a1, b2);
+    }
+
+#define CONV_INT8_UPDATE_ROW(row, c0, c1, c2) \
+    { \
+        int* cptr = c + (row)*ldc; \
+        c0 = _mm512_sub_epi32(c0, bsum[0]); \
+        c1 = _mm512_sub_epi32(c1, bsum[1]); \
+        c2 = _mm512_sub_epi32(c2, bsum[2]); \
+        if (!init_c) \
+        { \
+            c0 = _mm512_add_epi32(c0, _mm512_loadu_si512((const __m512i*)cptr)); \
+            c1 = _mm512_add_epi32(c1, _mm512_loadu_si512((const __m512i*)(cptr + 16))); \
+            c2 = _mm512_add_epi32(c2, _mm512_loadu_si512((const __m512i*)(cptr + 32))); \
+        } \
+        _mm512_storeu_si512((__m512i*)cptr, c0); \
+        _mm512_storeu_si512((__m512i*)(cptr + 16), c1); \
+        _mm512_storeu_si512((__m512i*)(cptr + 32), c2); \
+    }
+
+    CONV_INT8_UPDATE_ROW(0, c00, c01, c02);
+    CONV_INT8_UPDATE_ROW(1, c10, c11, c12);
+    CONV_INT8_UPDATE_ROW(2, c20, c21, c22);
+    CONV_INT8_UPDATE_ROW(3, c30, c31, c32);
+#undef CONV_INT8_UPDATE_ROW
+}
+
+void getConvBlockSizeInt8(int& mr, int& nr, bool& unsignedWeights)
+{
+    mr = CONV_INT8_MR;
+    nr = CONV_INT8_NR;
+    unsignedWeights = true;
+}
+
+void convBlocksInt8(int np, int mblocks, int nblocks, const int8_t* a, size_t astep,
+                    const int8_t* b, size_t bstep, int* c, int ldc, bool init_c)
+{
+    const __m512i ones = _mm512_set1_epi8(1);
+    for (int nb = 0; nb < nblocks; nb++, b += bstep)
+    {
+        // 128*sum(b) over each column, reused for all the row blocks
+        __m512i bsum[3] = { _mm512_setzero_si512(), _mm512_setzero_si512(), _mm512_setzero_si512() };
+        const int8_t* bptr = b;
+        for (int p = 0; p < np; p++, bptr += CONV_INT8_NR*4)
+        {
+            bsum[0] = _mm512_dpbusd_epi32(bsum[0], ones, _mm512_loadu_si512((const __m512i*)bptr));
+            bsum[1] = _mm512_dpbusd_epi32(bsum[1], ones, _mm512_loadu_si512((const __m512i*)(bptr + 64)));
+            bsum[2] = _mm512_dpbusd_epi32(bsum[2], ones, _mm512_loadu_si512((const __m512i*)(bptr + 128)));
+        }
+        for (int i = 0; i < 3; i++)
+            bsum[i] = _mm512_slli_epi32(bsum[i], 7);
+
+        for (int mb = 0; mb < mblocks; mb++)
+            convBlockInt8(np, a + mb*astep, b, c + (mb*CONV_INT8_MR)*ldc + nb*CONV_INT8_NR, ldc, init_c, bsum);
+    }
+}
+
+#elif CV_SIMD
+
+// v_dotprod_expand sums the products of 4 adjacent signed bytes into each 32-bit lane without
+// saturation (vpmaddwd on x86, sdot on ARMv8.2 with the dot-product extension).
+#if CV_SIMD_WIDTH >= 32 || (CV_NEON && CV_NEON_AARCH64)
+#define CONV_INT8_NRV 3
+#else
+#define CONV_INT8_NRV 2
+#endif
+
+enum { CONV_INT8_MR = 4, CONV_INT8_NR = CONV_INT8_NRV*v_int32::nlanes };
+
+static void convBlockInt8(int np, const int8_t* a, const int8_t* b, int* c, int ldc, bool init_c)
+{
+    const int VECSZ = v_int8::nlanes;
+    v_int32 c00 = vx_setzero_s32(), c01 = c00, c10 = c00, c11 = c00;
+    v_int32 c20 = c00, c21 = c00, c30 = c00, c31 = c00;
+#if CONV_INT8_NRV > 2
+    v_int32 c02 = c00, c12 = c00, c22 = c00, c32 = c00;
+#endif
+
+    for (int p = 0; p < np; p++, a += CONV_INT8_MR*4, b += CONV_INT8_NR*4)
+    {
+        v_int8 b0 = vx_load(b), b1 = vx_load(b + VECSZ);
+#if CONV_INT8_NRV > 2
+        v_int8 b2 = vx_load(b + VECSZ*2);
+#endif
+        v_int8 a0 = v_reinterpret_as_s8(vx_setall_s32(*(const int*)a));
+        v_int8 a1 = v_reinterpret_as_s8(vx_setall_s32(*(const int*)(a + 4)));
+
+        c00 = v_dotprod_expand(b0, a0, c00);
+        c01 = v_dotprod_expand(b1, a0, c01);
+        c10 = v_dotprod_expand(b0, a1, c10);
+        c11 = v_dotprod_expand(b1, a1, c11);
+#if CONV_INT8_NRV > 2
+        c02 = v_dotprod_expand(b2, a0, c02);
+        c12 = v_dotprod_expand(b2, a1, c12);
+#endif
+
+        a0 = v_reinterpret_as_s8(vx_setall_s32(*(const int*)(a + 8)));
+        a1 = v_reinterpret_as_s8(vx_setall_s32(*(const int*)(a + 12)));
+
+        c20 = v_dotprod_expand(b0, a0, c20);
+        c21 = v_dotprod_expand(b1, a0, c21);
+        c30 = v_dotprod_expand(b0, a1, c30);
+        c31 = v_dotprod_expand(b1, a1, c31);
+#if CONV_INT8_NRV > 2
+        c22 = v_dotprod_expand(b2, a0, c22);
+        c32 = v_dotprod_expand(b2, a1, c32);
+#endif
+    }
+
+    const int NLANES = v_int32::nlanes;
+    if (!init_c)
+    {
+        c00 += vx_load(c); c01 += vx_load(c + NLANES);
+        c10 += vx_load(c + ldc); c11 += vx_load(c + ldc + NLANES);
+        c20 += vx_load(c + ldc*2); c21 += vx_load(c + ldc*2 + NLANES);
+        c30 += vx_load(c + ldc*3); c31 += vx_load(c + ldc*3 + NLANES);
+#if CONV_INT8_NRV > 2
+        c02 += vx_load(c + NLANES*2);
+        c12 += vx_load(c + ldc + NLANES*2);
+        c22 += vx_load(c + ldc*2 + NLANES*2);
+        c32 += vx_load(c + ldc*3 + NLANES*2);
+#endif
+    }
+    v_store(c, c00); v_store(c + NLANES, c01);
+    v_store(c + ldc, c10); v_store(c + ldc + NLANES, c11);
+    v_store(c + ldc*2, c20); v_store(c + ldc*2 + NLANES, c21);
+    v_store(c + ldc*3, c30); v_store(c + ldc*3 + NLANES, c31);
+#if CONV_INT8_NRV > 2
+    v_store(c + NLANES*2, c02);
+    v_store(c + ldc + NLANES*2, c12);
+    v_store(c + ldc*2 + NLANES*2, c22);
+    v_store(c + ldc*3 + NLANES*2, c32);
+#endif
+}
+
+void getConvBlockSizeInt8(int& mr, int& nr, bool& unsignedWeights)
+{
+    mr = CONV_INT8_MR;
+    nr = CONV_INT8_NR;
+    unsignedWeights = false;
+}
+
+void convBlocksInt8(int np, int mblocks, int nblocks, const int8_t* a, size_t astep,
+                    const int8_t* b, size_t bstep, int* c, int ldc, bool init_c)
+{
+    for (int nb = 0; nb < nblocks; nb++)
+        for (int mb = 0; mb < mblocks; mb++)
+            convBlockInt8(np, a + mb*astep, b + nb*bstep, c + (mb*CONV_INT8_MR)*ldc + nb*CONV_INT8_NR, ldc, init_c);
+    vx_cleanup();
+}
+
+#else
+
+enum { CONV_INT8_MR = 4, CONV_INT8_NR = 8 };
+
+void getConvBlockSizeInt8(int& mr, int& nr, bool& unsignedWeights)
+{
+    mr = CONV_INT8_MR;
+    nr = CONV_INT8_NR;
+    unsignedWeights = false;
+}
+
+void convBlocksInt8(int np, int mblocks, int nblocks, const int8_t* a, size_t astep,
+                    const int8_t* b, size_t bstep, int* c, int ldc, bool init_c)
+{
+    for (int nb = 0; nb < nblocks; nb++)
+        for (int mb = 0; mb < mblocks; mb++)
+        {
+            const int8_t* aptr = a + mb*astep;
+            const int8_t* bptr = b + nb*bstep;
+            int* cptr = c + (mb*CONV_INT8_MR)*ldc + nb*CONV_INT8_NR;
+            for (int i = 0; i < CONV_INT8_MR; i++)
+                for (int j = 0; j < CONV_INT8_NR; j++)
+                {
+                    int s = init_c ? 0 : cptr[i*ldc + j];
+                    for (int p = 0; p < np; p++)
+                    {
+                        const int8_t* ap = aptr + (p*CONV_INT8_MR + i)*4;
+                        const int8_t* bp = bptr + (p*CONV_INT8_NR + j)*4;
+                        s += ap[0]*bp[0] + ap[1]*bp[1] + ap[2]*bp[2] + ap[3]*bp[3];
+                    }
+                    cptr[i*ldc + j] = s;
+                }
+        }
+}
+
+#endif
+
+#endif // CV_CPU_OPTIMIZATION_DECLARATIONS_ONLY
+
+CV_CPU_OPTIMIZATION_NAMESPACE_END
+}} // namespace
@@ -146,16 +146,20 @@ struct DataLayer : public Layer
         CV_OCL_RUN(IS_DNN_OPENCL_TARGET(preferableTarget),
                 forward_ocl(inputs_arr, outputs_arr, internals_arr))
 
-        bool isFP16 = outputs_arr.depth() == CV_16S;
-
-        std::vector<Mat> outputs, internals;
+        std::vector<Mat> outputs;
         outputs_arr.getMatVector(outputs);
-        internals_arr.getMatVector(internals);
+        convertInputs(inputsData, scaleFactors, means, outputs);
+    }
 
+    /** Converts the network inputs to the blobs of the input layer applying the scale and the mean. */
+    static void convertInputs(const std::vector<Mat>& inputsData, const std::vector<double>& scaleFactors,
+                              const std::vector<Scalar>& means, std::vector<Mat>& outputs)
+    {
         for (int i = 0; i < inputsData.size(); ++i)
         {
             double scale = scaleFactors[i];
-            Scalar& mean = means[i];
+            const Scalar& mean = means[i];
+            bool isFP16 = outputs[i].depth() == CV_16S;
 
             CV_Assert(mean == Scalar() || inputsData[i].size[1] <= 4);
             if (isFP16)
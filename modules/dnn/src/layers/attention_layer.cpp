@@ -0,0 +1,258 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "../precomp.hpp"
+#include "layers_common.hpp"
+#include "opencv2/core/hal/hal.hpp"
+
+#include <opencv2/dnn/shape_utils.hpp>
+
+namespace cv
+{
+namespace dnn
+{
+
+class AttentionLayerImpl CV_FINAL : public AttentionLayer
+{
+public:
+    enum { BLOCK_SIZE = 16 };  // number of queries processed at once
+
+    AttentionLayerImpl(const LayerParams& params)
+    {
+        setParamsFrom(params);
+        scale = params.get<float>("scale", 1.f);
+        softmaxAxis = params.get<int>("axis", -1);
+    }
+
+    virtual bool supportBackend(int backendId) CV_OVERRIDE
+    {
+        return backendId == DNN_BACKEND_OPENCV;
+    }
+
+    bool getMemoryShapes(const std::vector<MatShape> &inputs,
+                         const int requiredOutputs,
+                         std::vector<MatShape> &outputs,
+                         std::vector<MatShape> &internals) const CV_OVERRIDE
+    {
+        CV_Check(inputs.size(), inputs.size() == 3 || inputs.size() == 4, "Expected queries, keys, values and an optional mask");
+        const MatShape &q = inputs[0], &k = inputs[1], &v = inputs[2];
+        for (int i = 0; i < 3; i++)
+            CV_CheckGE(inputs[i].size(), (size_t)2, "");
+        const int S = q[q.size() - 2], D = q.back(), L = k.back();
+        CV_CheckEQ(k[k.size() - 2], D, "Keys are expected to be transposed");
+        CV_CheckEQ(v[v.size() - 2], L, "");
+
+        // the leading dimensions are broadcasted between queries, keys and values
+        size_t nbatch = std::max(q.size(), std::max(k.size(), v.size())) - 2;
+        MatShape outShape(nbatch, 1);
+        for (int i = 0; i < 3; i++)
+        {
+            const size_t shift = nbatch + 2 - inputs[i].size();
+            for (size_t d = 0; d + 2 < inputs[i].size(); d++)
+            {
+                int& sz = outShape[shift + d];
+                if (inputs[i][d] != sz)
+                {
+                    CV_Check(inputs[i][d], inputs[i][d] == 1 || sz == 1, "Batch dimensions can not be broadcasted");
+                    sz = std::max(sz, inputs[i][d]);
+                }
+            }
+        }
+        outShape.push_back(S);
+        outShape.push_back(v.back());
+
+        if (inputs.size() > 3)
+        {
+            const MatShape& mask = inputs[3];
+            CV_CheckLE(mask.size(), outShape.size(), "");
+            MatShape weightsShape = outShape;
+            weightsShape.back() = L;
+            const size_t shift = weightsShape.size() - mask.size();
+            for (size_t d = 0; d < mask.size(); d++)
+                CV_Check(mask[d], mask[d] == 1 || mask[d] == weightsShape[shift + d], "Mask can not be broadcasted to the attention weights");
+        }
+        CV_CheckEQ(normalize_axis(softmaxAxis, (int)outShape.size()), (int)outShape.size() - 1,
+                   "Attention weights are expected to be normalized along the keys");
+
+        outputs.assign(1, outShape);
+        return false;
+    }
+
+    void forward(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr, OutputArrayOfArrays internals_arr) CV_OVERRIDE
+    {
+        CV_TRACE_FUNCTION();
+        CV_TRACE_ARG_VALUE(name, "name", name.c_str());
+
+        if (inputs_arr.depth() == CV_16S)
+        {
+            forward_fallback(inputs_arr, outputs_arr, internals_arr);
+            return;
+        }
+
+        std::vector<Mat> inputs, outputs;
+        inputs_arr.getMatVector(inputs);
+        outputs_arr.getMatVector(outputs);
+
+        for (size_t i = 0; i < inputs.size(); i++)
+        {
+            CV_CheckTypeEQ(inputs[i].type(), CV_32F, "");
+            CV_Assert(inputs[i].isContinuous());
+        }
+        const Mat &Q = inputs[0], &K = inputs[1], &V = inputs[2];
+        const Mat* mask = inputs.size() > 3 ? &inputs[3] : 0;
+        Mat& out = outputs[0];
+        CV_Assert(out.isContinuous());
+
+        const int ndims = out.dims, nbatch = ndims - 2;
+        const int S = out.size[ndims - 2], Dv = out.size[ndims - 1];
+        const int D = Q.size[Q.dims - 1], L = K.size[K.dims - 1];
+        const size_t batchSize = out.total(0, nbatch);
+        const std::vector<size_t> qSteps = getBroadcastSteps(shape(Q), ndims), kSteps = getBroadcastSteps(shape(K), ndims),
+                                  vSteps = getBroadcastSteps(shape(V), ndims);
+        const std::vector<size_t> maskSteps = mask ? getBroadcastSteps(shape(*mask), ndims) : std::vector<size_t>();
+        const int nblocks = (S + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        const float alpha = scale;
+
+        parallel_for_(Range(0, (int)(batchSize * nblocks)), [&](const Range& r)
+        {
+            AutoBuffer<float> _weights(BLOCK_SIZE * L);
+            float* weights = _weights.data();
+            for (int task = r.start; task < r.end; task++)
+            {
+                const size_t b = task / nblocks;
+                const int s0 = (int)(task - b * nblocks) * BLOCK_SIZE;
+                const int rows = std::min((int)BLOCK_SIZE, S - s0);
+
+                size_t qOfs = 0, kOfs = 0, vOfs = 0, maskOfs = 0, idx = b;
+                for (int d = nbatch - 1; d >= 0; d--)
+                {
+                    size_t next_idx = idx / out.size[d];
+                    size_t i_d = idx - next_idx * out.size[d];
+                    qOfs += i_d * qSteps[d];
+                    kOfs += i_d * kSteps[d];
+                    vOfs += i_d * vSteps[d];
+                    if (mask)
+                        maskOfs += i_d * maskSteps[d];
+                    idx = next_idx;
+                }
+                const float* q = Q.ptr<float>() + qOfs + (size_t)s0 * D;
+                const float* k = K.ptr<float>() + kOfs;
+                const float* v = V.ptr<float>() + vOfs;
+                float* o = out.ptr<float>() + (b * S + s0) * Dv;
+
+                // weights = q * k * scale, a row of keys is reused for all the queries of the block
+                memset(weights, 0, rows * L * sizeof(float));
+                for (int d = 0; d < D; d++)
+                {
+                    const float* krow = k + (size_t)d * L;
+                    for (int i = 0; i < rows; i++)
+                        axpy(weights + i * L, krow, q[i * D + d] * alpha, L);
+                }
+
+                for (int i = 0; i < rows; i++)
+                {
+                    float* w = weights + i * L;
+                    if (mask)
+                    {
+                        const float* m = mask->ptr<float>() + maskOfs + (s0 + i) * maskSteps[nbatch];
+                        const size_t mstep = maskSteps[nbatch + 1];
+                        if (mstep == 1)
+                            axpy(w, m, 1.f, L);
+                        else
+                        {
+                            for (int j = 0; j < L; j++)
+                                w[j] += m[j * mstep];
+                        }
+                    }
+                    softmax(w, L);
+                }
+
+                // o = weights * v
+                memset(o, 0, rows * Dv * sizeof(float));
+                for (int j = 0; j < L; j++)
+                {
+                    const float* vrow = v + (size_t)j * Dv;
+                    for (int i = 0; i < rows; i++)
+                        axpy(o + i * Dv, vrow, weights[i * L + j], Dv);
+                }
+            }
+        }, std::max(1., std::min((double)getNumThreads() * 4, batchSize * S * (double)L * (D + Dv) / 65536.)));
+    }
+
+    // y += a * x
+    static void axpy(float* y, const float* x, float a, int n)
+    {
+        int i = 0;
+#if CV_SIMD
+        v_float32 va = vx_setall_f32(a);
+        for (; i <= n - v_float32::nlanes; i += v_float32::nlanes)
+            v_store(y + i, v_fma(vx_load(x + i), va, vx_load(y + i)));
+#endif
+        for (; i < n; i++)
+            y[i] += a * x[i];
+    }
+
+    static void softmax(float* w, int n)
+    {
+        float maxVal = w[0], sum = 0.f;
+        int i = 0;
+#if CV_SIMD
+        const int VECSZ = v_float32::nlanes;
+        v_float32 vmax = vx_setall_f32(maxVal);
+        for (; i <= n - VECSZ; i += VECSZ)
+            vmax = v_max(vmax, vx_load(w + i));
+        maxVal = v_reduce_max(vmax);
+#endif
+        for (; i < n; i++)
+            maxVal = std::max(maxVal, w[i]);
+
+        i = 0;
+#if CV_SIMD
+        vmax = vx_setall_f32(maxVal);
+        for (; i <= n - VECSZ; i += VECSZ)
+            v_store(w + i, vx_load(w + i) - vmax);
+#endif
+        for (; i < n; i++)
+            w[i] -= maxVal;
+        hal::exp32f(w, w, n);
+
+        i = 0;
+#if CV_SIMD
+        v_float32 vsum = vx_setzero_f32();
+        for (; i <= n - VECSZ; i += VECSZ)
+            vsum += vx_load(w + i);
+        sum = v_reduce_sum(vsum);
+#endif
+        for (; i < n; i++)
+            sum += w[i];
+
+        const float inv = 1.f / sum;
+        i = 0;
+#if CV_SIMD
+        v_float32 vinv = vx_setall_f32(inv);
+        for (; i <= n - VECSZ; i += VECSZ)
+            v_store(w + i, vx_load(w + i) * vinv);
+#endif
+        for (; i < n; i++)
+            w[i] *= inv;
+    }
+
+    virtual int64 getFLOPS(const std::vector<MatShape> &inputs,
+                           const std::vector<MatShape> &outputs) const CV_OVERRIDE
+    {
+        const MatShape& out = outputs[0];
+        const int64 D = inputs[0].back(), L = inputs[1].back();
+        return 2 * total(out, 0, (int)out.size() - 1) * L * (D + out.back()) + 4 * total(out, 0, (int)out.size() - 1) * L;
+    }
+
+private:
+    int softmaxAxis;
+};
+
+Ptr<AttentionLayer> AttentionLayer::create(const LayerParams& params)
+{
+    return makePtr<AttentionLayerImpl>(params);
+}
+
+}}  // namespace cv::dnn
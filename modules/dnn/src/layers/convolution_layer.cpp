@@ -83,6 +83,7 @@ class BaseConvolutionLayerImpl : public ConvolutionLayer
 public:
     bool fusedWeights, fusedBias;
     std::vector<double> weightsMultipliers;
+    std::string prepackKey;  // identifies the weights in the prepacked weights cache
 #ifdef HAVE_WEBNN
     int groups;
 #endif
@@ -116,6 +117,10 @@ public:
         fusedWeights = false;
         fusedBias = false;
 
+        std::string modelKey = params.get<String>("prepack_model_key", "");
+        if (!modelKey.empty())
+            prepackKey = modelKey + "/" + name;
+
         if (kernel_size.size() == 2)
             isConv2D = true;
     }
@@ -260,6 +265,7 @@ public:
     Ptr<ActivationLayer> activ;
 
     Ptr<FastConv2d> fastConv2dImpl;
+    Mutex variableWeightMutex;
 
 #ifdef HAVE_OPENCL
     Ptr<OCL4DNNConvSpatial<float> > convolutionOp;
@@ -476,8 +482,7 @@ public:
             return false;
 
         activ = layer;
-        if (activ.empty())
-            reluslope.clear();
+        reluslope.clear();
 #ifdef HAVE_OPENCL
         newActiv = true;
         activType = OCL4DNN_CONV_FUSED_ACTIV_NONE;
@@ -1974,8 +1979,12 @@ public:
         int outCn = blobs.empty() ? inputs[1].size[0] : blobs[0].size[0];
         // Need to align non-const blobs
         bool variableWeight = false;
+        // weights from the inputs are repacked into the layer on every call,
+        // so the layer is forwarded by one execution context at a time
+        std::unique_lock<Mutex> variableWeightLock(variableWeightMutex, std::defer_lock);
         if (blobs.empty())
         {
+            variableWeightLock.lock();
             variableWeight = true;
             Mat wm = inputs[1].reshape(1, outCn);
             if (wm.data != weightsMat.data)
@@ -2014,8 +2023,11 @@ public:
         int ngroups = inputs[0].size[1] / inpGroupCn;
         CV_Assert(outputs[0].size[1] % ngroups == 0);
 
-        reluslope.clear();
-        if( activ )
+        // slopes depend on the fused activation only and are kept between the calls
+        // to not modify the layer state by the concurrent forward passes
+        if( !reluslope.empty() && reluslope.size() != (size_t)outCn + 2 )
+            reluslope.clear();  // ReLU6 bounds stored by OpenCL path
+        if( activ && reluslope.empty() )
         {
             Ptr<ReLULayer> activ_relu = activ.dynamicCast<ReLULayer>();
             if( !activ_relu.empty() )
@@ -2113,7 +2125,8 @@ public:
                 int dilation_w = dilations.back();
 
                 fastConv2dImpl = initFastConv2d(ngroups, K, C, Hk, Wk, stride_w, stride_h, dilation_w,
-                                                dilation_h, pads_begin, pads_end, weightsMat, &biasvec[0], useWinograd);
+                                                dilation_h, pads_begin, pads_end, weightsMat, &biasvec[0], useWinograd,
+                                                prepackKey);
             }
 
             if (fastConv2dImpl)
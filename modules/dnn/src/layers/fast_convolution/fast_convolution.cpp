@@ -12,6 +12,7 @@
 #include "../../precomp.hpp"
 #include "fast_convolution.hpp"
 #include "fast_convolution.simd.hpp"
+#include "../../prepack_cache.hpp"
 
 namespace cv { namespace dnn {
 
@@ -24,7 +25,8 @@ Ptr<FastConv2d> initFastConv2d(
         const std::vector<size_t>& pads_end,
         InputArray _weightsMat,
         float* srcBias,
-        bool useWinograd)
+        bool useWinograd,
+        const std::string& prepackKey)
 {
     Ptr<FastConv2d> conv = makePtr<FastConv2d>();
 
@@ -56,8 +58,29 @@ Ptr<FastConv2d> initFastConv2d(
     conv->useWinograd63 = false;
 #endif
 
+    PrepackCacheKey cacheKey("FastConv2d");
+    bool saveToCache = false;
+    if (isPrepackCacheEnabled())
+    {
+        cacheKey << ngroups << K << C << Hk << Wk << stride_y << stride_x << dilation_y << dilation_x
+                 << (int)conv->useWinograd63;
+        cacheKey.addWeights(prepackKey, weightsMat);
+        std::vector<Mat> cached;
+        if (loadPrepackedBuffers(cacheKey, cached) && cached.size() == 2 && !cached[0].empty())
+        {
+            conv->weightsBuf = cached[0];
+            conv->weightsWino63Buf = cached[1];
+        }
+        else
+            saveToCache = true;
+    }
+
     float *srcWeights = (float *)weightsMat.data;
-    if (ngroups > 1 && ngroups == K && ngroups == C)
+    if (!conv->weightsBuf.empty())
+    {
+        // the weights are loaded from the prepacked weights cache
+    }
+    else if (ngroups > 1 && ngroups == K && ngroups == C)
     {
         // for depth-wise convolutions on NCHW data we just preserve the weights in KCHW layout,
         // but add some padding to make the weights array layout more SIMD-friendly
@@ -66,9 +89,8 @@ Ptr<FastConv2d> initFastConv2d(
         // this code aims to let memory fit with vector size.
         int padded_ksize = ((ksize + FAST_VEC_NLANES-1) / FAST_VEC_NLANES) * FAST_VEC_NLANES;
         int nweights = C*padded_ksize;
-        conv->weightsBuf.reserve(nweights);
-        float* weightsBufPtr = conv->weightsBuf.data();
-        memset(weightsBufPtr, 0, nweights*sizeof(weightsBufPtr[0]));
+        conv->weightsBuf = Mat::zeros(1, nweights, CV_32F);
+        float* weightsBufPtr = conv->weightsBuf.ptr<float>();
         for(int c = 0; c < C; c++)
         {
             for (int k = 0; k < ksize; k++)
@@ -84,9 +106,8 @@ Ptr<FastConv2d> initFastConv2d(
         int Kg_aligned = numStripsMR * CONV_MR;
         int HkWkCg = Hk*Wk*Cg;
         size_t nweights = ngroups*Kg_aligned*HkWkCg;
-        conv->weightsBuf.reserve(nweights);
-        float* weightsBufPtr = conv->weightsBuf.data();
-        memset(weightsBufPtr, 0, nweights*sizeof(weightsBufPtr[0]));
+        conv->weightsBuf = Mat::zeros(1, (int)nweights, CV_32F);
+        float* weightsBufPtr = conv->weightsBuf.ptr<float>();
 
         // Pack the weight.
         parallel_for_(Range(0, ngroups * numStripsMR), [&](const Range& r0){
@@ -122,11 +143,17 @@ Ptr<FastConv2d> initFastConv2d(
         }
     }
 
+    if (saveToCache)
+    {
+        std::vector<Mat> buffers = { conv->weightsBuf, conv->weightsWino63Buf };
+        savePrepackedBuffers(cacheKey, buffers);
+    }
+
     // store bias; append some zero's to make sure that
     // we can always read MR elements starting from any valid index
     {
         int k = 0, nbias = K + CONV_MR - 1;
-        conv->biasBuf.reserve(nbias);
+        conv->biasBuf.resize(nbias);
         float* biasBufPtr = conv->biasBuf.data();
         for(; k < K; k++)
             biasBufPtr[k] = srcBias ? srcBias[k] : 0.f;
@@ -447,7 +474,7 @@ void runFastConv2d(InputArray _input, OutputArray _output, const Ptr<FastConv2d>
                 }
 
                 yx0 = yx0_saved;
-                float* weights = conv->weightsBuf.data() + g * Kg_aligned * HkWkCg;
+                float* weights = conv->weightsBuf.ptr<float>() + g * Kg_aligned * HkWkCg;
                 const float* biasptr = conv->biasBuf.data() + Kg * g;
                 int ldc = nstripes * CONV_NR;
 
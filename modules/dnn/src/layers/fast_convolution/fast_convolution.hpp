@@ -41,8 +41,8 @@ struct FastConv2d
     int dilation_y, dilation_x;
     int pad_top, pad_bottom, pad_left, pad_right;
 
-    std::vector<float> weightsBuf;        // For generic Conv 2D
-    std::vector<float> weightsWino63Buf;  // For Winograd F(6x6, 3x3).
+    Mat weightsBuf;                       // For generic Conv 2D, may reference the prepacked weights cache file
+    Mat weightsWino63Buf;                 // For Winograd F(6x6, 3x3).
     std::vector<float> biasBuf;
     bool useWinograd63 = false;
     bool useAVX2 = checkHardwareSupport(CPU_AVX2);
@@ -58,7 +58,8 @@ Ptr<FastConv2d> initFastConv2d(
         const std::vector<size_t>& pads_begin,
         const std::vector<size_t>& pads_end,
         InputArray weightsMat,
-        float* srcBias, bool useWinograd);
+        float* srcBias, bool useWinograd,
+        const std::string& prepackKey);  // the model key and the layer name, see PrepackCacheKey
 
 // It contains different computing branches, like winograd, 1x1 conv.
 void runFastConv2d(InputArray _input, OutputArray _output, const Ptr<FastConv2d>& conv, int ntasks,
@@ -67,6 +68,9 @@ void runFastConv2d(InputArray _input, OutputArray _output, const Ptr<FastConv2d>
 void runDepthwise(InputArray _input, OutputArray _output, const Ptr<FastConv2d>& conv, float minval, float maxval,
         ActivationLayer* activ, bool ifMinMaxAct);
 
+// C[CONV_MR x CONV_NR] = A * B (+ C), where A is packed by CONV_MR rows and B by CONV_NR columns.
+void convBlock(int np, const float* a, const float* b, float* c, int ldc, bool init_c);
+
 // winograd init
 void initWinograd63(Ptr<FastConv2d>& conv, InputArray weightsMat, int K, int C);
 
@@ -87,6 +91,13 @@ void depthWiseBlock_AVX2(const float *inptr, float *outptr, const float *weights
 #endif
 } // namespace opt_AVX2
 
+namespace opt_NEON
+{
+#if CV_TRY_NEON
+void convBlock_NEON(int np, const float* a, const float* b, float* c, int ldc, bool init_c);
+#endif
+} // namespace opt_NEON
+
 } // namespace cv
 
 #endif //OPENCV_FAST_CONVOLUTION_HPP
@@ -415,9 +415,8 @@ void initWinograd63(Ptr<FastConv2d>& conv, InputArray _weightsMat, int K, int C)
     // Allocate memory for winograd.
     int nweights = K_aligned * C_aligned * WINO_AREA;
 
-    conv->weightsWino63Buf.reserve(nweights);
-    float* weightsWino63Ptr = conv->weightsWino63Buf.data();
-    memset(weightsWino63Ptr, 0, nweights*sizeof(weightsWino63Ptr[0]));
+    conv->weightsWino63Buf = Mat::zeros(1, nweights, CV_32F);
+    float* weightsWino63Ptr = conv->weightsWino63Buf.ptr<float>();
     float* wptrWino = weightsWino63Ptr;
 
     AutoBuffer<float> kernelTm0_;
@@ -659,7 +658,7 @@ int runWinograd63(InputArray _input, InputArray _fusedAddMat, OutputArray _outpu
     float* outputCnbuf0 = inputbuf0;
 
     // Input Parallel For
-    float* weight_ptr0 = conv->weightsWino63Buf.data();
+    float* weight_ptr0 = conv->weightsWino63Buf.ptr<float>();
 
     for (int bn = 0; bn < N; bn++)
     {
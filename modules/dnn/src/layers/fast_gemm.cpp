@@ -0,0 +1,202 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "../precomp.hpp"
+#include "layers_common.hpp"
+#include "fast_gemm.hpp"
+#include "fast_convolution/fast_convolution.hpp"
+
+#include <opencv2/dnn/shape_utils.hpp>
+
+namespace cv {
+namespace dnn {
+
+enum { M_TILE = CONV_MR * 16, N_TILE = CONV_NR * 4, K_BLOCK_SIZE = 256 };
+
+void fastGemmPackB(const Mat& B, bool trans, Mat& packed)
+{
+    const int dims = B.dims;
+    const int K = B.size[dims - (trans ? 1 : 2)], N = B.size[dims - (trans ? 2 : 1)];
+    const int npanels = (N + CONV_NR - 1) / CONV_NR;
+    const int nbatch = (int)B.total(0, dims - 2);
+    const size_t panelSize = (size_t)K * CONV_NR;
+    const size_t kstep = trans ? 1 : N, nstep = trans ? K : 1;
+
+    packed.create(1, (int)(nbatch * npanels * panelSize), CV_32F);
+    const float* src = B.ptr<float>();
+    float* dst = packed.ptr<float>();
+    parallel_for_(Range(0, nbatch * npanels), [&](const Range& r)
+    {
+        for (int task = r.start; task < r.end; task++)
+        {
+            const int b = task / npanels, p = task - b * npanels;
+            const int j0 = p * CONV_NR, nc = std::min((int)CONV_NR, N - j0);
+            const float* bptr = src + (size_t)b * K * N + j0 * nstep;
+            float* pptr = dst + task * panelSize;
+            for (int k = 0; k < K; k++, pptr += CONV_NR)
+            {
+                int j = 0;
+                if (nstep == 1)
+                {
+                    memcpy(pptr, bptr + k * kstep, nc * sizeof(float));
+                    j = nc;
+                }
+                for (; j < nc; j++)
+                    pptr[j] = bptr[k * kstep + j * nstep];
+                for (; j < CONV_NR; j++)
+                    pptr[j] = 0.f;
+            }
+        }
+    }, std::max(1., std::min((double)getNumThreads() * 4, B.total() / 16384.)));
+}
+
+void fastGemm(const Mat& A, bool transA, const Mat& packedB, const MatShape& bBatchShape,
+              const Mat& bias, float alpha, float beta, const ActivationLayer* activ, Mat& out)
+{
+    CV_CheckTypeEQ(A.type(), CV_32F, "");
+    CV_Assert(A.isContinuous() && out.isContinuous() && out.dims >= 2);
+    const float* packed = packedB.ptr<float>();
+
+    const int ndims = out.dims, nbatch = ndims - 2;
+    const int M = out.size[ndims - 2], N = out.size[ndims - 1];
+    const int K = A.size[A.dims - (transA ? 2 : 1)];
+    const int npanels = (N + CONV_NR - 1) / CONV_NR;
+    const size_t bBatchSize = (size_t)npanels * K * CONV_NR;
+    const size_t astep0 = transA ? 1 : K, astep1 = transA ? M : 1;
+
+    // A is addressed in elements, B in packed matrices
+    const std::vector<size_t> aSteps = getBroadcastSteps(shape(A), ndims);
+    const std::vector<size_t> bSteps = getBroadcastSteps(bBatchShape, nbatch);
+
+    const float* biasData = 0;
+    size_t biasStep0 = 0, biasStep1 = 0;
+    if (!bias.empty())
+    {
+        CV_CheckTypeEQ(bias.type(), CV_32F, "");
+        CV_Assert(bias.isContinuous());
+        std::vector<size_t> steps = getBroadcastSteps(shape(bias), 2);
+        biasData = bias.ptr<float>();
+        biasStep0 = steps[0];
+        biasStep1 = steps[1];
+    }
+
+    const size_t batchSize = out.total(0, nbatch);
+    const int mtiles = (M + M_TILE - 1) / M_TILE, ntiles = (N + N_TILE - 1) / N_TILE;
+    const int ntasks = (int)(batchSize * mtiles * ntiles);
+#if CV_TRY_AVX2
+    const bool useAVX2 = checkHardwareSupport(CPU_AVX2);
+#endif
+#if CV_TRY_NEON
+    const bool useNEON = checkHardwareSupport(CPU_NEON);
+#endif
+    const float* aData = A.ptr<float>();
+    float* outData = out.ptr<float>();
+
+    parallel_for_(Range(0, ntasks), [&](const Range& r)
+    {
+        AutoBuffer<float> abuf_(M_TILE * K_BLOCK_SIZE + M_TILE * N_TILE + 32);
+        float* abuf = alignPtr(abuf_.data(), 64);
+        float* cbuf = abuf + M_TILE * K_BLOCK_SIZE;
+        const int ldc = N_TILE;
+
+        for (int task = r.start; task < r.end; task++)
+        {
+            const size_t b = task / (mtiles * ntiles);
+            const int tile = (int)(task - b * mtiles * ntiles);
+            const int m0 = (tile / ntiles) * M_TILE, m1 = std::min(m0 + (int)M_TILE, M);
+            const int p0 = (tile % ntiles) * (N_TILE / CONV_NR), p1 = std::min(p0 + (int)(N_TILE / CONV_NR), npanels);
+            const int n0 = p0 * CONV_NR, n1 = std::min(p1 * CONV_NR, N);
+            const int mblocks = (m1 - m0 + CONV_MR - 1) / CONV_MR;
+
+            size_t aOfs = 0, bIdx = 0, idx = b;
+            for (int d = nbatch - 1; d >= 0; d--)
+            {
+                size_t next_idx = idx / out.size[d];
+                size_t i_d = idx - next_idx * out.size[d];
+                aOfs += i_d * aSteps[d];
+                bIdx += i_d * bSteps[d];
+                idx = next_idx;
+            }
+            const float* aptr = aData + aOfs;
+            const float* bptr = packed + bIdx * bBatchSize;
+
+            if (K == 0)
+                memset(cbuf, 0, M_TILE * N_TILE * sizeof(float));
+            for (int k0 = 0; k0 < K; k0 += K_BLOCK_SIZE)
+            {
+                const int kc = std::min((int)K_BLOCK_SIZE, K - k0);
+
+                // pack the rows of the tile by CONV_MR, the rows past M are zero
+                for (int mb = 0; mb < mblocks; mb++)
+                {
+                    float* pa = abuf + mb * kc * CONV_MR;
+                    for (int i = 0; i < CONV_MR; i++)
+                    {
+                        const int row = m0 + mb * CONV_MR + i;
+                        if (row >= m1)
+                        {
+                            for (int k = 0; k < kc; k++)
+                                pa[k * CONV_MR + i] = 0.f;
+                            continue;
+                        }
+                        const float* arow = aptr + row * astep0 + k0 * astep1;
+                        for (int k = 0; k < kc; k++)
+                            pa[k * CONV_MR + i] = arow[k * astep1];
+                    }
+                }
+
+                for (int p = p0; p < p1; p++)
+                {
+                    const float* pb = bptr + ((size_t)p * K + k0) * CONV_NR;
+                    for (int mb = 0; mb < mblocks; mb++)
+                    {
+                        const float* pa = abuf + mb * kc * CONV_MR;
+                        float* pc = cbuf + mb * CONV_MR * ldc + (p - p0) * CONV_NR;
+#if CV_TRY_AVX2
+                        if (useAVX2)
+                            cv::opt_AVX2::convBlock_AVX2(kc, pa, pb, pc, ldc, k0 == 0);
+                        else
+#endif
+#if CV_TRY_NEON
+                        if (useNEON)
+                            cv::opt_NEON::convBlock_NEON(kc, pa, pb, pc, ldc, k0 == 0);
+                        else
+#endif
+                            convBlock(kc, pa, pb, pc, ldc, k0 == 0);
+                    }
+                }
+            }
+
+            // out = alpha * cbuf + beta * bias
+            for (int i = m0; i < m1; i++)
+            {
+                const float* crow = cbuf + (i - m0) * ldc;
+                float* orow = outData + (b * M + i) * N + n0;
+                const float* brow = biasData ? biasData + i * biasStep0 + n0 * biasStep1 : 0;
+                const int n = n1 - n0;
+                int j = 0;
+#if CV_SIMD
+                if (!brow || biasStep1 <= 1)
+                {
+                    v_float32 valpha = vx_setall_f32(alpha), vbeta = vx_setall_f32(beta);
+                    v_float32 vbias = brow ? vx_setall_f32(brow[0]) : vx_setzero_f32();
+                    for (; j <= n - v_float32::nlanes; j += v_float32::nlanes)
+                    {
+                        v_float32 v = vx_load(crow + j) * valpha;
+                        if (brow)
+                            v = v_fma(biasStep1 ? vx_load(brow + j) : vbias, vbeta, v);
+                        v_store(orow + j, v);
+                    }
+                }
+#endif
+                for (; j < n; j++)
+                    orow[j] = alpha * crow[j] + (brow ? beta * brow[j * biasStep1] : 0.f);
+                if (activ)
+                    activ->forwardSlice(orow, orow, 1, 1, n0, n1);
+            }
+        }
+    }, ntasks);
+}
+
+}}  // namespace cv::dnn
@@ -0,0 +1,28 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_DNN_FAST_GEMM_HPP
+#define OPENCV_DNN_FAST_GEMM_HPP
+
+#include <opencv2/dnn/all_layers.hpp>
+
+namespace cv {
+namespace dnn {
+
+// Matrix multiplication on the blocked kernels of the fast convolution, used by the MatMul and InnerProduct layers.
+
+// Packs op(B) of every matrix of B (the last two dimensions, op(B) = B^T if trans is set) into
+// the panels of CONV_NR columns, [batch][panel][K][CONV_NR]. The last panel is padded with zeros.
+void fastGemmPackB(const Mat& B, bool trans, Mat& packed);
+
+// out = alpha * op(A) * op(B) + beta * bias for the matrices of the last two dimensions of out.
+// B is packed by fastGemmPackB(), bBatchShape is its shape without the last two dimensions.
+// The leading dimensions of A and B are broadcasted to the ones of out, the bias (may be empty)
+// is broadcasted to [M, N]. The activation, if any, treats the output columns as the channels.
+void fastGemm(const Mat& A, bool transA, const Mat& packedB, const MatShape& bBatchShape,
+              const Mat& bias, float alpha, float beta, const ActivationLayer* activ, Mat& out);
+
+}}  // namespace cv::dnn
+
+#endif  // OPENCV_DNN_FAST_GEMM_HPP
@@ -42,6 +42,7 @@
 
 #include "../precomp.hpp"
 #include "layers_common.hpp"
+#include "fast_gemm.hpp"
 #include "../op_cuda.hpp"
 #include "../op_halide.hpp"
 #include "../op_inf_engine.hpp"
@@ -69,7 +70,7 @@ namespace dnn
 class FullyConnectedLayerImpl CV_FINAL : public InnerProductLayer
 {
 public:
-    enum { VEC_ALIGN = 8 };
+    enum { VEC_ALIGN = 8, MIN_PACKED_ROWS = 2 };
 
 #ifdef HAVE_OPENCL
     Ptr<OCL4DNNInnerProduct<float> > innerProductOp;
@@ -505,6 +506,15 @@ public:
                 Mat srcMat = input[i].reshape(1, outerSize);
                 Mat dstMat = output[i].reshape(1, outerSize);
 
+                // Several rows are multiplied by the blocked kernel of the MatMul layer, a single row
+                // is faster with the unpacked weights. The weights are packed on the first such call.
+                if (outerSize >= MIN_PACKED_ROWS && srcMat.isContinuous())
+                {
+                    if (packedWeights.empty())
+                        fastGemmPackB(blobs[0], true, packedWeights);
+                    fastGemm(srcMat, false, packedWeights, MatShape(), bias ? biasMat : Mat(), 1.f, 1.f, activ.get(), dstMat);
+                    continue;
+                }
                 const int nstripes = getNumThreads();
                 FullyConnected::run(srcMat, weightsMat, biasMat, dstMat, activ.get(), nstripes);
             }
@@ -716,6 +726,7 @@ public:
 
     bool bias;
     Mat weightsMat, biasMat;
+    Mat packedWeights;  // for fastGemm()
     Ptr<ActivationLayer> activ;
 };
 
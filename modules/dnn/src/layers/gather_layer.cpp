@@ -64,17 +64,21 @@ public:
         char* dst = out.ptr<char>();
 
         const size_t es = inp.elemSize1();
-        for (size_t i = 0; i < outer_dims; ++i)
+        const size_t nindices = indices.total();
+        const size_t axis_size = inp.size[axis], axis_step = inp.step1(axis);
+        const size_t row_size = inner_size * es;
+        const double nstripes = std::max(1., std::min((double)getNumThreads()*4,
+                                                      outer_dims*nindices*row_size/65536.));
+        parallel_for_(Range(0, (int)(outer_dims * nindices)), [&](const Range& r)
         {
-            const size_t src_offset = i * outer_size;
-            for (size_t j = 0 ; j < indices.total(); ++j)
+            for (int k = r.start; k < r.end; ++k)
             {
-                const size_t index = (static_cast<int>(idx[j]) + inp.size[axis]) % inp.size[axis];
-                const size_t new_offset = src_offset + index * inp.step1(axis);
-                std::memcpy(dst, src + new_offset * es, inner_size * es);
-                dst += inner_size * es;
+                const size_t i = k / nindices, j = k - i * nindices;
+                const size_t index = (static_cast<int>(idx[j]) + axis_size) % axis_size;
+                const size_t src_offset = i * outer_size + index * axis_step;
+                std::memcpy(dst + k * row_size, src + src_offset * es, row_size);
             }
-        }
+        }, nstripes);
     }
 
 private:
@@ -0,0 +1,149 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "../precomp.hpp"
+#include "layers_common.hpp"
+
+#include <opencv2/dnn/shape_utils.hpp>
+
+namespace cv
+{
+namespace dnn
+{
+
+class LayerNormLayerImpl CV_FINAL : public LayerNormLayer
+{
+public:
+    LayerNormLayerImpl(const LayerParams& params)
+    {
+        setParamsFrom(params);
+        axis = params.get<int>("axis", -1);
+        epsilon = params.get<float>("epsilon", 1e-5f);
+        CV_CheckLE(blobs.size(), (size_t)2, "LayerNormalization expects optional scale and bias only");
+    }
+
+    virtual bool supportBackend(int backendId) CV_OVERRIDE
+    {
+        return backendId == DNN_BACKEND_OPENCV;
+    }
+
+    bool getMemoryShapes(const std::vector<MatShape> &inputs,
+                         const int requiredOutputs,
+                         std::vector<MatShape> &outputs,
+                         std::vector<MatShape> &internals) const CV_OVERRIDE
+    {
+        CV_CheckEQ(inputs.size(), (size_t)1, "");
+        const int normAxis = normalize_axis(axis, (int)inputs[0].size());
+        for (size_t i = 0; i < blobs.size(); i++)
+            CV_CheckEQ(blobs[i].total(), (size_t)total(inputs[0], normAxis), "Scale and bias must match the normalized dimensions");
+        outputs.assign(1, inputs[0]);
+        return true;
+    }
+
+    void forward(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr, OutputArrayOfArrays internals_arr) CV_OVERRIDE
+    {
+        CV_TRACE_FUNCTION();
+        CV_TRACE_ARG_VALUE(name, "name", name.c_str());
+
+        if (inputs_arr.depth() == CV_16S)
+        {
+            forward_fallback(inputs_arr, outputs_arr, internals_arr);
+            return;
+        }
+
+        std::vector<Mat> inputs, outputs;
+        inputs_arr.getMatVector(inputs);
+        outputs_arr.getMatVector(outputs);
+
+        const Mat& src = inputs[0];
+        Mat& dst = outputs[0];
+        CV_CheckTypeEQ(src.type(), CV_32F, "");
+        CV_Assert(src.isContinuous() && dst.isContinuous());
+
+        const int normAxis = normalize_axis(axis, src.dims);
+        const int rows = (int)src.total(0, normAxis), normSize = (int)src.total(normAxis);
+        const float* scale = blobs.size() > 0 ? blobs[0].ptr<float>() : 0;
+        const float* bias = blobs.size() > 1 ? blobs[1].ptr<float>() : 0;
+        const float* srcPtr = src.ptr<float>();
+        float* dstPtr = dst.ptr<float>();
+        const float eps = epsilon;
+
+        parallel_for_(Range(0, rows), [&](const Range& r)
+        {
+            for (int row = r.start; row < r.end; row++)
+                normalizeRow(srcPtr + (size_t)row * normSize, dstPtr + (size_t)row * normSize,
+                             normSize, scale, bias, eps);
+        }, std::max(1., std::min((double)getNumThreads() * 4, src.total() / 16384.)));
+    }
+
+    // The mean and the variance are computed in two passes to keep the precision
+    // for inputs with a large mean.
+    static void normalizeRow(const float* x, float* y, int n, const float* scale, const float* bias, float eps)
+    {
+        int i = 0;
+        float sum = 0.f;
+#if CV_SIMD
+        const int VECSZ = v_float32::nlanes;
+        v_float32 vsum = vx_setzero_f32();
+        for (; i <= n - VECSZ; i += VECSZ)
+            vsum += vx_load(x + i);
+        sum = v_reduce_sum(vsum);
+#endif
+        for (; i < n; i++)
+            sum += x[i];
+        const float mean = sum / n;
+
+        i = 0;
+        float sqsum = 0.f;
+#if CV_SIMD
+        v_float32 vmean = vx_setall_f32(mean), vsqsum = vx_setzero_f32();
+        for (; i <= n - VECSZ; i += VECSZ)
+        {
+            v_float32 d = vx_load(x + i) - vmean;
+            vsqsum = v_fma(d, d, vsqsum);
+        }
+        sqsum = v_reduce_sum(vsqsum);
+#endif
+        for (; i < n; i++)
+            sqsum += (x[i] - mean) * (x[i] - mean);
+        const float inv = 1.f / std::sqrt(sqsum / n + eps);
+
+        i = 0;
+#if CV_SIMD
+        v_float32 vinv = vx_setall_f32(inv);
+        for (; i <= n - VECSZ; i += VECSZ)
+        {
+            v_float32 v = (vx_load(x + i) - vmean) * vinv;
+            if (scale)
+                v = v * vx_load(scale + i);
+            if (bias)
+                v = v + vx_load(bias + i);
+            v_store(y + i, v);
+        }
+#endif
+        for (; i < n; i++)
+        {
+            float v = (x[i] - mean) * inv;
+            if (scale)
+                v *= scale[i];
+            if (bias)
+                v += bias[i];
+            y[i] = v;
+        }
+    }
+
+    virtual int64 getFLOPS(const std::vector<MatShape> &inputs,
+                           const std::vector<MatShape> &outputs) const CV_OVERRIDE
+    {
+        CV_UNUSED(outputs);
+        return 6 * total(inputs[0]);
+    }
+};
+
+Ptr<LayerNormLayer> LayerNormLayer::create(const LayerParams& params)
+{
+    return makePtr<LayerNormLayerImpl>(params);
+}
+
+}}  // namespace cv::dnn
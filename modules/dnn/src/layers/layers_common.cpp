@@ -263,5 +263,98 @@ double getWeightScale(const Mat& weightsMat)
     return (realMax == realMin) ? 1.0 : std::max(-realMin, realMax)/127;
 }
 
+template<typename T>
+static void copyStridedRow(const uchar* src, size_t srcStep, uchar* dst, size_t dstStep, int n)
+{
+    for (int i = 0; i < n; i++, src += srcStep, dst += dstStep)
+        *(T*)dst = *(const T*)src;
+}
+
+void copyStridedNd(int ndims, const int* shape_, size_t esz,
+                   const uchar* src, const size_t* srcStep_,
+                   uchar* dst, const size_t* dstStep_)
+{
+    // drop the unit dimensions and merge the ones which are contiguous in both layouts
+    std::vector<int> shape;
+    std::vector<size_t> srcStep, dstStep;
+    for (int i = 0; i < ndims; i++)
+    {
+        if (shape_[i] == 0)
+            return;
+        if (shape_[i] == 1)
+            continue;
+        if (!shape.empty() && srcStep.back() == srcStep_[i]*shape_[i] &&
+            dstStep.back() == dstStep_[i]*shape_[i])
+        {
+            shape.back() *= shape_[i];
+            srcStep.back() = srcStep_[i];
+            dstStep.back() = dstStep_[i];
+            continue;
+        }
+        shape.push_back(shape_[i]);
+        srcStep.push_back(srcStep_[i]);
+        dstStep.push_back(dstStep_[i]);
+    }
+    if (shape.empty())
+    {
+        memcpy(dst, src, esz);
+        return;
+    }
+
+    const int dims = (int)shape.size(), n = shape.back();
+    const size_t sstep = srcStep.back(), dstep = dstStep.back();
+    size_t nrows = 1;
+    for (int i = 0; i < dims - 1; i++)
+        nrows *= shape[i];
+    const double nstripes = std::max(1., std::min((double)getNumThreads()*4, nrows*n*esz/65536.));
+
+    parallel_for_(Range(0, (int)nrows), [&](const Range& r)
+    {
+        for (int row = r.start; row < r.end; row++)
+        {
+            const uchar* s = src;
+            uchar* d = dst;
+            size_t idx = row;
+            for (int k = dims - 2; k >= 0; k--)
+            {
+                size_t next_idx = idx/shape[k];
+                size_t i_k = idx - next_idx*shape[k];
+                s += i_k*srcStep[k];
+                d += i_k*dstStep[k];
+                idx = next_idx;
+            }
+            if (sstep == esz && dstep == esz)
+                memcpy(d, s, n*esz);
+            else if (esz == 4)
+                copyStridedRow<int>(s, sstep, d, dstep, n);
+            else if (esz == 2)
+                copyStridedRow<short>(s, sstep, d, dstep, n);
+            else if (esz == 1)
+                copyStridedRow<uchar>(s, sstep, d, dstep, n);
+            else if (esz == 8)
+                copyStridedRow<int64>(s, sstep, d, dstep, n);
+            else
+            {
+                for (int i = 0; i < n; i++)
+                    memcpy(d + i*dstep, s + i*sstep, esz);
+            }
+        }
+    }, nstripes);
+}
+
+std::vector<size_t> getBroadcastSteps(const MatShape& shape, int ndims)
+{
+    CV_Assert((int)shape.size() <= ndims);
+    std::vector<size_t> steps(ndims, 0);
+    size_t step = 1;
+    for (int d = (int)shape.size() - 1; d >= 0; d--)
+    {
+        if (shape[d] != 1)
+            steps[ndims - shape.size() + d] = step;
+        step *= shape[d];
+    }
+    return steps;
+}
+
 }
 }
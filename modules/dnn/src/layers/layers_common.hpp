@@ -76,6 +76,16 @@ void getConvPoolPaddings(const std::vector<int>& inp, const std::vector<size_t>&
 
 // Used in quantized model. It will return the (Max_element - Min_element)/127.
 double getWeightScale(const Mat& weightsMat);
+
+// Copies the ndims-dimensional box of the given shape between two strided layouts.
+// Steps are in bytes per dimension, rows of the box are copied in parallel.
+void copyStridedNd(int ndims, const int* shape, size_t esz,
+                   const uchar* src, const size_t* srcStep,
+                   uchar* dst, const size_t* dstStep);
+
+// Element steps of a blob of the given shape for every dimension of the ndims-dimensional
+// output it is broadcasted to, aligned to the right. Broadcasted dimensions get zero steps.
+std::vector<size_t> getBroadcastSteps(const MatShape& shape, int ndims);
 }
 }
 
@@ -0,0 +1,150 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "../precomp.hpp"
+#include "layers_common.hpp"
+#include "fast_gemm.hpp"
+
+#include <opencv2/dnn/shape_utils.hpp>
+
+namespace cv
+{
+namespace dnn
+{
+
+class MatMulLayerImpl CV_FINAL : public MatMulLayer
+{
+public:
+    MatMulLayerImpl(const LayerParams& params)
+    {
+        setParamsFrom(params);
+        transA = params.get<bool>("transA", false);
+        transB = params.get<bool>("transB", false);
+        alpha = params.get<float>("alpha", 1.f);
+        beta = params.get<float>("beta", 1.f);
+        hasBias = params.get<bool>("bias_term", false);
+        CV_Assert(blobs.size() == (size_t)hasBias || blobs.size() == (size_t)hasBias + 1);
+        constB = blobs.size() > (size_t)hasBias;
+
+        if (constB)
+        {
+            CV_CheckTypeEQ(blobs[0].type(), CV_32F, "");
+            CV_CheckGE(blobs[0].dims, 2, "");
+            // only the packed copy of B is kept
+            bShape = shape(blobs[0]);
+            fastGemmPackB(blobs[0], transB, packedB);
+            blobs[0] = Mat();
+        }
+    }
+
+    virtual bool supportBackend(int backendId) CV_OVERRIDE
+    {
+        return backendId == DNN_BACKEND_OPENCV;
+    }
+
+    bool getMemoryShapes(const std::vector<MatShape> &inputs,
+                         const int requiredOutputs,
+                         std::vector<MatShape> &outputs,
+                         std::vector<MatShape> &internals) const CV_OVERRIDE
+    {
+        CV_CheckEQ(inputs.size(), (size_t)(constB ? 1 : 2), "");
+        const MatShape& a = inputs[0];
+        const MatShape& b = constB ? bShape : inputs[1];
+        CV_CheckGE(a.size(), (size_t)2, "MatMul: 1D inputs are not supported");
+        CV_CheckGE(b.size(), (size_t)2, "MatMul: 1D inputs are not supported");
+
+        const int M = a[a.size() - (transA ? 1 : 2)], K = a[a.size() - (transA ? 2 : 1)];
+        const int Kb = b[b.size() - (transB ? 1 : 2)], N = b[b.size() - (transB ? 2 : 1)];
+        CV_CheckEQ(K, Kb, "MatMul: inner dimensions mismatch");
+
+        // the leading dimensions are broadcasted
+        const size_t nbatch = std::max(a.size(), b.size()) - 2;
+        MatShape outShape(nbatch, 1);
+        for (int i = 0; i < 2; i++)
+        {
+            const MatShape& s = i == 0 ? a : b;
+            const size_t shift = nbatch + 2 - s.size();
+            for (size_t d = 0; d + 2 < s.size(); d++)
+            {
+                int& sz = outShape[shift + d];
+                if (s[d] != sz)
+                {
+                    CV_Check(s[d], s[d] == 1 || sz == 1, "MatMul: batch dimensions can not be broadcasted");
+                    sz = std::max(sz, s[d]);
+                }
+            }
+        }
+        outShape.push_back(M);
+        outShape.push_back(N);
+
+        if (hasBias)
+        {
+            const MatShape c = shape(blobs.back());
+            CV_CheckLE(c.size(), (size_t)2, "MatMul: bias is expected to be broadcastable to [M, N]");
+            for (size_t d = 0; d < c.size(); d++)
+            {
+                const int sz = outShape[outShape.size() - c.size() + d];
+                CV_Check(c[d], c[d] == 1 || c[d] == sz, "MatMul: bias is expected to be broadcastable to [M, N]");
+            }
+        }
+
+        outputs.assign(1, outShape);
+        return false;
+    }
+
+    void forward(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr, OutputArrayOfArrays internals_arr) CV_OVERRIDE
+    {
+        CV_TRACE_FUNCTION();
+        CV_TRACE_ARG_VALUE(name, "name", name.c_str());
+
+        if (inputs_arr.depth() == CV_16S)
+        {
+            forward_fallback(inputs_arr, outputs_arr, internals_arr);
+            return;
+        }
+
+        std::vector<Mat> inputs, outputs;
+        inputs_arr.getMatVector(inputs);
+        outputs_arr.getMatVector(outputs);
+
+        const Mat& A = inputs[0];
+        Mat& out = outputs[0];
+        CV_CheckTypeEQ(A.type(), CV_32F, "");
+        CV_Assert(A.isContinuous() && out.isContinuous());
+
+        Mat packedInput;
+        MatShape inputBShape;
+        if (!constB)
+        {
+            CV_CheckTypeEQ(inputs[1].type(), CV_32F, "");
+            CV_Assert(inputs[1].isContinuous());
+            inputBShape = shape(inputs[1]);
+            fastGemmPackB(inputs[1], transB, packedInput);
+        }
+        const MatShape& b = constB ? bShape : inputBShape;
+
+        fastGemm(A, transA, constB ? packedB : packedInput, MatShape(b.begin(), b.end() - 2),
+                 hasBias ? blobs.back() : Mat(), alpha, beta, NULL, out);
+    }
+
+    virtual int64 getFLOPS(const std::vector<MatShape> &inputs,
+                           const std::vector<MatShape> &outputs) const CV_OVERRIDE
+    {
+        const MatShape& a = inputs[0];
+        const int64 K = a[a.size() - (transA ? 2 : 1)];
+        return 2 * total(outputs[0]) * K;
+    }
+
+private:
+    bool hasBias, constB;
+    MatShape bShape;  // of the constant B
+    Mat packedB;
+};
+
+Ptr<MatMulLayer> MatMulLayer::create(const LayerParams& params)
+{
+    return makePtr<MatMulLayerImpl>(params);
+}
+
+}}  // namespace cv::dnn
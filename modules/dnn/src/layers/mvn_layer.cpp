@@ -345,38 +345,41 @@ public:
                 return;
             }
 
-            Scalar mean, dev;
-            for ( i = 0; i < newRows; i++)
+            parallel_for_(Range(0, newRows), [&](const Range& r)
             {
-                Mat inpRow = inpMat.row(i);
-                Mat outRow = outMat.row(i);
-                float weight = 1.f;
-                float bias = 0.f;
-                if (fuse_batch_norm)
+                for (int i = r.start; i < r.end; i++)
                 {
-                    weight = i < scale.cols ? ((float*)scale.data)[i] : weight;
-                    bias = i < shift.cols ? ((float*)shift.data)[i] : bias;
-                }
-                cv::meanStdDev(inpRow, mean, (normVariance) ? dev : noArray());
-                double alpha = 1;
-                if (normVariance)
-                {
-                    alpha = 1 / std::sqrt(eps + dev[0]*dev[0]);
-                }
-                double normalizationScale = 1.0;
-                double normalizationShift = 0.0;
-                if (fuse_batch_norm)
-                {
-                    normalizationScale = alpha * weight;
-                    normalizationShift = -mean[0] * normalizationScale + bias;
-                }
-                else
-                {
-                    normalizationScale = alpha;
-                    normalizationShift = -mean[0] * alpha;
+                    Scalar mean, dev;
+                    Mat inpRow = inpMat.row(i);
+                    Mat outRow = outMat.row(i);
+                    float weight = 1.f;
+                    float bias = 0.f;
+                    if (fuse_batch_norm)
+                    {
+                        weight = i < scale.cols ? ((float*)scale.data)[i] : weight;
+                        bias = i < shift.cols ? ((float*)shift.data)[i] : bias;
+                    }
+                    cv::meanStdDev(inpRow, mean, (normVariance) ? dev : noArray());
+                    double alpha = 1;
+                    if (normVariance)
+                    {
+                        alpha = 1 / std::sqrt(eps + dev[0]*dev[0]);
+                    }
+                    double normalizationScale = 1.0;
+                    double normalizationShift = 0.0;
+                    if (fuse_batch_norm)
+                    {
+                        normalizationScale = alpha * weight;
+                        normalizationShift = -mean[0] * normalizationScale + bias;
+                    }
+                    else
+                    {
+                        normalizationScale = alpha;
+                        normalizationShift = -mean[0] * alpha;
+                    }
+                    inpRow.convertTo(outRow, outRow.type(), normalizationScale, normalizationShift);
                 }
-                inpRow.convertTo(outRow, outRow.type(), normalizationScale, normalizationShift);
-            }
+            });
         }
     }
 
@@ -15,6 +15,94 @@ namespace cv
 namespace dnn
 {
 
+// Arithmetic operations with SIMD overloads for the contiguous float rows.
+struct NaryAddOp
+{
+    template<typename T> auto operator()(const T& a, const T& b) const -> decltype(a + b) { return a + b; }
+};
+struct NarySubOp
+{
+    template<typename T> auto operator()(const T& a, const T& b) const -> decltype(a - b) { return a - b; }
+};
+struct NaryMulOp
+{
+    template<typename T> auto operator()(const T& a, const T& b) const -> decltype(a * b) { return a * b; }
+};
+struct NaryDivOp
+{
+    template<typename T> auto operator()(const T& a, const T& b) const -> decltype(a / b) { return a / b; }
+};
+struct NaryMaxOp
+{
+    template<typename T> T operator()(const T& a, const T& b) const { return std::max(a, b); }
+#if CV_SIMD
+    v_float32 operator()(const v_float32& a, const v_float32& b) const { return v_max(a, b); }
+#endif
+};
+struct NaryMinOp
+{
+    template<typename T> T operator()(const T& a, const T& b) const { return std::min(a, b); }
+#if CV_SIMD
+    v_float32 operator()(const v_float32& a, const v_float32& b) const { return v_min(a, b); }
+#endif
+};
+
+// Computes the head of a row where the inputs are either contiguous (step 1) or
+// broadcasted scalars (step 0) and returns the number of the processed elements.
+template<typename T, typename Functor>
+static inline int naryVecRow(const Functor&, const T*, size_t, const T*, size_t, T*, int)
+{
+    return 0;
+}
+
+#if CV_SIMD
+template<typename Functor>
+static inline int naryVecRowF32(const Functor& op, const float* a, size_t da,
+                                const float* b, size_t db, float* c, int n)
+{
+    const int VECSZ = v_float32::nlanes;
+    int i = 0;
+    if (da == 1 && db == 1)
+    {
+        for (; i <= n - VECSZ; i += VECSZ)
+            v_store(c + i, op(vx_load(a + i), vx_load(b + i)));
+    }
+    else if (da == 1 && db == 0)
+    {
+        v_float32 vb = vx_setall_f32(*b);
+        for (; i <= n - VECSZ; i += VECSZ)
+            v_store(c + i, op(vx_load(a + i), vb));
+    }
+    else if (da == 0 && db == 1)
+    {
+        v_float32 va = vx_setall_f32(*a);
+        for (; i <= n - VECSZ; i += VECSZ)
+            v_store(c + i, op(va, vx_load(b + i)));
+    }
+    return i;
+}
+
+#define NARY_VEC_ROW_F32(Op) \
+static inline int naryVecRow(const Op& op, const float* a, size_t da, const float* b, size_t db, float* c, int n) \
+{ \
+    return naryVecRowF32(op, a, da, b, db, c, n); \
+}
+NARY_VEC_ROW_F32(NaryAddOp)
+NARY_VEC_ROW_F32(NarySubOp)
+NARY_VEC_ROW_F32(NaryMulOp)
+NARY_VEC_ROW_F32(NaryDivOp)
+NARY_VEC_ROW_F32(NaryMaxOp)
+NARY_VEC_ROW_F32(NaryMinOp)
+#undef NARY_VEC_ROW_F32
+#endif
+
+// Rows of the broadcasted operations are distributed between the threads
+// when the output is large enough to pay off the scheduling.
+static inline double naryStripes(size_t nrows, size_t rowSize)
+{
+    return std::max(1., std::min((double)getNumThreads() * 4, nrows * (double)rowSize / 16384.));
+}
+
 class NaryEltwiseLayerImpl CV_FINAL : public NaryEltwiseLayer
 {
 public:
@@ -213,46 +301,48 @@ public:
         size_t dp2 = step2[ndims-1]/sizeof(T);
         size_t dp = step[ndims-1]/sizeof(T);
         int k, n1 = shape[ndims-1], n2 = shape[ndims-2];
-        size_t plane_idx, nplanes = 1;
+        size_t nplanes = 1;
         for (k = 0; k < ndims-2; k++) nplanes *= shape[k];
 
-        for (plane_idx = 0; plane_idx < nplanes; plane_idx++) {
-            const char* ptr1_ = data1;
-            const char* ptr2_ = data2;
-            char* ptr_ = data;
-            size_t idx = plane_idx;
-            for (k = ndims-3; k >= 0; k--) {
-                size_t next_idx = idx/shape[k];
-                int i_k = (int)(idx - next_idx*shape[k]);
-                ptr1_ += i_k*step1[k];
-                ptr2_ += i_k*step2[k];
-                ptr_ += i_k*step[k];
-                idx = next_idx;
-            }
-            for (int i2 = 0; i2 < n2; i2++, ptr1_ += step1[ndims-2],
-                                            ptr2_ += step2[ndims-2],
-                                            ptr_ += step[ndims-2])
+        parallel_for_(Range(0, (int)(nplanes*n2)), [&](const Range& r)
+        {
+            for (int row = r.start; row < r.end; row++)
             {
+                size_t plane_idx = row / n2;
+                int i2 = (int)(row - plane_idx*n2);
+                const char* ptr1_ = data1 + i2*step1[ndims-2];
+                const char* ptr2_ = data2 + i2*step2[ndims-2];
+                char* ptr_ = data + i2*step[ndims-2];
+                size_t idx = plane_idx;
+                for (int j = ndims-3; j >= 0; j--) {
+                    size_t next_idx = idx/shape[j];
+                    int i_k = (int)(idx - next_idx*shape[j]);
+                    ptr1_ += i_k*step1[j];
+                    ptr2_ += i_k*step2[j];
+                    ptr_ += i_k*step[j];
+                    idx = next_idx;
+                }
+
                 const T* ptr1 = (const T*)ptr1_;
                 const T* ptr2 = (const T*)ptr2_;
                 T* ptr = (T*)ptr_;
                 if (dp1 == 1 && dp2 == 1 && dp == 1) {
-                    for(int i1 = 0; i1 < n1; i1++)
+                    for(int i1 = naryVecRow(op, ptr1, dp1, ptr2, dp2, ptr, n1); i1 < n1; i1++)
                         ptr[i1] = op(ptr1[i1], ptr2[i1]);
                 } else if (dp1 == 1 && dp2 == 0 && dp == 1){
                     T x2 = *ptr2;
-                    for(int i1 = 0; i1 < n1; i1++)
+                    for(int i1 = naryVecRow(op, ptr1, dp1, ptr2, dp2, ptr, n1); i1 < n1; i1++)
                         ptr[i1] = op(ptr1[i1], x2);
                 } else if (dp1 == 0 && dp2 == 1 && dp == 1){
                     T x1 = *ptr1;
-                    for(int i1 = 0; i1 < n1; i1++)
+                    for(int i1 = naryVecRow(op, ptr1, dp1, ptr2, dp2, ptr, n1); i1 < n1; i1++)
                         ptr[i1] = op(x1, ptr2[i1]);
                 } else {
                     for(int i1 = 0; i1 < n1; i1++, ptr1 += dp1, ptr2 += dp2, ptr += dp)
                         *ptr = op(*ptr1, *ptr2);
                 }
             }
-        }
+        }, naryStripes(nplanes*n2, n1));
     }
 
     template <typename T, typename Functor>
@@ -316,42 +406,49 @@ public:
     template<typename T, typename Functor>
     void nary_forward_impl(
         const Functor& f, const T scale, int ninputs, int ndims, const int* shape,
-        const char** inp, char* out,
-        const size_t** steps, char** ptrs)
+        const char** inp, char* out, const size_t** steps)
     {
         CV_Assert(ndims >= 2);
+        int second = ninputs == 1 ? 1 : 2;
         size_t dp = steps[0][ndims-1]/sizeof(T);
         size_t dp1 = steps[1][ndims-1]/sizeof(T);
-        size_t dp2 = steps[2][ndims-1]/sizeof(T);
+        size_t dp2 = steps[second][ndims-1]/sizeof(T);
 
         CV_Assert(dp == 1);
         enum { BLOCK_SIZE = 1024 };
-        T blck[BLOCK_SIZE];
 
-        int k, i, di1=0, n1 = shape[ndims-1], n2 = shape[ndims-2];
-        int second = ninputs == 1 ? 1 : 2;
-        size_t plane_idx, nplanes = 1;
+        int k, n1 = shape[ndims-1], n2 = shape[ndims-2];
+        size_t nplanes = 1;
         for (k = 0; k < ndims-2; k++) nplanes *= shape[k];
 
-        for (plane_idx = 0; plane_idx < nplanes; plane_idx++) {
-            ptrs[0] = out;
-            for (i = 0; i < ninputs; i++) ptrs[i+1] = (char*)inp[i];
-            size_t idx = plane_idx;
-            for (k = ndims-3; k >= 0; k--) {
-                size_t next_idx = idx/shape[k];
-                int i_k = (int)(idx - next_idx*shape[k]);
-                for (i = 0; i < ninputs; i++)
-                    ptrs[i] += i_k*steps[i][k];
-                idx = next_idx;
-            }
-            for (int i2 = 0; i2 < n2; i2++)
+        parallel_for_(Range(0, (int)(nplanes*n2)), [&](const Range& r)
+        {
+            T blck[BLOCK_SIZE];
+            AutoBuffer<char*> _ptrs(ninputs + 1);
+            char** ptrs = _ptrs.data();
+            int i, di1 = 0;
+            for (int row = r.start; row < r.end; row++)
             {
+                size_t plane_idx = row / n2;
+                int i2 = (int)(row - plane_idx*n2);
+                ptrs[0] = out;
+                for (i = 0; i < ninputs; i++) ptrs[i+1] = (char*)inp[i];
+                size_t idx = plane_idx;
+                for (int j = ndims-3; j >= 0; j--) {
+                    size_t next_idx = idx/shape[j];
+                    int i_k = (int)(idx - next_idx*shape[j]);
+                    for (i = 0; i <= ninputs; i++)
+                        ptrs[i] += i_k*steps[i][j];
+                    idx = next_idx;
+                }
+
                 const T* ptr1 = (const T*)(ptrs[1] + steps[1][ndims-2]*i2);
                 const T* ptr2 = (const T*)(ptrs[second] + steps[second][ndims-2]*i2);
                 T* ptr = (T*)(ptrs[0] + steps[0][ndims-2]*i2);
                 if (ninputs <= 2) {
                     if (dp1 == 1 && dp2 == 1) {
-                        for (int i1 = 0; i1 < n1; i1++)
+                        int i1 = scale == T(1) ? naryVecRow(f, ptr1, dp1, ptr2, dp2, ptr, n1) : 0;
+                        for (; i1 < n1; i1++)
                             ptr[i1] = saturate_cast<T>(f(ptr1[i1], ptr2[i1])*scale);
                     } else {
                         for(int i1 = 0; i1 < n1; i1++, ptr1 += dp1, ptr2 += dp2, ptr += dp)
@@ -361,7 +458,7 @@ public:
                     for (int i1 = 0; i1 < n1; i1 += di1, ptr += di1) {
                         di1 = BLOCK_SIZE < n1-i1 ? BLOCK_SIZE : n1-i1;
                         if (dp1 == 1 && dp2 == 1) {
-                            for (int j = 0; j < di1; j++)
+                            for (int j = naryVecRow(f, ptr1, dp1, ptr2, dp2, blck, di1); j < di1; j++)
                                 blck[j] = f(ptr1[j], ptr2[j]);
                             ptr1 += di1;
                             ptr2 += di1;
@@ -375,10 +472,11 @@ public:
                                     steps[i+1][ndims-2]*i2) + i1*dp_i;
                             if (dp_i == 1) {
                                 if (i < ninputs-1) {
-                                    for (int j = 0; j < di1; j++)
+                                    for (int j = naryVecRow(f, blck, 1, ptr_i, 1, blck, di1); j < di1; j++)
                                         blck[j] = f(blck[j], ptr_i[j]);
                                 } else {
-                                    for (int j = 0; j < di1; j++)
+                                    int j = scale == T(1) ? naryVecRow(f, blck, 1, ptr_i, 1, ptr, di1) : 0;
+                                    for (; j < di1; j++)
                                         ptr[j] = saturate_cast<T>(f(blck[j], ptr_i[j]) * scale);
                                 }
                             } else {
@@ -394,7 +492,7 @@ public:
                     }
                 }
             }
-        }
+        }, naryStripes(nplanes*n2, (size_t)n1*ninputs));
     }
 
     template <typename T, typename Functor>
@@ -438,20 +536,17 @@ public:
 
         // buf holds the following buffers for inputs & output:
         //  * orig_shapes, shapes (result_shape), orig_steps, steps (result_step), (ninputs+1)*4 elements in total
-        //  * ptrs, (ninputs+1)*1 elements in total
         //  * shape_buf & step_buf, (ninputs+1)*2*max_ndims elements in total
         //  * all_ndims, (ninputs+1)*1 elements in total
         //  * all_type_sizes, (ninputs+1)*1 elements in total
-        AutoBuffer<size_t> buf((ninputs + 1) * (2 * max_ndims + 7));
+        AutoBuffer<size_t> buf((ninputs + 1) * (2 * max_ndims + 6));
 
         int** orig_shapes = (int**)buf.data();
         int** shapes = orig_shapes + ninputs + 1;
         size_t** orig_steps = (size_t**)(shapes + ninputs + 1);
         size_t** steps = orig_steps + ninputs + 1;
 
-        char** ptrs = (char**)(steps + ninputs + 1);
-
-        size_t* step_buf = (size_t*)(ptrs + ninputs + 1);
+        size_t* step_buf = (size_t*)(steps + ninputs + 1);
         int* shape_buf = (int*)(step_buf + (ninputs + 1)*max_ndims);
 
         int* all_ndims = shape_buf + (ninputs + 1)*max_ndims;
@@ -473,7 +568,7 @@ public:
             return;
 
         nary_forward_impl<T>(
-                f, scale, ninputs, max_ndims, shapes[0], inp, out, (const size_t **) steps, ptrs);
+                f, scale, ninputs, max_ndims, shapes[0], inp, out, (const size_t **) steps);
     }
 
     void forward(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr, OutputArrayOfArrays internals_arr) CV_OVERRIDE
@@ -544,7 +639,7 @@ public:
             }
             case OPERATION::MAX:
             {
-                auto max = [](const T &a, const T &b) { return std::max(a, b); };
+                NaryMaxOp max;
                 nary_forward<T>(max, T{1}, std::forward<Args>(args)...);
                 break;
             }
@@ -556,7 +651,7 @@ public:
             }
             case OPERATION::MIN:
             {
-                auto min = [](const T &a, const T &b) { return std::min(a, b); };
+                NaryMinOp min;
                 nary_forward<T>(min, T{1}, std::forward<Args>(args)...);
                 break;
             }
@@ -568,31 +663,31 @@ public:
             }
             case OPERATION::PROD:
             {
-                auto prod = [](const T &a, const T &b) { return a * b; };
+                NaryMulOp prod;
                 binary_forward<T>(prod, std::forward<Args>(args)...);
                 break;
             }
             case OPERATION::SUB:
             {
-                auto sub = [](const T &a, const T &b) { return a - b; };
+                NarySubOp sub;
                 binary_forward<T>(sub, std::forward<Args>(args)...);
                 break;
             }
             case OPERATION::SUM:
             {
-                auto sum = [](const T &a, const T &b) { return a + b; };
+                NaryAddOp sum;
                 nary_forward<T>(sum, T{1}, std::forward<Args>(args)...);
                 break;
             }
             case OPERATION::ADD:
             {
-                auto add = [](const T &a, const T &b) { return a + b; };
+                NaryAddOp add;
                 binary_forward<T>(add, std::forward<Args>(args)...);
                 break;
             }
             case OPERATION::DIV:
             {
-                auto div = [](const T &a, const T &b) { return a / b; };
+                NaryDivOp div;
                 binary_forward<T>(div, std::forward<Args>(args)...);
                 break;
             }
@@ -138,7 +138,14 @@ public:
                 outputs[0].setTo(saturate_cast<int8_t>(paddingValue));
             else
                 outputs[0].setTo(paddingValue);
-            inputs[0].copyTo(outputs[0](dstRanges));
+
+            const Mat& inp = inputs[0];
+            Mat& out = outputs[0];
+            uchar* dstData = out.ptr();
+            for (int i = 0; i < out.dims; i++)
+                dstData += (dstRanges[i] == Range::all() ? 0 : dstRanges[i].start)*out.step[i];
+            copyStridedNd(inp.dims, inp.size.p, inp.elemSize(), inp.ptr(), inp.step.p,
+                          dstData, out.step.p);
         }
         else if (paddingType == "reflect" || paddingType == "edge")
         {
@@ -162,16 +169,19 @@ public:
             CV_CheckLE(padTop, inpHeight, ""); CV_CheckLE(padBottom, inpHeight, "");
             CV_CheckLE(padLeft, inpWidth, ""); CV_CheckLE(padRight, inpWidth, "");
 
-            for (size_t n = 0; n < inputs[0].size[0]; ++n)
+            const int numChannels = inputs[0].size[1];
+            const int numPlanes = inputs[0].size[0] * numChannels;
+            parallel_for_(Range(0, numPlanes), [&](const Range& r)
             {
-                for (size_t ch = 0; ch < inputs[0].size[1]; ++ch)
+                for (int i = r.start; i < r.end; ++i)
                 {
-                    copyMakeBorder(getPlane(inputs[0], n, ch),
-                                   getPlane(outputs[0], n, ch),
+                    const int n = i / numChannels, ch = i % numChannels;
+                    Mat outPlane = getPlane(outputs[0], n, ch);
+                    copyMakeBorder(getPlane(inputs[0], n, ch), outPlane,
                                    padTop, padBottom, padLeft, padRight,
                                    borderType);
                 }
-            }
+            });
         }
         else
             CV_Error(Error::StsNotImplemented, "Unknown padding type: " + paddingType);
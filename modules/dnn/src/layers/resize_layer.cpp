@@ -140,168 +140,32 @@ public:
         {
             // INTER_LINEAR Resize mode does not support INT8 inputs
             InterpolationFlags mode = interpolation == "nearest" ? INTER_NEAREST : INTER_LINEAR;
-            for (size_t n = 0; n < inputs[0].size[0]; ++n)
+            const int numChannels = inp.size[1];
+            parallel_for_(Range(0, inp.size[0] * numChannels), [&](const Range& r)
             {
-                for (size_t ch = 0; ch < inputs[0].size[1]; ++ch)
+                for (int i = r.start; i < r.end; ++i)
                 {
-                    resize(getPlane(inp, n, ch), getPlane(out, n, ch),
+                    Mat outPlane = getPlane(out, i / numChannels, i % numChannels);
+                    resize(getPlane(inp, i / numChannels, i % numChannels), outPlane,
                            Size(outWidth, outHeight), 0, 0, mode);
                 }
-            }
+            });
         }
         else if (interpolation == "nearest")
         {
-            const int inpHeight = inp.size[2];
-            const int inpWidth = inp.size[3];
-            const int inpSpatialSize = inpHeight * inpWidth;
-            const int outSpatialSize = outHeight * outWidth;
-            const int numPlanes = inp.size[0] * inp.size[1];
             CV_Assert_N(inp.isContinuous(), out.isContinuous());
-
-            Mat inpPlanes = inp.reshape(1, numPlanes * inpHeight);
-            Mat outPlanes = out.reshape(1, numPlanes * outHeight);
-
-            float heightOffset = 0.0f;
-            float widthOffset = 0.0f;
-
-            if (halfPixelCenters)
-            {
-                heightOffset = 0.5f * scaleHeight;
-                widthOffset = 0.5f * scaleWidth;
-            }
-
             if (depth == CV_8S)
-            {
-                for (int y = 0; y < outHeight; ++y)
-                {
-                    float input_y = y * scaleHeight + heightOffset;
-                    int y0 = halfPixelCenters ? std::floor(input_y) : lroundf(input_y);
-                    y0 = std::min(y0, inpHeight - 1);
-
-                    const int8_t* inpData_row = inpPlanes.ptr<int8_t>(y0);
-
-                    for (int x = 0; x < outWidth; ++x)
-                    {
-                        float input_x = x * scaleWidth + widthOffset;
-                        int x0 = halfPixelCenters ? std::floor(input_x) : lroundf(input_x);
-                        x0 = std::min(x0, inpWidth - 1);
-
-                        int8_t* outData = outPlanes.ptr<int8_t>(y, x);
-                        const int8_t* inpData_row_c = inpData_row;
-
-                        for (int c = 0; c < numPlanes; ++c)
-                        {
-                            *outData = inpData_row_c[x0];
-
-                            inpData_row_c += inpSpatialSize;
-                            outData += outSpatialSize;
-                        }
-                    }
-                }
-            }
+                resizeNearest<int8_t>(inp, out);
             else
-            {
-                for (int y = 0; y < outHeight; ++y)
-                {
-                    float input_y = y * scaleHeight + heightOffset;
-                    int y0 = halfPixelCenters ? std::floor(input_y) : lroundf(input_y);
-                    y0 = std::min(y0, inpHeight - 1);
-
-                    const float* inpData_row = inpPlanes.ptr<float>(y0);
-
-                    for (int x = 0; x < outWidth; ++x)
-                    {
-                        float input_x = x * scaleWidth + widthOffset;
-                        int x0 = halfPixelCenters ? std::floor(input_x) : lroundf(input_x);
-                        x0 = std::min(x0, inpWidth - 1);
-
-                        float* outData = outPlanes.ptr<float>(y, x);
-                        const float* inpData_row_c = inpData_row;
-
-                        for (int c = 0; c < numPlanes; ++c)
-                        {
-                            *outData = inpData_row_c[x0];
-
-                            inpData_row_c += inpSpatialSize;
-                            outData += outSpatialSize;
-                        }
-                    }
-                }
-            }
+                resizeNearest<float>(inp, out);
         }
         else if (interpolation == "bilinear" || interpolation == "opencv_linear")
         {
-            const int inpHeight = inp.size[2];
-            const int inpWidth = inp.size[3];
-            const int inpSpatialSize = inpHeight * inpWidth;
-            const int outSpatialSize = outHeight * outWidth;
-            const int numPlanes = inp.size[0] * inp.size[1];
             CV_Assert_N(inp.isContinuous(), out.isContinuous());
-
-            Mat inpPlanes = inp.reshape(1, numPlanes * inpHeight);
-            Mat outPlanes = out.reshape(1, numPlanes * outHeight);
             if (depth == CV_8S)
-            {
-                for (int y = 0; y < outHeight; ++y)
-                {
-                    float input_y = halfPixelCenters ? std::max((y + 0.5f) * scaleHeight - 0.5f, 0.0f) : y * scaleHeight;
-                    int y0 = static_cast<int>(input_y);
-                    const int8_t* inpData_row0 = inpPlanes.ptr<int8_t>(y0);
-                    const int8_t* inpData_row1 = inpPlanes.ptr<int8_t>(std::min(y0 + 1, inpHeight - 1));
-                    for (int x = 0; x < outWidth; ++x)
-                    {
-                        float input_x = halfPixelCenters ? std::max((x + 0.5f) * scaleWidth - 0.5f, 0.0f) : x * scaleWidth;
-                        int x0 = static_cast<int>(input_x);
-                        int x1 = std::min(x0 + 1, inpWidth - 1);
-
-                        int8_t* outData = outPlanes.ptr<int8_t>(y, x);
-                        const int8_t* inpData_row0_c = inpData_row0;
-                        const int8_t* inpData_row1_c = inpData_row1;
-                        for (int c = 0; c < numPlanes; ++c)
-                        {
-                            *outData = static_cast<int8_t>(inpData_row0_c[x0] +
-                                (input_y - y0) * (inpData_row1_c[x0] - inpData_row0_c[x0]) +
-                                (input_x - x0) * (inpData_row0_c[x1] - inpData_row0_c[x0] +
-                                (input_y - y0) * (inpData_row1_c[x1] - inpData_row0_c[x1] - inpData_row1_c[x0] + inpData_row0_c[x0])));
-
-                            inpData_row0_c += inpSpatialSize;
-                            inpData_row1_c += inpSpatialSize;
-                            outData += outSpatialSize;
-                        }
-                    }
-                }
-            }
+                resizeBilinear<int8_t>(inp, out, halfPixelCenters);
             else
-            {
-                for (int y = 0; y < outHeight; ++y)
-                {
-                    float input_y = y * scaleHeight;
-                    int y0 = static_cast<int>(input_y);
-                    const float* inpData_row0 = inpPlanes.ptr<float>(y0);
-                    const float* inpData_row1 = inpPlanes.ptr<float>(std::min(y0 + 1, inpHeight - 1));
-                    for (int x = 0; x < outWidth; ++x)
-                    {
-                        float input_x = x * scaleWidth;
-                        int x0 = static_cast<int>(input_x);
-                        int x1 = std::min(x0 + 1, inpWidth - 1);
-
-                        float* outData = outPlanes.ptr<float>(y, x);
-                        const float* inpData_row0_c = inpData_row0;
-                        const float* inpData_row1_c = inpData_row1;
-                        for (int c = 0; c < numPlanes; ++c)
-                        {
-                            *outData = inpData_row0_c[x0] +
-                                (input_y - y0) * (inpData_row1_c[x0] - inpData_row0_c[x0]) +
-                                (input_x - x0) * (inpData_row0_c[x1] - inpData_row0_c[x0] +
-                                (input_y - y0) * (inpData_row1_c[x1] - inpData_row0_c[x1] - inpData_row1_c[x0] + inpData_row0_c[x0]));
-
-                            inpData_row0_c += inpSpatialSize;
-                            inpData_row1_c += inpSpatialSize;
-                            outData += outSpatialSize;
-                        }
-                    }
-                }
-            }
+                resizeBilinear<float>(inp, out, halfPixelCenters);
         }
         else
             CV_Error(Error::StsNotImplemented, "Unknown interpolation: " + interpolation);
@@ -409,6 +273,87 @@ public:
         return true;
     }
 
+    // Both helpers process the output rows of all the planes in parallel
+    // with the horizontal source offsets computed once per call.
+    template<typename T>
+    void resizeNearest(const Mat& inp, Mat& out) const
+    {
+        const int inpHeight = inp.size[2];
+        const int inpWidth = inp.size[3];
+        const int numPlanes = inp.size[0] * inp.size[1];
+        const float heightOffset = halfPixelCenters ? 0.5f * scaleHeight : 0.0f;
+        const float widthOffset = halfPixelCenters ? 0.5f * scaleWidth : 0.0f;
+
+        std::vector<int> xofs(outWidth);
+        for (int x = 0; x < outWidth; ++x)
+        {
+            float input_x = x * scaleWidth + widthOffset;
+            int x0 = halfPixelCenters ? std::floor(input_x) : lroundf(input_x);
+            xofs[x] = std::min(x0, inpWidth - 1);
+        }
+
+        Mat inpPlanes = inp.reshape(1, numPlanes * inpHeight);
+        Mat outPlanes = out.reshape(1, numPlanes * outHeight);
+        parallel_for_(Range(0, numPlanes * outHeight), [&](const Range& r)
+        {
+            for (int row = r.start; row < r.end; ++row)
+            {
+                const int c = row / outHeight, y = row - c * outHeight;
+                float input_y = y * scaleHeight + heightOffset;
+                int y0 = halfPixelCenters ? std::floor(input_y) : lroundf(input_y);
+                y0 = std::min(y0, inpHeight - 1);
+
+                const T* inpData_row = inpPlanes.ptr<T>(c * inpHeight + y0);
+                T* outData = outPlanes.ptr<T>(row);
+                for (int x = 0; x < outWidth; ++x)
+                    outData[x] = inpData_row[xofs[x]];
+            }
+        });
+    }
+
+    template<typename T>
+    void resizeBilinear(const Mat& inp, Mat& out, bool halfPixel) const
+    {
+        const int inpHeight = inp.size[2];
+        const int inpWidth = inp.size[3];
+        const int numPlanes = inp.size[0] * inp.size[1];
+
+        std::vector<int> xofs(outWidth * 2);
+        std::vector<float> xalpha(outWidth);
+        for (int x = 0; x < outWidth; ++x)
+        {
+            float input_x = halfPixel ? std::max((x + 0.5f) * scaleWidth - 0.5f, 0.0f) : x * scaleWidth;
+            int x0 = static_cast<int>(input_x);
+            xofs[x * 2] = x0;
+            xofs[x * 2 + 1] = std::min(x0 + 1, inpWidth - 1);
+            xalpha[x] = input_x - x0;
+        }
+
+        Mat inpPlanes = inp.reshape(1, numPlanes * inpHeight);
+        Mat outPlanes = out.reshape(1, numPlanes * outHeight);
+        parallel_for_(Range(0, numPlanes * outHeight), [&](const Range& r)
+        {
+            for (int row = r.start; row < r.end; ++row)
+            {
+                const int c = row / outHeight, y = row - c * outHeight;
+                float input_y = halfPixel ? std::max((y + 0.5f) * scaleHeight - 0.5f, 0.0f) : y * scaleHeight;
+                int y0 = static_cast<int>(input_y);
+                const float dy = input_y - y0;
+                const T* inpData_row0 = inpPlanes.ptr<T>(c * inpHeight + y0);
+                const T* inpData_row1 = inpPlanes.ptr<T>(c * inpHeight + std::min(y0 + 1, inpHeight - 1));
+                T* outData = outPlanes.ptr<T>(row);
+                for (int x = 0; x < outWidth; ++x)
+                {
+                    const int x0 = xofs[x * 2], x1 = xofs[x * 2 + 1];
+                    outData[x] = static_cast<T>(inpData_row0[x0] +
+                        dy * (inpData_row1[x0] - inpData_row0[x0]) +
+                        xalpha[x] * (inpData_row0[x1] - inpData_row0[x0] +
+                        dy * (inpData_row1[x1] - inpData_row0[x1] - inpData_row1[x0] + inpData_row0[x0])));
+                }
+            }
+        });
+    }
+
 protected:
     int outWidth, outHeight;
     const float zoomFactorWidth, zoomFactorHeight;
@@ -564,28 +564,24 @@ public:
         const Mat& inpMat = inputs[0];
         CV_Assert(outputs.size() == finalSliceRanges.size());
 
-        if (!hasSteps)
-        {
-            for (size_t i = 0; i < outputs.size(); i++)
-            {
-                inpMat(finalSliceRanges[i]).copyTo(outputs[i]);
-            }
-        }
-        else
+        const int dimsNum = inpMat.dims;
+        std::vector<int> outShape(dimsNum);
+        std::vector<size_t> inpStep(dimsNum);
+        for (size_t i = 0; i < outputs.size(); i++)
         {
-            int dimsNum = inpMat.dims;
-
-            for (size_t i = 0; i < outputs.size(); i++)
+            const std::vector<Range>& ranges = finalSliceRanges[i];
+            const uchar* inpData = inpMat.ptr();
+            for (int d = 0; d < dimsNum; d++)
             {
-                std::vector<int> inpIdx(dimsNum, 0);
-                std::vector<int> outIdx(dimsNum, 0);
-                if (inpMat.type() == CV_16S)
-                    getSliceRecursive<int16_t>(inpMat, inpIdx, finalSliceRanges[i], sliceSteps[i], 0, dimsNum, outputs[i], outIdx);
-                else if (inpMat.type() == CV_8S)
-                    getSliceRecursive<int8_t>(inpMat, inpIdx, finalSliceRanges[i], sliceSteps[i], 0, dimsNum, outputs[i], outIdx);
-                else
-                    getSliceRecursive<float>(inpMat, inpIdx, finalSliceRanges[i], sliceSteps[i], 0, dimsNum, outputs[i], outIdx);
+                const int step = hasSteps && i < sliceSteps.size() && d < (int)sliceSteps[i].size() ? sliceSteps[i][d] : 1;
+                const Range r = ranges[d] == Range::all() ? Range(0, inpMat.size[d]) : ranges[d];
+                inpData += r.start*inpMat.step[d];
+                inpStep[d] = step*inpMat.step[d];
+                outShape[d] = (r.end - r.start + step - 1)/step;
+                CV_Assert(outShape[d] == outputs[i].size[d]);
             }
+            copyStridedNd(dimsNum, outShape.data(), inpMat.elemSize(), inpData, inpStep.data(),
+                          outputs[i].ptr(), outputs[i].step.p);
         }
     }
 
@@ -654,30 +650,6 @@ public:
         return true;
     }
 
-private:
-    template <typename T>
-    void getSliceRecursive(const Mat &inpMat, std::vector<int> &inpIdx,
-                           const std::vector<Range> &sliceRanges,
-                           const std::vector<int> &sliceSteps, int dim, int dimsNum,
-                           Mat &outputs, std::vector<int> &outIdx)
-    {
-        int begin = sliceRanges[dim].start;
-        int end = sliceRanges[dim].end;
-        int step = !sliceSteps.empty() ? sliceSteps[dim] : 1;
-
-        // TODO optimization is required (for 2D tail case at least)
-        for (int k = begin, j = 0; k < end; k += step, j++)
-        {
-            inpIdx[dim] = k;
-            outIdx[dim] = j;
-
-            if (dim + 1 < dimsNum)
-                getSliceRecursive<T>(inpMat, inpIdx, sliceRanges, sliceSteps, dim + 1, dimsNum, outputs, outIdx);
-            else
-                outputs.at<T>(outIdx.data()) = inpMat.at<T>(inpIdx.data());
-        }
-    }
-
 protected:
     // The actual non-negative values determined from @p sliceRanges depends on input size.
     std::vector<std::vector<Range> > finalSliceRanges;
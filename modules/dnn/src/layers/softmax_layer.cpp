@@ -52,6 +52,7 @@
 #include <algorithm>
 #include <stdlib.h>
 #include <opencv2/core/utils/logger.hpp>
+#include "opencv2/core/hal/hal.hpp"
 using std::max;
 
 #ifdef HAVE_OPENCL
@@ -244,70 +245,157 @@ public:
         size_t outerStep = src.total(axis);
         size_t cnStep = src.total(axis + 1);
 
-        //compute max along axis
-        for (size_t outerDim = 0; outerDim < outerSize; outerDim++)
+        if (innerSize == 1)
         {
-            size_t srcOffset = outerDim * outerStep;
-            size_t bufOffset = outerDim * cnStep;
-
-            memcpy(bufPtr + bufOffset, srcPtr + srcOffset, innerSize * sizeof(float));
-
-            for (size_t cnDim = 1; cnDim < channels; cnDim++)
+            // softmax along the contiguous last axis, one row per task
+            parallel_for_(Range(0, (int)outerSize), [&](const Range& r)
             {
-                for (size_t i = 0; i < innerSize; i++)
-                    bufPtr[bufOffset + i] = std::max(bufPtr[bufOffset + i], srcPtr[srcOffset + cnDim * cnStep + i]);
-            }
+                for (int outerDim = r.start; outerDim < r.end; outerDim++)
+                    softmaxRow(srcPtr + outerDim * outerStep, dstPtr + outerDim * outerStep, (int)channels, logSoftMax);
+            }, std::max(1., std::min((double)getNumThreads() * 4, outerSize * channels / 16384.)));
+            return;
         }
 
-        //subtract max
-        for (size_t outerDim = 0; outerDim < outerSize; outerDim++)
+        // the inner dimension is split into blocks to have enough tasks for small outer sizes
+        const int blockSize = 256;
+        const int innerBlocks = (int)((innerSize + blockSize - 1) / blockSize);
+        parallel_for_(Range(0, (int)outerSize * innerBlocks), [&](const Range& r)
         {
-            size_t srcOffset = outerDim * outerStep;
-            size_t bufOffset = outerDim * cnStep;
-
-            for (size_t cnDim = 0; cnDim < channels; cnDim++)
+            for (int task = r.start; task < r.end; task++)
             {
-                const int offset = srcOffset + cnDim * cnStep;
-                for (size_t i = 0; i < innerSize; i++)
-                    dstPtr[offset + i] = srcPtr[offset + i] - bufPtr[bufOffset + i];
-            }
-        }
-
-        cv::exp(dst, dst);
-
-        for (size_t outerDim = 0; outerDim < outerSize; outerDim++)
-        {
-            size_t srcOffset = outerDim * outerStep;
-            size_t bufOffset = outerDim * cnStep;
-
-            //sum exp along axis
-            for (size_t i = 0; i < innerSize; i++)
-                bufPtr[bufOffset + i] = 0.f;
+                const size_t outerDim = task / innerBlocks;
+                const size_t i0 = (task - outerDim * innerBlocks) * blockSize;
+                const int len = (int)std::min(innerSize - i0, (size_t)blockSize);
+                const float* src0 = srcPtr + outerDim * outerStep + i0;
+                float* dst0 = dstPtr + outerDim * outerStep + i0;
+                float* buf = bufPtr + outerDim * cnStep + i0;
+
+                //compute max along axis
+                memcpy(buf, src0, len * sizeof(float));
+                for (size_t cnDim = 1; cnDim < channels; cnDim++)
+                    softmaxMax(buf, src0 + cnDim * cnStep, len);
+
+                //subtract max and exponentiate
+                for (size_t cnDim = 0; cnDim < channels; cnDim++)
+                {
+                    float* dst = dst0 + cnDim * cnStep;
+                    softmaxSub(dst, src0 + cnDim * cnStep, buf, len);
+                    hal::exp32f(dst, dst, len);
+                }
 
-            for (size_t cnDim = 0; cnDim < channels; cnDim++)
-            {
-                const int offset = srcOffset + cnDim * cnStep;
-                for (size_t i = 0; i < innerSize; i++)
-                    bufPtr[bufOffset + i] += dstPtr[offset + i];
-            }
+                //sum exp along axis
+                memset(buf, 0, len * sizeof(float));
+                for (size_t cnDim = 0; cnDim < channels; cnDim++)
+                    softmaxAdd(buf, dst0 + cnDim * cnStep, len);
+                for (int i = 0; i < len; i++)
+                    buf[i] = 1.f / buf[i];
 
-            //divide by computed sum
-            for (size_t cnDim = 0; cnDim < channels; cnDim++)
-            {
-                const int offset = srcOffset + cnDim * cnStep;
-                for (size_t i = 0; i < innerSize; i++)
-                    dstPtr[offset + i] /= bufPtr[bufOffset + i];
-            }
-            if (logSoftMax)
-            {
+                //divide by computed sum
                 for (size_t cnDim = 0; cnDim < channels; cnDim++)
                 {
-                    const int offset = srcOffset + cnDim * cnStep;
-                    for (size_t i = 0; i < innerSize; i++)
-                        dstPtr[offset + i] = log(dstPtr[offset + i]);
+                    float* dst = dst0 + cnDim * cnStep;
+                    softmaxMul(dst, buf, len);
+                    if (logSoftMax)
+                        hal::log32f(dst, dst, len);
                 }
             }
-        }
+        }, std::max(1., std::min((double)getNumThreads() * 4, src.total() / 16384.)));
+    }
+
+    // dst = max(dst, src)
+    static void softmaxMax(float* dst, const float* src, int len)
+    {
+        int i = 0;
+#if CV_SIMD
+        for (; i <= len - v_float32::nlanes; i += v_float32::nlanes)
+            v_store(dst + i, v_max(vx_load(dst + i), vx_load(src + i)));
+#endif
+        for (; i < len; i++)
+            dst[i] = std::max(dst[i], src[i]);
+    }
+
+    // dst = src - m
+    static void softmaxSub(float* dst, const float* src, const float* m, int len)
+    {
+        int i = 0;
+#if CV_SIMD
+        for (; i <= len - v_float32::nlanes; i += v_float32::nlanes)
+            v_store(dst + i, vx_load(src + i) - vx_load(m + i));
+#endif
+        for (; i < len; i++)
+            dst[i] = src[i] - m[i];
+    }
+
+    // dst += src
+    static void softmaxAdd(float* dst, const float* src, int len)
+    {
+        int i = 0;
+#if CV_SIMD
+        for (; i <= len - v_float32::nlanes; i += v_float32::nlanes)
+            v_store(dst + i, vx_load(dst + i) + vx_load(src + i));
+#endif
+        for (; i < len; i++)
+            dst[i] += src[i];
+    }
+
+    // dst *= s
+    static void softmaxMul(float* dst, const float* s, int len)
+    {
+        int i = 0;
+#if CV_SIMD
+        for (; i <= len - v_float32::nlanes; i += v_float32::nlanes)
+            v_store(dst + i, vx_load(dst + i) * vx_load(s + i));
+#endif
+        for (; i < len; i++)
+            dst[i] *= s[i];
+    }
+
+    // softmax of a contiguous vector
+    static void softmaxRow(const float* src, float* dst, int len, bool logSoftMax)
+    {
+        float maxVal = src[0], sum = 0.f;
+        int i = 0;
+#if CV_SIMD
+        const int VECSZ = v_float32::nlanes;
+        v_float32 vmax = vx_setall_f32(maxVal);
+        for (; i <= len - VECSZ; i += VECSZ)
+            vmax = v_max(vmax, vx_load(src + i));
+        maxVal = v_reduce_max(vmax);
+#endif
+        for (; i < len; i++)
+            maxVal = std::max(maxVal, src[i]);
+
+        i = 0;
+#if CV_SIMD
+        vmax = vx_setall_f32(maxVal);
+        for (; i <= len - VECSZ; i += VECSZ)
+            v_store(dst + i, vx_load(src + i) - vmax);
+#endif
+        for (; i < len; i++)
+            dst[i] = src[i] - maxVal;
+        hal::exp32f(dst, dst, len);
+
+        i = 0;
+#if CV_SIMD
+        v_float32 vsum = vx_setzero_f32();
+        for (; i <= len - VECSZ; i += VECSZ)
+            vsum += vx_load(dst + i);
+        sum = v_reduce_sum(vsum);
+#endif
+        for (; i < len; i++)
+            sum += dst[i];
+
+        const float scale = 1.f / sum;
+        i = 0;
+#if CV_SIMD
+        v_float32 vscale = vx_setall_f32(scale);
+        for (; i <= len - VECSZ; i += VECSZ)
+            v_store(dst + i, vx_load(dst + i) * vscale);
+#endif
+        for (; i < len; i++)
+            dst[i] *= scale;
+        if (logSoftMax)
+            hal::log32f(dst, dst, len);
     }
 
 #ifdef HAVE_CUDA
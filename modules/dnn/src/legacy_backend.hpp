@@ -106,9 +106,36 @@ private:
 #endif  // HAVE_OPENCL
 
 
+// Static placement of the blobs in a single memory arena, see Net::Impl::planBlobsMemory()
+struct BlobsMemoryPlan
+{
+    BlobsMemoryPlan() : arenaSize(0), externalSize(0) {}
+
+    // Byte offsets of the blobs in the arena. Outputs of in-place layers share offsets with their inputs.
+    std::map<LayerPin, size_t> offsets;
+    // Layers which write the output to the memory of the input blob.
+    std::set<int> inPlaceLayers;
+    // Size of the arena in bytes.
+    size_t arenaSize;
+    // Size of the blobs which are not placed in the arena (network inputs), in bytes.
+    size_t externalSize;
+};
+
+
 struct BlobManager
 {
 public:
+    // Allocates the arena for the plan. The blobs of the plan are placed in the arena instead
+    // of the reuse of the released blobs. Reset by reset().
+    void setPlan(const BlobsMemoryPlan& plan_)
+    {
+        plan = plan_;
+        arena.create(1, (int)std::max(plan.arenaSize, (size_t)1), CV_8U);
+        usePlan = true;
+    }
+
+    const BlobsMemoryPlan& getPlan() const { return plan; }
+
     // Increase references counter to layer output.
     void addReference(const LayerPin& lp)
     {
@@ -182,7 +209,22 @@ public:
 
     void reuseOrCreate(const MatShape& shape, const LayerPin& lp, Mat& dst, const int& dtype)
     {
-        if (!getParam_DNN_DISABLE_MEMORY_OPTIMIZATIONS())
+        if (usePlan)
+        {
+            std::map<LayerPin, size_t>::const_iterator ofsIt = plan.offsets.find(lp);
+            if (ofsIt != plan.offsets.end())
+            {
+                CV_Assert(ofsIt->second + total(shape)*CV_ELEM_SIZE(dtype) <= arena.total());
+                // the blob shares the reference counter of the arena as a ROI does
+                Mat m((int)shape.size(), &shape[0], dtype, arena.data + ofsIt->second);
+                m.u = arena.u;
+                CV_XADD(&m.u->refcount, 1);
+                dst = m;
+                addHost(lp, dst);
+                return;
+            }
+        }
+        else if (!getParam_DNN_DISABLE_MEMORY_OPTIMIZATIONS())
         {
             Mat bestBlob;
             LayerPin bestBlobPin;
@@ -247,7 +289,9 @@ public:
         bool inPlace = false;
         if (layerShapes.supportInPlace)
         {
-            if (ld.inputBlobs.size() == 1)
+            if (usePlan)
+                inPlace = plan.inPlaceLayers.count(ld.id) != 0;
+            else if (ld.inputBlobs.size() == 1)
             {
                 // Get number of references to the input memory.
                 int numRef = numReferences(ld.inputBlobsId[0]);
@@ -311,6 +355,9 @@ public:
         refCounter.clear();
         reuseMap.clear();
         memHosts.clear();
+        plan = BlobsMemoryPlan();
+        arena.release();
+        usePlan = false;
     }
 
 private:
@@ -327,6 +374,10 @@ private:
     // For origin blobs key == value.
     std::map<LayerPin, LayerPin> reuseMap;
     std::map<LayerPin, Mat> memHosts;
+
+    BlobsMemoryPlan plan;
+    Mat arena;
+    bool usePlan = false;
 };  // BlobManager
 
 
@@ -0,0 +1,205 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+#include "mapped_file.hpp"
+
+#include <fstream>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#define OPENCV_DNN_HAVE_MMAP 1
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define OPENCV_DNN_HAVE_MMAP 1
+#else
+#define OPENCV_DNN_HAVE_MMAP 0
+#endif
+
+namespace cv { namespace dnn {
+
+namespace {
+
+// Mats referencing a part of the mapped file: the UMatData holds a reference to the MappedFile
+class MappedFileAllocator CV_FINAL : public MatAllocator
+{
+public:
+    UMatData* allocate(int, const int*, int, void*, size_t*, AccessFlag, UMatUsageFlags) const CV_OVERRIDE
+    {
+        return NULL;  // Mat::create() falls back to the default allocator
+    }
+
+    bool allocate(UMatData*, AccessFlag, UMatUsageFlags) const CV_OVERRIDE
+    {
+        return false;
+    }
+
+    void deallocate(UMatData* u) const CV_OVERRIDE
+    {
+        if (!u)
+            return;
+        CV_Assert(u->urefcount == 0);
+        CV_Assert(u->refcount == 0);
+        delete (Ptr<MappedFile>*)u->userdata;
+        u->userdata = NULL;
+        delete u;
+    }
+};
+
+MappedFileAllocator& getMappedFileAllocator()
+{
+    static MappedFileAllocator* allocator = new MappedFileAllocator();  // never destroyed, the Mats may outlive the statics
+    return *allocator;
+}
+
+}  // namespace
+
+MappedFile::MappedFile() : data_(NULL), size_(0), mapped_(false), mapBase_(NULL), mapSize_(0)
+#ifdef _WIN32
+    , mapping_(NULL)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+#if OPENCV_DNN_HAVE_MMAP
+    if (mapped_)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(mapBase_);
+        CloseHandle((HANDLE)mapping_);
+#else
+        munmap(mapBase_, mapSize_);
+#endif
+    }
+#endif
+}
+
+Ptr<MappedFile> MappedFile::open(const std::string& path, size_t offset, size_t size)
+{
+    Ptr<MappedFile> file(new MappedFile());
+    size_t fileSize = 0;
+#if OPENCV_DNN_HAVE_MMAP
+#ifdef _WIN32
+    HANDLE hfile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hfile == INVALID_HANDLE_VALUE)
+        return Ptr<MappedFile>();
+    LARGE_INTEGER fsize;
+    if (!GetFileSizeEx(hfile, &fsize))
+    {
+        CloseHandle(hfile);
+        return Ptr<MappedFile>();
+    }
+    fileSize = (size_t)fsize.QuadPart;
+    if (offset > fileSize || (size != (size_t)-1 && size > fileSize - offset))
+    {
+        CloseHandle(hfile);
+        return Ptr<MappedFile>();
+    }
+    file->size_ = size == (size_t)-1 ? fileSize - offset : size;
+    if (file->size_ > 0)
+    {
+        SYSTEM_INFO si;
+        GetSystemInfo(&si);
+        uint64_t mapOffset = offset - offset % si.dwAllocationGranularity;
+        HANDLE hmap = CreateFileMappingA(hfile, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+        if (hmap)
+        {
+            size_t mapSize = (size_t)(offset - mapOffset) + file->size_;
+            void* ptr = MapViewOfFile(hmap, FILE_MAP_COPY, (DWORD)(mapOffset >> 32), (DWORD)mapOffset, mapSize);
+            if (ptr)
+            {
+                file->mapBase_ = ptr;
+                file->mapSize_ = mapSize;
+                file->data_ = (uchar*)ptr + (offset - mapOffset);
+                file->mapping_ = hmap;
+                file->mapped_ = true;
+            }
+            else
+                CloseHandle(hmap);
+        }
+    }
+    CloseHandle(hfile);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return Ptr<MappedFile>();
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        ::close(fd);
+        return Ptr<MappedFile>();
+    }
+    fileSize = (size_t)st.st_size;
+    if (offset > fileSize || (size != (size_t)-1 && size > fileSize - offset))
+    {
+        ::close(fd);
+        return Ptr<MappedFile>();
+    }
+    file->size_ = size == (size_t)-1 ? fileSize - offset : size;
+    if (file->size_ > 0)
+    {
+        size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+        size_t mapOffset = offset - offset % pageSize;
+        size_t mapSize = offset - mapOffset + file->size_;
+        void* ptr = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, (off_t)mapOffset);
+        if (ptr != MAP_FAILED)
+        {
+            file->mapBase_ = ptr;
+            file->mapSize_ = mapSize;
+            file->data_ = (uchar*)ptr + (offset - mapOffset);
+            file->mapped_ = true;
+        }
+    }
+    ::close(fd);
+#endif
+#endif
+    if (!file->mapped_)
+    {
+        std::ifstream ifs(path.c_str(), std::ios::binary);
+        if (!ifs.is_open())
+            return Ptr<MappedFile>();
+        ifs.seekg(0, std::ios::end);
+        fileSize = (size_t)ifs.tellg();
+        if (offset > fileSize || (size != (size_t)-1 && size > fileSize - offset))
+            return Ptr<MappedFile>();
+        file->size_ = size == (size_t)-1 ? fileSize - offset : size;
+        file->buffer_.resize(file->size_);
+        ifs.seekg((std::streamoff)offset, std::ios::beg);
+        if (file->size_ > 0 && !ifs.read((char*)file->buffer_.data(), file->size_))
+            return Ptr<MappedFile>();
+        file->data_ = file->buffer_.data();
+    }
+    return file;
+}
+
+Mat MappedFile::wrap(const Ptr<MappedFile>& file, size_t offset, int dims, const int* sizes, int type)
+{
+    CV_Assert(file);
+    Mat m(dims, sizes, type, (void*)(file->data_ + offset));
+    size_t nbytes = m.total()*m.elemSize();
+    CV_Assert(offset <= file->size_ && nbytes <= file->size_ - offset);
+    if (nbytes == 0)
+        return Mat(dims, sizes, type);
+
+    MappedFileAllocator& allocator = getMappedFileAllocator();
+    UMatData* u = new UMatData(&allocator);
+    u->data = u->origdata = m.data;
+    u->size = nbytes;
+    u->userdata = new Ptr<MappedFile>(file);
+    m.allocator = &allocator;
+    m.u = u;
+    m.addref();
+    return m;
+}
+
+}}  // namespace cv::dnn
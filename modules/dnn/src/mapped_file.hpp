@@ -0,0 +1,47 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_DNN_SRC_MAPPED_FILE_HPP
+#define OPENCV_DNN_SRC_MAPPED_FILE_HPP
+
+#include <opencv2/core.hpp>
+
+namespace cv { namespace dnn {
+
+// Read-only view of the file contents. The file is memory-mapped where the platform allows it
+// (copy-on-write, so writes through the wrapped Mats never reach the file), otherwise it is read into memory.
+class MappedFile
+{
+public:
+    ~MappedFile();
+
+    // Maps the range [offset, offset + size) of the file, by default the whole file.
+    // Returns an empty pointer if the file can't be opened or the range is out of the file.
+    static Ptr<MappedFile> open(const std::string& path, size_t offset = 0, size_t size = (size_t)-1);
+
+    const uchar* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool isMapped() const { return mapped_; }
+
+    // Wraps the region [offset, offset + total(sizes)*elemSize) of the mapped range into a Mat without copying.
+    // The Mat (and all its copies) keeps the file mapped.
+    static Mat wrap(const Ptr<MappedFile>& file, size_t offset, int dims, const int* sizes, int type);
+
+private:
+    MappedFile();
+
+    uchar* data_;
+    size_t size_;
+    bool mapped_;
+    void* mapBase_;              // start and size of the mapping, which begins at a page boundary
+    size_t mapSize_;
+    std::vector<uchar> buffer_;  // the file contents when the file is not mapped
+#ifdef _WIN32
+    void* mapping_;
+#endif
+};
+
+}}  // namespace cv::dnn
+
+#endif  // OPENCV_DNN_SRC_MAPPED_FILE_HPP
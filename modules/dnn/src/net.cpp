@@ -417,5 +417,13 @@ int64 Net::getPerfProfile(std::vector<double>& timings)
     return impl->getPerfProfile(timings);
 }
 
+int64 Net::getPerfProfile(std::vector<double>& timings, std::vector<int>& branches,
+        std::vector<double>& branchTimings)
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(impl);
+    return impl->getPerfProfile(timings, branches, branchTimings);
+}
+
 CV__DNN_INLINE_NS_END
 }}  // namespace cv::dnn
@@ -32,7 +32,7 @@ std::string detail::NetImplBase::getDumpFileNameBase() const
 
 Net::Impl::~Impl()
 {
-    // nothing
+    waitAsyncRequests();
 }
 
 
@@ -49,6 +49,12 @@ Net::Impl::Impl()
 
     lastLayerId = 0;
     netWasAllocated = false;
+    allocationCounter = 0;
+    warmupAllocationCounter = -1;
+    warmupLastLayerId = -1;
+    parallelLayers = false;
+    layersRanConcurrently = false;
+    forwardTicks = 0;
     netWasQuantized = false;
     fusion = true;
     isAsync = false;
@@ -69,6 +75,8 @@ void Net::Impl::clear()
 {
     CV_TRACE_FUNCTION();
 
+    waitAsyncRequests();
+
     MapIdToLayerData::iterator it;
     for (it = layers.begin(); it != layers.end(); it++)
     {
@@ -133,6 +141,7 @@ void Net::Impl::setUpNet(const std::vector<LayerPin>& blobsToKeep_)
 
     if (!netWasAllocated || this->blobsToKeep != blobsToKeep_)
     {
+        waitAsyncRequests();  // the layers are shared with the running requests
         if (preferableBackend == DNN_BACKEND_OPENCV && IS_DNN_OPENCL_TARGET(preferableTarget))
 #ifndef HAVE_OPENCL
         {
@@ -551,10 +560,284 @@ void Net::Impl::allocateLayer(int lid, const LayersShapesMap& layersShapes)
 }
 
 
+void Net::Impl::getAllocationOrder(std::vector<int>& order) const
+{
+    order.clear();
+    std::set<int> done;
+    // depth-first traversal, the inputs in the ascending order of the ids as allocateLayer() does
+    std::vector<std::pair<int, bool> > stack;
+    for (MapIdToLayerData::const_reverse_iterator it = layers.rbegin(); it != layers.rend(); ++it)
+        stack.push_back(std::make_pair(it->first, false));
+    while (!stack.empty())
+    {
+        std::pair<int, bool> item = stack.back();
+        stack.pop_back();
+        if (done.count(item.first))
+            continue;
+        if (item.second)
+        {
+            done.insert(item.first);
+            order.push_back(item.first);
+            continue;
+        }
+        stack.push_back(std::make_pair(item.first, true));
+        const LayerData& ld = layers.find(item.first)->second;
+        std::set<int> inputLayers;
+        for (size_t i = 0; i < ld.inputBlobsId.size(); i++)
+            inputLayers.insert(ld.inputBlobsId[i].lid);
+        for (std::set<int>::const_reverse_iterator i = inputLayers.rbegin(); i != inputLayers.rend(); ++i)
+            stack.push_back(std::make_pair(*i, false));
+    }
+}
+
+
+namespace {
+
+// alignment of the blobs in the memory arena, bytes
+const size_t BLOB_ALIGN = 64;
+
+// Memory of a blob and of the outputs of the in-place layers which reuse it
+struct PlannedBuffer
+{
+    size_t size;
+    int start, end;  // the first and the last allocation steps which use the memory
+    bool external;   // network input, not placed in the arena
+    size_t offset;
+    std::vector<int> users;  // allocation steps of the layers which write or read the memory
+};
+
+// ancestors[i][j] is true if the layer of the allocation step i depends on the layer of the step j
+typedef std::vector<std::vector<bool> > LayersAncestors;
+
+// The buffers may share the memory if their lifetimes do not intersect. For the concurrent execution
+// (non-empty ancestors) the earlier buffer must also be released by the layers which all precede
+// the first writer of the later one, otherwise the layers of the independent branches may use
+// the memory at the same time.
+static bool buffersConflict(const PlannedBuffer& a, const PlannedBuffer& b, const LayersAncestors& ancestors)
+{
+    if (a.start <= b.end && b.start <= a.end)
+        return true;
+    if (ancestors.empty())
+        return false;
+    const PlannedBuffer& first = a.end < b.start ? a : b;
+    const PlannedBuffer& second = a.end < b.start ? b : a;
+    const std::vector<bool>& precede = ancestors[second.start];
+    for (size_t i = 0; i < first.users.size(); i++)
+    {
+        if (!precede[first.users[i]])
+            return true;
+    }
+    return false;
+}
+
+// Greedy by size offset assignment: the largest buffers are placed first, every buffer takes
+// the tightest gap which fits it between the already placed buffers it conflicts with
+static size_t assignBufferOffsets(std::vector<PlannedBuffer>& buffers, const LayersAncestors& ancestors)
+{
+    std::vector<int> order;
+    for (int i = 0; i < (int)buffers.size(); i++)
+    {
+        if (!buffers[i].external)
+            order.push_back(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return buffers[a].size > buffers[b].size; });
+
+    size_t arenaSize = 0;
+    std::vector<std::pair<size_t, size_t> > busy;
+    for (size_t k = 0; k < order.size(); k++)
+    {
+        PlannedBuffer& buf = buffers[order[k]];
+        busy.clear();
+        for (size_t j = 0; j < k; j++)
+        {
+            const PlannedBuffer& other = buffers[order[j]];
+            if (buffersConflict(buf, other, ancestors))
+                busy.push_back(std::make_pair(other.offset, other.offset + other.size));
+        }
+        std::sort(busy.begin(), busy.end());
+
+        size_t ofs = 0, bestOfs = 0, bestGap = std::numeric_limits<size_t>::max();
+        bool found = false;
+        for (size_t j = 0; j < busy.size(); j++)
+        {
+            if (busy[j].first >= ofs + buf.size && busy[j].first - ofs < bestGap)
+            {
+                bestOfs = ofs;
+                bestGap = busy[j].first - ofs;
+                found = true;
+            }
+            ofs = std::max(ofs, busy[j].second);
+        }
+        buf.offset = found ? bestOfs : ofs;
+        arenaSize = std::max(arenaSize, buf.offset + buf.size);
+    }
+    return arenaSize;
+}
+
+}  // namespace
+
+
+void Net::Impl::planBlobsMemory(const LayersShapesMap& layersShapes, const std::vector<LayerPin>& blobsToKeep_,
+                                bool concurrentLayers, BlobsMemoryPlan& plan) const
+{
+    CV_TRACE_FUNCTION();
+
+    plan = BlobsMemoryPlan();
+
+    std::vector<int> order;
+    getAllocationOrder(order);
+    const int nsteps = (int)order.size();
+
+    LayersAncestors ancestors;
+    if (concurrentLayers)
+    {
+        std::map<int, int> stepOf;
+        for (int step = 0; step < nsteps; step++)
+            stepOf[order[step]] = step;
+        ancestors.assign(nsteps, std::vector<bool>(nsteps, false));
+        for (int step = 0; step < nsteps; step++)
+        {
+            const LayerData& ld = layers.find(order[step])->second;
+            std::vector<bool>& anc = ancestors[step];
+            for (size_t i = 0; i < ld.inputBlobsId.size(); i++)
+            {
+                int inputStep = stepOf[ld.inputBlobsId[i].lid];
+                const std::vector<bool>& inputAnc = ancestors[inputStep];
+                for (int j = 0; j < inputStep; j++)
+                    anc[j] = anc[j] || inputAnc[j];
+                anc[inputStep] = true;
+            }
+        }
+    }
+
+    // the same references as allocateLayers() adds to BlobManager
+    std::map<LayerPin, int> refs;
+    LayersShapesMap::const_iterator inputShapesIt = layersShapes.find(0);
+    CV_Assert(inputShapesIt != layersShapes.end());
+    for (int i = 0; i < (int)inputShapesIt->second.out.size(); i++)
+        refs[LayerPin(0, i)]++;
+    for (MapIdToLayerData::const_iterator it = layers.begin(); it != layers.end(); ++it)
+    {
+        for (size_t i = 0; i < it->second.inputBlobsId.size(); i++)
+            refs[it->second.inputBlobsId[i]]++;
+    }
+    for (size_t i = 0; i < blobsToKeep_.size(); i++)
+        refs[blobsToKeep_[i]]++;
+
+    std::vector<PlannedBuffer> buffers;
+    std::vector<int> bufferRefs;
+    std::vector<bool> keepAlive;
+    std::map<LayerPin, int> bufferOf;
+    // the step since which the outputs of the layer may be written: fuseLayers() makes a layer
+    // with the only consumer write directly to the outputs of that consumer
+    std::map<int, int> firstWriteStep;
+
+    for (int step = 0; step < nsteps; step++)
+    {
+        const LayerData& ld = layers.find(order[step])->second;
+        LayersShapesMap::const_iterator shapesIt = layersShapes.find(ld.id);
+        CV_Assert(shapesIt != layersShapes.end());
+        const ShapesVec& outShapes = shapesIt->second.out;
+        const ShapesVec& internalShapes = shapesIt->second.internal;
+        const size_t elemSize = CV_ELEM_SIZE(ld.dtype);
+
+        // the same condition as BlobManager checks: the layer is the only user of the input memory
+        bool inPlace = false;
+        if (ld.id != 0 && shapesIt->second.supportInPlace && ld.inputBlobsId.size() == 1)
+        {
+            std::map<LayerPin, int>::const_iterator it = bufferOf.find(ld.inputBlobsId[0]);
+            inPlace = it != bufferOf.end() && bufferRefs[it->second] == 1;
+        }
+        if (inPlace)
+            plan.inPlaceLayers.insert(ld.id);
+
+        // a fusable layer which does not work in-place gets the output of the fused producer
+        int start = step;
+        if (!inPlace && ld.id != 0 && shapesIt->second.supportInPlace && ld.inputBlobsId.size() == 1)
+        {
+            const LayerData& inp = layers.find(ld.inputBlobsId[0].lid)->second;
+            if (inp.id != 0 && inp.consumers.size() == 1)
+                start = firstWriteStep[inp.id];
+        }
+        firstWriteStep[ld.id] = start;
+
+        const int numOutputs = (int)std::max((size_t)1, outShapes.size());
+        for (size_t i = 0; i < outShapes.size() + internalShapes.size(); i++)
+        {
+            const bool isOutput = i < outShapes.size();
+            const MatShape& shape = isOutput ? outShapes[i] : internalShapes[i - outShapes.size()];
+            if (!total(shape))
+                continue;
+
+            LayerPin pin(ld.id, isOutput ? (int)i : numOutputs + (int)(i - outShapes.size()));
+            int b;
+            if (isOutput && inPlace)
+            {
+                b = bufferOf[ld.inputBlobsId[0]];
+                buffers[b].users.push_back(step);
+            }
+            else
+            {
+                b = (int)buffers.size();
+                PlannedBuffer buf;
+                buf.size = alignSize(total(shape)*elemSize, BLOB_ALIGN);
+                buf.start = isOutput ? start : step;
+                buf.end = step;
+                buf.external = ld.id == 0;
+                buf.offset = 0;
+                buf.users.push_back(buf.start);
+                if (buf.start != step)
+                    buf.users.push_back(step);
+                buffers.push_back(buf);
+                bufferRefs.push_back(0);
+                keepAlive.push_back(false);
+            }
+            bufferOf[pin] = b;
+
+            // internal blobs are released right after the layer, outputs without consumers are kept
+            std::map<LayerPin, int>::const_iterator refIt = refs.find(pin);
+            int nrefs = isOutput ? (refIt != refs.end() ? refIt->second : 0) : 1;
+            bufferRefs[b] += nrefs;
+            if (isOutput && nrefs == 0)
+                keepAlive[b] = true;
+        }
+
+        std::vector<LayerPin> released(ld.inputBlobsId);
+        for (size_t i = 0; i < internalShapes.size(); i++)
+            released.push_back(LayerPin(ld.id, numOutputs + (int)i));
+        for (size_t i = 0; i < released.size(); i++)
+        {
+            std::map<LayerPin, int>::const_iterator it = bufferOf.find(released[i]);
+            if (it == bufferOf.end())
+                continue;
+            buffers[it->second].users.push_back(step);
+            if (--bufferRefs[it->second] == 0)
+                buffers[it->second].end = step;
+        }
+    }
+
+    for (size_t b = 0; b < buffers.size(); b++)
+    {
+        if (keepAlive[b] || bufferRefs[b] > 0)
+            buffers[b].end = nsteps;
+        if (buffers[b].external)
+            plan.externalSize += buffers[b].size;
+    }
+    plan.arenaSize = assignBufferOffsets(buffers, ancestors);
+    for (std::map<LayerPin, int>::const_iterator it = bufferOf.begin(); it != bufferOf.end(); ++it)
+    {
+        if (!buffers[it->second].external)
+            plan.offsets[it->first] = buffers[it->second].offset;
+    }
+}
+
+
 void Net::Impl::allocateLayers(const std::vector<LayerPin>& blobsToKeep_)
 {
     CV_TRACE_FUNCTION();
 
+    allocationCounter++;
+    layersStages.clear();
     for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); it++)
         it->second.flag = 0;
 
@@ -578,6 +861,20 @@ void Net::Impl::allocateLayers(const std::vector<LayerPin>& blobsToKeep_)
     blobManager.reset();
     backendWrappers.clear();
 
+    // the blobs memory is planned for the execution mode, so the mode is fixed until the next allocation
+    parallelLayers = preferableBackend == DNN_BACKEND_OPENCV && preferableTarget == DNN_TARGET_CPU &&
+                     getParam_DNN_PARALLEL_LAYERS();
+
+    // on CPU all the blobs are placed in a single arena by the lifetimes known in advance
+    if (preferableBackend == DNN_BACKEND_OPENCV && preferableTarget == DNN_TARGET_CPU &&
+        !getParam_DNN_DISABLE_MEMORY_OPTIMIZATIONS())
+    {
+        BlobsMemoryPlan plan;
+        planBlobsMemory(layersShapes, blobsToKeep_, parallelLayers, plan);
+        blobManager.setPlan(plan);
+        CV_LOG_DEBUG(NULL, "DNN: blobs memory arena: " << plan.arenaSize << " bytes");
+    }
+
     for (auto& layer : layers)
     {
         auto& ld = layer.second;
@@ -858,6 +1155,9 @@ void Net::Impl::forwardToLayer(LayerData& ld, bool clearFlags)
 {
     CV_TRACE_FUNCTION();
 
+    // the layers are shared with the asynchronous passes and not all of them are re-entrant
+    waitAsyncRequests();
+
     if (clearFlags)
     {
         for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end(); it++)
@@ -868,18 +1168,31 @@ void Net::Impl::forwardToLayer(LayerData& ld, bool clearFlags)
     if (ld.flag)
         return;
 
+    TickMeter tm;
+    tm.start();
+
     // forward parents
-    for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end() && (it->second.id < ld.id); ++it)
+    if (parallelLayers && !isAsync)
     {
-        LayerData& ld = it->second;
-        if (ld.flag)
-            continue;
-        forwardLayer(ld);
+        forwardLayersConcurrently(ld.id);
+    }
+    else
+    {
+        for (MapIdToLayerData::iterator it = layers.begin(); it != layers.end() && (it->second.id < ld.id); ++it)
+        {
+            LayerData& ld = it->second;
+            if (ld.flag)
+                continue;
+            forwardLayer(ld);
+        }
     }
 
     // forward itself
     forwardLayer(ld);
 
+    tm.stop();
+    forwardTicks = (clearFlags ? 0 : forwardTicks) + tm.getTimeTicks();
+
 #ifdef HAVE_CUDA
     if (preferableBackend == DNN_BACKEND_CUDA)
         cudaInfo->context.stream.synchronize();
@@ -887,6 +1200,233 @@ void Net::Impl::forwardToLayer(LayerData& ld, bool clearFlags)
 }
 
 
+// Checks if the elements of the blobs may share the memory. The blobs which are the disjoint regions of
+// the same buffer (the inputs of Concat written directly to its output) are told apart by their indices.
+static bool blobsOverlap(const Mat& a, const Mat& b)
+{
+    if (a.datastart != b.datastart || a.dims != b.dims || a.dims == 0)
+        return a.datastart < b.dataend && b.datastart < a.dataend;
+    for (int i = 0; i < a.dims; i++)
+    {
+        if (a.step.p[i] != b.step.p[i])
+            return true;
+    }
+    if (a.isContinuous() && b.isContinuous())
+        return a.data < b.data + b.total()*b.elemSize() && b.data < a.data + a.total()*a.elemSize();
+    // the regions of the buffer are disjoint if their ranges of indices are disjoint along any axis
+    size_t aofs = a.data - a.datastart, bofs = b.data - b.datastart;
+    for (int i = 0; i < a.dims; i++)
+    {
+        size_t step = a.step.p[i];
+        size_t aidx = aofs/step, bidx = bofs/step;
+        aofs -= aidx*step;
+        bofs -= bidx*step;
+        if (aidx + a.size.p[i] <= bidx || bidx + b.size.p[i] <= aidx)
+            return false;
+    }
+    return true;
+}
+
+void buildBlobsDependencies(const std::vector<std::vector<const Mat*> >& reads,
+        const std::vector<std::vector<const Mat*> >& writes,
+        std::vector<std::vector<int> >& successors, std::vector<int>& numDependencies)
+{
+    CV_Assert(reads.size() == writes.size());
+    const int n = (int)reads.size();
+    successors.assign(n, std::vector<int>());
+    numDependencies.assign(n, 0);
+
+    struct Access
+    {
+        const Mat* blob;
+        bool write;
+    };
+    std::vector<std::vector<Access> > accesses(n);
+    for (int i = 0; i < n; i++)
+    {
+        for (int k = 0; k < 2; k++)
+        {
+            const std::vector<const Mat*>& blobs = k == 0 ? reads[i] : writes[i];
+            for (size_t j = 0; j < blobs.size(); j++)
+            {
+                if (!blobs[j] || blobs[j]->empty())
+                    continue;
+                Access a = { blobs[j], k == 1 };
+                accesses[i].push_back(a);
+            }
+        }
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = 0; j < i; j++)
+        {
+            bool conflict = false;
+            for (size_t a = 0; a < accesses[i].size() && !conflict; a++)
+            {
+                const Access& ai = accesses[i][a];
+                for (size_t b = 0; b < accesses[j].size() && !conflict; b++)
+                {
+                    const Access& aj = accesses[j][b];
+                    conflict = (ai.write || aj.write) && blobsOverlap(*ai.blob, *aj.blob);
+                }
+            }
+            if (conflict)
+            {
+                successors[j].push_back(i);
+                numDependencies[i]++;
+            }
+        }
+    }
+}
+
+
+namespace {
+
+// Layers cheaper than this are not worth to be parallelized inside,
+// so they run concurrently with the other layers of the same stage.
+// Zero FLOPS is what the layers without an estimate report, they are not considered small.
+static const int64 SMALL_LAYER_FLOPS = 1 << 24;
+
+class ParallelLayers : public ParallelLoopBody
+{
+public:
+    ParallelLayers(Net::Impl& net_, const std::vector<LayerData*>& layers_)
+        : net(net_), layers(layers_) {}
+
+    void operator()(const Range& r) const CV_OVERRIDE
+    {
+        for (int i = r.start; i < r.end; i++)
+            net.forwardLayer(*layers[i]);
+    }
+
+private:
+    Net::Impl& net;
+    const std::vector<LayerData*>& layers;
+};
+
+}  // namespace
+
+
+void Net::Impl::getLayersStages(int lastLid, std::vector<LayersStage>& stages) const
+{
+    std::vector<int> lids;
+    std::vector<std::vector<const Mat*> > reads, writes;
+    for (MapIdToLayerData::const_iterator it = layers.begin(); it != layers.end() && it->first < lastLid; ++it)
+    {
+        const LayerData& ld = it->second;
+        lids.push_back(ld.id);
+        reads.push_back(std::vector<const Mat*>());
+        writes.push_back(std::vector<const Mat*>());
+        if (ld.skip)
+            continue;
+        if (ld.id == 0)
+        {
+            for (size_t i = 0; i < netInputLayer->inputsData.size(); i++)
+                reads.back().push_back(&netInputLayer->inputsData[i]);
+        }
+        for (size_t i = 0; i < ld.inputBlobs.size(); i++)
+            reads.back().push_back(ld.inputBlobs[i]);
+        for (size_t i = 0; i < ld.outputBlobs.size(); i++)
+            writes.back().push_back(&ld.outputBlobs[i]);
+        for (size_t i = 0; i < ld.internals.size(); i++)
+            writes.back().push_back(&ld.internals[i]);
+    }
+
+    std::vector<std::vector<int> > successors;
+    std::vector<int> numDependencies;
+    buildBlobsDependencies(reads, writes, successors, numDependencies);
+
+    // a stage of a layer is the longest path to it, so the layers of a stage do not depend on each other
+    std::vector<int> stage(lids.size(), 0);
+    stages.clear();
+    for (size_t i = 0; i < lids.size(); i++)
+    {
+        if (stages.size() <= (size_t)stage[i])
+            stages.resize(stage[i] + 1);
+        for (size_t j = 0; j < successors[i].size(); j++)
+        {
+            int k = successors[i][j];
+            stage[k] = std::max(stage[k], stage[i] + 1);
+        }
+
+        const LayerData& ld = layers.find(lids[i])->second;
+        bool small = false;
+        if (!ld.skip && ld.id != 0)
+        {
+            std::vector<MatShape> inputShapes(ld.inputBlobs.size()), outputShapes(ld.outputBlobs.size());
+            for (size_t j = 0; j < ld.inputBlobs.size(); j++)
+                inputShapes[j] = shape(*ld.inputBlobs[j]);
+            for (size_t j = 0; j < ld.outputBlobs.size(); j++)
+                outputShapes[j] = shape(ld.outputBlobs[j]);
+            int64 flops = ld.layerInstance->getFLOPS(inputShapes, outputShapes);
+            small = flops > 0 && flops < SMALL_LAYER_FLOPS;
+        }
+        (small ? stages[stage[i]].concurrent : stages[stage[i]].sequential).push_back(ld.id);
+    }
+
+    for (size_t i = 0; i < stages.size(); i++)
+    {
+        LayersStage& st = stages[i];
+        if (st.concurrent.size() == 1)
+        {
+            st.sequential.push_back(st.concurrent[0]);
+            st.concurrent.clear();
+        }
+    }
+}
+
+
+void Net::Impl::forwardLayersConcurrently(int lastLid)
+{
+    CV_TRACE_FUNCTION();
+
+    std::map<int, std::vector<LayersStage> >::const_iterator it = layersStages.find(lastLid);
+    if (it == layersStages.end())
+    {
+        std::vector<LayersStage> stages;
+        getLayersStages(lastLid, stages);
+        it = layersStages.insert(std::make_pair(lastLid, stages)).first;
+    }
+    const std::vector<LayersStage>& stages = it->second;
+
+    // Small layers of a stage run concurrently, every one in a single thread: nested parallel_for_()
+    // calls are executed sequentially, so the layers share the threads of the pool without oversubscription.
+    // Large layers keep running one by one using the whole pool.
+    const bool parallel = getNumThreads() > 1;
+    layersRanConcurrently = false;
+    std::vector<LayerData*> concurrent;
+    for (size_t s = 0; s < stages.size(); s++)
+    {
+        const LayersStage& stage = stages[s];
+        for (size_t i = 0; i < stage.sequential.size(); i++)
+        {
+            LayerData& ld = layers[stage.sequential[i]];
+            if (!ld.flag)
+                forwardLayer(ld);
+        }
+
+        concurrent.clear();
+        for (size_t i = 0; i < stage.concurrent.size(); i++)
+        {
+            LayerData& ld = layers[stage.concurrent[i]];
+            if (!ld.flag)
+                concurrent.push_back(&ld);
+        }
+        if (parallel && concurrent.size() > 1)
+        {
+            parallel_for_(Range(0, (int)concurrent.size()), ParallelLayers(*this, concurrent), (double)concurrent.size());
+            layersRanConcurrently = true;
+        }
+        else
+        {
+            for (size_t i = 0; i < concurrent.size(); i++)
+                forwardLayer(*concurrent[i]);
+        }
+    }
+}
+
+
 Mat Net::Impl::forward(const String& outputName)
 {
     CV_Assert(!empty());
@@ -924,11 +1464,14 @@ AsyncArray Net::Impl::forwardAsync(const String& outputName)
         layerName = layerNames.back();
     }
 
+    if (preferableBackend == DNN_BACKEND_OPENCV && preferableTarget == DNN_TARGET_CPU)
+        return forwardAsyncCPU(layerName);
+
     std::vector<LayerPin> pins(1, getPinByAlias(layerName));
     setUpNet(pins);
 
     if (preferableBackend != DNN_BACKEND_INFERENCE_ENGINE_NGRAPH)
-        CV_Error(Error::StsNotImplemented, "DNN: Asynchronous forward is supported for Inference Engine backend only");
+        CV_Error(Error::StsNotImplemented, "DNN: Asynchronous forward is supported for OpenCV backend on CPU and Inference Engine backend only");
 
     isAsync = true;
     forwardToLayer(getLayerData(layerName));
@@ -1993,16 +2536,75 @@ void Net::Impl::getMemoryConsumption(
         weights += w[i];
         blobs += b[i];
     }
+
+    // the blobs share the memory as allocateLayers() places them, the same conditions apply
+    if (preferableBackend == DNN_BACKEND_OPENCV && preferableTarget == DNN_TARGET_CPU &&
+        !getParam_DNN_DISABLE_MEMORY_OPTIMIZATIONS())
+    {
+        LayersShapesMap layersShapes;
+        getLayersShapes(netInputShapes, layersShapes);
+        BlobsMemoryPlan plan;
+        planBlobsMemory(layersShapes, blobsToKeep, getParam_DNN_PARALLEL_LAYERS(), plan);
+        blobs = plan.arenaSize + plan.externalSize;
+    }
 }
 
 
 int64 Net::Impl::getPerfProfile(std::vector<double>& timings) const
 {
     timings = std::vector<double>(layersTimings.begin() + 1, layersTimings.end());
+    if (layersRanConcurrently)
+        return forwardTicks;  // the sum of the layers timings exceeds the wall time
     int64 total = (int64)std::accumulate(timings.begin(), timings.end(), 0.0);
     return total;
 }
 
+int64 Net::Impl::getPerfProfile(std::vector<double>& timings, std::vector<int>& branches,
+        std::vector<double>& branchTimings) const
+{
+    int64 total = getPerfProfile(timings);
+
+    // A branch is a chain of layers where every layer has a single producer
+    // which has no other consumers. The branches without dependencies between each other run concurrently.
+    std::map<int, std::set<int> > producers, consumers;
+    for (MapIdToLayerData::const_iterator it = layers.begin(); it != layers.end(); ++it)
+    {
+        const LayerData& ld = it->second;
+        for (size_t i = 0; i < ld.inputBlobsId.size(); i++)
+        {
+            producers[ld.id].insert(ld.inputBlobsId[i].lid);
+            consumers[ld.inputBlobsId[i].lid].insert(ld.id);
+        }
+    }
+
+    branches.assign(timings.size(), -1);
+    branchTimings.clear();
+    std::map<int, int> layerBranch;
+    for (MapIdToLayerData::const_iterator it = layers.begin(); it != layers.end(); ++it)
+    {
+        const int lid = it->first;
+        if (lid == 0 || lid > (int)timings.size())
+            continue;
+        const std::set<int>& inps = producers[lid];
+        int branch = -1;
+        if (inps.size() == 1)
+        {
+            int from = *inps.begin();
+            if (from != 0 && consumers[from].size() == 1 && layerBranch.count(from))
+                branch = layerBranch[from];
+        }
+        if (branch < 0)
+        {
+            branch = (int)branchTimings.size();
+            branchTimings.push_back(0);
+        }
+        layerBranch[lid] = branch;
+        branches[lid - 1] = branch;
+        branchTimings[branch] += timings[lid - 1];
+    }
+    return total;
+}
+
 void Net::Impl::getMemoryConsumption(
         const std::vector<MatShape>& netInputShapes,
         std::vector<int>& layerIds, std::vector<size_t>& weights,
@@ -61,6 +61,9 @@ struct Net::Impl : public detail::NetImplBase
     int lastLayerId;
 
     bool netWasAllocated;
+    int allocationCounter;  // incremented on each allocateLayers() call, invalidates InferRequest objects
+    int warmupAllocationCounter;  // the allocation and the last layer of the InferRequest warm-up pass
+    int warmupLastLayerId;
     bool netWasQuantized;
     bool fusion;
     bool isAsync;  // FIXIT: drop
@@ -216,10 +219,31 @@ struct Net::Impl : public detail::NetImplBase
 
     void allocateLayers(const std::vector<LayerPin>& blobsToKeep_);
 
+    // Layer ids in the order of allocateLayer() calls: every layer goes after its inputs.
+    void getAllocationOrder(std::vector<int>& order) const;
+    // Assigns the arena offsets to the blobs of all layers from their lifetimes in the allocation order.
+    // With concurrentLayers the memory is shared only by the blobs of the layers depending on each other,
+    // so the layers which may run at the same time never use the same memory.
+    void planBlobsMemory(const LayersShapesMap& layersShapes, const std::vector<LayerPin>& blobsToKeep_,
+                         bool concurrentLayers, BlobsMemoryPlan& plan) const;
+
     virtual void forwardLayer(LayerData& ld);
 
     void forwardToLayer(LayerData& ld, bool clearFlags = true);
 
+    // Layers preceding the target one split to the stages of the layers independent from each other.
+    struct LayersStage
+    {
+        std::vector<int> sequential;  // skipped and large layers
+        std::vector<int> concurrent;  // small layers running at the same time
+    };
+    void getLayersStages(int lastLid, std::vector<LayersStage>& stages) const;
+    void forwardLayersConcurrently(int lastLid);
+    std::map<int, std::vector<LayersStage> > layersStages;  // by the target layer id, reset on allocation
+    bool parallelLayers;  // the blobs are allocated for the concurrent execution of the layers
+    bool layersRanConcurrently;
+    int64 forwardTicks;  // wall time of the last forward pass
+
     Mat forward(const String& outputName);
     AsyncArray forwardAsync(const String& outputName);
     void forward(OutputArrayOfArrays outputBlobs, const String& outputName);
@@ -228,6 +252,15 @@ struct Net::Impl : public detail::NetImplBase
     void forward(std::vector<std::vector<Mat>>& outputBlobs,
             const std::vector<String>& outBlobNames);
 
+    Ptr<InferRequest::Impl> createInferRequest(const std::vector<String>& outBlobNames);
+    std::map<int, Ptr<Mutex> > layerForwardMutexes;  // by the layer id, shared by all the requests
+
+    // asynchronous forward on CPU, the passes run by InferRequest contexts owned by the network
+    struct AsyncRequests;
+    Ptr<AsyncRequests> asyncRequests;
+    AsyncArray forwardAsyncCPU(const String& layerName);
+    void waitAsyncRequests();
+
 
     void getLayerShapesRecursively(int id, LayersShapesMap& inOutShapes);
 
@@ -263,6 +296,8 @@ struct Net::Impl : public detail::NetImplBase
             std::vector<int>& layerIds, std::vector<size_t>& weights,
             std::vector<size_t>& blobs) /*const*/;
     int64 getPerfProfile(std::vector<double>& timings) const;
+    int64 getPerfProfile(std::vector<double>& timings, std::vector<int>& branches,
+            std::vector<double>& branchTimings) const;
 
     // TODO drop
     LayerPin getLatestLayerPin(const std::vector<LayerPin>& pins) const;
@@ -289,6 +324,20 @@ struct Net::Impl : public detail::NetImplBase
 };  // Net::Impl
 
 
+/** @brief Builds the execution order constraints of the steps accessing the blobs.
+ *
+ * A step depends on every preceding one accessing the same memory, unless both of them only read it,
+ * so the steps which do not depend on each other may run at the same time.
+ * @param reads blobs read by each step
+ * @param writes blobs written by each step (outputs and internals)
+ * @param successors steps which depend on each step
+ * @param numDependencies number of steps each step depends on
+ */
+void buildBlobsDependencies(const std::vector<std::vector<const Mat*> >& reads,
+        const std::vector<std::vector<const Mat*> >& writes,
+        std::vector<std::vector<int> >& successors, std::vector<int>& numDependencies);
+
+
 CV__DNN_INLINE_NS_END
 }}  // namespace cv::dnn
 #endif  // __OPENCV_DNN_SRC_NET_IMPL_HPP__
@@ -10,6 +10,7 @@
 #include "../graph_simplifier.hpp"
 #include "onnx_graph_simplifier.hpp"
 
+#include <opencv2/core/utils/filesystem.hpp>
 #include <opencv2/core/utils/logger.hpp>
 #include <queue>
 
@@ -61,7 +62,8 @@ public:
 class ONNXGraphWrapper : public ImportGraphWrapper
 {
 public:
-    ONNXGraphWrapper(opencv_onnx::GraphProto& _net) : net(_net)
+    ONNXGraphWrapper(opencv_onnx::GraphProto& _net, ONNXExternalData* _externalData)
+        : net(_net), externalData(_externalData)
     {
         numInputs = net.input_size();
         numInitializers = net.initializer_size();
@@ -105,9 +107,35 @@ public:
         net.mutable_node()->DeleteSubrange(idx - numInputs - numInitializers, 1);
     }
 
+    // Returns the tensor of an initializer or of a Constant node output, NULL for other tensors.
+    const opencv_onnx::TensorProto* getConstantTensor(const std::string& name) const
+    {
+        for (int i = 0; i < numInitializers; i++)
+        {
+            if (net.initializer(i).name() == name)
+                return &net.initializer(i);
+        }
+        for (int i = 0; i < net.node_size(); i++)
+        {
+            const opencv_onnx::NodeProto& node = net.node(i);
+            if (node.op_type() == "Constant" && node.output_size() == 1 && node.output(0) == name &&
+                node.attribute_size() == 1 && node.attribute(0).has_t())
+                return &node.attribute(0).t();
+        }
+        return NULL;
+    }
+
+    // Returns the value of an initializer or of a Constant node output, an empty Mat for other tensors.
+    Mat getConstant(const std::string& name) const
+    {
+        const opencv_onnx::TensorProto* tensor = getConstantTensor(name);
+        return tensor ? getMatFromTensor(*tensor, externalData) : Mat();
+    }
+
 private:
     int numInputs, numInitializers;
     opencv_onnx::GraphProto& net;
+    ONNXExternalData* externalData;
 };
 
 class SoftMaxSubgraphBase : public Subgraph
@@ -743,7 +771,248 @@ public:
     }
 };
 
-void simplifySubgraphs(opencv_onnx::GraphProto& net)
+// Returns the graph node matched to the node of the pattern.
+static opencv_onnx::NodeProto* getMatchedNode(const Ptr<ImportGraphWrapper>& net,
+                                              const std::vector<int>& matchedNodesIds,
+                                              const std::vector<int>& targetNodesIds,
+                                              int patternNodeId)
+{
+    for (size_t i = 0; i < targetNodesIds.size(); i++)
+    {
+        if (targetNodesIds[i] == patternNodeId)
+            return net->getNode(matchedNodesIds[i]).dynamicCast<ONNXNodeWrapper>()->node;
+    }
+    CV_Error(Error::StsInternal, "Pattern node is not matched");
+}
+
+// Returns the value of a scalar constant input of the node or NaN.
+static float getScalarInput(const Ptr<ImportGraphWrapper>& net, const opencv_onnx::NodeProto* node, int inputId)
+{
+    Mat value = net.dynamicCast<ONNXGraphWrapper>()->getConstant(node->input(inputId));
+    if (value.total() != 1)
+        return std::numeric_limits<float>::quiet_NaN();
+    value.convertTo(value, CV_32F);
+    return value.at<float>(0);
+}
+
+static bool getIntAttribute(const opencv_onnx::NodeProto* node, const std::string& name, int& value)
+{
+    for (int i = 0; i < node->attribute_size(); i++)
+    {
+        if (node->attribute(i).name() == name)
+        {
+            value = (int)node->attribute(i).i();
+            return true;
+        }
+    }
+    return false;
+}
+
+// Decomposed layer normalization as exported from PyTorch and TensorFlow:
+// (x - mean(x)) / sqrt(mean((x - mean(x))^2) + eps) [* weight + bias]
+class LayerNormSubgraph : public Subgraph
+{
+public:
+    LayerNormSubgraph(bool affine) : axis(-1), epsilon(1e-5f)
+    {
+        input = addNodeToMatch("");
+        mean = addNodeToMatch("ReduceMean", input);
+        sub = addNodeToMatch("Sub", input, mean);
+        pow = addNodeToMatch("Pow", sub, addNodeToMatch(""));
+        var = addNodeToMatch("ReduceMean", pow);
+        add = addNodeToMatch("Add", var, addNodeToMatch(""));
+        int sqrtNode = addNodeToMatch("Sqrt", add);
+        int div = addNodeToMatch("Div", sub, sqrtNode);
+        if (affine)
+        {
+            int weight = addNodeToMatch(""), bias = addNodeToMatch("");
+            mul = addNodeToMatch("Mul", div, weight);
+            addNodeToMatch("Add", mul, bias);
+            setFusedNode("LayerNormalization", input, weight, bias);
+        }
+        else
+        {
+            mul = -1;
+            setFusedNode("LayerNormalization", input);
+        }
+    }
+
+    // Returns the first of the trailing axes reduced by the node or 0 if the axes are not trailing.
+    static int getTrailingAxes(const Ptr<ImportGraphWrapper>& net, const opencv_onnx::NodeProto* node)
+    {
+        int keepdims = 1;
+        getIntAttribute(node, "keepdims", keepdims);
+        if (!keepdims)
+            return 0;
+
+        std::vector<int> axes;
+        for (int i = 0; i < node->attribute_size(); i++)
+        {
+            const opencv_onnx::AttributeProto& attr = node->attribute(i);
+            if (attr.name() == "axes")
+            {
+                for (int j = 0; j < attr.ints_size(); j++)
+                    axes.push_back((int)attr.ints(j));
+            }
+        }
+        if (axes.empty() && node->input_size() == 2)
+        {
+            Mat axesMat = net.dynamicCast<ONNXGraphWrapper>()->getConstant(node->input(1));
+            axesMat.convertTo(axesMat, CV_32S);
+            axes.assign(axesMat.begin<int>(), axesMat.end<int>());
+        }
+        // the rank is unknown here, so only the negative axes can be checked to be the last ones
+        std::sort(axes.begin(), axes.end());
+        for (size_t i = 0; i < axes.size(); i++)
+        {
+            if (axes[i] != -(int)(axes.size() - i))
+                return 0;
+        }
+        return axes.empty() ? 0 : axes[0];
+    }
+
+    virtual bool match(const Ptr<ImportGraphWrapper>& net, int nodeId,
+                       std::vector<int>& matchedNodesIds,
+                       std::vector<int>& targetNodesIds) CV_OVERRIDE
+    {
+        if (!Subgraph::match(net, nodeId, matchedNodesIds, targetNodesIds))
+            return false;
+
+        const opencv_onnx::NodeProto* meanNode = getMatchedNode(net, matchedNodesIds, targetNodesIds, mean);
+        const opencv_onnx::NodeProto* subNode = getMatchedNode(net, matchedNodesIds, targetNodesIds, sub);
+        if (subNode->input(0) != meanNode->input(0))
+            return false;
+
+        axis = getTrailingAxes(net, meanNode);
+        if (axis == 0 || getTrailingAxes(net, getMatchedNode(net, matchedNodesIds, targetNodesIds, var)) != axis)
+            return false;
+
+        if (getScalarInput(net, getMatchedNode(net, matchedNodesIds, targetNodesIds, pow), 1) != 2.f)
+            return false;
+        epsilon = getScalarInput(net, getMatchedNode(net, matchedNodesIds, targetNodesIds, add), 1);
+        if (cvIsNaN(epsilon))
+            return false;
+
+        if (mul >= 0)
+        {
+            // weight and bias become the blobs of the layer
+            Ptr<ONNXGraphWrapper> onnxNet = net.dynamicCast<ONNXGraphWrapper>();
+            const opencv_onnx::NodeProto* mulNode = getMatchedNode(net, matchedNodesIds, targetNodesIds, mul);
+            const opencv_onnx::NodeProto* biasNode = net->getNode(matchedNodesIds.back()).dynamicCast<ONNXNodeWrapper>()->node;
+            if (!hasNormalizedShape(onnxNet->getConstantTensor(mulNode->input(1))) ||
+                !hasNormalizedShape(onnxNet->getConstantTensor(biasNode->input(1))) ||
+                onnxNet->getConstant(mulNode->input(1)).empty() || onnxNet->getConstant(biasNode->input(1)).empty())
+                return false;
+        }
+        return true;
+    }
+
+    virtual void finalize(const Ptr<ImportGraphWrapper>&,
+                          const Ptr<ImportNodeWrapper>& fusedNode,
+                          std::vector<Ptr<ImportNodeWrapper> >&) CV_OVERRIDE
+    {
+        opencv_onnx::NodeProto* node = fusedNode.dynamicCast<ONNXNodeWrapper>()->node;
+        opencv_onnx::AttributeProto* attr = node->add_attribute();
+        attr->set_name("axis");
+        attr->set_i(axis);
+        attr = node->add_attribute();
+        attr->set_name("epsilon");
+        attr->set_f(epsilon);
+    }
+
+protected:
+    // The layer takes the weight and the bias of the size of the normalized axes. The input shape is unknown here,
+    // so the constant must have exactly the normalized axes (after the leading ones) and no broadcasted axis in them.
+    // Anything else (a scalar, a per-row constant) keeps the graph unfused.
+    bool hasNormalizedShape(const opencv_onnx::TensorProto* tensor) const
+    {
+        if (!tensor)
+            return false;
+        int first = 0;
+        while (first < tensor->dims_size() && tensor->dims(first) == 1)
+            first++;
+        if (tensor->dims_size() - first != -axis)
+            return false;
+        for (int i = first; i < tensor->dims_size(); i++)
+        {
+            if (tensor->dims(i) <= 1)
+                return false;
+        }
+        return true;
+    }
+
+    int input, mean, sub, pow, var, add, mul;
+    int axis;
+    float epsilon;
+};
+
+// Scaled dot-product attention: MatMul(Softmax([Add](Div|Mul(MatMul(Q, K^T), c), mask)), V).
+class AttentionSubgraph : public Subgraph
+{
+public:
+    AttentionSubgraph(const std::string& scaleOp, bool withMask) : scale(1.f)
+    {
+        int q = addNodeToMatch(""), k = addNodeToMatch(""), v = addNodeToMatch("");
+        int weights = addNodeToMatch("MatMul", q, k);
+        scaleNode = -1;
+        if (!scaleOp.empty())
+            weights = scaleNode = addNodeToMatch(scaleOp, weights, addNodeToMatch(""));
+        int mask = -1;
+        if (withMask)
+        {
+            mask = addNodeToMatch("");
+            weights = addNodeToMatch("Add", weights, mask);
+        }
+        softmax = addNodeToMatch("Softmax", weights);
+        addNodeToMatch("MatMul", softmax, v);
+        if (withMask)
+            setFusedNode("ScaledDotProductAttention", q, k, v, mask);
+        else
+            setFusedNode("ScaledDotProductAttention", q, k, v);
+    }
+
+    virtual bool match(const Ptr<ImportGraphWrapper>& net, int nodeId,
+                       std::vector<int>& matchedNodesIds,
+                       std::vector<int>& targetNodesIds) CV_OVERRIDE
+    {
+        if (!Subgraph::match(net, nodeId, matchedNodesIds, targetNodesIds))
+            return false;
+
+        // The default axis depends on the opset version, so it must be given explicitly. The rank is unknown here,
+        // so only -1 is known to be the last axis (for the older opsets it is the only one flattened as well).
+        const opencv_onnx::NodeProto* softmaxNode = getMatchedNode(net, matchedNodesIds, targetNodesIds, softmax);
+        int softmaxAxis = 0;
+        if (!getIntAttribute(softmaxNode, "axis", softmaxAxis) || softmaxAxis != -1)
+            return false;
+
+        scale = 1.f;
+        if (scaleNode >= 0)
+        {
+            const opencv_onnx::NodeProto* node = getMatchedNode(net, matchedNodesIds, targetNodesIds, scaleNode);
+            float c = getScalarInput(net, node, 1);
+            if (cvIsNaN(c) || c == 0.f)
+                return false;
+            scale = node->op_type() == "Div" ? 1.f / c : c;
+        }
+        return true;
+    }
+
+    virtual void finalize(const Ptr<ImportGraphWrapper>&,
+                          const Ptr<ImportNodeWrapper>& fusedNode,
+                          std::vector<Ptr<ImportNodeWrapper> >&) CV_OVERRIDE
+    {
+        opencv_onnx::NodeProto* node = fusedNode.dynamicCast<ONNXNodeWrapper>()->node;
+        opencv_onnx::AttributeProto* attr = node->add_attribute();
+        attr->set_name("scale");
+        attr->set_f(scale);
+    }
+
+protected:
+    int scaleNode, softmax;
+    float scale;
+};
+
+void simplifySubgraphs(opencv_onnx::GraphProto& net, ONNXExternalData* externalData)
 {
     std::vector<Ptr<Subgraph> > subgraphs;
     subgraphs.push_back(makePtr<GatherCastSubgraph>());
@@ -768,16 +1037,144 @@ void simplifySubgraphs(opencv_onnx::GraphProto& net)
     subgraphs.push_back(makePtr<MishSubgraph>());
     subgraphs.push_back(makePtr<NormalizeSubgraph4>());
     subgraphs.push_back(makePtr<NormalizeSubgraph5>());
+    subgraphs.push_back(makePtr<LayerNormSubgraph>(true));
+    subgraphs.push_back(makePtr<LayerNormSubgraph>(false));
+    subgraphs.push_back(makePtr<AttentionSubgraph>("Div", true));
+    subgraphs.push_back(makePtr<AttentionSubgraph>("Mul", true));
+    subgraphs.push_back(makePtr<AttentionSubgraph>("Div", false));
+    subgraphs.push_back(makePtr<AttentionSubgraph>("Mul", false));
+    subgraphs.push_back(makePtr<AttentionSubgraph>("", true));
+    subgraphs.push_back(makePtr<AttentionSubgraph>("", false));
+
+    simplifySubgraphs(Ptr<ImportGraphWrapper>(new ONNXGraphWrapper(net, externalData)), subgraphs);
+}
+
+// the location may not be absolute and may not leave the directory by the ".." components
+static bool isLocationInsideDirectory(const std::string& location)
+{
+    if (location.empty() || location[0] == '/' || location[0] == '\\' || (location.size() > 1 && location[1] == ':'))
+        return false;
+    int depth = 0;
+    size_t start = 0;
+    while (start <= location.size())
+    {
+        size_t end = location.find_first_of("/\\", start);
+        if (end == std::string::npos)
+            end = location.size();
+        const std::string part = location.substr(start, end - start);
+        if (part == "..")
+        {
+            if (--depth < 0)
+                return false;
+        }
+        else if (!part.empty() && part != ".")
+            depth++;
+        start = end + 1;
+    }
+    return true;
+}
 
-    simplifySubgraphs(Ptr<ImportGraphWrapper>(new ONNXGraphWrapper(net)), subgraphs);
+void ONNXExternalData::addFile(const std::string& location, const Ptr<MappedFile>& file)
+{
+    CV_Assert(file);
+    files_[location] = file;
+}
+
+Ptr<MappedFile> ONNXExternalData::getFile(const std::string& location, const std::string& tensorName)
+{
+    std::map<std::string, Ptr<MappedFile> >::const_iterator it = files_.find(location);
+    if (it != files_.end())
+        return it->second;
+    if (!isLocationInsideDirectory(location))
+        CV_Error(Error::StsBadArg, cv::format("DNN/ONNX: the location of the external data of tensor '%s' is outside "
+                                              "of the model directory: %s", tensorName.c_str(), location.c_str()));
+    const std::string path = utils::fs::join(dir_, location);
+    Ptr<MappedFile> file = MappedFile::open(path);
+    if (!file)
+        CV_Error(Error::StsError, cv::format("DNN/ONNX: can't read the external data of tensor '%s' from %s",
+                                             tensorName.c_str(), path.c_str()));
+    files_[location] = file;
+    return file;
+}
+
+// offset and length of the external data are decimal numbers
+static size_t parseExternalDataSize(const std::string& value, const std::string& key, const std::string& tensorName)
+{
+    size_t result = 0;
+    bool ok = !value.empty();
+    for (size_t i = 0; ok && i < value.size(); i++)
+    {
+        const char c = value[i];
+        ok = c >= '0' && c <= '9' && result <= (std::numeric_limits<size_t>::max() - (c - '0'))/10;
+        result = result*10 + (c - '0');
+    }
+    if (!ok)
+        CV_Error(Error::StsUnsupportedFormat, cv::format("DNN/ONNX: invalid %s '%s' of the external data of tensor: %s",
+                                                         key.c_str(), value.c_str(), tensorName.c_str()));
+    return result;
 }
 
-Mat getMatFromTensor(const opencv_onnx::TensorProto& tensor_proto)
+// The tensor data stored outside of the TensorProto (data_location = EXTERNAL) is the region of the mapped file.
+// The external_data and data_location fields are not in opencv-onnx.proto, they are parsed as unknown fields.
+static Ptr<MappedFile> getExternalTensorData(const opencv_onnx::TensorProto& tensor_proto, ONNXExternalData* externalData,
+                                             size_t& offset, size_t& length)
 {
-    if (tensor_proto.raw_data().empty() && tensor_proto.float_data().empty() &&
+    const ::google::protobuf::UnknownFieldSet& fields = tensor_proto.unknown_fields();
+    bool isExternal = false;
+    std::string location;
+    offset = 0;
+    length = (size_t)-1;
+    for (int i = 0; i < fields.field_count(); i++)
+    {
+        const ::google::protobuf::UnknownField& field = fields.field(i);
+        if (field.number() == ONNX_TENSOR_DATA_LOCATION && field.type() == ::google::protobuf::UnknownField::TYPE_VARINT)
+            isExternal = field.varint() == ONNX_DATA_LOCATION_EXTERNAL;
+        else if (field.number() == ONNX_TENSOR_EXTERNAL_DATA && field.type() == ::google::protobuf::UnknownField::TYPE_LENGTH_DELIMITED)
+        {
+            opencv_onnx::StringStringEntryProto entry;
+            if (!entry.ParseFromString(field.length_delimited()))
+                CV_Error(Error::StsUnsupportedFormat, "DNN/ONNX: invalid external_data of tensor: " + tensor_proto.name());
+            if (entry.key() == "location")
+                location = entry.value();
+            else if (entry.key() == "offset")
+                offset = parseExternalDataSize(entry.value(), entry.key(), tensor_proto.name());
+            else if (entry.key() == "length")
+                length = parseExternalDataSize(entry.value(), entry.key(), tensor_proto.name());
+        }
+    }
+    if (!isExternal)
+        return Ptr<MappedFile>();
+    if (location.empty())
+        CV_Error(Error::StsUnsupportedFormat, "DNN/ONNX: no location of the external data of tensor: " + tensor_proto.name());
+    if (!externalData)
+        CV_Error(Error::StsNotImplemented, "DNN/ONNX: the external data is supported for the models read from files only, tensor: " +
+                                           tensor_proto.name());
+    Ptr<MappedFile> file = externalData->getFile(location, tensor_proto.name());
+    if (offset > file->size() || (length != (size_t)-1 && length > file->size() - offset))
+        CV_Error(Error::StsUnsupportedFormat, cv::format("DNN/ONNX: the external data of tensor '%s' is out of the file %s (offset=%zu)",
+                                                         tensor_proto.name().c_str(), location.c_str(), offset));
+    if (length == (size_t)-1)
+        length = file->size() - offset;
+    return file;
+}
+
+Ptr<MappedFile> getTensorExternalFile(const opencv_onnx::TensorProto& tensor_proto, ONNXExternalData* externalData)
+{
+    size_t offset = 0, length = 0;
+    return getExternalTensorData(tensor_proto, externalData, offset, length);
+}
+
+Mat getMatFromTensor(const opencv_onnx::TensorProto& tensor_proto, ONNXExternalData* externalDataFiles)
+{
+    // the raw data of big tensors may reference the model file or ONNX external data files
+    size_t externalOffset = 0, externalSize = 0;
+    Ptr<MappedFile> externalData = getExternalTensorData(tensor_proto, externalDataFiles, externalOffset, externalSize);
+    if (!externalData && tensor_proto.raw_data().empty() && tensor_proto.float_data().empty() &&
         tensor_proto.double_data().empty() && tensor_proto.int64_data().empty() &&
         tensor_proto.int32_data().empty())
         return Mat();
+    const char* rawData = externalData ? (const char*)externalData->data() + externalOffset : tensor_proto.raw_data().c_str();
+    const size_t rawSize = externalData ? externalSize : tensor_proto.raw_data().size();
 
     opencv_onnx::TensorProto_DataType datatype = tensor_proto.data_type();
     Mat blob;
@@ -787,14 +1184,28 @@ Mat getMatFromTensor(const opencv_onnx::TensorProto& tensor_proto)
     }
     if (sizes.empty())
         sizes.assign(1, 1);
+    if (externalData)
+    {
+        size_t total = 1;
+        for (size_t i = 0; i < sizes.size(); i++)
+            total *= sizes[i];
+        size_t esz = datatype == opencv_onnx::TensorProto_DataType_INT8 || datatype == opencv_onnx::TensorProto_DataType_UINT8 ? 1 :
+                     datatype == opencv_onnx::TensorProto_DataType_FLOAT16 ? 2 :
+                     datatype == opencv_onnx::TensorProto_DataType_INT64 || datatype == opencv_onnx::TensorProto_DataType_DOUBLE ? 8 : 4;
+        if (rawSize < total*esz)
+            CV_Error(Error::StsUnsupportedFormat, "DNN/ONNX: the external data is too short for tensor: " + tensor_proto.name());
+    }
     if (datatype == opencv_onnx::TensorProto_DataType_FLOAT) {
 
         if (!tensor_proto.float_data().empty()) {
             const ::google::protobuf::RepeatedField<float> field = tensor_proto.float_data();
             Mat(sizes, CV_32FC1, (void*)field.data()).copyTo(blob);
         }
+        else if (externalData && isAligned<sizeof(float)>(rawData)) {
+            blob = MappedFile::wrap(externalData, externalOffset, (int)sizes.size(), sizes.data(), CV_32FC1);
+        }
         else {
-            char* val = const_cast<char*>(tensor_proto.raw_data().c_str());
+            char* val = const_cast<char*>(rawData);
             Mat(sizes, CV_32FC1, val).copyTo(blob);
         }
     }
@@ -827,13 +1238,13 @@ Mat getMatFromTensor(const opencv_onnx::TensorProto& tensor_proto)
         }
         else
         {
-            char* val = const_cast<char*>(tensor_proto.raw_data().c_str());
+            char* val = const_cast<char*>(rawData);
 #if CV_STRONG_ALIGNMENT
             // Aligned pointer is required.
             AutoBuffer<float16_t, 16> aligned_val;
             if (!isAligned<sizeof(float16_t)>(val))
             {
-                size_t sz = tensor_proto.raw_data().size();
+                size_t sz = rawSize;
                 aligned_val.allocate(divUp(sz, sizeof(float16_t)));
                 memcpy(aligned_val.data(), val, sz);
                 val = (char*)aligned_val.data();
@@ -852,7 +1263,7 @@ Mat getMatFromTensor(const opencv_onnx::TensorProto& tensor_proto)
         AutoBuffer<double, 16> aligned_val;
         if (!isAligned<sizeof(double)>(val))
         {
-            size_t sz = tensor_proto.raw_data().size();
+            size_t sz = rawSize;
             aligned_val.allocate(divUp(sz, sizeof(double)));
             memcpy(aligned_val.data(), val, sz);
             val = (char*)aligned_val.data();
@@ -867,9 +1278,13 @@ Mat getMatFromTensor(const opencv_onnx::TensorProto& tensor_proto)
             const ::google::protobuf::RepeatedField<int32_t> field = tensor_proto.int32_data();
             Mat(sizes, CV_32SC1, (void*)field.data()).copyTo(blob);
         }
+        else if (externalData && isAligned<sizeof(int32_t)>(rawData))
+        {
+            blob = MappedFile::wrap(externalData, externalOffset, (int)sizes.size(), sizes.data(), CV_32SC1);
+        }
         else
         {
-            char* val = const_cast<char*>(tensor_proto.raw_data().c_str());
+            char* val = const_cast<char*>(rawData);
             Mat(sizes, CV_32SC1, val).copyTo(blob);
         }
     }
@@ -884,14 +1299,14 @@ Mat getMatFromTensor(const opencv_onnx::TensorProto& tensor_proto)
         }
         else
         {
-            const char* val = tensor_proto.raw_data().c_str();
+            const char* val = rawData;
 #if CV_STRONG_ALIGNMENT
             // Aligned pointer is required: https://github.com/opencv/opencv/issues/16373
             // this doesn't work: typedef int64_t CV_DECL_ALIGNED(1) unaligned_int64_t;
             AutoBuffer<int64_t, 16> aligned_val;
             if (!isAligned<sizeof(int64_t)>(val))
             {
-                size_t sz = tensor_proto.raw_data().size();
+                size_t sz = rawSize;
                 aligned_val.allocate(divUp(sz, sizeof(int64_t)));
                 memcpy(aligned_val.data(), val, sz);
                 val = (const char*)aligned_val.data();
@@ -913,9 +1328,13 @@ Mat getMatFromTensor(const opencv_onnx::TensorProto& tensor_proto)
             const ::google::protobuf::RepeatedField<int32_t> field = tensor_proto.int32_data();
             Mat(sizes, CV_32SC1, (void*)field.data()).convertTo(blob, CV_8S, 1.0, offset);
         }
+        else if (externalData && depth == CV_8S)
+        {
+            blob = MappedFile::wrap(externalData, externalOffset, (int)sizes.size(), sizes.data(), CV_8S);
+        }
         else
         {
-            char* val = const_cast<char*>(tensor_proto.raw_data().c_str());
+            char* val = const_cast<char*>(rawData);
             Mat(sizes, depth, val).convertTo(blob, CV_8S, 1.0, offset);
         }
     }
@@ -17,10 +17,31 @@
 #pragma GCC diagnostic pop
 #endif
 
+#include "../mapped_file.hpp"
+
 namespace cv { namespace dnn {
 CV__DNN_INLINE_NS_BEGIN
 
-void simplifySubgraphs(opencv_onnx::GraphProto& net);
+// Files with the data of the tensors stored outside of the TensorProto (data_location = EXTERNAL): the ONNX
+// external data files and the model file itself, whose big raw_data is left in place by the importer.
+// The locations are relative to the model directory, as in onnxruntime the ones leaving it are rejected.
+// Every file is mapped once.
+class ONNXExternalData
+{
+public:
+    explicit ONNXExternalData(const std::string& dir) : dir_(dir) {}
+
+    // registers the already mapped file
+    void addFile(const std::string& location, const Ptr<MappedFile>& file);
+    // throws if the location is outside of the model directory or the file can't be read
+    Ptr<MappedFile> getFile(const std::string& location, const std::string& tensorName);
+
+private:
+    std::string dir_;
+    std::map<std::string, Ptr<MappedFile> > files_;
+};
+
+void simplifySubgraphs(opencv_onnx::GraphProto& net, ONNXExternalData* externalData = NULL);
 
 template<typename T1, typename T2>
 void convertInt64ToInt32(const T1& src, T2& dst, int size)
@@ -31,7 +52,19 @@ void convertInt64ToInt32(const T1& src, T2& dst, int size)
     }
 }
 
-Mat getMatFromTensor(const opencv_onnx::TensorProto& tensor_proto);
+// TensorProto fields of the newer ONNX versions, which are not in opencv-onnx.proto
+enum
+{
+    ONNX_TENSOR_EXTERNAL_DATA = 13,  // repeated StringStringEntryProto: location, offset, length
+    ONNX_TENSOR_DATA_LOCATION = 14,  // DEFAULT = 0, EXTERNAL = 1
+    ONNX_DATA_LOCATION_EXTERNAL = 1
+};
+
+// externalData is required for the tensors with data_location = EXTERNAL
+Mat getMatFromTensor(const opencv_onnx::TensorProto& tensor_proto, ONNXExternalData* externalData = NULL);
+
+// the file with the data of the tensor with data_location = EXTERNAL, an empty pointer for the other tensors
+Ptr<MappedFile> getTensorExternalFile(const opencv_onnx::TensorProto& tensor_proto, ONNXExternalData* externalData);
 
 CV__DNN_INLINE_NS_END
 }}  // namespace dnn, namespace cv
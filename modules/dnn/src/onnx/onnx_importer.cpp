@@ -43,6 +43,9 @@
 #endif
 
 #include "onnx_graph_simplifier.hpp"
+#include "../mapped_file.hpp"
+#include "../prepack_cache.hpp"
+#include <opencv2/core/utils/filesystem.hpp>
 
 namespace cv {
 namespace dnn {
@@ -104,6 +107,8 @@ protected:
     Net& dstNet;
 
     opencv_onnx::GraphProto graph_proto;
+    Ptr<ONNXExternalData> externalData;  // empty for the models read from memory
+    std::string prepackModelKey;  // empty for the models read from memory or if the prepacked weights cache is disabled
     std::string framework_name;
 
     std::map<std::string, Mat> constBlobs;
@@ -177,6 +182,8 @@ private:
     void parseSoftMax              (LayerParams& layerParams, const opencv_onnx::NodeProto& node_proto);
     void parseDetectionOutput      (LayerParams& layerParams, const opencv_onnx::NodeProto& node_proto);
     void parseCumSum               (LayerParams& layerParams, const opencv_onnx::NodeProto& node_proto);
+    void parseLayerNorm            (LayerParams& layerParams, const opencv_onnx::NodeProto& node_proto);
+    void parseAttention            (LayerParams& layerParams, const opencv_onnx::NodeProto& node_proto);
     void parseElementWise          (LayerParams& layerParams, const opencv_onnx::NodeProto& node_proto);
     void parseDepthToSpace         (LayerParams& layerParams, const opencv_onnx::NodeProto& node_proto);
     void parseRange                (LayerParams& layerParams, const opencv_onnx::NodeProto& node_proto);
@@ -244,6 +251,158 @@ void ONNXLayerHandler::fillRegistry(const opencv_onnx::GraphProto &net)
     printMissing();
 }
 
+// The model file is parsed in place without copying the raw data of big initializers: such a tensor gets
+// data_location = EXTERNAL with the region of the model file instead, getMatFromTensor() wraps it into Mat.
+// This is done on the protobuf wire format level, the rest of the fields are merged to the messages as is.
+namespace {
+
+enum { ONNX_MAPPED_RAW_DATA_MIN_SIZE = 4096 };
+
+struct ProtoWireField
+{
+    int number;
+    int wireType;
+    const uchar* begin;    // the whole field including the tag
+    const uchar* end;
+    const uchar* payload;  // the length-delimited content
+    size_t payloadSize;
+};
+
+bool readVarint(const uchar*& p, const uchar* end, uint64_t& val)
+{
+    val = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7)
+    {
+        uchar b = *p++;
+        val |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80))
+            return true;
+    }
+    return false;
+}
+
+bool readField(const uchar*& p, const uchar* end, ProtoWireField& f)
+{
+    uint64_t tag = 0, val = 0;
+    f.begin = p;
+    if (!readVarint(p, end, tag))
+        return false;
+    f.number = (int)(tag >> 3);
+    f.wireType = (int)(tag & 7);
+    f.payload = p;
+    f.payloadSize = 0;
+    switch (f.wireType)
+    {
+    case 0:  // varint
+        if (!readVarint(p, end, val))
+            return false;
+        break;
+    case 1:  // 64-bit
+        if (end - p < 8)
+            return false;
+        p += 8;
+        break;
+    case 2:  // length-delimited
+        if (!readVarint(p, end, val) || val > (uint64_t)(end - p))
+            return false;
+        f.payload = p;
+        f.payloadSize = (size_t)val;
+        p += f.payloadSize;
+        break;
+    case 5:  // 32-bit
+        if (end - p < 4)
+            return false;
+        p += 4;
+        break;
+    default:  // groups are not used by ONNX
+        return false;
+    }
+    f.end = p;
+    return true;
+}
+
+bool mergeField(::google::protobuf::Message& msg, const ProtoWireField& f)
+{
+    ::google::protobuf::io::CodedInputStream input(f.begin, (int)(f.end - f.begin));
+    return msg.MergePartialFromCodedStream(&input);
+}
+
+void addExternalDataEntry(opencv_onnx::TensorProto& tensor, const std::string& key, const std::string& value)
+{
+    opencv_onnx::StringStringEntryProto entry;
+    entry.set_key(key);
+    entry.set_value(value);
+    tensor.mutable_unknown_fields()->AddLengthDelimited(ONNX_TENSOR_EXTERNAL_DATA, entry.SerializeAsString());
+}
+
+// location is the model file name, the external data locations are relative to its directory as well
+bool parseTensorMapped(const uchar* fileData, const uchar* p, const uchar* end, const std::string& location,
+                       opencv_onnx::TensorProto& tensor)
+{
+    const uchar* rawData = NULL;
+    size_t rawSize = 0;
+    ProtoWireField f;
+    while (p < end)
+    {
+        if (!readField(p, end, f))
+            return false;
+        if (f.number == 9 && f.wireType == 2 && f.payloadSize >= ONNX_MAPPED_RAW_DATA_MIN_SIZE)  // raw_data
+        {
+            rawData = f.payload;
+            rawSize = f.payloadSize;
+        }
+        else if (!mergeField(tensor, f))
+            return false;
+    }
+    if (rawData)
+    {
+        tensor.mutable_unknown_fields()->AddVarint(ONNX_TENSOR_DATA_LOCATION, ONNX_DATA_LOCATION_EXTERNAL);
+        addExternalDataEntry(tensor, "location", location);
+        addExternalDataEntry(tensor, "offset", std::to_string((unsigned long long)(rawData - fileData)));
+        addExternalDataEntry(tensor, "length", std::to_string((unsigned long long)rawSize));
+    }
+    return true;
+}
+
+bool parseGraphMapped(const uchar* fileData, const uchar* p, const uchar* end, const std::string& location,
+                      opencv_onnx::GraphProto& graph)
+{
+    ProtoWireField f;
+    while (p < end)
+    {
+        if (!readField(p, end, f))
+            return false;
+        bool ok = f.number == 5 && f.wireType == 2 ?  // initializer
+                  parseTensorMapped(fileData, f.payload, f.payload + f.payloadSize, location, *graph.add_initializer()) :
+                  mergeField(graph, f);
+        if (!ok)
+            return false;
+    }
+    return true;
+}
+
+bool parseModelMapped(const MappedFile& file, const std::string& location, opencv_onnx::ModelProto& model)
+{
+    if (file.size() > (size_t)INT_MAX)
+        return false;  // protobuf limit
+    const uchar* fileData = file.data();
+    const uchar *p = fileData, *end = fileData + file.size();
+    ProtoWireField f;
+    while (p < end)
+    {
+        if (!readField(p, end, f))
+            return false;
+        bool ok = f.number == 7 && f.wireType == 2 ?  // graph
+                  parseGraphMapped(fileData, f.payload, f.payload + f.payloadSize, location, *model.mutable_graph()) :
+                  mergeField(model, f);
+        if (!ok)
+            return false;
+    }
+    return true;
+}
+
+}  // namespace
+
 ONNXImporter::ONNXImporter(Net& net, const char *onnxFile)
     : layerHandler(DNN_DIAGNOSTICS_RUN ? new ONNXLayerHandler(this) : nullptr)
     , dstNet(net)
@@ -254,15 +413,36 @@ ONNXImporter::ONNXImporter(Net& net, const char *onnxFile)
     CV_Assert(onnxFile);
     CV_LOG_DEBUG(NULL, "DNN/ONNX: processing ONNX model from file: " << onnxFile);
 
-    std::fstream input(onnxFile, std::ios::in | std::ios::binary);
-    if (!input)
     {
-        CV_Error(Error::StsBadArg, cv::format("Can't read ONNX file: %s", onnxFile));
-    }
+        Ptr<MappedFile> file = MappedFile::open(onnxFile);
+        if (!file)
+        {
+            CV_Error(Error::StsBadArg, cv::format("Can't read ONNX file: %s", onnxFile));
+        }
 
-    if (!model_proto.ParseFromIstream(&input))
-    {
-        CV_Error(Error::StsUnsupportedFormat, cv::format("Failed to parse ONNX model: %s", onnxFile));
+        // the big initializers reference the model file by its name
+        const std::string path = onnxFile;
+        const size_t sep = path.find_last_of("/\\");
+        const std::string fileName = sep == std::string::npos ? path : path.substr(sep + 1);
+        externalData = makePtr<ONNXExternalData>(sep == std::string::npos ? std::string() : path.substr(0, sep + 1));
+        externalData->addFile(fileName, file);
+        if (!parseModelMapped(*file, fileName, model_proto))
+        {
+            CV_Error(Error::StsUnsupportedFormat, cv::format("Failed to parse ONNX model: %s", onnxFile));
+        }
+        if (isPrepackCacheEnabled())
+        {
+            // the weights are in the model file and in the external data files referenced by the initializers
+            std::vector<Ptr<MappedFile> > files(1, file);
+            const opencv_onnx::GraphProto& graph = model_proto.graph();
+            for (int i = 0; i < graph.initializer_size(); i++)
+            {
+                Ptr<MappedFile> dataFile = getTensorExternalFile(graph.initializer(i), externalData.get());
+                if (dataFile && std::find(files.begin(), files.end(), dataFile) == files.end())
+                    files.push_back(dataFile);
+            }
+            prepackModelKey = getPrepackModelKey(files);
+        }
     }
 
     populateNet();
@@ -397,7 +577,7 @@ std::map<std::string, Mat> ONNXImporter::getGraphTensors(
     {
         const opencv_onnx::TensorProto& tensor_proto = graph_proto.initializer(i);
         dumpTensorProto(i, tensor_proto, "initializer");
-        Mat mat = getMatFromTensor(tensor_proto);
+        Mat mat = getMatFromTensor(tensor_proto, externalData.get());
         releaseONNXTensor(const_cast<opencv_onnx::TensorProto&>(tensor_proto));  // drop already loaded data
 
         if (DNN_DIAGNOSTICS_RUN && mat.empty())
@@ -510,7 +690,7 @@ LayerParams ONNXImporter::getLayerParams(const opencv_onnx::NodeProto& node_prot
             else if (attribute_proto.has_t())
             {
                 opencv_onnx::TensorProto tensor = attribute_proto.t();
-                Mat blob = getMatFromTensor(tensor);
+                Mat blob = getMatFromTensor(tensor, externalData.get());
                 lp.blobs.push_back(blob);
                 lp.set("original_dims_of_mat", tensor.dims_size());
             }
@@ -601,6 +781,8 @@ void ONNXImporter::addLayer(LayerParams& layerParams,
                             const opencv_onnx::NodeProto& node_proto)
 {
     int depth = layerParams.get<int>("depth", CV_32F);
+    if (!prepackModelKey.empty() && !layerParams.blobs.empty())
+        layerParams.set("prepack_model_key", prepackModelKey);
     int id = dstNet.addLayer(layerParams.name, layerParams.type, depth, layerParams);
     for (int i = 0; i < node_proto.output_size(); ++i)
     {
@@ -776,7 +958,7 @@ void ONNXImporter::handleQuantizedNode(LayerParams& layerParams,
 void ONNXImporter::populateNet()
 {
     CV_Assert(model_proto.has_graph());
-    graph_proto = model_proto.graph();
+    graph_proto.Swap(model_proto.mutable_graph());
 
     std::string framework_version;
     if (model_proto.has_producer_name())
@@ -796,7 +978,7 @@ void ONNXImporter::populateNet()
 
     parseOperatorSet();
 
-    simplifySubgraphs(graph_proto);
+    simplifySubgraphs(graph_proto, externalData.get());
 
     const int layersSize = graph_proto.node_size();
     CV_LOG_DEBUG(NULL, "DNN/ONNX: graph simplified to " << layersSize << " nodes");
@@ -1960,63 +2142,140 @@ void ONNXImporter::parseBatchNormalization(LayerParams& layerParams, const openc
     addLayer(layerParams, node_proto);
 }
 
-// A * B + C = Y, we require that the dimension of A is [m, k], and the dimension of B is [n, k].
-// And the dim of output Y is [m, n]
+// alpha * A' * B' + beta * C = Y, where A' and B' are optionally transposed. The InnerProduct layer,
+// which is supported by all the backends, handles constant B with A of shape [m, k] and C broadcasted
+// along the rows; alpha and beta are folded into the weights and the bias then. On CPU it runs
+// the packed kernel of the MatMul layer for several rows of A.
 void ONNXImporter::parseGemm(LayerParams& layerParams, const opencv_onnx::NodeProto& node_proto)
 {
     CV_Assert(node_proto.input_size() >= 2);
-    layerParams.type = "InnerProduct";
-    Mat weights = getBlob(node_proto, 1);
+    const bool hasBias = node_proto.input_size() == 3 && !node_proto.input(2).empty();
+    const bool constB = constBlobs.find(node_proto.input(1)) != constBlobs.end();
+    const float alpha = layerParams.get<float>("alpha", 1.f);
+    const float beta = layerParams.get<float>("beta", 1.f);
+    Mat bias;
+    if (hasBias)
+    {
+        CV_Assert(constBlobs.find(node_proto.input(2)) != constBlobs.end());
+        bias = getBlob(node_proto, 2);
+    }
 
-    if (!layerParams.get<int>("transB", 0))
+    bool innerProduct = constB && !layerParams.get<int>("transA", 0);
+    if (innerProduct && hasBias)
     {
-        transpose(weights, weights);
+        Mat B = getBlob(node_proto, 1);
+        const int N = layerParams.get<int>("transB", 0) ? B.size[0] : B.size[1];
+        innerProduct = bias.total() == 1 ||
+                       (bias.total() == (size_t)N && (getBlobExtraInfo(node_proto, 2).real_ndims <= 1 || bias.size[0] == 1));
     }
-    layerParams.blobs.push_back(weights);
 
-    if (node_proto.input_size() == 3) {
-        Mat bias = getBlob(node_proto, 2);
-        layerParams.blobs.push_back(bias);
+    if (innerProduct)
+    {
+        layerParams.type = "InnerProduct";
+        Mat weights = getBlob(node_proto, 1);
+
+        if (!layerParams.get<int>("transB", 0))
+        {
+            transpose(weights, weights);
+        }
+        if (alpha != 1.f)
+            weights = weights*alpha;
+        layerParams.blobs.push_back(weights);
+        if (hasBias)
+        {
+            // a scalar bias is broadcasted to all the outputs
+            if (bias.total() == 1 && weights.rows != 1)
+                bias = Mat(1, weights.rows, bias.type(), Scalar::all(bias.at<float>(0)));
+            bias = bias.reshape(1, 1);
+            if (beta != 1.f)
+                bias = bias*beta;
+            layerParams.blobs.push_back(bias);
+        }
     }
-    if (constBlobs.find(node_proto.input(0)) != constBlobs.end())
+    else
     {
-        Mat inputBuf = getBlob(node_proto, 0);
+        layerParams.type = "MatMul";
+        if (constB)
+            layerParams.blobs.push_back(getBlob(node_proto, 1));
+        if (hasBias)
+        {
+            // [n] is broadcasted along the rows
+            if (getBlobExtraInfo(node_proto, 2).real_ndims <= 1)
+                bias = bias.reshape(1, 1);
+            layerParams.blobs.push_back(bias);
+        }
+        layerParams.set("bias_term", hasBias);
+    }
 
-        LayerParams constParams;
-        constParams.name = node_proto.input(0);
-        constParams.type = "Const";
-        constParams.blobs.push_back(inputBuf);
+    for (int i = 0; i < (constB ? 1 : 2); i++)
+    {
+        if (constBlobs.find(node_proto.input(i)) != constBlobs.end())
+        {
+            LayerParams constParams;
+            constParams.name = node_proto.input(i);
+            constParams.type = "Const";
+            constParams.blobs.push_back(getBlob(node_proto, i));
 
-        opencv_onnx::NodeProto proto;
-        proto.add_output(constParams.name);
-        addLayer(constParams, proto);
+            opencv_onnx::NodeProto proto;
+            proto.add_output(constParams.name);
+            addLayer(constParams, proto);
+        }
     }
 
-    layerParams.set("num_output", layerParams.blobs[0].size[0]);
-    layerParams.set("bias_term", node_proto.input_size() == 3);
-    addLayer(layerParams, node_proto);
+    opencv_onnx::NodeProto proto = node_proto;
+    proto.clear_input();
+    proto.add_input(node_proto.input(0));
+    if (!constB)
+        proto.add_input(node_proto.input(1));
+
+    if (layerParams.type == "InnerProduct")
+    {
+        layerParams.set("num_output", layerParams.blobs[0].size[0]);
+        layerParams.set("bias_term", hasBias);
+    }
+    addLayer(layerParams, proto);
 }
 
+// A 2-D constant B keeps the InnerProduct layer, which is supported by all the backends
+// and runs the packed kernel of the MatMul layer on CPU.
+// The MatMul layer handles N-D and broadcasted B and the non-constant operands.
 void ONNXImporter::parseMatMul(LayerParams& layerParams, const opencv_onnx::NodeProto& node_proto)
 {
     CV_Assert(node_proto.input_size() == 2);
-    layerParams.type = "InnerProduct";
-    layerParams.set("bias_term", false);
-    CV_Assert(constBlobs.find(node_proto.input(0)) == constBlobs.end());
-    int firstInpDims = outShapes[node_proto.input(0)].size();
-    int secondInpDims;
-
-    if (constBlobs.find(node_proto.input(1)) != constBlobs.end())
+    const bool constA = constBlobs.find(node_proto.input(0)) != constBlobs.end();
+    const bool constB = constBlobs.find(node_proto.input(1)) != constBlobs.end();
+    if (!constA && constB && getBlobExtraInfo(node_proto, 1).real_ndims == 2)
     {
+        layerParams.type = "InnerProduct";
+        layerParams.set("bias_term", false);
         Mat blob = getBlob(node_proto, 1);
-        secondInpDims = blob.dims;
         layerParams.blobs.push_back(blob.t());
         layerParams.set("num_output", layerParams.blobs[0].size[0]);
-    } else {
-        secondInpDims = outShapes[node_proto.input(1)].size();
+        layerParams.set("axis", (int)outShapes[node_proto.input(0)].size() - 1);
+        addLayer(layerParams, node_proto);
+        return;
     }
-    layerParams.set("axis", firstInpDims - secondInpDims + 1);
-    addLayer(layerParams, node_proto);
+
+    layerParams.type = "MatMul";
+    opencv_onnx::NodeProto proto = node_proto;
+    if (constB)
+    {
+        // constant B is packed once by the layer
+        layerParams.blobs.push_back(getBlob(node_proto, 1));
+        proto.mutable_input()->RemoveLast();
+    }
+    if (constA)
+    {
+        LayerParams constParams;
+        constParams.name = node_proto.input(0);
+        constParams.type = "Const";
+        constParams.blobs.push_back(getBlob(node_proto, 0));
+
+        opencv_onnx::NodeProto constProto;
+        constProto.add_output(constParams.name);
+        addLayer(constParams, constProto);
+    }
+    addLayer(layerParams, proto);
 }
 
 void findBroadAxis(const MatShape& broadShape, const MatShape& outShape, size_t& axis, int& broadAxis)
@@ -2912,6 +3171,51 @@ void ONNXImporter::parseCumSum(LayerParams& layerParams, const opencv_onnx::Node
     addLayer(layerParams, node_proto);
 }
 
+void ONNXImporter::parseLayerNorm(LayerParams& layerParams, const opencv_onnx::NodeProto& node_proto)
+{
+    layerParams.type = "LayerNormalization";
+    for (int i = 1; i < node_proto.output_size(); i++)
+    {
+        if (!node_proto.output(i).empty())
+            CV_Error(Error::StsNotImplemented, "LayerNormalization: Mean and InvStdDev outputs are not supported");
+    }
+
+    // scale and bias
+    for (int i = 1; i < node_proto.input_size(); i++)
+    {
+        if (node_proto.input(i).empty())
+            continue;
+        CV_Assert(constBlobs.find(node_proto.input(i)) != constBlobs.end());
+        CV_CheckEQ((int)layerParams.blobs.size(), i - 1, "LayerNormalization: bias without scale is not supported");
+        Mat blob = getBlob(node_proto, i);
+        blob.convertTo(blob, CV_32F);
+        layerParams.blobs.push_back(blob);
+    }
+    addLayer(layerParams, node_proto);
+}
+
+// Fused by the graph simplifier from MatMul, Div or Mul, Add, Softmax and MatMul nodes.
+void ONNXImporter::parseAttention(LayerParams& layerParams, const opencv_onnx::NodeProto& node_proto)
+{
+    layerParams.type = "Attention";
+    for (int i = 0; i < node_proto.input_size(); i++)
+    {
+        const std::string& input = node_proto.input(i);
+        if (constBlobs.find(input) != constBlobs.end() && layer_id.find(input) == layer_id.end())
+        {
+            LayerParams constParams;
+            constParams.name = input;
+            constParams.type = "Const";
+            constParams.blobs.push_back(getBlob(input));
+
+            opencv_onnx::NodeProto proto;
+            proto.add_output(constParams.name);
+            addLayer(constParams, proto);
+        }
+    }
+    addLayer(layerParams, node_proto);
+}
+
 // "Equal" "Greater" "Less" "Pow" "Add" "Sub" "Mul" "Div" "Sum" "Min" "Max" "GreaterOrEqual" "LessOrEqual"
 void ONNXImporter::parseElementWise(LayerParams& layerParams, const opencv_onnx::NodeProto& node_proto_)
 {
@@ -3718,6 +4022,8 @@ void ONNXImporter::buildDispatchMap_ONNX_AI(int opset_version)
     dispatch["SoftMax"] = dispatch["LogSoftmax"] = &ONNXImporter::parseSoftMax;
     dispatch["DetectionOutput"] = &ONNXImporter::parseDetectionOutput;
     dispatch["CumSum"] = &ONNXImporter::parseCumSum;
+    dispatch["LayerNormalization"] = &ONNXImporter::parseLayerNorm;
+    dispatch["ScaledDotProductAttention"] = &ONNXImporter::parseAttention;
     dispatch["SpaceToDepth"] = dispatch["DepthToSpace"] = &ONNXImporter::parseDepthToSpace;
 
     dispatch["Equal"] = dispatch["Greater"] = dispatch["Less"] = dispatch["Pow"] = dispatch["Add"] =
@@ -3790,7 +4096,8 @@ Mat readTensorFromONNX(const String& path)
     {
         CV_Error(Error::StsUnsupportedFormat, cv::format("Failed to parse ONNX data: %s", path.c_str()));
     }
-    Mat mat = getMatFromTensor(tensor_proto);
+    ONNXExternalData externalData(utils::fs::getParent(path));
+    Mat mat = getMatFromTensor(tensor_proto, &externalData);
     releaseONNXTensor(tensor_proto);
     return mat;
 }
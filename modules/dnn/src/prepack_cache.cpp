@@ -0,0 +1,375 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+#include "dnn_common.hpp"
+#include "mapped_file.hpp"
+#include "prepack_cache.hpp"
+
+#include <opencv2/core/utils/logger.hpp>
+#include <opencv2/core/utils/filesystem.hpp>
+#include <opencv2/core/utils/filesystem.private.hpp>
+
+#include <fstream>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#endif
+
+namespace cv { namespace dnn {
+
+namespace {
+
+// bump it when the file layout or any of the packed weights layouts changes
+enum { PREPACK_FORMAT_VERSION = 1 };
+static const char PREPACK_MAGIC[8] = { 'C', 'V', 'D', 'N', 'N', 'P', 'K', '\0' };
+enum { PREPACK_DATA_ALIGN = 64 };
+enum { PREPACK_SAMPLE_SIZE = 64, PREPACK_MAX_SAMPLES = 1024 };
+
+struct PrepackFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t nbuffers;
+    uint64_t key;
+    uint64_t fileSize;
+};
+
+struct PrepackBufferHeader
+{
+    int32_t type;
+    int32_t dims;
+    int32_t size[CV_MAX_DIM];
+    uint64_t offset;    // from the beginning of the file, aligned to PREPACK_DATA_ALIGN
+    uint64_t nbytes;
+};
+
+const uint64_t PRIME1 = 11400714785074694791ULL;
+const uint64_t PRIME2 = 14029467366897019727ULL;
+const uint64_t PRIME3 = 1609587929392839161ULL;
+const uint64_t PRIME4 = 9650029242287828579ULL;
+const uint64_t PRIME5 = 2870177450012600261ULL;
+
+inline uint64_t rotl64(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+inline uint64_t hashRound(uint64_t acc, uint64_t val)
+{
+    acc += val*PRIME2;
+    return rotl64(acc, 31)*PRIME1;
+}
+
+inline uint64_t load64(const uchar* p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// everything besides the layer itself the packed layout depends on
+const std::string& getPrepackEnvironment()
+{
+    static std::string env = [](){
+        std::ostringstream ss;
+        ss << (int)PREPACK_FORMAT_VERSION << ";" << CV_VERSION << ";" << getCPUFeaturesLine() << ";";
+        for (int i = 1; i < CPU_MAX_FEATURE; i++)
+            if (checkHardwareSupport(i))
+                ss << i << ",";
+        return ss.str();
+    }();
+    return env;
+}
+
+// hashes up to PREPACK_MAX_SAMPLES evenly spaced pieces of the data, all of it if it's small enough
+void addSampledData(PrepackCacheKey& key, const uchar* data, size_t nbytes)
+{
+    size_t nsamples = std::min((size_t)PREPACK_MAX_SAMPLES, nbytes/PREPACK_SAMPLE_SIZE);
+    if (nsamples < PREPACK_MAX_SAMPLES)
+    {
+        key.add(data, nbytes);
+        return;
+    }
+    size_t stride = (nbytes - PREPACK_SAMPLE_SIZE)/(nsamples - 1);
+    for (size_t i = 0; i < nsamples; i++)
+        key.add(data + i*stride, PREPACK_SAMPLE_SIZE);
+}
+
+// std::rename() doesn't replace the existing file on Windows
+bool replaceFile(const std::string& src, const std::string& dst)
+{
+#ifdef _WIN32
+    return MoveFileExA(src.c_str(), dst.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return std::rename(src.c_str(), dst.c_str()) == 0;
+#endif
+}
+
+std::string getPrepackFilePath(const std::string& dir, const PrepackCacheKey& key)
+{
+    char hex[32];
+    snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)key.hash());
+    return utils::fs::join(dir, key.tag() + "_" + hex + ".bin");
+}
+
+}  // namespace
+
+PrepackCacheKey::PrepackCacheKey(const char* tag) : tag_(tag), length_(0)
+{
+    state_[0] = PRIME1 + PRIME2;
+    state_[1] = PRIME2;
+    state_[2] = 0;
+    state_[3] = 0 - PRIME1;
+    const std::string& env = getPrepackEnvironment();
+    add(tag_.data(), tag_.size());
+    add(env.data(), env.size());
+}
+
+PrepackCacheKey& PrepackCacheKey::add(const void* data_, size_t nbytes)
+{
+    const uchar* data = (const uchar*)data_;
+    size_t i = 0;
+    for (; i + 32 <= nbytes; i += 32)
+    {
+        state_[0] = hashRound(state_[0], load64(data + i));
+        state_[1] = hashRound(state_[1], load64(data + i + 8));
+        state_[2] = hashRound(state_[2], load64(data + i + 16));
+        state_[3] = hashRound(state_[3], load64(data + i + 24));
+    }
+    for (; i + 8 <= nbytes; i += 8)
+        state_[0] = hashRound(state_[0], load64(data + i));
+    if (i < nbytes)
+    {
+        uint64_t tail = 0;
+        memcpy(&tail, data + i, nbytes - i);
+        state_[1] = hashRound(state_[1], tail);
+    }
+    // the number of bytes separates the consecutive pieces
+    state_[2] = hashRound(state_[2], (uint64_t)nbytes);
+    length_ += nbytes;
+    return *this;
+}
+
+PrepackCacheKey& PrepackCacheKey::operator<<(int val)
+{
+    return add(&val, sizeof(val));
+}
+
+PrepackCacheKey& PrepackCacheKey::operator<<(const std::string& str)
+{
+    return add(str.data(), str.size());
+}
+
+PrepackCacheKey& PrepackCacheKey::operator<<(const Mat& m)
+{
+    int header[2] = { m.type(), m.dims };
+    add(header, sizeof(header));
+    add(m.size.p, m.dims*sizeof(m.size.p[0]));
+    if (m.empty())
+        return *this;
+    if (m.isContinuous())
+        add(m.data, m.total()*m.elemSize());
+    else if (m.dims == 2)
+    {
+        for (int i = 0; i < m.rows; i++)
+            add(m.ptr(i), m.cols*m.elemSize());
+    }
+    else
+    {
+        Mat c = m.clone();
+        add(c.data, c.total()*c.elemSize());
+    }
+    return *this;
+}
+
+PrepackCacheKey& PrepackCacheKey::addWeights(const std::string& modelKey, const Mat& weights)
+{
+    if (modelKey.empty() || !weights.isContinuous())
+        return *this << weights;
+    *this << modelKey;
+    int header[2] = { weights.type(), weights.dims };
+    add(header, sizeof(header));
+    add(weights.size.p, weights.dims*sizeof(weights.size.p[0]));
+    addSampledData(*this, weights.data, weights.total()*weights.elemSize());
+    return *this;
+}
+
+uint64_t PrepackCacheKey::hash() const
+{
+    uint64_t h = rotl64(state_[0], 1) + rotl64(state_[1], 7) + rotl64(state_[2], 12) + rotl64(state_[3], 18);
+    for (int i = 0; i < 4; i++)
+    {
+        h ^= hashRound(0, state_[i]);
+        h = h*PRIME1 + PRIME4;
+    }
+    h += length_ + PRIME5;
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    h *= PRIME3;
+    h ^= h >> 32;
+    return h;
+}
+
+bool isPrepackCacheEnabled()
+{
+#if OPENCV_HAVE_FILESYSTEM_SUPPORT
+    return !getParam_DNN_PREPACK_CACHE_DIR().empty();
+#else
+    return false;
+#endif
+}
+
+std::string getPrepackModelKey(const std::vector<Ptr<MappedFile> >& files)
+{
+    CV_TRACE_FUNCTION();
+    // any change of the weights must change the key, so nothing is sampled here
+    PrepackCacheKey key("model");
+    for (size_t i = 0; i < files.size(); i++)
+        key.add(files[i]->data(), files[i]->size());
+    return cv::format("%016llx", (unsigned long long)key.hash());
+}
+
+bool loadPrepackedBuffers(const PrepackCacheKey& key, std::vector<Mat>& buffers)
+{
+    buffers.clear();
+    if (!isPrepackCacheEnabled())
+        return false;
+    std::string path = getPrepackFilePath(getParam_DNN_PREPACK_CACHE_DIR(), key);
+    if (!utils::fs::exists(path))
+        return false;
+    Ptr<MappedFile> file = MappedFile::open(path);
+    if (!file)
+    {
+        CV_LOG_WARNING(NULL, "DNN: can't open the prepacked weights file: " << path);
+        return false;
+    }
+
+    PrepackFileHeader header;
+    size_t fileSize = file->size();
+    if (fileSize < sizeof(header))
+    {
+        CV_LOG_WARNING(NULL, "DNN: invalid prepacked weights file: " << path);
+        return false;
+    }
+    memcpy(&header, file->data(), sizeof(header));
+    if (memcmp(header.magic, PREPACK_MAGIC, sizeof(PREPACK_MAGIC)) != 0 || header.version != PREPACK_FORMAT_VERSION ||
+        header.key != key.hash() || header.fileSize != fileSize ||
+        header.nbuffers > (fileSize - sizeof(header))/sizeof(PrepackBufferHeader))
+    {
+        CV_LOG_WARNING(NULL, "DNN: invalid prepacked weights file: " << path);
+        return false;
+    }
+
+    std::vector<Mat> result(header.nbuffers);
+    for (uint32_t i = 0; i < header.nbuffers; i++)
+    {
+        PrepackBufferHeader bh;
+        memcpy(&bh, file->data() + sizeof(header) + i*sizeof(bh), sizeof(bh));
+        size_t total = bh.dims > 0 ? CV_ELEM_SIZE(bh.type) : 0;
+        bool ok = bh.dims >= 0 && bh.dims <= CV_MAX_DIM && bh.type == CV_MAT_TYPE(bh.type) &&
+                  bh.offset % PREPACK_DATA_ALIGN == 0 && bh.offset <= fileSize && bh.nbytes <= fileSize - bh.offset;
+        for (int j = 0; ok && j < bh.dims; j++)
+        {
+            ok = bh.size[j] > 0 && total <= fileSize/bh.size[j];
+            total *= ok ? bh.size[j] : 0;
+        }
+        if (!ok || total != bh.nbytes)
+        {
+            CV_LOG_WARNING(NULL, "DNN: invalid prepacked weights file: " << path);
+            return false;
+        }
+        if (bh.dims > 0)
+            result[i] = MappedFile::wrap(file, (size_t)bh.offset, bh.dims, bh.size, bh.type);
+    }
+    CV_LOG_DEBUG(NULL, "DNN: loaded prepacked weights: " << path);
+    buffers.swap(result);
+    return true;
+}
+
+void savePrepackedBuffers(const PrepackCacheKey& key, const std::vector<Mat>& buffers)
+{
+    if (!isPrepackCacheEnabled())
+        return;
+    std::string dir = getParam_DNN_PREPACK_CACHE_DIR();
+    std::string path = getPrepackFilePath(dir, key);
+    try
+    {
+        if (!utils::fs::isDirectory(dir) && !utils::fs::createDirectories(dir))
+        {
+            CV_LOG_WARNING(NULL, "DNN: can't create the prepacked weights cache directory: " << dir);
+            return;
+        }
+
+        PrepackFileHeader header;
+        memcpy(header.magic, PREPACK_MAGIC, sizeof(PREPACK_MAGIC));
+        header.version = PREPACK_FORMAT_VERSION;
+        header.nbuffers = (uint32_t)buffers.size();
+        header.key = key.hash();
+
+        std::vector<PrepackBufferHeader> table(buffers.size());
+        uint64_t offset = sizeof(header) + table.size()*sizeof(table[0]);
+        for (size_t i = 0; i < buffers.size(); i++)
+        {
+            const Mat& m = buffers[i];
+            CV_Assert(m.empty() || m.isContinuous());
+            PrepackBufferHeader& bh = table[i];
+            memset(&bh, 0, sizeof(bh));
+            bh.type = m.type();
+            bh.dims = m.empty() ? 0 : m.dims;
+            for (int j = 0; j < bh.dims; j++)
+                bh.size[j] = m.size.p[j];
+            offset = alignSize((size_t)offset, PREPACK_DATA_ALIGN);
+            bh.offset = offset;
+            bh.nbytes = m.empty() ? 0 : m.total()*m.elemSize();
+            offset += bh.nbytes;
+        }
+        header.fileSize = offset;
+
+        // write to a temporary file and rename it, so the concurrent readers never see a partial file
+        std::string tmpPath = cv::format("%s.%llx.tmp", path.c_str(), (unsigned long long)getTickCount());
+        {
+            std::ofstream ofs(tmpPath.c_str(), std::ios::binary);
+            if (!ofs.is_open())
+            {
+                CV_LOG_WARNING(NULL, "DNN: can't write the prepacked weights file: " << tmpPath);
+                return;
+            }
+            ofs.write((const char*)&header, sizeof(header));
+            ofs.write((const char*)table.data(), table.size()*sizeof(table[0]));
+            uint64_t pos = sizeof(header) + table.size()*sizeof(table[0]);
+            const char zeros[PREPACK_DATA_ALIGN] = {0};
+            for (size_t i = 0; i < buffers.size(); i++)
+            {
+                ofs.write(zeros, (std::streamsize)(table[i].offset - pos));
+                ofs.write((const char*)buffers[i].data, (std::streamsize)table[i].nbytes);
+                pos = table[i].offset + table[i].nbytes;
+            }
+            if (!ofs.good())
+            {
+                ofs.close();
+                utils::fs::remove_all(tmpPath);
+                CV_LOG_WARNING(NULL, "DNN: can't write the prepacked weights file: " << tmpPath);
+                return;
+            }
+        }
+        // an existing entry is invalid (it hasn't been loaded) or is being stored by another process with the same contents
+        if (!replaceFile(tmpPath, path))
+        {
+            utils::fs::remove_all(tmpPath);
+            CV_LOG_WARNING(NULL, "DNN: can't store the prepacked weights file: " << path);
+        }
+        else
+        {
+            CV_LOG_DEBUG(NULL, "DNN: stored prepacked weights: " << path);
+        }
+    }
+    catch (const cv::Exception& e)
+    {
+        CV_LOG_WARNING(NULL, "DNN: can't store the prepacked weights file " << path << ": " << e.what());
+    }
+}
+
+}}  // namespace cv::dnn
@@ -0,0 +1,58 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_DNN_SRC_PREPACK_CACHE_HPP
+#define OPENCV_DNN_SRC_PREPACK_CACHE_HPP
+
+#include <opencv2/core.hpp>
+
+namespace cv { namespace dnn {
+
+// On-disk cache of the weights repacked by the layers for their compute kernels.
+// It is enabled by the OPENCV_DNN_PREPACK_CACHE_DIR configuration parameter. An entry is keyed by
+// the hash of everything the packed layout depends on: the layer kind, the library version,
+// the CPU features, the layer parameters and the source weights. The cached buffers are loaded
+// as memory-mapped Mats, so the processes using the same model share the packed weights.
+class PrepackCacheKey
+{
+public:
+    explicit PrepackCacheKey(const char* tag);
+
+    PrepackCacheKey& operator<<(int val);
+    PrepackCacheKey& operator<<(const std::string& str);
+    PrepackCacheKey& operator<<(const Mat& m);  // type, shape and contents
+    PrepackCacheKey& add(const void* data, size_t nbytes);
+
+    // The source weights of the layer. If the layer comes from a model file (modelKey is not empty),
+    // the weights are identified by the model key and the layer name and only a sparse sample of them
+    // is hashed to catch the changes made by the layers fusion. Otherwise all the weights are hashed.
+    PrepackCacheKey& addWeights(const std::string& modelKey, const Mat& weights);
+
+    const std::string& tag() const { return tag_; }
+    uint64_t hash() const;
+
+private:
+    std::string tag_;
+    uint64_t state_[4];
+    uint64_t length_;
+};
+
+bool isPrepackCacheEnabled();
+
+class MappedFile;
+
+// Identity of the model for the prepack_model_key layer parameter: the hash of the whole contents of the files
+// the model weights are read from. The importers compute it once per model, so the layers don't hash their
+// weights one by one on every start. The layers append their names to it.
+std::string getPrepackModelKey(const std::vector<Ptr<MappedFile> >& files);
+
+// returns false if there is no valid entry for the key
+bool loadPrepackedBuffers(const PrepackCacheKey& key, std::vector<Mat>& buffers);
+
+// stores the continuous buffers, errors are reported to the log only
+void savePrepackedBuffers(const PrepackCacheKey& key, const std::vector<Mat>& buffers);
+
+}}  // namespace cv::dnn
+
+#endif  // OPENCV_DNN_SRC_PREPACK_CACHE_HPP
@@ -130,6 +130,21 @@ void normAssertTextDetections(
 
 void readFileContent(const std::string& filename, CV_OUT std::vector<char>& content);
 
+// sets the environment variable the configuration parameter is read from
+void setConfigParam(const char* name, const std::string& value);
+
+// sets the configuration parameter for the scope, the previous value (or its absence) is restored on exit
+class ScopedConfigParam
+{
+public:
+    ScopedConfigParam(const char* name, const std::string& value);
+    ~ScopedConfigParam();
+
+private:
+    std::string name_, prevValue_;
+    bool wasSet_;
+};
+
 bool validateVPUType();
 
 testing::internal::ParamGenerator< tuple<Backend, Target> > dnnBackendsAndTargets(
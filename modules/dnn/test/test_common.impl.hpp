@@ -243,6 +243,41 @@ void readFileContent(const std::string& filename, CV_OUT std::vector<char>& cont
     ASSERT_FALSE(ifs.fail());
 }
 
+void setConfigParam(const char* name, const std::string& value)
+{
+#ifdef _WIN32
+    _putenv_s(name, value.c_str());
+#else
+    setenv(name, value.c_str(), 1);
+#endif
+}
+
+ScopedConfigParam::ScopedConfigParam(const char* name, const std::string& value)
+    : name_(name), wasSet_(false)
+{
+    const char* prev = getenv(name);
+    if (prev)
+    {
+        prevValue_ = prev;
+        wasSet_ = true;
+    }
+    setConfigParam(name, value);
+}
+
+ScopedConfigParam::~ScopedConfigParam()
+{
+    if (wasSet_)
+        setConfigParam(name_.c_str(), prevValue_);
+    else
+    {
+#ifdef _WIN32
+        _putenv_s(name_.c_str(), "");  // removes the variable
+#else
+        unsetenv(name_.c_str());
+#endif
+    }
+}
+
 
 testing::internal::ParamGenerator< tuple<Backend, Target> > dnnBackendsAndTargets(
         bool withInferenceEngine /*= true*/,
@@ -501,6 +501,108 @@ TEST_P(Test_Int8_layers, Eltwise)
 
 INSTANTIATE_TEST_CASE_P(/**/, Test_Int8_layers, dnnBackendsAndTargetsInt8());
 
+// Compares the int8 convolution with the direct computation of the quantized result.
+TEST(Layer_Test_Int8_Convolution, Accuracy)
+{
+    // inpCn, outCn, group, kernel, stride, pad, dilation
+    const int configs[][7] = {
+        {16, 32, 1, 1, 1, 0, 1},
+        {13, 20, 1, 3, 1, 1, 1},
+        {12, 24, 3, 3, 2, 1, 1},
+        {8, 10, 1, 3, 1, 2, 2},
+        {24, 24, 24, 3, 1, 1, 1},
+        {24, 24, 24, 3, 2, 1, 1},
+        {16, 16, 16, 5, 1, 2, 2}
+    };
+    const int N = 2, H = 23, W = 37, inpZp = 3, outZp = -5;
+    RNG& rng = TS::ptr()->get_rng();
+
+    for (size_t i = 0; i < sizeof(configs)/sizeof(configs[0]); i++)
+    {
+        const int C = configs[i][0], K = configs[i][1], group = configs[i][2], kernel = configs[i][3];
+        const int stride = configs[i][4], pad = configs[i][5], dilation = configs[i][6];
+        const int Cg = C / group, Kg = K / group, ksize = Cg*kernel*kernel;
+        const int H0 = (H + 2*pad - dilation*(kernel - 1) - 1)/stride + 1;
+        const int W0 = (W + 2*pad - dilation*(kernel - 1) - 1)/stride + 1;
+
+        int inpShape[] = {N, C, H, W}, wShape[] = {K, Cg, kernel, kernel};
+        Mat inputInt8(4, inpShape, CV_8S), input, weights(4, wShape, CV_8S);
+        Mat bias(1, K, CV_32S), multiplier(1, K, CV_32F);
+        rng.fill(inputInt8, RNG::UNIFORM, -128, 128);
+        rng.fill(weights, RNG::UNIFORM, -127, 128);
+        rng.fill(bias, RNG::UNIFORM, -10000, 10000);
+        rng.fill(multiplier, RNG::UNIFORM, 0.5f/(110*std::sqrt((float)ksize)), 1.5f/(110*std::sqrt((float)ksize)));
+        inputInt8.convertTo(input, CV_32F);
+
+        // ReLU in the quantized domain
+        Mat lut(1, 256, CV_8S);
+        for (int j = 0; j < 256; j++)
+            lut.at<schar>(j) = (schar)std::max(j - 128, outZp);
+
+        LayerParams qParams;
+        qParams.set("scales", 1.f);
+        qParams.set("zeropoints", 0);
+
+        LayerParams lp;
+        lp.set("kernel_size", kernel);
+        lp.set("stride", stride);
+        lp.set("pad", pad);
+        lp.set("dilation", dilation);
+        lp.set("group", group);
+        lp.set("num_output", K);
+        lp.set("bias_term", true);
+        lp.set("input_scale", 1.f);
+        lp.set("input_zeropoint", inpZp);
+        lp.set("scales", 1.f);
+        lp.set("zeropoints", outZp);
+        lp.blobs.push_back(weights);
+        lp.blobs.push_back(bias);
+        lp.blobs.push_back(multiplier);
+
+        LayerParams reluParams;
+        reluParams.set("input_scale", 1.f);
+        reluParams.set("input_zeropoint", outZp);
+        reluParams.set("scales", 1.f);
+        reluParams.set("zeropoints", outZp);
+        reluParams.blobs.push_back(lut);
+
+        Net net;
+        net.addLayerToPrev("quantize", "Quantize", CV_8S, qParams);
+        net.addLayerToPrev("conv", "ConvolutionInt8", CV_8S, lp);
+        net.addLayerToPrev("relu", "ReLUInt8", CV_8S, reluParams);
+        net.setPreferableBackend(DNN_BACKEND_OPENCV);
+        net.setInput(input);
+        Mat out = net.forward();
+        ASSERT_EQ(out.type(), CV_8S);
+
+        int outShape[] = {N, K, H0, W0};
+        Mat ref(4, outShape, CV_8S);
+        for (int n = 0; n < N; n++)
+            for (int k = 0; k < K; k++)
+            {
+                const int g = k / Kg;
+                for (int y = 0; y < H0; y++)
+                    for (int x = 0; x < W0; x++)
+                    {
+                        int s = bias.at<int>(k);
+                        for (int c = 0; c < Cg; c++)
+                            for (int ky = 0; ky < kernel; ky++)
+                                for (int kx = 0; kx < kernel; kx++)
+                                {
+                                    int yi = y*stride - pad + ky*dilation, xi = x*stride - pad + kx*dilation;
+                                    int v = yi >= 0 && yi < H && xi >= 0 && xi < W ?
+                                            inputInt8.ptr<schar>(n, g*Cg + c)[yi*W + xi] : inpZp;
+                                    s += v*weights.ptr<schar>(k, c)[ky*kernel + kx];
+                                }
+                        schar q = saturate_cast<schar>(outZp + cvRound(s*multiplier.at<float>(k)));
+                        ref.ptr<schar>(n, k)[y*W0 + x] = lut.at<schar>(q + 128);
+                    }
+            }
+        // the rounding of ties may differ between the vectorized and the scalar code
+        EXPECT_LE(cvtest::norm(ref, out, NORM_INF), 1) << "config " << i;
+    }
+}
+
 class Test_Int8_nets : public DNNTestLayer
 {
 public:
@@ -2611,4 +2611,510 @@ INSTANTIATE_TEST_CASE_P(TestLayerFusion, ConvolutionActivationEltwiseFusion, Com
                         TestLayerFusion::dnnBackendsAndTargetsForFusionTests()
 ));
 
+// The CPU kernels below split their work between the threads,
+// so they are checked against plain loops with several threads enabled.
+class Layer_Test_CPU_Parallel : public testing::Test
+{
+protected:
+    virtual void SetUp() CV_OVERRIDE
+    {
+        nthreads = getNumThreads();
+        setNumThreads(4);
+    }
+    virtual void TearDown() CV_OVERRIDE
+    {
+        setNumThreads(nthreads);
+    }
+    int nthreads;
+};
+
+// Index of the broadcasted element of a blob with the given shape aligned to the right of the output.
+static size_t broadcastIndex(const MatShape& shape, const MatShape& outShape, const std::vector<int>& idx)
+{
+    size_t ofs = 0;
+    const int shift = (int)(outShape.size() - shape.size());
+    for (int i = 0; i < (int)shape.size(); i++)
+        ofs = ofs * shape[i] + (shape[i] == 1 ? 0 : idx[i + shift]);
+    return ofs;
+}
+
+TEST_F(Layer_Test_CPU_Parallel, NaryEltwise_broadcast)
+{
+    const int aShape[] = {2, 3, 1, 19}, bShape[] = {3, 4, 1}, cShape[] = {2, 1, 1, 19};
+    const int outShape[] = {2, 3, 4, 19};
+    Mat a(4, aShape, CV_32F), b(3, bShape, CV_32F), c(4, cShape, CV_32F);
+    randu(a, 1, 2);
+    randu(b, 1, 2);
+    randu(c, -1, 1);
+
+    const std::string ops[] = {"add", "sub", "mul", "div", "max", "min", "sum"};
+    for (size_t k = 0; k < sizeof(ops)/sizeof(ops[0]); k++)
+    {
+        // the n-ary operations also get a third input varying along the outermost axis
+        const bool nary = ops[k] == "sum" || ops[k] == "max";
+        LayerParams lp;
+        lp.type = "NaryEltwise";
+        lp.name = "testLayer";
+        lp.set("operation", ops[k]);
+        Ptr<Layer> layer = LayerFactory::createLayerInstance(lp.type, lp);
+
+        std::vector<Mat> inputs(1, a), outputs;
+        inputs.push_back(b);
+        if (nary)
+            inputs.push_back(c);
+        runLayer(layer, inputs, outputs);
+        ASSERT_EQ(1u, outputs.size());
+        ASSERT_EQ(shape(outShape, 4), shape(outputs[0]));
+
+        Mat ref(4, outShape, CV_32F);
+        std::vector<int> idx(4);
+        for (size_t i = 0; i < ref.total(); i++)
+        {
+            size_t rest = i;
+            for (int d = 3; d >= 0; d--)
+            {
+                idx[d] = (int)(rest % outShape[d]);
+                rest /= outShape[d];
+            }
+            float x = a.ptr<float>()[broadcastIndex(shape(a), shape(ref), idx)];
+            float y = b.ptr<float>()[broadcastIndex(shape(b), shape(ref), idx)];
+            float z = c.ptr<float>()[broadcastIndex(shape(c), shape(ref), idx)];
+            float r = ops[k] == "add" ? x + y : ops[k] == "sub" ? x - y : ops[k] == "mul" ? x * y :
+                      ops[k] == "div" ? x / y : ops[k] == "min" ? std::min(x, y) :
+                      ops[k] == "max" ? std::max(std::max(x, y), z) :
+                      x + y + z;
+            ref.ptr<float>()[i] = r;
+        }
+        normAssert(ref, outputs[0], ops[k].c_str());
+    }
+}
+
+TEST_F(Layer_Test_CPU_Parallel, Softmax_axes)
+{
+    const int shapes[][4] = { {2, 5, 3, 37}, {2, 5, 3, 37}, {1, 4, 600, 1}, {3, 1, 2, 1000} };
+    const int axes[] = {1, 3, 1, 3};
+    for (int k = 0; k < 4; k++)
+    {
+        Mat inp(4, shapes[k], CV_32F);
+        randu(inp, -10, 10);
+        const int axis = axes[k];
+        const size_t outer = inp.total(0, axis), channels = inp.size[axis], inner = inp.total(axis + 1);
+
+        for (int logSoftMax = 0; logSoftMax < 2; logSoftMax++)
+        {
+            LayerParams lp;
+            lp.type = "Softmax";
+            lp.name = "testLayer";
+            lp.set("axis", axis);
+            lp.set("log_softmax", logSoftMax != 0);
+            Ptr<Layer> layer = LayerFactory::createLayerInstance(lp.type, lp);
+
+            std::vector<Mat> inputs(1, inp), outputs;
+            runLayer(layer, inputs, outputs);
+
+            Mat ref(4, shapes[k], CV_32F);
+            const float* src = inp.ptr<float>();
+            float* dst = ref.ptr<float>();
+            for (size_t o = 0; o < outer; o++)
+            {
+                for (size_t i = 0; i < inner; i++)
+                {
+                    const size_t base = o * channels * inner + i;
+                    double maxVal = src[base], sum = 0;
+                    for (size_t c = 1; c < channels; c++)
+                        maxVal = std::max(maxVal, (double)src[base + c * inner]);
+                    for (size_t c = 0; c < channels; c++)
+                        sum += std::exp(src[base + c * inner] - maxVal);
+                    for (size_t c = 0; c < channels; c++)
+                    {
+                        double v = src[base + c * inner] - maxVal;
+                        dst[base + c * inner] = (float)(logSoftMax ? v - std::log(sum) : std::exp(v) / sum);
+                    }
+                }
+            }
+            normAssert(ref, outputs[0], cv::format("axis=%d, log=%d", axis, logSoftMax).c_str(), 1e-5, 1e-4);
+        }
+    }
+}
+
+TEST_F(Layer_Test_CPU_Parallel, Slice_steps)
+{
+    const int inpShape[] = {2, 5, 7, 9};
+    const int begin[] = {0, 1, 2, 1}, end[] = {2, 5, 7, 9}, steps[] = {1, 2, 2, 3};
+    Mat inp(4, inpShape, CV_32F);
+    randu(inp, -1, 1);
+
+    LayerParams lp;
+    lp.type = "Slice";
+    lp.name = "testLayer";
+    lp.set("begin", DictValue::arrayInt<const int*>(begin, 4));
+    lp.set("end", DictValue::arrayInt<const int*>(end, 4));
+    lp.set("steps", DictValue::arrayInt<const int*>(steps, 4));
+    Ptr<Layer> layer = LayerFactory::createLayerInstance(lp.type, lp);
+
+    std::vector<Mat> inputs(1, inp), outputs;
+    runLayer(layer, inputs, outputs);
+
+    const int outShape[] = {2, 2, 3, 3};
+    ASSERT_EQ(shape(outShape, 4), shape(outputs[0]));
+    Mat ref(4, outShape, CV_32F);
+    for (int n = 0; n < outShape[0]; n++)
+        for (int c = 0; c < outShape[1]; c++)
+            for (int y = 0; y < outShape[2]; y++)
+                for (int x = 0; x < outShape[3]; x++)
+                {
+                    int dstIdx[] = {n, c, y, x};
+                    int srcIdx[] = {begin[0] + n * steps[0], begin[1] + c * steps[1],
+                                    begin[2] + y * steps[2], begin[3] + x * steps[3]};
+                    ref.at<float>(dstIdx) = inp.at<float>(srcIdx);
+                }
+    normAssert(ref, outputs[0], "", 0, 0);
+}
+
+TEST_F(Layer_Test_CPU_Parallel, Gather_negative_indices)
+{
+    const int inpShape[] = {3, 4, 5};
+    Mat inp(3, inpShape, CV_32F);
+    randu(inp, -1, 1);
+    Mat indices = (Mat_<float>(1, 3) << -1, 2, 0);
+
+    LayerParams lp;
+    lp.type = "Gather";
+    lp.name = "testLayer";
+    lp.set("axis", 1);
+    Ptr<Layer> layer = LayerFactory::createLayerInstance(lp.type, lp);
+
+    std::vector<Mat> inputs(1, inp), outputs;
+    inputs.push_back(indices);
+    runLayer(layer, inputs, outputs);
+
+    const int outShape[] = {3, 1, 3, 5};
+    ASSERT_EQ(shape(outShape, 4), shape(outputs[0]));
+    for (int n = 0; n < 3; n++)
+        for (int j = 0; j < 3; j++)
+            for (int x = 0; x < 5; x++)
+            {
+                int dstIdx[] = {n, 0, j, x};
+                int srcIdx[] = {n, ((int)indices.at<float>(j) + 4) % 4, x};
+                EXPECT_EQ(inp.at<float>(srcIdx), outputs[0].at<float>(dstIdx));
+            }
+}
+
+TEST_F(Layer_Test_CPU_Parallel, Padding_constant)
+{
+    const int inpShape[] = {2, 3, 4, 5};
+    const int paddings[] = {0, 1, 1, 2, 0, 1, 3, 0};
+    Mat inp(4, inpShape, CV_32F);
+    randu(inp, -1, 1);
+
+    LayerParams lp;
+    lp.type = "Padding";
+    lp.name = "testLayer";
+    lp.set("paddings", DictValue::arrayInt<const int*>(paddings, 8));
+    lp.set("value", 0.5);
+    Ptr<Layer> layer = LayerFactory::createLayerInstance(lp.type, lp);
+
+    std::vector<Mat> inputs(1, inp), outputs;
+    runLayer(layer, inputs, outputs);
+
+    const int outShape[] = {3, 6, 5, 8};
+    ASSERT_EQ(shape(outShape, 4), shape(outputs[0]));
+    Mat ref(4, outShape, CV_32F, Scalar(0.5));
+    std::vector<Range> ranges(4);
+    for (int i = 0; i < 4; i++)
+        ranges[i] = Range(paddings[i * 2], paddings[i * 2] + inpShape[i]);
+    inp.copyTo(ref(ranges));
+    normAssert(ref, outputs[0], "", 0, 0);
+}
+
+TEST_F(Layer_Test_CPU_Parallel, MVN_rows)
+{
+    const int inpShape[] = {2, 3, 4, 5};
+    Mat inp(4, inpShape, CV_32F);
+    randu(inp, -1, 1);
+
+    for (int acrossChannels = 0; acrossChannels < 2; acrossChannels++)
+    {
+        LayerParams lp;
+        lp.type = "MVN";
+        lp.name = "testLayer";
+        lp.set("across_channels", acrossChannels != 0);
+        Ptr<Layer> layer = LayerFactory::createLayerInstance(lp.type, lp);
+
+        std::vector<Mat> inputs(1, inp), outputs;
+        runLayer(layer, inputs, outputs);
+
+        const int rows = acrossChannels ? 2 : 6;
+        Mat src = inp.reshape(1, rows), ref(rows, (int)inp.total() / rows, CV_32F);
+        for (int i = 0; i < rows; i++)
+        {
+            Scalar mean, dev;
+            meanStdDev(src.row(i), mean, dev);
+            src.row(i).convertTo(ref.row(i), CV_32F, 1 / std::sqrt(1e-9 + dev[0] * dev[0]),
+                                 -mean[0] / std::sqrt(1e-9 + dev[0] * dev[0]));
+        }
+        normAssert(ref, outputs[0].reshape(1, rows));
+    }
+}
+
+TEST_F(Layer_Test_CPU_Parallel, Resize_align_corners)
+{
+    const int inpShape[] = {2, 3, 5, 7};
+    Mat inp(4, inpShape, CV_32F);
+    randu(inp, -1, 1);
+    const int outH = 9, outW = 16;
+    const float scaleH = 4.f / (outH - 1), scaleW = 6.f / (outW - 1);
+
+    const std::string modes[] = {"nearest", "bilinear"};
+    for (int k = 0; k < 2; k++)
+    {
+        LayerParams lp;
+        lp.type = "Resize";
+        lp.name = "testLayer";
+        lp.set("interpolation", modes[k]);
+        lp.set("align_corners", true);
+        lp.set("height", outH);
+        lp.set("width", outW);
+        Ptr<Layer> layer = LayerFactory::createLayerInstance(lp.type, lp);
+
+        std::vector<Mat> inputs(1, inp), outputs;
+        runLayer(layer, inputs, outputs);
+
+        const int outShape[] = {2, 3, outH, outW};
+        ASSERT_EQ(shape(outShape, 4), shape(outputs[0]));
+        Mat ref(4, outShape, CV_32F);
+        for (int n = 0; n < 2; n++)
+            for (int c = 0; c < 3; c++)
+            {
+                Mat src = getPlane(inp, n, c), dst = getPlane(ref, n, c);
+                for (int y = 0; y < outH; y++)
+                    for (int x = 0; x < outW; x++)
+                    {
+                        float fy = y * scaleH, fx = x * scaleW;
+                        if (k == 0)
+                        {
+                            dst.at<float>(y, x) = src.at<float>(std::min((int)lroundf(fy), 4),
+                                                                std::min((int)lroundf(fx), 6));
+                            continue;
+                        }
+                        int y0 = (int)fy, x0 = (int)fx;
+                        int y1 = std::min(y0 + 1, 4), x1 = std::min(x0 + 1, 6);
+                        float dy = fy - y0, dx = fx - x0;
+                        dst.at<float>(y, x) = (1 - dy) * ((1 - dx) * src.at<float>(y0, x0) + dx * src.at<float>(y0, x1)) +
+                                              dy * ((1 - dx) * src.at<float>(y1, x0) + dx * src.at<float>(y1, x1));
+                    }
+            }
+        normAssert(ref, outputs[0], modes[k].c_str());
+    }
+}
+
+TEST_F(Layer_Test_CPU_Parallel, LayerNorm)
+{
+    const int inpShape[] = {2, 3, 5, 19};
+    Mat inp(4, inpShape, CV_32F);
+    randu(inp, -1, 1);
+    inp += 10;  // a large mean must not affect the precision
+
+    for (int axis = -2; axis <= -1; axis++)
+    {
+        const int rows = axis == -1 ? 30 : 6, cols = (int)inp.total() / rows;
+        Mat scale(1, cols, CV_32F), bias(1, cols, CV_32F);
+        randu(scale, -1, 1);
+        randu(bias, -1, 1);
+
+        LayerParams lp;
+        lp.type = "LayerNormalization";
+        lp.name = "testLayer";
+        lp.set("axis", axis);
+        lp.set("epsilon", 1e-3f);
+        lp.blobs.push_back(scale);
+        lp.blobs.push_back(bias);
+        Ptr<Layer> layer = LayerFactory::createLayerInstance(lp.type, lp);
+
+        std::vector<Mat> inputs(1, inp), outputs;
+        runLayer(layer, inputs, outputs);
+
+        Mat src = inp.reshape(1, rows), ref(rows, cols, CV_32F);
+        for (int i = 0; i < rows; i++)
+        {
+            Scalar mean, dev;
+            meanStdDev(src.row(i), mean, dev);
+            const double inv = 1 / std::sqrt(dev[0] * dev[0] + 1e-3);
+            src.row(i).convertTo(ref.row(i), CV_32F, inv, -mean[0] * inv);
+            ref.row(i) = ref.row(i).mul(scale) + bias;
+        }
+        normAssert(ref, outputs[0].reshape(1, rows), cv::format("axis=%d", axis).c_str());
+    }
+}
+
+TEST_F(Layer_Test_CPU_Parallel, Attention_broadcast_mask)
+{
+    // the number of queries is not a multiple of the block size
+    const int S = 37, L = 21, D = 8, Dv = 5;
+    const int qShape[] = {2, 3, S, D}, kShape[] = {3, D, L}, vShape[] = {2, 1, L, Dv}, maskShape[] = {2, 1, 1, L};
+    Mat q(4, qShape, CV_32F), k(3, kShape, CV_32F), v(4, vShape, CV_32F), mask(4, maskShape, CV_32F);
+    randu(q, -1, 1);
+    randu(k, -1, 1);
+    randu(v, -1, 1);
+    randu(mask, -2, 0);
+    const float scale = 0.35f;
+
+    for (int withMask = 0; withMask < 2; withMask++)
+    {
+        LayerParams lp;
+        lp.type = "Attention";
+        lp.name = "testLayer";
+        lp.set("scale", scale);
+        Ptr<Layer> layer = LayerFactory::createLayerInstance(lp.type, lp);
+
+        std::vector<Mat> inputs, outputs;
+        inputs.push_back(q);
+        inputs.push_back(k);
+        inputs.push_back(v);
+        if (withMask)
+            inputs.push_back(mask);
+        runLayer(layer, inputs, outputs);
+
+        const int outShape[] = {2, 3, S, Dv};
+        ASSERT_EQ(shape(outShape, 4), shape(outputs[0]));
+        Mat ref(4, outShape, CV_32F);
+        for (int n = 0; n < 2; n++)
+            for (int c = 0; c < 3; c++)
+            {
+                Mat qc(S, D, CV_32F, q.ptr<float>(n, c)), kc(D, L, CV_32F, k.ptr<float>(c));
+                Mat vc(L, Dv, CV_32F, v.ptr<float>(n, 0)), weights = qc * kc * scale;
+                for (int i = 0; i < S; i++)
+                {
+                    Mat w = weights.row(i);
+                    if (withMask)
+                        w += Mat(1, L, CV_32F, mask.ptr<float>(n, 0));
+                    double maxVal;
+                    minMaxLoc(w, 0, &maxVal);
+                    exp(w - maxVal, w);
+                    w /= sum(w)[0];
+                }
+                Mat(weights * vc).copyTo(Mat(S, Dv, CV_32F, ref.ptr<float>(n, c)));
+            }
+        normAssert(ref, outputs[0], withMask ? "mask" : "");
+    }
+}
+
+TEST_F(Layer_Test_CPU_Parallel, MatMul_broadcast_transpose)
+{
+    // K is larger than a block of the packed kernel, M and N are not multiples of the tiles
+    const int M = 70, K = 300, N = 101;
+    for (int iter = 0; iter < 8; iter++)
+    {
+        const bool transA = (iter & 1) != 0, transB = (iter & 2) != 0, constB = (iter & 4) != 0;
+        const int aShape[] = {2, 1, transA ? K : M, transA ? M : K};
+        const int bShape[] = {3, transB ? N : K, transB ? K : N};
+        Mat a(4, aShape, CV_32F), b(3, bShape, CV_32F);
+        randu(a, -1, 1);
+        randu(b, -1, 1);
+
+        LayerParams lp;
+        lp.type = "MatMul";
+        lp.name = "testLayer";
+        lp.set("transA", transA);
+        lp.set("transB", transB);
+        if (constB)
+            lp.blobs.push_back(b);
+        Ptr<Layer> layer = LayerFactory::createLayerInstance(lp.type, lp);
+        if (constB)
+        {
+            EXPECT_TRUE(layer->blobs[0].empty()) << "only the packed copy of B is kept";
+        }
+
+        std::vector<Mat> inputs(1, a), outputs;
+        if (!constB)
+            inputs.push_back(b);
+        runLayer(layer, inputs, outputs);
+
+        const int outShape[] = {2, 3, M, N};
+        ASSERT_EQ(shape(outShape, 4), shape(outputs[0]));
+        Mat ref(4, outShape, CV_32F);
+        for (int n = 0; n < 2; n++)
+            for (int c = 0; c < 3; c++)
+            {
+                Mat an(aShape[2], aShape[3], CV_32F, a.ptr<float>(n)), bc(bShape[1], bShape[2], CV_32F, b.ptr<float>(c));
+                Mat dst(M, N, CV_32F, ref.ptr<float>(n, c));
+                cv::gemm(an, bc, 1, noArray(), 0, dst, (transA ? GEMM_1_T : 0) | (transB ? GEMM_2_T : 0));
+            }
+        normAssert(ref, outputs[0], cv::format("transA=%d transB=%d constB=%d", transA, transB, constB).c_str(), 1e-4, 1e-3);
+    }
+}
+
+TEST_F(Layer_Test_CPU_Parallel, MatMul_gemm_bias)
+{
+    const int M = 5, K = 17, N = 29;
+    Mat a(K, M, CV_32F), b(K, N, CV_32F);
+    randu(a, -1, 1);
+    randu(b, -1, 1);
+    const float alpha = 0.5f, beta = 2.f;
+
+    Mat biases[] = {Mat(1, 1, CV_32F), Mat(1, N, CV_32F), Mat(M, 1, CV_32F), Mat(M, N, CV_32F)};
+    for (size_t i = 0; i < sizeof(biases) / sizeof(biases[0]); i++)
+    {
+        Mat& bias = biases[i];
+        randu(bias, -1, 1);
+
+        LayerParams lp;
+        lp.type = "MatMul";
+        lp.name = "testLayer";
+        lp.set("transA", true);
+        lp.set("alpha", alpha);
+        lp.set("beta", beta);
+        lp.set("bias_term", true);
+        lp.blobs.push_back(b);
+        lp.blobs.push_back(bias);
+        Ptr<Layer> layer = LayerFactory::createLayerInstance(lp.type, lp);
+
+        std::vector<Mat> inputs(1, a), outputs;
+        runLayer(layer, inputs, outputs);
+
+        Mat ref, broadcastedBias;
+        repeat(bias, M / bias.rows, N / bias.cols, broadcastedBias);
+        cv::gemm(a, b, alpha, broadcastedBias, beta, ref, GEMM_1_T);
+        normAssert(ref, outputs[0], cv::format("bias %dx%d", bias.rows, bias.cols).c_str());
+    }
+}
+
+TEST_F(Layer_Test_CPU_Parallel, InnerProduct_packed_rows)
+{
+    // a single row is multiplied by the unpacked weights, several rows by the packed ones
+    const int K = 300, N = 101;
+    Mat weights(N, K, CV_32F), bias(1, N, CV_32F);
+    randu(weights, -1, 1);
+    randu(bias, -1, 1);
+    const int rows[] = {1, 3, 70};
+    for (size_t i = 0; i < sizeof(rows) / sizeof(rows[0]); i++)
+    {
+        const int M = rows[i];
+        LayerParams lp;
+        lp.type = "InnerProduct";
+        lp.name = "testLayer";
+        lp.set("num_output", N);
+        lp.set("axis", 2);
+        lp.blobs.push_back(weights.clone());
+        lp.blobs.push_back(bias);
+        Ptr<InnerProductLayer> layer = InnerProductLayer::create(lp);
+        LayerParams lpReLU;
+        ASSERT_TRUE(layer->setActivation(ReLULayer::create(lpReLU)));
+
+        std::vector<int> inpShape(3);
+        inpShape[0] = 1;
+        inpShape[1] = M;
+        inpShape[2] = K;
+        Mat a(inpShape, CV_32F);
+        randu(a, -1, 1);
+        std::vector<Mat> inputs(1, a), outputs;
+        runLayer(layer, inputs, outputs);
+
+        Mat ref;
+        cv::gemm(a.reshape(1, M), weights, 1, repeat(bias, M, 1), 1, ref, GEMM_2_T);
+        ref = cv::max(ref, 0);
+        normAssert(ref, outputs[0].reshape(1, M), cv::format("M=%d", M).c_str(), 1e-4, 1e-3);
+    }
+}
+
 }} // namespace
@@ -7,8 +7,11 @@
 
 #include "test_precomp.hpp"
 #include <opencv2/core/ocl.hpp>
+#include <opencv2/core/utils/filesystem.hpp>
 #include <opencv2/core/opencl/ocl_defs.hpp>
 #include <opencv2/dnn/layer.details.hpp>  // CV_DNN_REGISTER_LAYER_CLASS
+#include <opencv2/dnn/shape_utils.hpp>
+#include <thread>
 
 namespace opencv_test { namespace {
 
@@ -436,6 +439,510 @@ TEST(Net, forwardAndRetrieve)
     normAssert(outBlobs[0][1], inp.rowRange(2, 4), "second part");
 }
 
+TEST(Net, blobs_memory_plan)
+{
+    // the chain of the layers which can not work in-place, every one needs two blobs at a time
+    const int depth = 8;
+    Net net;
+    int prevId = 0;
+    for (int i = 0; i < depth; i++)
+    {
+        LayerParams lp;
+        lp.set("operation", "sum");
+        lp.type = "Eltwise";
+        lp.name = format("sum_%d", i);
+        int id = net.addLayer(lp.name, lp.type, lp);
+        net.connect(prevId, 0, id, 0);
+        net.connect(prevId, 0, id, 1);
+        prevId = id;
+    }
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+
+    MatShape inpShape = shape(1, 8, 16, 16);
+    const size_t blobSize = total(inpShape)*sizeof(float);
+    size_t weights = 0, blobs = 0;
+    net.getMemoryConsumption(inpShape, weights, blobs);
+    // the input and two blobs of the arena
+    EXPECT_EQ(3*blobSize, blobs);
+
+    std::vector<int> layerIds;
+    std::vector<size_t> layerWeights, layerBlobs;
+    net.getMemoryConsumption(inpShape, layerIds, layerWeights, layerBlobs);
+    size_t layerBlobsTotal = 0;
+    for (size_t i = 0; i < layerBlobs.size(); i++)
+        layerBlobsTotal += layerBlobs[i];
+    EXPECT_LT(blobs, layerBlobsTotal);
+
+    // the other backends don't use the arena, the sum over the layers is reported (no forward is needed)
+    net.setPreferableBackend(DNN_BACKEND_CUDA);
+    size_t cudaBlobs = 0;
+    net.getMemoryConsumption(inpShape, weights, cudaBlobs);
+    EXPECT_EQ(layerBlobsTotal, cudaBlobs);
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+
+    Mat inp(inpShape, CV_32F), ref;
+    randu(inp, -1, 1);
+    inp.convertTo(ref, CV_32F, 1 << depth);
+    for (int iter = 0; iter < 2; iter++)
+    {
+        net.setInput(inp);
+        Mat out = net.forward();
+        normAssert(ref, out);
+    }
+
+    // the intermediate blob requested in addition to the output must not be overwritten
+    std::vector<Mat> outs;
+    std::vector<String> outNames;
+    outNames.push_back("sum_2");
+    outNames.push_back(format("sum_%d", depth - 1));
+    net.setInput(inp);
+    net.forward(outs, outNames);
+    ASSERT_EQ(2u, outs.size());
+    Mat ref2;
+    inp.convertTo(ref2, CV_32F, 8);
+    normAssert(ref2, outs[0], "sum_2");
+    normAssert(ref, outs[1], format("sum_%d", depth - 1).c_str());
+}
+
+static LayerParams makeConvParams(const String& name, int inpCn, int outCn)
+{
+    int sz[] = {outCn, inpCn, 3, 3};
+    Mat weights(4, &sz[0], CV_32F), bias(1, outCn, CV_32F);
+    randu(weights, -1.0f, 1.0f);
+    randu(bias, -1.0f, 1.0f);
+
+    LayerParams lp;
+    lp.set("kernel_size", 3);
+    lp.set("pad", 1);
+    lp.set("num_output", outCn);
+    lp.set("bias_term", true);
+    lp.type = "Convolution";
+    lp.name = name;
+    lp.blobs.push_back(weights);
+    lp.blobs.push_back(bias);
+    return lp;
+}
+
+TEST(Net, infer_request_concurrent)
+{
+    // conv -> relu -> two convolutions -> concat: fused activation and concat share the blobs
+    Net net;
+    LayerParams lp = makeConvParams("conv1", 3, 8);
+    int conv1 = net.addLayer(lp.name, lp.type, lp);
+    net.connect(0, 0, conv1, 0);
+    LayerParams lpRelu;
+    lpRelu.type = "ReLU";
+    lpRelu.name = "relu1";
+    int relu1 = net.addLayer(lpRelu.name, lpRelu.type, lpRelu);
+    net.connect(conv1, 0, relu1, 0);
+    lp = makeConvParams("conv2", 8, 4);
+    int conv2 = net.addLayer(lp.name, lp.type, lp);
+    net.connect(relu1, 0, conv2, 0);
+    lp = makeConvParams("conv3", 8, 4);
+    int conv3 = net.addLayer(lp.name, lp.type, lp);
+    net.connect(relu1, 0, conv3, 0);
+    LayerParams lpConcat;
+    lpConcat.set("axis", 1);
+    lpConcat.type = "Concat";
+    lpConcat.name = "concat";
+    int concat = net.addLayer(lpConcat.name, lpConcat.type, lpConcat);
+    net.connect(conv2, 0, concat, 0);
+    net.connect(conv3, 0, concat, 1);
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+
+    const int numRequests = 4;
+    std::vector<Mat> inputs(numRequests), refs(numRequests);
+    for (int i = 0; i < numRequests; i++)
+    {
+        inputs[i].create(shape(1, 3, 24, 32), CV_32F);
+        randu(inputs[i], -1.0f, 1.0f);
+        net.setInput(inputs[i]);
+        refs[i] = net.forward().clone();
+    }
+
+    std::vector<InferRequest> requests(numRequests);
+    for (int i = 0; i < numRequests; i++)
+    {
+        requests[i] = net.createInferRequest();
+        ASSERT_FALSE(requests[i].empty());
+    }
+
+    std::vector<Mat> outs(numRequests);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numRequests; i++)
+    {
+        threads.push_back(std::thread([&, i]{
+            for (int iter = 0; iter < 5; iter++)
+            {
+                requests[i].setInput(inputs[i]);
+                outs[i] = requests[i].forward().clone();
+                if (cv::norm(outs[i], refs[i], NORM_INF) > 1e-5)
+                    break;
+            }
+        }));
+    }
+    for (int i = 0; i < numRequests; i++)
+        threads[i].join();
+    for (int i = 0; i < numRequests; i++)
+        normAssert(refs[i], outs[i], format("request %d", i).c_str());
+
+    // several outputs, the requests do not affect the network blobs
+    std::vector<String> outNames;
+    outNames.push_back("relu1");
+    outNames.push_back("concat");
+    InferRequest request = net.createInferRequest(outNames);
+    std::vector<Mat> netOuts, reqOuts;
+    net.setInput(inputs[0]);
+    net.forward(netOuts, outNames);
+    request.setInput(inputs[1]);
+    request.forward(reqOuts);
+    ASSERT_EQ(2u, reqOuts.size());
+    normAssert(refs[1], reqOuts[1], "concat");
+    normAssert(refs[0], netOuts[1], "network");
+
+    EXPECT_ANY_THROW(request.setInput(Mat(shape(1, 3, 8, 8), CV_32F)));
+    // the requests become invalid when the network is reallocated
+    net.setInput(Mat(shape(1, 3, 8, 8), CV_32F, Scalar(0)));
+    net.forward();
+    EXPECT_ANY_THROW(requests[0].forward());
+}
+
+TEST(Net, infer_request_lstm_threads)
+{
+    // LSTM keeps the recurrent state in the request internals, Exp is run by one request at a time
+    const int numTimeStamps = 6, numFeatures = 8, numHidden = 16;
+    LayerParams lp;
+    lp.type = "LSTM";
+    lp.name = "lstm";
+    lp.blobs.resize(5);
+    lp.blobs[0].create(4 * numHidden, numHidden, CV_32F);  // Wh
+    lp.blobs[1].create(4 * numHidden, numFeatures, CV_32F);  // Wx
+    lp.blobs[2].create(1, 4 * numHidden, CV_32F);  // bias
+    lp.blobs[3].create(1, numHidden, CV_32F);  // h0
+    lp.blobs[4].create(1, numHidden, CV_32F);  // c0
+    for (size_t i = 0; i < lp.blobs.size(); i++)
+        randu(lp.blobs[i], -0.5f, 0.5f);
+    lp.set("use_timestamp_dim", true);
+
+    Net net;
+    int lstm = net.addLayer(lp.name, lp.type, lp);
+    net.connect(0, 0, lstm, 0);
+    LayerParams lpExp;
+    lpExp.type = "Exp";
+    lpExp.name = "exp";
+    int exp = net.addLayer(lpExp.name, lpExp.type, lpExp);
+    net.connect(lstm, 0, exp, 0);
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+
+    const int numRequests = 4;
+    MatShape inpShape(3);
+    inpShape[0] = numTimeStamps;
+    inpShape[1] = 1;
+    inpShape[2] = numFeatures;
+    std::vector<Mat> inputs(numRequests), refs(numRequests);
+    for (int i = 0; i < numRequests; i++)
+    {
+        inputs[i].create(inpShape, CV_32F);
+        randu(inputs[i], -1.0f, 1.0f);
+        net.setInput(inputs[i]);
+        refs[i] = net.forward().clone();
+    }
+
+    std::vector<InferRequest> requests(numRequests);
+    for (int i = 0; i < numRequests; i++)
+        requests[i] = net.createInferRequest();
+
+    std::vector<Mat> outs(numRequests);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numRequests; i++)
+    {
+        threads.push_back(std::thread([&, i]{
+            for (int iter = 0; iter < 20; iter++)
+            {
+                requests[i].setInput(inputs[i]);
+                outs[i] = requests[i].forward().clone();
+                if (cv::norm(outs[i], refs[i], NORM_INF) > 1e-5)
+                    break;
+            }
+        }));
+    }
+    for (int i = 0; i < numRequests; i++)
+        threads[i].join();
+    for (int i = 0; i < numRequests; i++)
+        normAssert(refs[i], outs[i], format("request %d", i).c_str());
+}
+
+TEST(Net, forwardAsync_cpu)
+{
+    // two independent heads on the top of the shared convolution
+    Net net;
+    LayerParams lp = makeConvParams("conv", 3, 8);
+    int conv = net.addLayer(lp.name, lp.type, lp);
+    net.connect(0, 0, conv, 0);
+    int lastIds[2];
+    for (int head = 0; head < 2; head++)
+    {
+        int prevId = conv;
+        for (int i = 0; i < 3; i++)
+        {
+            lp = makeConvParams(format("head%d_conv%d", head, i), 8, 8);
+            int id = net.addLayer(lp.name, lp.type, lp);
+            net.connect(prevId, 0, id, 0);
+            prevId = id;
+        }
+        lastIds[head] = prevId;
+    }
+    LayerParams lpConcat;
+    lpConcat.set("axis", 1);
+    lpConcat.type = "Concat";
+    lpConcat.name = "concat";
+    int concat = net.addLayer(lpConcat.name, lpConcat.type, lpConcat);
+    net.connect(lastIds[0], 0, concat, 0);
+    net.connect(lastIds[1], 0, concat, 1);
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+
+    const int numInputs = 6;
+    std::vector<Mat> inputs(numInputs), refs(numInputs);
+    for (int i = 0; i < numInputs; i++)
+    {
+        inputs[i].create(shape(1, 3, 20, 24), CV_32F);
+        randu(inputs[i], -1.0f, 1.0f);
+        net.setInput(inputs[i]);
+        refs[i] = net.forward().clone();
+    }
+
+    // several passes in flight, the inputs are captured on the call
+    std::vector<AsyncArray> outs(numInputs);
+    for (int i = numInputs - 1; i >= 0; i--)
+    {
+        net.setInput(inputs[i]);
+        outs[i] = net.forwardAsync();
+    }
+    for (int i = 0; i < numInputs; i++)
+    {
+        ASSERT_TRUE(outs[i].valid());
+        Mat result;
+        EXPECT_TRUE(outs[i].get(result, std::chrono::seconds(10)));
+        normAssert(refs[i], result, format("Index: %d", i).c_str());
+    }
+
+    net.setInput(inputs[0]);
+    Mat head;
+    net.forwardAsync("head1_conv2").get(head);
+    net.setInput(inputs[0]);
+    normAssert(net.forward("head1_conv2"), head, "head");
+}
+
+// Identity which counts the concurrent calls of its forward()
+class NonReentrantLayer CV_FINAL : public Layer
+{
+public:
+    NonReentrantLayer(const LayerParams &params) : Layer(params) {}
+
+    static Ptr<Layer> create(LayerParams& params)
+    {
+        return Ptr<Layer>(new NonReentrantLayer(params));
+    }
+
+    void forward(InputArrayOfArrays inputs_arr, OutputArrayOfArrays outputs_arr, OutputArrayOfArrays) CV_OVERRIDE
+    {
+        if (CV_XADD(&running, 1) != 0)
+            CV_XADD(&overlaps, 1);
+        std::vector<Mat> inputs, outputs;
+        inputs_arr.getMatVector(inputs);
+        outputs_arr.getMatVector(outputs);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        inputs[0].copyTo(outputs[0]);
+        CV_XADD(&running, -1);
+    }
+
+    static int running, overlaps;
+};
+int NonReentrantLayer::running = 0;
+int NonReentrantLayer::overlaps = 0;
+
+TEST(Net, forwardAsync_cpu_mixed_with_forward)
+{
+    CV_DNN_REGISTER_LAYER_CLASS(NonReentrant, NonReentrantLayer);
+    Net net;
+    LayerParams lp = makeConvParams("conv", 3, 8);
+    int conv = net.addLayer(lp.name, lp.type, lp);
+    net.connect(0, 0, conv, 0);
+    LayerParams lpProbe;
+    lpProbe.type = "NonReentrant";
+    lpProbe.name = "probe";
+    int probe = net.addLayer(lpProbe.name, lpProbe.type, lpProbe);
+    net.connect(conv, 0, probe, 0);
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+
+    const int numInputs = 6;
+    std::vector<Mat> inputs(numInputs), refs(numInputs);
+    for (int i = 0; i < numInputs; i++)
+    {
+        inputs[i].create(shape(1, 3, 20, 24), CV_32F);
+        randu(inputs[i], -1.0f, 1.0f);
+        net.setInput(inputs[i]);
+        refs[i] = net.forward().clone();
+    }
+
+    // the synchronous passes are issued while the asynchronous ones run the shared layers
+    NonReentrantLayer::overlaps = 0;
+    std::vector<AsyncArray> outs(numInputs);
+    std::vector<Mat> syncOuts(numInputs);
+    for (int i = 0; i < numInputs; i++)
+    {
+        net.setInput(inputs[i]);
+        outs[i] = net.forwardAsync();
+        net.setInput(inputs[(i + 1) % numInputs]);
+        syncOuts[i] = net.forward().clone();
+    }
+    for (int i = 0; i < numInputs; i++)
+    {
+        Mat result;
+        EXPECT_TRUE(outs[i].get(result, std::chrono::seconds(10)));
+        normAssert(refs[i], result, format("async %d", i).c_str());
+        normAssert(refs[(i + 1) % numInputs], syncOuts[i], format("sync %d", i).c_str());
+    }
+    EXPECT_EQ(0, NonReentrantLayer::overlaps);
+    LayerFactory::unregisterLayer("NonReentrant");
+}
+
+TEST(Net, parallel_layers_branches)
+{
+    // inception-like block: small branches of different depth joined by concat
+    const int numBranches = 4;
+    Net net;
+    LayerParams lp = makeConvParams("stem", 3, 8);
+    int stem = net.addLayer(lp.name, lp.type, lp);
+    net.connect(0, 0, stem, 0);
+    std::vector<int> lastIds;
+    for (int b = 0; b < numBranches; b++)
+    {
+        int prevId = stem;
+        for (int i = 0; i <= b; i++)
+        {
+            lp = makeConvParams(format("branch%d_conv%d", b, i), i == 0 ? 8 : 4, 4);
+            int id = net.addLayer(lp.name, lp.type, lp);
+            net.connect(prevId, 0, id, 0);
+            prevId = id;
+        }
+        lastIds.push_back(prevId);
+    }
+    LayerParams lpConcat;
+    lpConcat.set("axis", 1);
+    lpConcat.type = "Concat";
+    lpConcat.name = "concat";
+    int concat = net.addLayer(lpConcat.name, lpConcat.type, lpConcat);
+    for (int b = 0; b < numBranches; b++)
+        net.connect(lastIds[b], 0, concat, b);
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(DNN_TARGET_CPU);
+
+    Mat inp(shape(1, 3, 16, 16), CV_32F);
+    randu(inp, -1.0f, 1.0f);
+    // applied on the allocation of the network, the blobs are planned for the concurrent execution
+    ScopedConfigParam parallelLayers("OPENCV_DNN_PARALLEL_LAYERS", "1");
+    net.setInput(inp);
+    // the request context runs the layers sequentially
+    InferRequest request = net.createInferRequest();
+    request.setInput(inp);
+    Mat ref = request.forward().clone();
+
+    const int nthreads = getNumThreads();
+    setNumThreads(4);
+    for (int iter = 0; iter < 3; iter++)
+    {
+        net.setInput(inp);
+        Mat out = net.forward();
+        normAssert(ref, out, format("iter %d", iter).c_str());
+    }
+    setNumThreads(nthreads);
+
+    std::vector<double> timings, branchTimings;
+    std::vector<int> branches;
+    int64 total = net.getPerfProfile(timings, branches, branchTimings);
+    EXPECT_GT(total, 0);
+    ASSERT_EQ(timings.size(), branches.size());
+    // the stem, every branch and the concat
+    ASSERT_EQ((size_t)numBranches + 2, branchTimings.size());
+    for (int b = 0; b < numBranches; b++)
+    {
+        int first = net.getLayerId(format("branch%d_conv0", b)) - 1;
+        for (int i = 1; i <= b; i++)
+            EXPECT_EQ(branches[first], branches[net.getLayerId(format("branch%d_conv%d", b, i)) - 1]);
+    }
+    double sum = 0, branchSum = 0;
+    for (size_t i = 0; i < timings.size(); i++)
+        sum += timings[i];
+    for (size_t i = 0; i < branchTimings.size(); i++)
+        branchSum += branchTimings[i];
+    EXPECT_EQ(sum, branchSum);
+}
+
+TEST(Net, prepack_weights_cache)
+{
+    const std::string cacheDir = tempfile("dnn_prepack");
+    LayerParams lp = makeConvParams("conv", 16, 24);
+    Mat inp(shape(1, 16, 12, 12), CV_32F);
+    randu(inp, -1.0f, 1.0f);
+
+    Net net0;
+    net0.addLayerToPrev(lp.name, lp.type, lp);
+    net0.setPreferableBackend(DNN_BACKEND_OPENCV);
+    net0.setInput(inp);
+    Mat ref = net0.forward().clone();
+
+    ScopedConfigParam cacheDirParam("OPENCV_DNN_PREPACK_CACHE_DIR", cacheDir);
+    std::vector<cv::String> files;
+    for (int iter = 0; iter < 3; iter++)
+    {
+        // 0 - stores the weights, 1 - loads them, 2 - ignores the corrupted entry
+        if (iter == 1)
+        {
+            // negate the packed weights stored at the end of the entry, so the output shows where they come from
+            ASSERT_EQ(1u, files.size());
+            std::fstream fs(files[0].c_str(), std::ios::binary | std::ios::in | std::ios::out);
+            std::vector<char> data((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+            size_t nbytes = lp.blobs[0].total()*sizeof(float);
+            ASSERT_GT(data.size(), nbytes);
+            for (size_t i = data.size() - nbytes; i < data.size(); i += sizeof(float))
+                data[i + 3] ^= (char)0x80;  // the sign bit of the little-endian float
+            fs.seekp(0);
+            fs.write(data.data(), data.size());
+        }
+        if (iter == 2)
+        {
+            ASSERT_EQ(1u, files.size());
+            std::ofstream ofs(files[0].c_str(), std::ios::binary | std::ios::trunc);
+            ofs << "garbage";
+        }
+        Net net;
+        net.addLayerToPrev(lp.name, lp.type, lp);
+        net.setPreferableBackend(DNN_BACKEND_OPENCV);
+        net.setInput(inp);
+        Mat out = net.forward();
+        if (iter == 1)
+            EXPECT_GT(cvtest::norm(ref, out, NORM_INF), 1e-3) << "the weights are not loaded from the cache";
+        else
+            normAssert(ref, out, format("iter %d", iter).c_str());
+        files.clear();
+        utils::fs::glob(cacheDir, "*.bin", files);
+        ASSERT_EQ(1u, files.size()) << "iter " << iter;
+        if (iter == 2)
+        {
+            // the corrupted entry is replaced
+            std::ifstream ifs(files[0].c_str(), std::ios::binary | std::ios::ate);
+            EXPECT_GT((size_t)ifs.tellg(), lp.blobs[0].total()*sizeof(float));
+        }
+    }
+    utils::fs::remove_all(cacheDir);
+}
+
 #ifdef HAVE_INF_ENGINE
 static const std::chrono::milliseconds async_timeout(10000);
 
@@ -9,6 +9,7 @@
 #include "test_precomp.hpp"
 #include "npy_blob.hpp"
 #include <opencv2/dnn/shape_utils.hpp>
+#include <opencv2/core/utils/filesystem.hpp>
 namespace opencv_test { namespace {
 
 template<typename TString>
@@ -2445,4 +2446,456 @@ TEST_P(Test_ONNX_layers, YOLOv7)
 
 INSTANTIATE_TEST_CASE_P(/**/, Test_ONNX_nets, dnnBackendsAndTargets());
 
+// minimal protobuf encoder to build the ONNX models in place
+static void writeVarint(std::string& buf, uint64_t val)
+{
+    for (; val >= 0x80; val >>= 7)
+        buf += (char)(val | 0x80);
+    buf += (char)val;
+}
+
+static std::string protoVarint(int field, uint64_t val)
+{
+    std::string buf;
+    writeVarint(buf, (uint64_t)field << 3);
+    writeVarint(buf, val);
+    return buf;
+}
+
+static std::string protoBytes(int field, const std::string& val)
+{
+    std::string buf;
+    writeVarint(buf, ((uint64_t)field << 3) | 2);
+    writeVarint(buf, val.size());
+    return buf + val;
+}
+
+// Y = MatMul(X, W), where the W initializer is stored as raw_data or in the external file
+static std::string makeMatMulModel(const Mat& W, const std::string& location = "", const std::string& offset = "0")
+{
+    std::string tensor = protoVarint(1, W.rows) + protoVarint(1, W.cols) + protoVarint(2, 1 /*FLOAT*/) + protoBytes(8, "W");
+    if (location.empty())
+        tensor += protoBytes(9, std::string((const char*)W.data, W.total()*W.elemSize()));
+    else
+        tensor += protoBytes(13, protoBytes(1, "location") + protoBytes(2, location)) +
+                  protoBytes(13, protoBytes(1, "offset") + protoBytes(2, offset)) +
+                  protoVarint(14, 1 /*EXTERNAL*/);
+    auto valueInfo = [](const std::string& name, int rows, int cols) {
+        std::string shape = protoBytes(1, protoVarint(1, rows)) + protoBytes(1, protoVarint(1, cols));
+        return protoBytes(1, name) + protoBytes(2, protoBytes(1, protoVarint(1, 1 /*FLOAT*/) + protoBytes(2, shape)));
+    };
+    std::string node = protoBytes(1, "X") + protoBytes(1, "W") + protoBytes(2, "Y") + protoBytes(4, "MatMul");
+    std::string graph = protoBytes(1, node) + protoBytes(2, "graph") + protoBytes(5, tensor) +
+                        protoBytes(11, valueInfo("X", 1, W.rows)) + protoBytes(12, valueInfo("Y", 1, W.cols));
+    return protoVarint(1, 7 /*ir_version*/) + protoBytes(8, protoVarint(2, 13 /*opset*/)) + protoBytes(7, graph);
+}
+
+static void writeFile(const std::string& path, const std::string& data)
+{
+    std::ofstream ofs(path.c_str(), std::ios::binary);
+    ofs.write(data.data(), data.size());
+    ASSERT_TRUE(ofs.good()) << path;
+}
+
+static std::string protoFloat(int field, float val)
+{
+    std::string buf;
+    writeVarint(buf, ((uint64_t)field << 3) | 5);
+    return buf + std::string((const char*)&val, sizeof(val));
+}
+
+// FLOAT initializer, the shape of the Mat is used by default
+static std::string onnxTensor(const std::string& name, const Mat& m, MatShape tensorShape = MatShape())
+{
+    if (tensorShape.empty())
+        tensorShape = shape(m);
+    CV_Assert(m.type() == CV_32F && m.isContinuous() && (size_t)total(tensorShape) == m.total());
+    std::string tensor;
+    for (size_t i = 0; i < tensorShape.size(); i++)
+        tensor += protoVarint(1, tensorShape[i]);
+    return tensor + protoVarint(2, 1 /*FLOAT*/) + protoBytes(8, name) +
+           protoBytes(9, std::string((const char*)m.data, m.total()*m.elemSize()));
+}
+
+static std::string onnxValueInfo(const std::string& name, const MatShape& tensorShape)
+{
+    std::string dims;
+    for (size_t i = 0; i < tensorShape.size(); i++)
+        dims += protoBytes(1, protoVarint(1, tensorShape[i]));
+    return protoBytes(1, name) + protoBytes(2, protoBytes(1, protoVarint(1, 1 /*FLOAT*/) + protoBytes(2, dims)));
+}
+
+static std::string onnxAttr(const std::string& name, int val)
+{
+    return protoBytes(5, protoBytes(1, name) + protoVarint(3, (uint64_t)(int64_t)val) + protoVarint(20, 2 /*INT*/));
+}
+
+static std::string onnxAttr(const std::string& name, float val)
+{
+    return protoBytes(5, protoBytes(1, name) + protoFloat(2, val) + protoVarint(20, 1 /*FLOAT*/));
+}
+
+static std::string onnxAttr(const std::string& name, const std::vector<int>& vals)
+{
+    std::string attr = protoBytes(1, name);
+    for (size_t i = 0; i < vals.size(); i++)
+        attr += protoVarint(8, (uint64_t)(int64_t)vals[i]);
+    return protoBytes(5, attr + protoVarint(20, 7 /*INTS*/));
+}
+
+// the graph node, an empty input name marks the omitted optional input
+static std::string onnxNode(const std::string& op, const std::vector<std::string>& inputs,
+                            const std::string& output, const std::string& attrs = "")
+{
+    std::string node;
+    for (size_t i = 0; i < inputs.size(); i++)
+        node += protoBytes(1, inputs[i]);
+    return protoBytes(1, node + protoBytes(2, output) + protoBytes(4, op) + attrs);
+}
+
+// the inputs and the outputs are the serialized value infos
+static std::string onnxModel(const std::string& nodes, const std::string& initializers,
+                             const std::vector<std::string>& inputs, const std::vector<std::string>& outputs,
+                             int opset = 13)
+{
+    std::string graph = nodes + protoBytes(2, "graph");
+    graph += initializers;
+    for (size_t i = 0; i < inputs.size(); i++)
+        graph += protoBytes(11, inputs[i]);
+    for (size_t i = 0; i < outputs.size(); i++)
+        graph += protoBytes(12, outputs[i]);
+    return protoVarint(1, 7 /*ir_version*/) + protoBytes(8, protoVarint(2, opset)) + protoBytes(7, graph);
+}
+
+static Net readNetFromONNXString(const std::string& model)
+{
+    Net net = readNetFromONNX(model.data(), model.size());
+    net.setPreferableBackend(DNN_BACKEND_OPENCV);
+    return net;
+}
+
+TEST(Test_ONNX_importer, raw_and_external_data)
+{
+    Mat W(64, 48, CV_32F), X(1, 64, CV_32F);
+    randu(W, -1.0f, 1.0f);
+    randu(X, -1.0f, 1.0f);
+    Mat ref = X*W;
+
+    const std::string dir = tempfile("onnx_data");
+    ASSERT_TRUE(utils::fs::createDirectories(dir));
+    const std::string rawModel = makeMatMulModel(W);
+    writeFile(utils::fs::join(dir, "raw.onnx"), rawModel);
+    // the weights follow some other data in the external file
+    const size_t offset = 100;
+    const std::string offsetStr = std::to_string(offset);
+    writeFile(utils::fs::join(dir, "weights.bin"), std::string(offset, '\0') + std::string((const char*)W.data, W.total()*W.elemSize()));
+    writeFile(utils::fs::join(dir, "external.onnx"), makeMatMulModel(W, "weights.bin", offsetStr));
+    ASSERT_TRUE(utils::fs::createDirectories(utils::fs::join(dir, "sub")));
+    writeFile(utils::fs::join(dir, "external2.onnx"), makeMatMulModel(W, "./sub/../weights.bin", offsetStr));
+
+    for (int i = 0; i < 4; i++)
+    {
+        Net net = i == 0 ? readNetFromONNX(utils::fs::join(dir, "raw.onnx")) :
+                  i == 1 ? readNetFromONNX(utils::fs::join(dir, "external.onnx")) :
+                  i == 2 ? readNetFromONNX(utils::fs::join(dir, "external2.onnx")) :
+                           readNetFromONNX(rawModel.data(), rawModel.size());
+        net.setPreferableBackend(DNN_BACKEND_OPENCV);
+        net.setInput(X);
+        Mat out = net.forward();
+        normAssert(ref, out.reshape(1, 1), format("model %d", i).c_str());
+    }
+
+    // the locations outside of the model directory are rejected
+    writeFile(utils::fs::join(dir, "absolute.onnx"), makeMatMulModel(W, utils::fs::canonical(utils::fs::join(dir, "weights.bin")), offsetStr));
+    EXPECT_ANY_THROW(readNetFromONNX(utils::fs::join(dir, "absolute.onnx")));
+    writeFile(utils::fs::join(dir, "parent.onnx"), makeMatMulModel(W, "sub/../../weights.bin", offsetStr));
+    EXPECT_ANY_THROW(readNetFromONNX(utils::fs::join(dir, "parent.onnx")));
+    // there is no model directory for the model read from memory
+    const std::string externalModel = makeMatMulModel(W, "weights.bin", offsetStr);
+    EXPECT_ANY_THROW(readNetFromONNX(externalModel.data(), externalModel.size()));
+
+    // the offset is not a decimal number or doesn't fit size_t
+    const char* badOffsets[] = { "", "abc", "-100", "100x", "99999999999999999999999" };
+    for (size_t i = 0; i < sizeof(badOffsets)/sizeof(badOffsets[0]); i++)
+    {
+        writeFile(utils::fs::join(dir, "bad_offset.onnx"), makeMatMulModel(W, "weights.bin", badOffsets[i]));
+        EXPECT_THROW(readNetFromONNX(utils::fs::join(dir, "bad_offset.onnx")), cv::Exception) << badOffsets[i];
+    }
+
+    // the external file is shorter than the tensor
+    writeFile(utils::fs::join(dir, "weights.bin"), std::string(offset, '\0'));
+    EXPECT_ANY_THROW(readNetFromONNX(utils::fs::join(dir, "external.onnx")));
+    utils::fs::remove_all(dir);
+}
+
+// 2-D constant B is mapped to InnerProduct, which all the backends support
+TEST(Test_ONNX_importer, MatMul_Gemm_layers)
+{
+    Mat A(3, 8, CV_32F), B(8, 5, CV_32F), C(1, 5, CV_32F), B3(shape(2, 8, 5), CV_32F), A3(shape(2, 3, 8), CV_32F);
+    randu(A, -1.0f, 1.0f);
+    randu(B, -1.0f, 1.0f);
+    randu(C, -1.0f, 1.0f);
+    randu(B3, -1.0f, 1.0f);
+    randu(A3, -1.0f, 1.0f);
+    const std::string inpA = onnxValueInfo("A", shape(A)), inpAt = onnxValueInfo("A", shape(8, 3));
+    const std::string inpB = onnxValueInfo("B", shape(B)), inpA3 = onnxValueInfo("A", shape(A3));
+    const std::string outY = onnxValueInfo("Y", shape(3, 5)), outY3 = onnxValueInfo("Y", shape(2, 3, 5));
+
+    Mat Bt = B.t(), At = A.t(), CC;
+    repeat(C, 3, 1, CC);
+    Mat ref3(shape(2, 3, 5), CV_32F);
+    for (int i = 0; i < 2; i++)
+    {
+        Mat a(3, 8, CV_32F, A3.ptr<float>(i)), b(8, 5, CV_32F, B3.ptr<float>(i)), y(3, 5, CV_32F, ref3.ptr<float>(i));
+        y = a*b;
+    }
+
+    struct {
+        std::string model;
+        std::string type;
+        Mat a, b;  // the network inputs, b is empty if B is constant
+        Mat ref;
+    } cases[] = {
+        { onnxModel(onnxNode("MatMul", {"A", "B"}, "Y"), protoBytes(5, onnxTensor("B", B)), {inpA}, {outY}),
+          "InnerProduct", A, Mat(), Mat(A*B) },
+        { onnxModel(onnxNode("MatMul", {"A", "B"}, "Y"), "", {inpA, inpB}, {outY}),
+          "MatMul", A, B, Mat(A*B) },
+        { onnxModel(onnxNode("MatMul", {"A", "B"}, "Y"), protoBytes(5, onnxTensor("B", B3)), {inpA3}, {outY3}),
+          "MatMul", A3, Mat(), ref3 },
+        { onnxModel(onnxNode("Gemm", {"A", "B", "C"}, "Y", onnxAttr("alpha", 0.5f) + onnxAttr("beta", 2.0f) + onnxAttr("transB", 1)),
+                    protoBytes(5, onnxTensor("B", Bt)) + protoBytes(5, onnxTensor("C", C, shape(5))), {inpA}, {outY}),
+          "InnerProduct", A, Mat(), Mat(0.5*A*B + 2*CC) },
+        { onnxModel(onnxNode("Gemm", {"A", "B", "C"}, "Y", onnxAttr("transA", 1)),
+                    protoBytes(5, onnxTensor("B", B)) + protoBytes(5, onnxTensor("C", C)), {inpAt}, {outY}),
+          "MatMul", At, Mat(), Mat(A*B + CC) },
+    };
+    for (size_t i = 0; i < sizeof(cases)/sizeof(cases[0]); i++)
+    {
+        Net net = readNetFromONNXString(cases[i].model);
+        EXPECT_EQ(cases[i].type, net.getLayer(net.getLayerId("onnx_node_output_0!Y"))->type) << "case " << i;
+        net.setInput(cases[i].a, "A");
+        if (!cases[i].b.empty())
+            net.setInput(cases[i].b, "B");
+        Mat out = net.forward("Y");
+        normAssert(cases[i].ref, out.reshape(1, cases[i].ref.dims, cases[i].ref.size.p), format("case %d", (int)i).c_str(), 1e-5, 1e-4);
+    }
+}
+
+// (x - mean(x)) / sqrt(mean((x - mean(x))^power) + eps) [* weight + bias] along the last axis
+static std::string makeLayerNormModel(const MatShape& inpShape, float power, const Mat& weight, const Mat& bias)
+{
+    const float eps = 1e-5f;
+    const std::string reduce = onnxAttr("axes", std::vector<int>(1, -1)) + onnxAttr("keepdims", 1);
+    std::string nodes = onnxNode("ReduceMean", {"X"}, "mean", reduce) + onnxNode("Sub", {"X", "mean"}, "d") +
+                        onnxNode("Pow", {"d", "power"}, "d2") + onnxNode("ReduceMean", {"d2"}, "var", reduce) +
+                        onnxNode("Add", {"var", "eps"}, "var_eps") + onnxNode("Sqrt", {"var_eps"}, "std");
+    std::string initializers = protoBytes(5, onnxTensor("power", Mat(1, 1, CV_32F, Scalar(power)), MatShape(1, 1))) +
+                               protoBytes(5, onnxTensor("eps", Mat(1, 1, CV_32F, Scalar(eps)), MatShape(1, 1)));
+    if (weight.empty())
+        nodes += onnxNode("Div", {"d", "std"}, "Y");
+    else
+    {
+        nodes += onnxNode("Div", {"d", "std"}, "norm") + onnxNode("Mul", {"norm", "weight"}, "scaled") +
+                 onnxNode("Add", {"scaled", "bias"}, "Y");
+        initializers += protoBytes(5, onnxTensor("weight", weight, shape(weight))) +
+                        protoBytes(5, onnxTensor("bias", bias, shape(bias)));
+    }
+    return onnxModel(nodes, initializers, {onnxValueInfo("X", inpShape)}, {onnxValueInfo("Y", inpShape)});
+}
+
+TEST(Test_ONNX_importer, LayerNorm_fusion)
+{
+    const MatShape inpShape = shape(2, 3, 16);
+    const int n = inpShape.back();
+    Mat X(inpShape, CV_32F), weight(1, n, CV_32F), bias(1, n, CV_32F);
+    randu(X, -1.0f, 1.0f);
+    randu(weight, -1.0f, 1.0f);
+    randu(bias, -1.0f, 1.0f);
+    // the constants which broadcast differently from the normalized axes
+    Mat scalarWeight(1, 1, CV_32F, Scalar(0.5f)), scalarBias(1, 1, CV_32F, Scalar(-0.25f));
+    Mat rowsWeight(inpShape[1], n, CV_32F), rowsBias(inpShape[1], n, CV_32F);
+    randu(rowsWeight, -1.0f, 1.0f);
+    randu(rowsBias, -1.0f, 1.0f);
+
+    for (int i = 0; i < 6; i++)
+    {
+        const bool affine = i % 2 == 1 || i >= 4;
+        // the decomposition with another power is not a layer normalization
+        const float power = i == 2 || i == 3 ? 4.f : 2.f;
+        const Mat& w = i == 4 ? scalarWeight : i == 5 ? rowsWeight : weight;
+        const Mat& b = i == 4 ? scalarBias : i == 5 ? rowsBias : bias;
+        Net net = readNetFromONNXString(makeLayerNormModel(inpShape, power, affine ? w : Mat(), affine ? b : Mat()));
+        const std::string type = net.getLayer(net.getLayerId("onnx_node_output_0!Y"))->type;
+        if (i < 2)
+            EXPECT_EQ("LayerNormalization", type) << "case " << i;
+        else
+            EXPECT_NE("LayerNormalization", type) << "case " << i;
+
+        Mat ref(inpShape, CV_32F);
+        Mat x2d = X.reshape(1, (int)X.total()/n), ref2d = ref.reshape(1, (int)X.total()/n);
+        for (int r = 0; r < x2d.rows; r++)
+        {
+            Mat d = x2d.row(r) - mean(x2d.row(r))[0], dp;
+            pow(d, power, dp);
+            ref2d.row(r) = d/std::sqrt(mean(dp)[0] + 1e-5);
+            if (affine)
+            {
+                const int wr = w.rows > 1 ? r % w.rows : 0;
+                Mat wrow = w.cols > 1 ? w.row(wr) : Mat(1, n, CV_32F, Scalar(w.at<float>(0)));
+                Mat brow = b.cols > 1 ? b.row(wr) : Mat(1, n, CV_32F, Scalar(b.at<float>(0)));
+                ref2d.row(r) = ref2d.row(r).mul(wrow) + brow;
+            }
+        }
+        net.setInput(X);
+        normAssert(ref, net.forward("Y"), format("case %d", i).c_str(), 1e-5, 1e-4);
+    }
+}
+
+// MatMul(Softmax(Div(MatMul(Q, K^T), sqrt(d)) [+ mask], axis), V), K^T is the input
+static std::string makeAttentionModel(const MatShape& qShape, int softmaxAxis, const Mat& mask, int opset = 13)
+{
+    const int s = qShape[2], d = qShape[3];
+    std::string nodes = onnxNode("MatMul", {"Q", "KT"}, "qk") + onnxNode("Div", {"qk", "c"}, "scaled");
+    std::string initializers = protoBytes(5, onnxTensor("c", Mat(1, 1, CV_32F, Scalar(std::sqrt((float)d))), MatShape(1, 1)));
+    std::string weights = "scaled";
+    if (!mask.empty())
+    {
+        nodes += onnxNode("Add", {"scaled", "mask"}, "masked");
+        initializers += protoBytes(5, onnxTensor("mask", mask));
+        weights = "masked";
+    }
+    nodes += onnxNode("Softmax", {weights}, "probs", onnxAttr("axis", softmaxAxis)) + onnxNode("MatMul", {"probs", "V"}, "Y");
+    return onnxModel(nodes, initializers,
+                     {onnxValueInfo("Q", qShape), onnxValueInfo("KT", shape(qShape[0], qShape[1], d, s)), onnxValueInfo("V", qShape)},
+                     {onnxValueInfo("Y", qShape)}, opset);
+}
+
+TEST(Test_ONNX_importer, Attention_fusion)
+{
+    const MatShape qShape = shape(1, 2, 5, 8);
+    const int heads = qShape[1], s = qShape[2], d = qShape[3];
+    Mat Q(qShape, CV_32F), KT(shape(1, heads, d, s), CV_32F), V(qShape, CV_32F), mask(shape(1, 1, s, s), CV_32F);
+    randu(Q, -1.0f, 1.0f);
+    randu(KT, -1.0f, 1.0f);
+    randu(V, -1.0f, 1.0f);
+    randu(mask, -2.0f, 0.0f);
+
+    struct {
+        int axis, opset;
+        bool withMask, fused;
+    } cases[] = {
+        { -1, 13, false, true },
+        { -1, 13, true, true },
+        // the softmax along another axis is not an attention
+        { 2, 13, true, false },
+        // the same as -1 for the 4-D input, but the rank is not known to the graph simplifier
+        { 3, 11, false, false },
+    };
+    for (size_t i = 0; i < sizeof(cases)/sizeof(cases[0]); i++)
+    {
+        Net net = readNetFromONNXString(makeAttentionModel(qShape, cases[i].axis, cases[i].withMask ? mask : Mat(), cases[i].opset));
+        const std::string type = net.getLayer(net.getLayerId("onnx_node_output_0!Y"))->type;
+        if (cases[i].fused)
+            EXPECT_EQ("Attention", type) << "case " << i;
+        else
+            EXPECT_NE("Attention", type) << "case " << i;
+
+        Mat ref(qShape, CV_32F);
+        for (int h = 0; h < heads; h++)
+        {
+            Mat q(s, d, CV_32F, Q.ptr<float>(0, h)), kt(d, s, CV_32F, KT.ptr<float>(0, h));
+            Mat v(s, d, CV_32F, V.ptr<float>(0, h)), y(s, d, CV_32F, ref.ptr<float>(0, h));
+            Mat w = q*kt/std::sqrt((float)d);
+            if (cases[i].withMask)
+                w += Mat(s, s, CV_32F, mask.ptr<float>());
+            // the rows are normalized for the last axis and the columns for the axis 2
+            const bool rows = cases[i].axis != 2;
+            if (!rows)
+                w = w.t();
+            for (int r = 0; r < s; r++)
+            {
+                Mat e;
+                exp(w.row(r), e);
+                w.row(r) = e/sum(e)[0];
+            }
+            if (!rows)
+                w = w.t();
+            y = w*v;
+        }
+        net.setInput(Q, "Q");
+        net.setInput(KT, "KT");
+        net.setInput(V, "V");
+        normAssert(ref, net.forward("Y"), format("case %d", (int)i).c_str(), 1e-5, 1e-4);
+    }
+}
+
+TEST(Test_ONNX_importer, prepack_cache_model_key)
+{
+    const MatShape inpShape = shape(1, 8, 10, 10);
+    Mat X(inpShape, CV_32F), W(shape(16, 8, 3, 3), CV_32F), B(shape(16), CV_32F);
+    randu(X, -1.0f, 1.0f);
+    randu(W, -1.0f, 1.0f);
+    randu(B, -1.0f, 1.0f);
+    Mat weights[] = { W, -W };  // the models of the same size
+    std::string models[2];
+    Mat refs[2];
+    for (int i = 0; i < 2; i++)
+    {
+        models[i] = onnxModel(onnxNode("Conv", {"X", "W", "B"}, "Y",
+                                       onnxAttr("kernel_shape", std::vector<int>{3, 3}) + onnxAttr("pads", std::vector<int>{1, 1, 1, 1})),
+                              protoBytes(5, onnxTensor("W", weights[i])) + protoBytes(5, onnxTensor("B", B, shape(16))),
+                              {onnxValueInfo("X", inpShape)}, {onnxValueInfo("Y", shape(1, 16, 10, 10))});
+        Net net = readNetFromONNXString(models[i]);
+        net.setInput(X);
+        refs[i] = net.forward().clone();
+    }
+
+    // the same convolution with W in the external data file
+    std::string externalW;
+    for (int i = 0; i < W.dims; i++)
+        externalW += protoVarint(1, W.size[i]);
+    externalW += protoVarint(2, 1 /*FLOAT*/) + protoBytes(8, "W") +
+                 protoBytes(13, protoBytes(1, "location") + protoBytes(2, "W.bin")) + protoVarint(14, 1 /*EXTERNAL*/);
+    const std::string externalModel = onnxModel(onnxNode("Conv", {"X", "W", "B"}, "Y",
+                                                         onnxAttr("kernel_shape", std::vector<int>{3, 3}) + onnxAttr("pads", std::vector<int>{1, 1, 1, 1})),
+                                                protoBytes(5, externalW) + protoBytes(5, onnxTensor("B", B, shape(16))),
+                                                {onnxValueInfo("X", inpShape)}, {onnxValueInfo("Y", shape(1, 16, 10, 10))});
+
+    const std::string dir = tempfile("onnx_prepack");
+    ASSERT_TRUE(utils::fs::createDirectories(dir));
+    const std::string modelPath = utils::fs::join(dir, "conv.onnx"), cacheDir = utils::fs::join(dir, "cache");
+    const std::string externalModelPath = utils::fs::join(dir, "conv_external.onnx");
+    writeFile(externalModelPath, externalModel);
+    ScopedConfigParam cacheDirParam("OPENCV_DNN_PREPACK_CACHE_DIR", cacheDir);
+    // 0 - stores the weights, 1 - loads them, 2 - the model file is changed,
+    // 3 - the model read from memory has no model key, its entry is keyed by the weights,
+    // 4, 5 - only the external data file is changed, its size stays the same
+    const size_t numEntries[] = { 1, 1, 2, 3, 4, 5 };
+    for (int iter = 0; iter < 6; iter++)
+    {
+        const int m = iter < 2 ? 0 : iter < 4 ? 1 : iter - 4;
+        Net net;
+        if (iter < 3)
+        {
+            if (iter != 1)
+                writeFile(modelPath, models[m]);
+            net = readNetFromONNX(modelPath);
+        }
+        else if (iter == 3)
+            net = readNetFromONNXString(models[m]);
+        else
+        {
+            writeFile(utils::fs::join(dir, "W.bin"), std::string((const char*)weights[m].data, weights[m].total()*weights[m].elemSize()));
+            net = readNetFromONNX(externalModelPath);
+        }
+        net.setPreferableBackend(DNN_BACKEND_OPENCV);
+        net.setInput(X);
+        normAssert(refs[m], net.forward(), format("iter %d", iter).c_str());
+        std::vector<cv::String> files;
+        utils::fs::glob(cacheDir, "*.bin", files);
+        EXPECT_EQ(numEntries[iter], files.size()) << "iter " << iter;
+    }
+    utils::fs::remove_all(dir);
+}
+
 }} // namespace
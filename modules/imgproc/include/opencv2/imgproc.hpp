@@ -365,7 +365,10 @@ enum GrabCutModes {
     /** The value means that the algorithm should just resume. */
     GC_EVAL            = 2,
     /** The value means that the algorithm should just run the grabCut algorithm (a single iteration) with the fixed model */
-    GC_EVAL_FREEZE_MODEL = 3
+    GC_EVAL_FREEZE_MODEL = 3,
+    /** The flag can be combined with #GC_INIT_WITH_RECT or #GC_INIT_WITH_MASK. The initial GMMs
+    are estimated from a subsampled image, which is much faster for large images. */
+    GC_INIT_DOWNSCALED = 8
 };
 
 //! distanceTransform algorithm flags
@@ -1039,6 +1042,58 @@ public:
     CV_WRAP virtual void collectGarbage() = 0;
 };
 
+/** @brief Histogram of an image region that is updated incrementally.
+
+The object keeps per-channel histograms of 8-bit or 16-bit pixels with histSize uniform bins over
+[rangeMin, rangeMax), see createStreamingHistogram. The pixels can be added and removed in any
+order, so the histogram of a sliding window or of the last N frames is maintained at the cost of
+the pixels that change instead of the whole region.
+*/
+class CV_EXPORTS_W StreamingHistogram : public Algorithm
+{
+public:
+    /** @brief Adds the pixels of the image to the histogram.
+
+    @param image 8-bit or 16-bit image with up to 4 channels. All the images added to the
+    histogram must have the same type until reset() is called.
+    @param mask Optional 8-bit mask of the same size as image, only the pixels with non-zero
+    mask elements are counted.
+     */
+    CV_WRAP virtual void add(InputArray image, InputArray mask = noArray()) = 0;
+
+    /** @brief Removes the pixels of the image that were added before.
+
+    The parameters are the same as in add().
+     */
+    CV_WRAP virtual void remove(InputArray image, InputArray mask = noArray()) = 0;
+
+    /** @brief Moves the histogram window over the image.
+
+    The first call after creation or reset() computes the histogram of the whole window. The
+    next calls with the same image only remove the rows and columns that leave the window and add
+    the ones that enter it, so sliding the window by a few pixels costs a few rows or columns.
+    The window is recomputed from scratch when the image size or type changes, or when the
+    windows don't overlap. If the image contents change, call reset() first.
+
+    @param image 8-bit or 16-bit image with up to 4 channels.
+    @param window New window, it must be inside the image.
+     */
+    CV_WRAP virtual void setWindow(InputArray image, Rect window) = 0;
+
+    //! Clears the histogram.
+    CV_WRAP virtual void reset() = 0;
+
+    /** @brief Returns the current histogram.
+
+    @param hist Output histogram of type CV_32SC1 with histSize rows and one column per image
+    channel.
+     */
+    CV_WRAP virtual void getHist(OutputArray hist) const = 0;
+
+    //! Returns the number of bins per channel.
+    CV_WRAP virtual int getHistSize() const = 0;
+};
+
 //! @} imgproc_hist
 
 //! @addtogroup imgproc_subdiv2d
@@ -1483,7 +1538,8 @@ In-place operation is supported.
 @note The median filter uses #BORDER_REPLICATE internally to cope with border pixels, see #BorderTypes
 
 @param src input 1-, 3-, or 4-channel image; when ksize is 3 or 5, the image depth should be
-CV_8U, CV_16U, or CV_32F, for larger aperture sizes, it can only be CV_8U.
+CV_8U, CV_16U, or CV_32F, for larger aperture sizes, it can only be CV_8U or CV_16U (the aperture
+size is limited by 255 for CV_16U).
 @param dst destination array of the same size and type as src.
 @param ksize aperture linear size; it must be odd and greater than 1, for example: 3, 5, 7 ...
 @sa  bilateralFilter, blur, boxFilter, GaussianBlur
@@ -1546,6 +1602,27 @@ CV_EXPORTS_W void bilateralFilter( InputArray src, OutputArray dst, int d,
                                    double sigmaColor, double sigmaSpace,
                                    int borderType = BORDER_DEFAULT );
 
+/** @brief Applies an approximate bilateral filter to an image using the bilateral grid.
+
+The function approximates bilateralFilter as described in @cite Chen2007 . The image is downsampled
+into a 3D grid with cells of sigmaSpace pixels by sigmaColor intensity levels, the grid is blurred
+and the result is interpolated back. The processing time per pixel does not depend on sigmaSpace,
+so the function is much faster than bilateralFilter for large neighborhoods. For small sigmaSpace
+and sigmaColor the grid would be larger than the image, then bilateralFilter is called instead.
+
+For 3-channel images the color distance is measured by the luminance of the pixels only, so the
+edges between different colors of the same brightness are not preserved. Pixels outside of the
+image are not used.
+
+@param src Source 8-bit or floating-point, 1-channel or 3-channel image.
+@param dst Destination image of the same size and type as src .
+@param sigmaColor Filter sigma in the color space, see bilateralFilter.
+@param sigmaSpace Filter sigma in the coordinate space, see bilateralFilter.
+@sa bilateralFilter
+ */
+CV_EXPORTS_W void fastBilateralFilter( InputArray src, OutputArray dst,
+                                       double sigmaColor, double sigmaSpace );
+
 /** @brief Blurs an image using the box filter.
 
 The function smooths an image using the kernel:
@@ -1692,6 +1769,31 @@ CV_EXPORTS_W void sepFilter2D( InputArray src, OutputArray dst, int ddepth,
                                Point anchor = Point(-1,-1),
                                double delta = 0, int borderType = BORDER_DEFAULT );
 
+/** @brief Applies several separable linear filters to the same image.
+
+The function is equivalent to calling sepFilter2D for every pair of kernels kernelsX[i], kernelsY[i]
+and storing the result in dst[i], but the source image is processed by horizontal bands, so that every
+band is read from memory once and then filtered by all the kernels while it stays in cache. It is
+useful when several derivatives or smoothed versions of the same image are needed, e.g. to compute
+the structure tensor. The results are bit-exact with sepFilter2D.
+
+@param src Source image.
+@param dst Vector of destination images of the same size and the same number of channels as src.
+@param ddepth Destination image depth, see @ref filter_depths "combinations"
+@param kernelsX Coefficients for filtering each row, one 1D kernel per output.
+@param kernelsY Coefficients for filtering each column, one 1D kernel per output. All the kernels
+must have the same type.
+@param anchor Anchor position within the kernels. The default value \f$(-1,-1)\f$ means that the anchor
+is at the kernel center.
+@param delta Value added to the filtered results before storing them.
+@param borderType Pixel extrapolation method, see #BorderTypes. #BORDER_WRAP is not supported.
+@sa  sepFilter2D, Sobel, getDerivKernels
+ */
+CV_EXPORTS_W void sepFilter2DMulti( InputArray src, OutputArrayOfArrays dst, int ddepth,
+                                    InputArrayOfArrays kernelsX, InputArrayOfArrays kernelsY,
+                                    Point anchor = Point(-1,-1),
+                                    double delta = 0, int borderType = BORDER_DEFAULT );
+
 /** @example samples/cpp/tutorial_code/ImgTrans/Sobel_Demo.cpp
 Sample code using Sobel and/or Scharr OpenCV functions to make a simple Edge Detector
 ![Sample screenshot](Sobel_Derivatives_Tutorial_Result.jpg)
@@ -2170,6 +2272,34 @@ CV_EXPORTS_W void HoughLinesP( InputArray image, OutputArray lines,
                                double rho, double theta, int threshold,
                                double minLineLength = 0, double maxLineGap = 0 );
 
+/** @brief Finds line segments in a binary image using the probabilistic Hough transform on image tiles.
+
+This is a parallel variant of #HoughLinesP. The image is split into tiles, and the probabilistic Hough
+transform runs on every tile independently. Then the pieces of the segments that cross the tile borders
+are joined: two pieces found in the neighbor tiles (sharing a side or a corner) are joined if one end of
+the first piece and one end of the second piece are at most maxLineGap + 1 pixels apart along both axes,
+and both ends of the shorter piece lie within 2 pixels from the line through the longer one. The 2 pixels
+tolerate the rounding of the piece ends to the pixel grid. The joined segment connects the two farthest
+ends of its pieces. The result is the same for any number of threads, but it differs from the result of #HoughLinesP:
+a segment gets only the votes of the points within one tile, so the threshold applies to the votes of a single
+piece of it. The tiles should be large compared to the threshold.
+
+@param image 8-bit, single-channel binary source image.
+@param lines Output vector of lines, see #HoughLinesP.
+@param rho Distance resolution of the accumulator in pixels.
+@param theta Angle resolution of the accumulator in radians.
+@param threshold Accumulator threshold parameter, applied within every tile.
+@param minLineLength Minimum line length. Line segments shorter than that are rejected after joining the pieces.
+@param maxLineGap Maximum allowed gap between points on the same line to link them.
+@param tileSize Size of the tiles.
+
+@sa HoughLinesP
+ */
+CV_EXPORTS_W void HoughLinesPTiled( InputArray image, OutputArray lines,
+                                    double rho, double theta, int threshold,
+                                    double minLineLength = 0, double maxLineGap = 0,
+                                    Size tileSize = Size(256, 256) );
+
 /** @brief Finds lines in a set of points using the standard Hough transform.
 
 The function finds lines in a set of points using a modification of the Hough transform.
@@ -2343,6 +2473,87 @@ CV_EXPORTS_W void morphologyEx( InputArray src, OutputArray dst,
                                 int borderType = BORDER_CONSTANT,
                                 const Scalar& borderValue = morphologyDefaultBorderValue() );
 
+/** @brief Binary image with one bit per pixel.
+
+The pixels of every row are packed into 32-bit words: the pixel x is the bit (x % 32) of the word x/32,
+the least significant bit goes first. The bits past the image width are always zero. A packed image takes
+8 times less memory than the 8-bit mask, and the functions below process 32 pixels (or more with SIMD) per
+operation.
+
+The binary images are created by #packBinary and converted back to 8-bit masks by #unpackBinary. The
+overloads of #erode, #dilate, #bitwise_and, #bitwise_or, #bitwise_xor, #bitwise_not, #countNonZero,
+#connectedComponents and #findContours accept them directly.
+ */
+class CV_EXPORTS BinaryImage
+{
+public:
+    BinaryImage();
+    //! creates the image of the given size with all the pixels set to 0
+    explicit BinaryImage(Size size);
+
+    //! allocates the image of the given size if needed, the content is undefined
+    void create(Size size);
+    Size size() const { return Size(width, bits.rows); }
+    bool empty() const { return bits.empty(); }
+
+    //! rows x ((width + 31)/32) matrix of the CV_32SC1 words with the pixel bits
+    Mat bits;
+    //! image width in pixels
+    int width;
+};
+
+/** @brief Packs a mask into the binary image.
+
+The pixels greater than thresh are set to 1 (with the default threshold, all the non-zero pixels).
+
+@param src Single-channel 8-bit, 16-bit or 32-bit floating-point image.
+@param dst Destination binary image of the same size.
+@param thresh Threshold value.
+@sa unpackBinary, threshold
+ */
+CV_EXPORTS void packBinary(InputArray src, BinaryImage& dst, double thresh = 0);
+
+/** @brief Unpacks the binary image into the 8-bit mask.
+
+@param src Source binary image.
+@param dst Destination CV_8UC1 image of the same size, the pixels are 0 or value.
+@param value Value of the pixels which are set in the binary image.
+ */
+CV_EXPORTS void unpackBinary(const BinaryImage& src, OutputArray dst, double value = 255);
+
+/** @overload
+
+Erodes the binary image, the same as erode() of the unpacked 8-bit mask with the default border.
+
+@param src Source binary image.
+@param dst Destination binary image of the same size. It can be the same as src.
+@param kernel Structuring element (CV_8UC1). If it is empty, the 3x3 rectangle is used.
+@param anchor Position of the anchor within the element; the default value (-1, -1) means the element center.
+ */
+CV_EXPORTS void erode(const BinaryImage& src, BinaryImage& dst, InputArray kernel, Point anchor = Point(-1,-1));
+
+/** @overload
+
+Dilates the binary image, the same as dilate() of the unpacked 8-bit mask with the default border.
+
+@param src Source binary image.
+@param dst Destination binary image of the same size. It can be the same as src.
+@param kernel Structuring element (CV_8UC1). If it is empty, the 3x3 rectangle is used.
+@param anchor Position of the anchor within the element; the default value (-1, -1) means the element center.
+ */
+CV_EXPORTS void dilate(const BinaryImage& src, BinaryImage& dst, InputArray kernel, Point anchor = Point(-1,-1));
+
+//! per-pixel conjunction of the binary images of the same size
+CV_EXPORTS void bitwise_and(const BinaryImage& src1, const BinaryImage& src2, BinaryImage& dst);
+//! per-pixel disjunction of the binary images of the same size
+CV_EXPORTS void bitwise_or(const BinaryImage& src1, const BinaryImage& src2, BinaryImage& dst);
+//! per-pixel "exclusive or" of the binary images of the same size
+CV_EXPORTS void bitwise_xor(const BinaryImage& src1, const BinaryImage& src2, BinaryImage& dst);
+//! inverts every pixel of the binary image
+CV_EXPORTS void bitwise_not(const BinaryImage& src, BinaryImage& dst);
+//! counts the pixels which are set in the binary image
+CV_EXPORTS int countNonZero(const BinaryImage& src);
+
 //! @} imgproc_filter
 
 //! @addtogroup imgproc_transform
@@ -2519,6 +2730,73 @@ CV_EXPORTS_W void convertMaps( InputArray map1, InputArray map2,
                                OutputArray dstmap1, OutputArray dstmap2,
                                int dstmap1type, bool nninterpolation = false );
 
+/** @brief Precomputed, cache-blocked representation of a remap transformation.
+
+The class converts a pair of maps accepted by #remap (for example, maps produced by
+#initUndistortRectifyMap or by the fisheye variant of it) into a compact tiled form and then
+applies it to images. The destination image is split into tiles, and for every tile the source
+coordinates are stored as 16-bit deltas (in 1/#INTER_TAB_SIZE pixel units) relative to the
+tile's source footprint, which takes 4 bytes per pixel instead of 8 bytes for #CV_32FC2 maps.
+Tiles whose footprint does not fit the 16-bit range fall back to the #CV_16SC2 + #CV_16UC1
+representation. Tiles are executed in the order of their source footprints, so consecutive tiles
+touch neighbouring source memory, and the footprint of the next tile is prefetched while the
+current one is processed.
+
+The result of apply() is bit-exact with #remap called with the same maps converted by
+#convertMaps to the fixed-point #CV_16SC2 representation.
+
+@sa remap, convertMaps, initUndistortRectifyMap
+ */
+class CV_EXPORTS_W_SIMPLE TiledRemap
+{
+public:
+    CV_WRAP TiledRemap();
+
+    /** @overload */
+    CV_WRAP TiledRemap(InputArray map1, InputArray map2, bool nninterpolation = false,
+                       Size tileSize = Size(32, 32));
+
+    /** @brief Builds the tiled map.
+
+    @param map1 The first map of either (x,y) points or just x values having the type CV_16SC2 ,
+    CV_32FC1, or CV_32FC2 (see #remap).
+    @param map2 The second map of y values having the type CV_16UC1, CV_32FC1, or none (empty map
+    if map1 is (x,y) points), respectively.
+    @param nninterpolation Flag indicating whether the map will be used for the nearest-neighbor
+    interpolation only. In this case floating-point coordinates are rounded the same way as #remap
+    does it for #INTER_NEAREST.
+    @param tileSize Size of destination tiles.
+     */
+    CV_WRAP void create(InputArray map1, InputArray map2, bool nninterpolation = false,
+                        Size tileSize = Size(32, 32));
+
+    /** @brief Applies the transformation to an image.
+
+    @param src Source image.
+    @param dst Destination image. It has the size of the maps and the same type as src.
+    @param interpolation Interpolation method, see #remap.
+    @param borderMode Pixel extrapolation method, see #remap.
+    @param borderValue Value used in case of a constant border.
+     */
+    CV_WRAP void apply(InputArray src, OutputArray dst, int interpolation = INTER_LINEAR,
+                       int borderMode = BORDER_CONSTANT, const Scalar& borderValue = Scalar()) const;
+
+    /** @brief Returns the size of the destination image. */
+    CV_WRAP Size size() const;
+
+    /** @brief Returns true if the map has not been created. */
+    CV_WRAP bool empty() const;
+
+    /** @brief Returns the number of bytes occupied by the compact map data. */
+    CV_WRAP size_t getByteSize() const;
+
+#ifndef CV_DOXYGEN
+    struct Impl;
+protected:
+    std::shared_ptr<Impl> impl;
+#endif
+};
+
 /** @brief Calculates an affine matrix of 2D rotation.
 
 The function calculates the following matrix:
@@ -3310,6 +3588,38 @@ equally sized rectangular tiles. tileGridSize defines the number of tiles in row
  */
 CV_EXPORTS_W Ptr<CLAHE> createCLAHE(double clipLimit = 40.0, Size tileGridSize = Size(8, 8));
 
+/** @brief Creates a smart pointer to a cv::StreamingHistogram object.
+
+@param histSize Number of bins per channel.
+@param rangeMin Inclusive lower boundary of the histogram range.
+@param rangeMax Exclusive upper boundary of the histogram range. The range is split into histSize
+bins of equal width, the pixel values out of the range are not counted.
+ */
+CV_EXPORTS_W Ptr<StreamingHistogram> createStreamingHistogram(int histSize = 256, double rangeMin = 0,
+                                                              double rangeMax = 256);
+
+/** @brief Calculates the histograms of the image tiles.
+
+The image is divided into tileGridSize.width x tileGridSize.height non-overlapping tiles that cover
+it exactly, and the histogram of every tile is computed. The tile (tx, ty) spans the columns
+\f$[\lfloor cols \cdot tx / W \rfloor, \lfloor cols \cdot (tx + 1) / W \rfloor)\f$ and the rows
+\f$[\lfloor rows \cdot ty / H \rfloor, \lfloor rows \cdot (ty + 1) / H \rfloor)\f$, where W x H is
+tileGridSize, so the sizes of the tiles differ by one pixel at most. Unlike CLAHE, the image is not
+padded and the histograms are not interpolated between the neighbor tiles. The tiles are processed
+in parallel.
+
+@param src 8-bit or 16-bit image with up to 4 channels.
+@param hist Output array of type CV_32SC1 with one row per tile in the row-major tile order. A row
+holds the histograms of the channels one after another, histSize bins each.
+@param tileGridSize Number of tiles in row and column.
+@param histSize Number of bins per channel.
+@param rangeMin Inclusive lower boundary of the histogram range.
+@param rangeMax Exclusive upper boundary of the histogram range.
+@sa createStreamingHistogram, createCLAHE
+ */
+CV_EXPORTS_W void calcTileHistograms(InputArray src, OutputArray hist, Size tileGridSize,
+                                     int histSize = 256, double rangeMin = 0, double rangeMax = 256);
+
 /** @brief Computes the "minimal work" distance between two weighted point configurations.
 
 The function computes the earth mover distance and/or a lower boundary of the distance between the
@@ -3458,7 +3768,8 @@ processing the same image.
 @param iterCount Number of iterations the algorithm should make before returning the result. Note
 that the result can be refined with further calls with mode==#GC_INIT_WITH_MASK or
 mode==GC_EVAL .
-@param mode Operation mode that could be one of the #GrabCutModes
+@param mode Operation mode that could be one of the #GrabCutModes . #GC_INIT_WITH_RECT and
+#GC_INIT_WITH_MASK can be combined with #GC_INIT_DOWNSCALED .
  */
 CV_EXPORTS_W void grabCut( InputArray img, InputOutputArray mask, Rect rect,
                            InputOutputArray bgdModel, InputOutputArray fgdModel,
@@ -3510,9 +3821,9 @@ distinct labels. When labelType==#DIST_LABEL_PIXEL, the function scans through t
 marks all the zero pixels with distinct labels.
 
 In this mode, the complexity is still linear. That is, the function provides a very fast way to
-compute the Voronoi diagram for a binary image. Currently, the second variant can use only the
-approximate distance transform algorithm, i.e. maskSize=#DIST_MASK_PRECISE is not supported
-yet.
+compute the Voronoi diagram for a binary image. The exact Voronoi diagram is computed for
+distanceType == #DIST_L2 and maskSize == #DIST_MASK_PRECISE, otherwise the approximate algorithm with
+a \f$5\times 5\f$ mask is used.
 
 @param src 8-bit, single-channel (binary) source image.
 @param dst Output image with calculated distances. It is a 8-bit or 32-bit floating-point,
@@ -3521,9 +3832,8 @@ single-channel image of the same size as src.
 CV_32SC1 and the same size as src.
 @param distanceType Type of distance, see #DistanceTypes
 @param maskSize Size of the distance transform mask, see #DistanceTransformMasks.
-#DIST_MASK_PRECISE is not supported by this variant. In case of the #DIST_L1 or #DIST_C distance type,
-the parameter is forced to 3 because a \f$3\times 3\f$ mask gives the same result as \f$5\times
-5\f$ or any larger aperture.
+#DIST_MASK_PRECISE is supported by this variant only for the #DIST_L2 distance type. Otherwise the
+parameter is forced to 5.
 @param labelType Type of the label array to build, see #DistanceTransformLabelTypes.
  */
 CV_EXPORTS_AS(distanceTransformWithLabels) void distanceTransform( InputArray src, OutputArray dst,
@@ -3711,6 +4021,41 @@ This function only supports YUV420 to RGB conversion as of now.
 */
 CV_EXPORTS_W void cvtColorTwoPlane( InputArray src1, InputArray src2, OutputArray dst, int code );
 
+/** @brief Converts, resizes and normalizes an image into a planar blob in a single pass.
+
+The function is equivalent to the following sequence of calls, but it processes the image in
+parallel stripes without storing full-size intermediate images:
+@code
+    cvtColor(src, bgr, code);                     // if code >= 0
+    bgr.convertTo(tmp, CV_32F);
+    resize(tmp, tmp, dsize, 0, 0, interpolation);
+    // for every channel c: blob[0][c] = (tmp[c] - mean[c]) * scale[c]
+@endcode
+Values are not rounded to 8 bits after resizing, so the result may differ from the 8-bit pipeline
+by less than one source intensity level.
+
+@param src input image. #CV_8UC1 or #CV_8UC3 when code is negative or #COLOR_BGR2RGB, or a
+YUV 4:2:0 image (#CV_8UC1, height is 3/2 of the image height) for the YUV codes.
+@param dst output 4-dimensional blob of shape 1 x C x dsize.height x dsize.width and depth ddepth.
+@param code color conversion code. It can take the following values:
+- a negative value: no color conversion
+- #COLOR_BGR2RGB (same as #COLOR_RGB2BGR): swap the first and the third channels
+- #COLOR_YUV2BGR_NV12, #COLOR_YUV2RGB_NV12, #COLOR_YUV2BGR_NV21, #COLOR_YUV2RGB_NV21
+- #COLOR_YUV2BGR_I420, #COLOR_YUV2RGB_I420, #COLOR_YUV2BGR_YV12, #COLOR_YUV2RGB_YV12
+@param dsize output spatial size; if it is empty, the size of the converted image is used.
+@param interpolation #INTER_LINEAR or #INTER_AREA, with the same results as #resize.
+@param mean values subtracted from the channels of the converted image (in the output channel order).
+@param scale multipliers applied to the channels after mean subtraction (in the output channel order).
+@param ddepth depth of the output blob: #CV_32F or #CV_16F.
+
+@sa cvtColor, resize, Mat::convertTo
+ */
+CV_EXPORTS_W void cvtResizeNormalize( InputArray src, OutputArray dst, int code, Size dsize,
+                                      int interpolation = INTER_LINEAR,
+                                      const Scalar& mean = Scalar(),
+                                      const Scalar& scale = Scalar::all(1.0),
+                                      int ddepth = CV_32F );
+
 /** @brief main function for all demosaicing processes
 
 @param src input image: 8-bit unsigned or 16-bit unsigned.
@@ -3955,6 +4300,19 @@ CV_EXPORTS_W int connectedComponentsWithStats(InputArray image, OutputArray labe
                                               OutputArray stats, OutputArray centroids,
                                               int connectivity = 8, int ltype = CV_32S);
 
+/** @overload
+
+Labels the runs of the set pixels of the packed binary image and merges the runs which touch in the
+adjacent rows. The labels are numbered in the row major order, as #CCL_SAUF does.
+
+@param image the binary image to be labeled
+@param labels destination labeled image
+@param connectivity 8 or 4 for 8-way or 4-way connectivity respectively
+@param ltype output image label type. Currently CV_32S and CV_16U are supported.
+*/
+CV_EXPORTS int connectedComponents(const BinaryImage& image, OutputArray labels,
+                                   int connectivity = 8, int ltype = CV_32S);
+
 
 /** @brief Finds contours in a binary image.
 
@@ -3990,6 +4348,14 @@ CV_EXPORTS_W void findContours( InputArray image, OutputArrayOfArrays contours,
 CV_EXPORTS void findContours( InputArray image, OutputArrayOfArrays contours,
                               int mode, int method, Point offset = Point());
 
+/** @overload
+
+Finds contours in the packed binary image, see #BinaryImage.
+ */
+CV_EXPORTS void findContours( const BinaryImage& image, OutputArrayOfArrays contours,
+                              OutputArray hierarchy, int mode,
+                              int method, Point offset = Point());
+
 /** @example samples/cpp/squares.cpp
 A program using pyramid scaling, Canny, contours and contour simplification to find
 squares in a list of images (pic1-6.png). Returns sequence of squares detected on the image.
@@ -4654,6 +5020,25 @@ CV_EXPORTS void fillPoly(InputOutputArray img, const Point** pts,
                          const Scalar& color, int lineType = LINE_8, int shift = 0,
                          Point offset = Point() );
 
+/** @brief Fills a batch of polygons, each with its own color.
+
+The function gives the same result as calling fillPoly for every polygon of the batch in turn, but
+the edges of all the polygons are prepared once and the horizontal stripes of the image are
+rasterized in parallel. It is meant for drawing masks of many contours or detections at once. With
+lineType == #LINE_AA the polygons are drawn sequentially.
+
+@param img Image.
+@param pts Array of polygons where each polygon is represented as an array of points. Unlike
+fillPoly, every polygon is filled separately, the later polygons are drawn over the earlier ones.
+@param colors Polygon colors, one per polygon or a single color for all of them.
+@param lineType Type of the polygon boundaries. See #LineTypes
+@param shift Number of fractional bits in the vertex coordinates.
+@param offset Optional offset of all points of the polygons.
+ */
+CV_EXPORTS_W void fillPolyBatch(InputOutputArray img, InputArrayOfArrays pts,
+                                const std::vector<Scalar>& colors, int lineType = LINE_8,
+                                int shift = 0, Point offset = Point() );
+
 /** @brief Draws several polygonal curves.
 
 @param img Image.
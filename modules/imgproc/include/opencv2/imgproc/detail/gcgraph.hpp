@@ -54,6 +54,9 @@ public:
     void create( unsigned int vtxCount, unsigned int edgeCount );
     int addVtx();
     void addEdges( int i, int j, TWeight w, TWeight revw );
+    // After maxFlow() it can be called again with the changes (possibly negative) of the terminal
+    // weights; the next maxFlow() then starts from the current flow instead of solving from scratch.
+    // The cut stays exact, the returned flow value differs from the cut cost by a constant.
     void addTermWeights( int i, TWeight sourceW, TWeight sinkW );
     TWeight maxFlow();
     bool inSourceSegment( int i );
@@ -179,7 +182,12 @@ TWeight GCGraph<TWeight>::maxFlow()
             v->t = v->weight < 0;
         }
         else
+        {
+            // the vertex can be left from the previous maxFlow() call, see addTermWeights()
             v->parent = 0;
+            v->next = 0;
+            v->t = 0;
+        }
     }
     first = first->next;
     last->next = nilNode;
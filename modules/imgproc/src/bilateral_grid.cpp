@@ -0,0 +1,302 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+#include "opencv2/core/hal/intrin.hpp"
+
+/*
+ * Bilateral grid (J. Chen, S. Paris, F. Durand, "Real-time edge-aware image processing with
+ * the bilateral grid", 2007).
+ *
+ * The pixels are accumulated into a coarse 3D grid over (x, y, intensity) as homogeneous values
+ * (sum of the pixel values, number of pixels), the grid is blurred by a small separable kernel and
+ * the result is read back with the trilinear interpolation. The cell sizes are sigmaSpace and
+ * sigmaColor, so the cost per pixel doesn't depend on them.
+ */
+
+namespace cv
+{
+
+namespace
+{
+
+// empty cells around the grid, enough for the blur kernel and the interpolation
+const int BG_PAD = 2;
+
+// maximum number of the intensity levels of the grid
+const int BG_MAX_LEVELS = 256;
+
+// maximum size of the grid in the accumulated values per image pixel: the grid of the small sigmas
+// is larger than the image, bilateralFilter() is faster then and doesn't need the memory
+const int BG_MAX_VALUES_PER_PIXEL = 16;
+
+struct BilateralGrid
+{
+    int gw, gh, gd;     // grid size in x, y and intensity
+    int nch;            // number of the accumulated values per cell, the last one is the weight
+    float invSpace, invColor, minVal;
+    std::vector<float> data;
+
+    size_t cellIdx(int gy, int gx, int gz) const
+    {
+        return (((size_t)gy*gw + gx)*gd + gz)*nch;
+    }
+};
+
+template<typename T> static inline float guideValue(const T* p, int cn)
+{
+    return cn == 1 ? (float)p[0] : 0.114f*p[0] + 0.587f*p[1] + 0.299f*p[2];
+}
+
+// Accumulates the image rows which map to the grid rows [range.start, range.end);
+// the grid rows are disjoint, so the threads never update the same cells
+template<typename T>
+class BilateralGridSplatInvoker : public ParallelLoopBody
+{
+public:
+    BilateralGridSplatInvoker(const Mat& _src, BilateralGrid& _grid, const std::vector<int>& _rowOfs)
+        : src(_src), grid(_grid), rowOfs(_rowOfs)
+    {
+    }
+
+    virtual void operator()(const Range& range) const CV_OVERRIDE
+    {
+        const int cn = src.channels(), width = src.cols;
+        for (int gy = range.start; gy < range.end; gy++)
+        {
+            for (int y = rowOfs[gy]; y < rowOfs[gy + 1]; y++)
+            {
+                const T* p = src.ptr<T>(y);
+                for (int x = 0; x < width; x++, p += cn)
+                {
+                    int gx = cvRound(x*grid.invSpace) + BG_PAD;
+                    int gz = cvRound((guideValue(p, cn) - grid.minVal)*grid.invColor) + BG_PAD;
+                    float* cell = &grid.data[grid.cellIdx(gy + BG_PAD, gx, gz)];
+                    for (int c = 0; c < cn; c++)
+                        cell[c] += (float)p[c];
+                    cell[cn] += 1.f;
+                }
+            }
+        }
+    }
+
+private:
+    const Mat& src;
+    BilateralGrid& grid;
+    const std::vector<int>& rowOfs;
+};
+
+// Convolves the grid with [1 4 6 4 1]/16 along one axis. The grid is treated as a set of
+// 'outer' x 'inner' lines of 'len' cells; the lines of the same outer index are processed together
+class BilateralGridBlurInvoker : public ParallelLoopBody
+{
+public:
+    BilateralGridBlurInvoker(const float* _src, float* _dst, int _len, size_t _cellStep,
+                             size_t _outerStep, int _inner, size_t _innerStep, int _nch)
+        : src(_src), dst(_dst), len(_len), cellStep(_cellStep), outerStep(_outerStep),
+          inner(_inner), innerStep(_innerStep), nch(_nch)
+    {
+    }
+
+    virtual void operator()(const Range& range) const CV_OVERRIDE
+    {
+        const float k0 = 6.f/16, k1 = 4.f/16, k2 = 1.f/16;
+        for (int o = range.start; o < range.end; o++)
+        {
+            for (int i = 0; i < inner; i++)
+            {
+                const float* s = src + o*outerStep + i*innerStep;
+                float* d = dst + o*outerStep + i*innerStep;
+                for (int j = 0; j < len; j++)
+                {
+                    const float* c = s + j*cellStep;
+                    float* out = d + j*cellStep;
+                    int k = 0;
+                    if (j >= 2 && j < len - 2)
+                    {
+#if CV_SIMD128
+                        for (; k <= nch - v_float32x4::nlanes; k += v_float32x4::nlanes)
+                        {
+                            v_float32x4 v = v_load(c + k)*v_setall_f32(k0) +
+                                            (v_load(c + k - cellStep) + v_load(c + k + cellStep))*v_setall_f32(k1) +
+                                            (v_load(c + k - 2*cellStep) + v_load(c + k + 2*cellStep))*v_setall_f32(k2);
+                            v_store(out + k, v);
+                        }
+#endif
+                        for (; k < nch; k++)
+                            out[k] = c[k]*k0 + (c[k - cellStep] + c[k + cellStep])*k1 +
+                                     (c[k - 2*cellStep] + c[k + 2*cellStep])*k2;
+                    }
+                    else
+                    {
+                        // the cells outside of the grid are empty
+                        for (; k < nch; k++)
+                        {
+                            float v = c[k]*k0;
+                            if (j >= 1) v += c[k - cellStep]*k1;
+                            if (j >= 2) v += c[k - 2*cellStep]*k2;
+                            if (j + 1 < len) v += c[k + cellStep]*k1;
+                            if (j + 2 < len) v += c[k + 2*cellStep]*k2;
+                            out[k] = v;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    const float* src;
+    float* dst;
+    int len;
+    size_t cellStep, outerStep;
+    int inner;
+    size_t innerStep;
+    int nch;
+};
+
+// Reads the filtered values back by the trilinear interpolation of the grid
+template<typename T>
+class BilateralGridSliceInvoker : public ParallelLoopBody
+{
+public:
+    BilateralGridSliceInvoker(const Mat& _src, Mat& _dst, const BilateralGrid& _grid)
+        : src(_src), dst(_dst), grid(_grid)
+    {
+    }
+
+    virtual void operator()(const Range& range) const CV_OVERRIDE
+    {
+        const int cn = src.channels(), width = src.cols, nch = grid.nch;
+        const size_t zstep = nch, xstep = (size_t)grid.gd*nch, ystep = (size_t)grid.gw*grid.gd*nch;
+        for (int y = range.start; y < range.end; y++)
+        {
+            const T* p = src.ptr<T>(y);
+            T* out = dst.ptr<T>(y);
+            float fy = y*grid.invSpace + BG_PAD;
+            int gy = cvFloor(fy);
+            float wy = fy - gy;
+            for (int x = 0; x < width; x++, p += cn, out += cn)
+            {
+                float fx = x*grid.invSpace + BG_PAD;
+                float fz = (guideValue(p, cn) - grid.minVal)*grid.invColor + BG_PAD;
+                int gx = cvFloor(fx), gz = cvFloor(fz);
+                float wx = fx - gx, wz = fz - gz;
+                const float* c000 = &grid.data[grid.cellIdx(gy, gx, gz)];
+                float acc[4] = { 0.f, 0.f, 0.f, 0.f };
+                for (int k = 0; k < nch; k++)
+                {
+                    const float* c = c000 + k;
+                    float v00 = c[0] + (c[zstep] - c[0])*wz;
+                    float v01 = c[xstep] + (c[xstep + zstep] - c[xstep])*wz;
+                    float v10 = c[ystep] + (c[ystep + zstep] - c[ystep])*wz;
+                    float v11 = c[ystep + xstep] + (c[ystep + xstep + zstep] - c[ystep + xstep])*wz;
+                    float v0 = v00 + (v01 - v00)*wx;
+                    float v1 = v10 + (v11 - v10)*wx;
+                    acc[k] = v0 + (v1 - v0)*wy;
+                }
+                float w = acc[cn];
+                if (w > FLT_EPSILON)
+                {
+                    float iw = 1.f/w;
+                    for (int c = 0; c < cn; c++)
+                        out[c] = saturate_cast<T>(acc[c]*iw);
+                }
+                else
+                {
+                    for (int c = 0; c < cn; c++)
+                        out[c] = p[c];
+                }
+            }
+        }
+    }
+
+private:
+    const Mat& src;
+    Mat& dst;
+    const BilateralGrid& grid;
+};
+
+// returns false if the grid would be too large
+template<typename T>
+static bool fastBilateralFilter_(const Mat& src, Mat& dst, double sigmaColor, double sigmaSpace)
+{
+    const int cn = src.channels();
+    BilateralGrid grid;
+
+    double minVal = 0, maxVal = 255;
+    if (src.depth() != CV_8U)
+    {
+        minMaxIdx(src.reshape(1), &minVal, &maxVal);
+        CV_Assert(!cvIsNaN(minVal) && !cvIsInf(minVal) && !cvIsNaN(maxVal) && !cvIsInf(maxVal));
+    }
+    double range = std::max(maxVal - minVal, 1e-6);
+    double cellColor = std::max(sigmaColor, range/BG_MAX_LEVELS);
+    double cellSpace = std::max(sigmaSpace, 1.);
+
+    grid.nch = cn + 1;
+    grid.minVal = (float)minVal;
+    grid.invColor = (float)(1./cellColor);
+    grid.invSpace = (float)(1./cellSpace);
+    grid.gw = cvRound((src.cols - 1)*grid.invSpace) + 1 + 2*BG_PAD;
+    grid.gh = cvRound((src.rows - 1)*grid.invSpace) + 1 + 2*BG_PAD;
+    grid.gd = cvRound(range*grid.invColor) + 1 + 2*BG_PAD;
+    size_t total = (size_t)grid.gw*grid.gh*grid.gd*grid.nch;
+    if (total > src.total()*BG_MAX_VALUES_PER_PIXEL)
+        return false;
+    grid.data.assign(total, 0.f);
+
+    // image rows which map to every grid row
+    int ngy = grid.gh - 2*BG_PAD;
+    std::vector<int> rowOfs(ngy + 1, src.rows);
+    for (int y = src.rows - 1; y >= 0; y--)
+        rowOfs[cvRound(y*grid.invSpace)] = y;
+    for (int gy = ngy - 1; gy >= 0; gy--)
+        rowOfs[gy] = std::min(rowOfs[gy], rowOfs[gy + 1]);
+    rowOfs[0] = 0;
+
+    parallel_for_(Range(0, ngy), BilateralGridSplatInvoker<T>(src, grid, rowOfs));
+
+    // blur along z, x and y
+    std::vector<float> tmp(total);
+    const size_t zstep = grid.nch, xstep = (size_t)grid.gd*grid.nch, ystep = (size_t)grid.gw*grid.gd*grid.nch;
+    parallel_for_(Range(0, grid.gh), BilateralGridBlurInvoker(&grid.data[0], &tmp[0], grid.gd, zstep,
+                                                              ystep, grid.gw, xstep, grid.nch));
+    parallel_for_(Range(0, grid.gh), BilateralGridBlurInvoker(&tmp[0], &grid.data[0], grid.gw, xstep,
+                                                              ystep, grid.gd, zstep, grid.nch));
+    parallel_for_(Range(0, grid.gw), BilateralGridBlurInvoker(&grid.data[0], &tmp[0], grid.gh, ystep,
+                                                              xstep, grid.gd, zstep, grid.nch));
+    grid.data.swap(tmp);
+
+    parallel_for_(Range(0, src.rows), BilateralGridSliceInvoker<T>(src, dst, grid));
+    return true;
+}
+
+} // namespace
+
+void fastBilateralFilter( InputArray _src, OutputArray _dst, double sigmaColor, double sigmaSpace )
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_Assert(!_src.empty());
+    CV_Assert(_src.dims() <= 2);
+    CV_CheckGT(sigmaColor, 0., "");
+    CV_CheckGT(sigmaSpace, 0., "");
+
+    Mat src = _src.getMat();
+    int type = src.type(), depth = src.depth(), cn = src.channels();
+    CV_CheckType(type, (depth == CV_8U || depth == CV_32F) && (cn == 1 || cn == 3), "");
+
+    if (_dst.getObj() == _src.getObj())
+        src = src.clone();
+    _dst.create(src.size(), type);
+    Mat dst = _dst.getMat();
+
+    bool done = depth == CV_8U ? fastBilateralFilter_<uchar>(src, dst, sigmaColor, sigmaSpace) :
+                                 fastBilateralFilter_<float>(src, dst, sigmaColor, sigmaSpace);
+    if (!done)
+        bilateralFilter(src, dst, -1, sigmaColor, sigmaSpace);
+}
+
+} // namespace cv
@@ -0,0 +1,529 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+#include "opencv2/core/hal/intrin.hpp"
+
+namespace cv
+{
+
+BinaryImage::BinaryImage() : width(0)
+{
+}
+
+BinaryImage::BinaryImage(Size size) : width(0)
+{
+    create(size);
+    bits.setTo(Scalar::all(0));
+}
+
+void BinaryImage::create(Size size)
+{
+    CV_Assert(size.width >= 0 && size.height >= 0);
+    bits.create(size.height, (size.width + 31)/32, CV_32SC1);
+    width = size.width;
+}
+
+namespace
+{
+
+// the bits of the last word of a row which belong to the image
+static inline unsigned lastWordMask(int width)
+{
+    return (width & 31) ? (1u << (width & 31)) - 1 : ~0u;
+}
+
+static inline int popCount32(unsigned v)
+{
+    v = v - ((v >> 1) & 0x55555555u);
+    v = (v & 0x33333333u) + ((v >> 2) & 0x33333333u);
+    return (int)((((v + (v >> 4)) & 0x0F0F0F0Fu)*0x01010101u) >> 24);
+}
+
+template<typename T>
+static void packRow(const T* src, unsigned* dst, int width, double thresh)
+{
+    for (int x = 0, i = 0; x < width; x += 32, i++)
+    {
+        int n = std::min(width - x, 32);
+        unsigned w = 0;
+        for (int k = 0; k < n; k++)
+            w |= (unsigned)(src[x + k] > thresh) << k;
+        dst[i] = w;
+    }
+}
+
+static void packRow8u(const uchar* src, unsigned* dst, int width, double thresh)
+{
+    int x = 0, i = 0;
+    if (thresh < 0 || thresh >= UCHAR_MAX)
+    {
+        unsigned fill = thresh < 0 ? ~0u : 0u;
+        for (; x < width; x += 32, i++)
+            dst[i] = fill;
+        if (width & 31)
+            dst[i - 1] &= lastWordMask(width);
+        return;
+    }
+#if CV_SIMD128
+    v_uint8x16 t = v_setall_u8((uchar)cvFloor(thresh));
+    for (; x <= width - 32; x += 32, i++)
+    {
+        unsigned lo = (unsigned)v_signmask(v_load(src + x) > t);
+        unsigned hi = (unsigned)v_signmask(v_load(src + x + 16) > t);
+        dst[i] = lo | (hi << 16);
+    }
+#endif
+    packRow<uchar>(src + x, dst + i, width - x, thresh);
+}
+
+// The source row with the margins of 'fill' words; the bits past the image width are set to the fill value
+static void padRow(const unsigned* src, unsigned* dst, int nwords, int margin, int width, unsigned fill)
+{
+    std::fill(dst, dst + margin, fill);
+    memcpy(dst + margin, src, nwords*sizeof(unsigned));
+    if (fill && (width & 31))
+        dst[margin + nwords - 1] |= ~lastWordMask(width);
+    std::fill(dst + margin + nwords, dst + margin*2 + nwords, fill);
+}
+
+// The 32 bits of 'a' starting from the bit 'ofs' of the word 'i'; the bits past the end are 'fill'
+static inline unsigned wordAt(const unsigned* a, int n, int i, int ofs, unsigned fill)
+{
+    int q = i + (ofs >> 5), r = ofs & 31;
+    unsigned lo = q < n ? a[q] : fill;
+    if (!r)
+        return lo;
+    unsigned hi = q + 1 < n ? a[q + 1] : fill;
+    return (lo >> r) | (hi << (32 - r));
+}
+
+// d[i] = a[i + ofs1 bits] op a[i + ofs2 bits], i < count; d may be the same as a if ofs1, ofs2 >= 0
+static void combineShifted(bool isDilate, const unsigned* a, int n, int ofs1, int ofs2,
+                           unsigned* d, int count, unsigned fill)
+{
+    int i = 0;
+#if CV_SIMD
+    const int vlanes = v_uint32::nlanes;
+    const int q1 = ofs1 >> 5, r1 = ofs1 & 31, q2 = ofs2 >> 5, r2 = ofs2 & 31;
+    // the vectors must not read past the end
+    int vend = std::min(count, n - 1 - std::max(q1, q2));
+    for (; i <= vend - vlanes; i += vlanes)
+    {
+        v_uint32 w1 = vx_load(a + i + q1), w2 = vx_load(a + i + q2);
+        if (r1)
+            w1 = (w1 >> r1) | (vx_load(a + i + q1 + 1) << (32 - r1));
+        if (r2)
+            w2 = (w2 >> r2) | (vx_load(a + i + q2 + 1) << (32 - r2));
+        v_store(d + i, isDilate ? (w1 | w2) : (w1 & w2));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        unsigned w1 = wordAt(a, n, i, ofs1, fill), w2 = wordAt(a, n, i, ofs2, fill);
+        d[i] = isDilate ? (w1 | w2) : (w1 & w2);
+    }
+}
+
+static void combineRows(bool isDilate, const unsigned* a, unsigned* d, int n)
+{
+    int i = 0;
+#if CV_SIMD
+    for (; i <= n - v_uint32::nlanes; i += v_uint32::nlanes)
+        v_store(d + i, isDilate ? (vx_load(d + i) | vx_load(a + i)) : (vx_load(d + i) & vx_load(a + i)));
+#endif
+    for (; i < n; i++)
+        d[i] = isDilate ? (d[i] | a[i]) : (d[i] & a[i]);
+}
+
+struct BinaryKernelRun
+{
+    int row;    // kernel row
+    int idx;    // index of the horizontal run (column, length)
+};
+
+// Every row of the destination is the AND (OR) of the horizontal runs of the kernel applied to the source rows.
+// A run of n bits is computed by log2(n) + 1 shifts of the words
+class BinaryMorphInvoker : public ParallelLoopBody
+{
+public:
+    BinaryMorphInvoker(const BinaryImage& _src, BinaryImage& _dst, bool _isDilate, const std::vector<BinaryKernelRun>& _runs,
+                       const std::vector<Point>& _hruns, Size _ksize, Point _anchor, int _stripeHeight)
+        : src(_src), dst(_dst), isDilate(_isDilate), runs(_runs), hruns(_hruns), ksize(_ksize), anchor(_anchor),
+          stripeHeight(_stripeHeight)
+    {
+    }
+
+    virtual void operator()(const Range& range) const CV_OVERRIDE
+    {
+        const int nwords = src.bits.cols, height = src.bits.rows;
+        const int margin = (ksize.width*2 + 31)/32 + 1, pw = nwords + margin*2;
+        const unsigned fill = isDilate ? 0u : ~0u, mask = lastWordMask(src.width);
+        const int nh = (int)hruns.size();
+        int nlevels = 1;
+        for (int k = 0; k < nh; k++)
+            for (; (1 << nlevels) <= hruns[k].y; nlevels++)
+                ;
+
+        for (int stripe = range.start; stripe < range.end; stripe++)
+        {
+            int y0 = stripe*stripeHeight, y1 = std::min(y0 + stripeHeight, height);
+            // the source rows of the stripe, the rows outside of the image do not change the result
+            int sy0 = std::max(y0 - anchor.y, 0), sy1 = std::min(y1 + ksize.height - 1 - anchor.y, height);
+            int nrows = sy1 - sy0;
+            // the level l is the AND (OR) of the runs of 2^l bits of the padded source row
+            std::vector<unsigned> levels((size_t)nlevels*pw), hbuf((size_t)nh*nrows*nwords);
+            for (int i = 0; i < nrows; i++)
+            {
+                padRow(src.bits.ptr<unsigned>(sy0 + i), &levels[0], nwords, margin, src.width, fill);
+                for (int l = 1; l < nlevels; l++)
+                    combineShifted(isDilate, &levels[(size_t)(l - 1)*pw], pw, 0, 1 << (l - 1),
+                                   &levels[(size_t)l*pw], pw, fill);
+                for (int k = 0; k < nh; k++)
+                {
+                    // the run covers the bits [x + c, x + c + len) of the source row
+                    int c = hruns[k].x - anchor.x, len = hruns[k].y, l = 0;
+                    for (; (2 << l) <= len; l++)
+                        ;
+                    combineShifted(isDilate, &levels[(size_t)l*pw], pw, margin*32 + c, margin*32 + c + len - (1 << l),
+                                   &hbuf[((size_t)k*nrows + i)*nwords], nwords, fill);
+                }
+            }
+
+            std::vector<unsigned> acc(nwords);
+            for (int y = y0; y < y1; y++)
+            {
+                std::fill(acc.begin(), acc.end(), fill);
+                for (size_t j = 0; j < runs.size(); j++)
+                {
+                    int sy = y + runs[j].row - anchor.y;
+                    if (sy < 0 || sy >= height)
+                        continue;
+                    combineRows(isDilate, &hbuf[((size_t)runs[j].idx*nrows + sy - sy0)*nwords], &acc[0], nwords);
+                }
+                if (nwords > 0)
+                    acc[nwords - 1] &= mask;
+                memcpy(dst.bits.ptr<unsigned>(y), &acc[0], nwords*sizeof(unsigned));
+            }
+        }
+    }
+
+private:
+    const BinaryImage& src;
+    BinaryImage& dst;
+    bool isDilate;
+    const std::vector<BinaryKernelRun>& runs;
+    const std::vector<Point>& hruns;
+    Size ksize;
+    Point anchor;
+    int stripeHeight;
+};
+
+static void binaryMorph(bool isDilate, const BinaryImage& _src, BinaryImage& dst, InputArray _kernel, Point anchor)
+{
+    CV_Assert(!_src.empty());
+
+    Mat kernel = _kernel.getMat();
+    if (kernel.empty())
+        kernel = getStructuringElement(MORPH_RECT, Size(3, 3));
+    CV_CheckType(kernel.type(), kernel.type() == CV_8UC1, "");
+    anchor = normalizeAnchor(anchor, kernel.size());
+
+    // the runs of the non-zero kernel elements in every row and the distinct (column, length) pairs
+    std::vector<BinaryKernelRun> runs;
+    std::vector<Point> hruns;
+    for (int i = 0; i < kernel.rows; i++)
+    {
+        const uchar* k = kernel.ptr<uchar>(i);
+        for (int j = 0; j < kernel.cols; )
+        {
+            if (!k[j])
+            {
+                j++;
+                continue;
+            }
+            int j0 = j;
+            for (; j < kernel.cols && k[j]; j++)
+                ;
+            Point hrun(j0, j - j0);
+            size_t idx = std::find(hruns.begin(), hruns.end(), hrun) - hruns.begin();
+            if (idx == hruns.size())
+                hruns.push_back(hrun);
+            BinaryKernelRun run = { i, (int)idx };
+            runs.push_back(run);
+        }
+    }
+
+    BinaryImage src = _src;
+    if (src.bits.data == dst.bits.data)
+        src.bits = _src.bits.clone();
+    dst.create(src.size());
+
+    if (runs.empty())
+    {
+        // no pixels in the kernel: the result is the border value
+        dst.bits.setTo(Scalar::all(0));
+        if (!isDilate)
+            for (int y = 0; y < dst.bits.rows; y++)
+            {
+                unsigned* d = dst.bits.ptr<unsigned>(y);
+                std::fill(d, d + dst.bits.cols, ~0u);
+                d[dst.bits.cols - 1] &= lastWordMask(dst.width);
+            }
+        return;
+    }
+
+    int stripeHeight = std::max(kernel.rows*4, 64);
+    int nstripes = (src.bits.rows + stripeHeight - 1)/stripeHeight;
+    parallel_for_(Range(0, nstripes), BinaryMorphInvoker(src, dst, isDilate, runs, hruns, kernel.size(),
+                                                         anchor, stripeHeight));
+}
+
+static int findBit(const unsigned* w, int x, int width, bool value)
+{
+    while (x < width)
+    {
+        unsigned word = w[x >> 5];
+        if (!value)
+            word = ~word;
+        word &= ~0u << (x & 31);
+        if (word)
+            return std::min((x & ~31) + (int)trailingZeros32(word), width);
+        x = (x & ~31) + 32;
+    }
+    return width;
+}
+
+static inline int findRoot(std::vector<int>& parent, int i)
+{
+    while (parent[i] != i)
+        i = parent[i] = parent[parent[i]];
+    return i;
+}
+
+} // namespace
+
+void packBinary(InputArray _src, BinaryImage& dst, double thresh)
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat src = _src.getMat();
+    int type = src.type();
+    CV_CheckType(type, type == CV_8UC1 || type == CV_16UC1 || type == CV_16SC1 || type == CV_32FC1, "");
+    CV_Assert(src.dims <= 2);
+
+    dst.create(src.size());
+    parallel_for_(Range(0, src.rows), [&](const Range& range)
+    {
+        for (int y = range.start; y < range.end; y++)
+        {
+            unsigned* d = dst.bits.ptr<unsigned>(y);
+            if (type == CV_8UC1)
+                packRow8u(src.ptr<uchar>(y), d, src.cols, thresh);
+            else if (type == CV_16UC1)
+                packRow<ushort>(src.ptr<ushort>(y), d, src.cols, thresh);
+            else if (type == CV_16SC1)
+                packRow<short>(src.ptr<short>(y), d, src.cols, thresh);
+            else
+                packRow<float>(src.ptr<float>(y), d, src.cols, thresh);
+        }
+    });
+}
+
+void unpackBinary(const BinaryImage& src, OutputArray _dst, double value)
+{
+    CV_INSTRUMENT_REGION();
+
+    _dst.create(src.size(), CV_8UC1);
+    Mat dst = _dst.getMat();
+    const int width = src.width;
+
+    // 8 destination pixels for every byte of the bits
+    uchar v = saturate_cast<uchar>(value);
+    uint64 tab[256];
+    for (int b = 0; b < 256; b++)
+    {
+        uchar p[8];
+        for (int k = 0; k < 8; k++)
+            p[k] = (b >> k) & 1 ? v : 0;
+        memcpy(&tab[b], p, 8);
+    }
+
+    parallel_for_(Range(0, dst.rows), [&](const Range& range)
+    {
+        for (int y = range.start; y < range.end; y++)
+        {
+            const unsigned* s = src.bits.ptr<unsigned>(y);
+            uchar* d = dst.ptr<uchar>(y);
+            int x = 0;
+            for (; x <= width - 32; x += 32)
+            {
+                unsigned w = s[x >> 5];
+                for (int k = 0; k < 4; k++)
+                    memcpy(d + x + k*8, &tab[(w >> k*8) & 255], 8);
+            }
+            for (; x < width; x++)
+                d[x] = (s[x >> 5] >> (x & 31)) & 1 ? v : 0;
+        }
+    });
+}
+
+void erode(const BinaryImage& src, BinaryImage& dst, InputArray kernel, Point anchor)
+{
+    CV_INSTRUMENT_REGION();
+
+    binaryMorph(false, src, dst, kernel, anchor);
+}
+
+void dilate(const BinaryImage& src, BinaryImage& dst, InputArray kernel, Point anchor)
+{
+    CV_INSTRUMENT_REGION();
+
+    binaryMorph(true, src, dst, kernel, anchor);
+}
+
+void bitwise_and(const BinaryImage& src1, const BinaryImage& src2, BinaryImage& dst)
+{
+    CV_Assert(src1.size() == src2.size());
+    int width = src1.width;
+    cv::bitwise_and(src1.bits, src2.bits, dst.bits);
+    dst.width = width;
+}
+
+void bitwise_or(const BinaryImage& src1, const BinaryImage& src2, BinaryImage& dst)
+{
+    CV_Assert(src1.size() == src2.size());
+    int width = src1.width;
+    cv::bitwise_or(src1.bits, src2.bits, dst.bits);
+    dst.width = width;
+}
+
+void bitwise_xor(const BinaryImage& src1, const BinaryImage& src2, BinaryImage& dst)
+{
+    CV_Assert(src1.size() == src2.size());
+    int width = src1.width;
+    cv::bitwise_xor(src1.bits, src2.bits, dst.bits);
+    dst.width = width;
+}
+
+void bitwise_not(const BinaryImage& src, BinaryImage& dst)
+{
+    int width = src.width;
+    cv::bitwise_not(src.bits, dst.bits);
+    dst.width = width;
+    // keep the bits past the width zero
+    if ((width & 31) && !dst.empty())
+    {
+        unsigned mask = lastWordMask(width);
+        for (int y = 0; y < dst.bits.rows; y++)
+            dst.bits.ptr<unsigned>(y)[dst.bits.cols - 1] &= mask;
+    }
+}
+
+int countNonZero(const BinaryImage& src)
+{
+    CV_INSTRUMENT_REGION();
+
+    const int nwords = src.bits.cols;
+    int count = 0;
+    for (int y = 0; y < src.bits.rows; y++)
+    {
+        const unsigned* w = src.bits.ptr<unsigned>(y);
+        int i = 0;
+#if CV_SIMD
+        v_uint32 s = vx_setzero_u32();
+        for (; i <= nwords - v_uint32::nlanes; i += v_uint32::nlanes)
+            s += v_popcount(vx_load(w + i));
+        count += (int)v_reduce_sum(s);
+#endif
+        for (; i < nwords; i++)
+            count += popCount32(w[i]);
+    }
+    return count;
+}
+
+int connectedComponents(const BinaryImage& image, OutputArray _labels, int connectivity, int ltype)
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_Assert(connectivity == 8 || connectivity == 4);
+    CV_Assert(ltype == CV_32S || ltype == CV_16U);
+
+    const int width = image.width, height = image.bits.rows;
+    // the runs of the foreground pixels [start, end) and their provisional labels, row by row
+    std::vector<int> runStart, runEnd, runLabel, rowRuns(height + 1, 0), parent;
+    const int gap = connectivity == 8 ? 1 : 0;
+
+    for (int y = 0; y < height; y++)
+    {
+        const unsigned* w = image.bits.ptr<unsigned>(y);
+        int prev = y > 0 ? rowRuns[y - 1] : 0, prevEnd = rowRuns[y];
+        for (int x = findBit(w, 0, width, true); x < width; x = findBit(w, x, width, true))
+        {
+            int e = findBit(w, x, width, false);
+            // skip the runs of the previous row which end before this one may touch them
+            while (prev < prevEnd && runEnd[prev] + gap <= x)
+                prev++;
+            int label = -1;
+            for (int p = prev; p < prevEnd && runStart[p] < e + gap; p++)
+            {
+                int root = findRoot(parent, runLabel[p]);
+                if (label < 0)
+                    label = root;
+                else if (root != label)
+                {
+                    // the smaller label is the root, so the labels keep the order of the first pixels
+                    parent[std::max(root, label)] = std::min(root, label);
+                    label = std::min(root, label);
+                }
+            }
+            if (label < 0)
+            {
+                label = (int)parent.size();
+                parent.push_back(label);
+            }
+            runStart.push_back(x);
+            runEnd.push_back(e);
+            runLabel.push_back(label);
+            x = e;
+        }
+        rowRuns[y + 1] = (int)runStart.size();
+    }
+
+    // the final labels in the order of the first pixels of the components
+    std::vector<int> labelMap(parent.size());
+    int nlabels = 1;
+    for (size_t i = 0; i < parent.size(); i++)
+        labelMap[i] = parent[i] == (int)i ? nlabels++ : labelMap[findRoot(parent, (int)i)];
+    if (ltype == CV_16U)
+        CV_CheckLE(nlabels, USHRT_MAX + 1, "too many labels for CV_16U");
+
+    _labels.create(image.size(), ltype);
+    Mat labels = _labels.getMat();
+    labels.setTo(Scalar::all(0));
+    for (int y = 0; y < height; y++)
+    {
+        for (int r = rowRuns[y]; r < rowRuns[y + 1]; r++)
+        {
+            int label = labelMap[runLabel[r]];
+            if (ltype == CV_32S)
+                std::fill(labels.ptr<int>(y) + runStart[r], labels.ptr<int>(y) + runEnd[r], label);
+            else
+                std::fill(labels.ptr<ushort>(y) + runStart[r], labels.ptr<ushort>(y) + runEnd[r], (ushort)label);
+        }
+    }
+    return nlabels;
+}
+
+void findContours(const BinaryImage& image, OutputArrayOfArrays contours, OutputArray hierarchy,
+                  int mode, int method, Point offset)
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat mask;
+    unpackBinary(image, mask, 1);
+    findContours(mask, contours, hierarchy, mode, method, offset);
+}
+
+} // namespace cv
@@ -12,6 +12,7 @@
 #include "opencl_kernels_imgproc.hpp"
 #include "opencv2/core/hal/intrin.hpp"
 #include "opencv2/core/softfloat.hpp"
+#include "opencv2/core/utils/configuration.private.hpp"
 
 #include "color.hpp"
 
@@ -964,6 +965,14 @@ static const int *abToXZ_b;
 static const bool enableRGB2LuvInterpolation = true;
 static const bool enablePackedRGB2Luv = true;
 static const bool enablePackedLuv2RGB = true;
+
+// 32f sRGB->Luv can use the same 16-bit LUT as 8u, the way 32f sRGB->Lab does.
+// It is several times faster but the error in u and v grows up to ~0.5, so it is off by default.
+// The parameter is read on every conversion, the cost is negligible compared to the conversion itself.
+static bool useRGB2Luv32fInterpolation()
+{
+    return utils::getConfigurationParameterBool("OPENCV_IMGPROC_RGB2LUV_32F_INTERPOLATION", false);
+}
 static const softfloat uLow(-134), uHigh(220), uRange(uHigh-uLow);
 static const softfloat vLow(-140), vHigh(122), vRange(vHigh-vLow);
 
@@ -994,6 +1003,50 @@ static const softfloat lscale  = softfloat(841) / softfloat(108); // 7.787f = (2
 static const softfloat lbias = softfloat(16) / softfloat(116);
 static const softfloat f255(255);
 
+#if CV_SIMD
+
+// Cube root of non-negative x: the exponent is divided by 3 on the bit level and refined by
+// 2 Halley iterations. Unlike the spline it needs no table lookups, which are gathers in SIMD.
+static inline v_float32 v_cbrt(const v_float32& x)
+{
+    // tiny values are clamped to keep y^3 normalized; they fall to the linear part of Lab anyway
+    v_float32 x0 = v_max(x, vx_setall_f32(1e-20f));
+    v_int32 ix = v_trunc(v_cvt_f32(v_reinterpret_as_s32(x0))*vx_setall_f32(1.f/3));
+    v_float32 y = v_reinterpret_as_f32(ix + vx_setall_s32(709921077));
+    for(int k = 0; k < 2; k++)
+    {
+        v_float32 y3 = y*y*y;
+        y = y*v_fma(x0, vx_setall_f32(2.f), y3)/v_fma(y3, vx_setall_f32(2.f), x0);
+    }
+    return y;
+}
+
+// The same function as LabCbrtTab: cube root above (6/29)^3 and the linear segment below
+static inline v_float32 v_labCbrt(const v_float32& x)
+{
+    return v_select(x > vx_setall_f32((float)lthresh), v_cbrt(x),
+                    v_fma(x, vx_setall_f32((float)lscale), vx_setall_f32((float)lbias)));
+}
+
+#endif // CV_SIMD
+
+// Scalar version of v_labCbrt(): the tails of the rows get exactly the values the SIMD body would give them
+static inline float labCbrt(float x)
+{
+    if (!(x > (float)lthresh))
+        return x*(float)lscale + (float)lbias;
+    Cv32suf v;
+    v.f = x;
+    v.i = (int)((float)v.i*(1.f/3)) + 709921077;
+    float y = v.f;
+    for(int k = 0; k < 2; k++)
+    {
+        float y3 = y*y*y;
+        y = y*(x*2.f + y3)/(y3*2.f + x);
+    }
+    return y;
+}
+
 
 static inline softfloat applyGamma(softfloat x)
 {
@@ -1206,119 +1259,123 @@ static LABLUVLUT_s16_t initLUTforLABLUVs16(const softfloat & un, const softfloat
 }
 
 
-static void initLabTabs()
+static bool buildLabTabs()
 {
-    static bool initialized = false;
-    if(!initialized)
+    softfloat f[LAB_CBRT_TAB_SIZE+1], g[GAMMA_TAB_SIZE+1], ig[GAMMA_TAB_SIZE+1];
+    softfloat scale = softfloat::one()/softfloat(LabCbrtTabScale);
+    int i;
+    for(i = 0; i <= LAB_CBRT_TAB_SIZE; i++)
     {
-        softfloat f[LAB_CBRT_TAB_SIZE+1], g[GAMMA_TAB_SIZE+1], ig[GAMMA_TAB_SIZE+1];
-        softfloat scale = softfloat::one()/softfloat(LabCbrtTabScale);
-        int i;
-        for(i = 0; i <= LAB_CBRT_TAB_SIZE; i++)
-        {
-            softfloat x = scale*softfloat(i);
-            f[i] = x < lthresh ? mulAdd(x, lscale, lbias) : cbrt(x);
-        }
-        LabCbrtTab = splineBuild(f, LAB_CBRT_TAB_SIZE);
+        softfloat x = scale*softfloat(i);
+        f[i] = x < lthresh ? mulAdd(x, lscale, lbias) : cbrt(x);
+    }
+    LabCbrtTab = splineBuild(f, LAB_CBRT_TAB_SIZE);
 
-        scale = softfloat::one()/softfloat(GammaTabScale);
-        for(i = 0; i <= GAMMA_TAB_SIZE; i++)
-        {
-            softfloat x = scale*softfloat(i);
-            g[i] = applyGamma(x);
-            ig[i] = applyInvGamma(x);
-        }
+    scale = softfloat::one()/softfloat(GammaTabScale);
+    for(i = 0; i <= GAMMA_TAB_SIZE; i++)
+    {
+        softfloat x = scale*softfloat(i);
+        g[i] = applyGamma(x);
+        ig[i] = applyInvGamma(x);
+    }
 
-        sRGBGammaTab = splineBuild(g, GAMMA_TAB_SIZE);
-        sRGBInvGammaTab = splineBuild(ig, GAMMA_TAB_SIZE);
+    sRGBGammaTab = splineBuild(g, GAMMA_TAB_SIZE);
+    sRGBInvGammaTab = splineBuild(ig, GAMMA_TAB_SIZE);
 
-        static const softfloat intScale(255*(1 << gamma_shift));
-        for(i = 0; i < 256; i++)
+    static const softfloat intScale(255*(1 << gamma_shift));
+    for(i = 0; i < 256; i++)
+    {
+        softfloat x = softfloat(i)/f255;
+        sRGBGammaTab_b[i] = (ushort)(cvRound(intScale*applyGamma(x)));
+        linearGammaTab_b[i] = (ushort)(i*(1 << gamma_shift));
+    }
+    static const softfloat invScale = softfloat::one()/softfloat((int)INV_GAMMA_TAB_SIZE);
+    for(i = 0; i < INV_GAMMA_TAB_SIZE; i++)
+    {
+        softfloat x = invScale*softfloat(i);
+        sRGBInvGammaTab_b[i] = (ushort)(cvRound(f255*applyInvGamma(x)));
+        linearInvGammaTab_b[i] = (ushort)(cvTrunc(f255*x));
+    }
+
+    static const softfloat cbTabScale(softfloat::one()/(f255*(1 << gamma_shift)));
+    static const softfloat lshift2(1 << lab_shift2);
+    for(i = 0; i < LAB_CBRT_TAB_SIZE_B; i++)
+    {
+        softfloat x = cbTabScale*softfloat(i);
+        LabCbrtTab_b[i] = (ushort)(cvRound(lshift2 * (x < lthresh ? mulAdd(x, lscale, lbias) : cbrt(x))));
+    }
+
+    //Lookup table for L to y and ify calculations
+    for(i = 0; i < 256; i++)
+    {
+        int y, ify;
+        //8 * 255.0 / 100.0 == 20.4
+        if( i <= 20)
         {
-            softfloat x = softfloat(i)/f255;
-            sRGBGammaTab_b[i] = (ushort)(cvRound(intScale*applyGamma(x)));
-            linearGammaTab_b[i] = (ushort)(i*(1 << gamma_shift));
+            //yy = li / 903.3f;
+            //y = L*100/903.3f; 903.3f = (29/3)^3, 255 = 17*3*5
+            y = cvRound(softfloat(i*LUT_BASE*20*9)/softfloat(17*29*29*29));
+            //fy = 7.787f * yy + 16.0f / 116.0f; 7.787f = (29/3)^3/(29*4)
+            ify = cvRound(softfloat((int)LUT_BASE)*(softfloat(16)/softfloat(116) + softfloat(i*5)/softfloat(3*17*29)));
         }
-        static const softfloat invScale = softfloat::one()/softfloat((int)INV_GAMMA_TAB_SIZE);
-        for(i = 0; i < INV_GAMMA_TAB_SIZE; i++)
+        else
         {
-            softfloat x = invScale*softfloat(i);
-            sRGBInvGammaTab_b[i] = (ushort)(cvRound(f255*applyInvGamma(x)));
-            linearInvGammaTab_b[i] = (ushort)(cvTrunc(f255*x));
+            //fy = (li + 16.0f) / 116.0f;
+            softfloat fy = (softfloat(i*100*LUT_BASE)/softfloat(255*116) +
+                            softfloat(16*LUT_BASE)/softfloat(116));
+            ify = cvRound(fy);
+            //yy = fy * fy * fy;
+            y = cvRound(fy*fy*fy/softfloat(LUT_BASE*LUT_BASE));
         }
 
-        static const softfloat cbTabScale(softfloat::one()/(f255*(1 << gamma_shift)));
-        static const softfloat lshift2(1 << lab_shift2);
-        for(i = 0; i < LAB_CBRT_TAB_SIZE_B; i++)
-        {
-            softfloat x = cbTabScale*softfloat(i);
-            LabCbrtTab_b[i] = (ushort)(cvRound(lshift2 * (x < lthresh ? mulAdd(x, lscale, lbias) : cbrt(x))));
-        }
+        LabToYF_b[i*2  ] = (ushort)y;   // 0 <= y <= BASE
+        LabToYF_b[i*2+1] = (ushort)ify; // 2260 <= ify <= BASE
+    }
 
-        //Lookup table for L to y and ify calculations
-        for(i = 0; i < 256; i++)
-        {
-            int y, ify;
-            //8 * 255.0 / 100.0 == 20.4
-            if( i <= 20)
-            {
-                //yy = li / 903.3f;
-                //y = L*100/903.3f; 903.3f = (29/3)^3, 255 = 17*3*5
-                y = cvRound(softfloat(i*LUT_BASE*20*9)/softfloat(17*29*29*29));
-                //fy = 7.787f * yy + 16.0f / 116.0f; 7.787f = (29/3)^3/(29*4)
-                ify = cvRound(softfloat((int)LUT_BASE)*(softfloat(16)/softfloat(116) + softfloat(i*5)/softfloat(3*17*29)));
-            }
-            else
-            {
-                //fy = (li + 16.0f) / 116.0f;
-                softfloat fy = (softfloat(i*100*LUT_BASE)/softfloat(255*116) +
-                                softfloat(16*LUT_BASE)/softfloat(116));
-                ify = cvRound(fy);
-                //yy = fy * fy * fy;
-                y = cvRound(fy*fy*fy/softfloat(LUT_BASE*LUT_BASE));
-            }
+    //Lookup table for a,b to x,z conversion
+    abToXZ_b = initLUTforABXZ();
 
-            LabToYF_b[i*2  ] = (ushort)y;   // 0 <= y <= BASE
-            LabToYF_b[i*2+1] = (ushort)ify; // 2260 <= ify <= BASE
-        }
+    softfloat dd = D65[0] + D65[1]*softdouble(15) + D65[2]*softdouble(3);
+    dd = softfloat::one()/max(dd, softfloat::eps());
+    softfloat un = dd*softfloat(13*4)*D65[0];
+    softfloat vn = dd*softfloat(13*9)*D65[1];
 
-        //Lookup table for a,b to x,z conversion
-        abToXZ_b = initLUTforABXZ();
+    //Luv LUT
+    LUVLUT = initLUTforLUV(un, vn);
 
-        softfloat dd = D65[0] + D65[1]*softdouble(15) + D65[2]*softdouble(3);
-        dd = softfloat::one()/max(dd, softfloat::eps());
-        softfloat un = dd*softfloat(13*4)*D65[0];
-        softfloat vn = dd*softfloat(13*9)*D65[1];
+    //try to suppress warning
+    static const bool calcLUT = enableRGB2LabInterpolation || enableRGB2LuvInterpolation;
+    if(calcLUT)
+    {
 
-        //Luv LUT
-        LUVLUT = initLUTforLUV(un, vn);
+        LABLUVLUTs16 = initLUTforLABLUVs16(un, vn);
 
-        //try to suppress warning
-        static const bool calcLUT = enableRGB2LabInterpolation || enableRGB2LuvInterpolation;
-        if(calcLUT)
+        for(int16_t p = 0; p < TRILINEAR_BASE; p++)
         {
-
-            LABLUVLUTs16 = initLUTforLABLUVs16(un, vn);
-
-            for(int16_t p = 0; p < TRILINEAR_BASE; p++)
+            int16_t pp = TRILINEAR_BASE - p;
+            for(int16_t q = 0; q < TRILINEAR_BASE; q++)
             {
-                int16_t pp = TRILINEAR_BASE - p;
-                for(int16_t q = 0; q < TRILINEAR_BASE; q++)
+                int16_t qq = TRILINEAR_BASE - q;
+                for(int16_t r = 0; r < TRILINEAR_BASE; r++)
                 {
-                    int16_t qq = TRILINEAR_BASE - q;
-                    for(int16_t r = 0; r < TRILINEAR_BASE; r++)
-                    {
-                        int16_t rr = TRILINEAR_BASE - r;
-                        int16_t* w = &trilinearLUT[8*p + 8*TRILINEAR_BASE*q + 8*TRILINEAR_BASE*TRILINEAR_BASE*r];
-                        w[0]  = pp * qq * rr; w[1]  = pp * qq * r ; w[2]  = pp * q  * rr; w[3]  = pp * q  * r ;
-                        w[4]  = p  * qq * rr; w[5]  = p  * qq * r ; w[6]  = p  * q  * rr; w[7]  = p  * q  * r ;
-                    }
+                    int16_t rr = TRILINEAR_BASE - r;
+                    int16_t* w = &trilinearLUT[8*p + 8*TRILINEAR_BASE*q + 8*TRILINEAR_BASE*TRILINEAR_BASE*r];
+                    w[0]  = pp * qq * rr; w[1]  = pp * qq * r ; w[2]  = pp * q  * rr; w[3]  = pp * q  * r ;
+                    w[4]  = p  * qq * rr; w[5]  = p  * qq * r ; w[6]  = p  * q  * rr; w[7]  = p  * q  * r ;
                 }
             }
         }
-
-        initialized = true;
     }
+
+    return true;
+}
+
+static void initLabTabs()
+{
+    // the tables are shared by all the converters; the initialization of the local static
+    // is thread-safe, so they are built exactly once even if the first conversions run concurrently
+    static bool initialized = buildLabTabs();
+    CV_UNUSED(initialized);
 }
 
 
@@ -2023,7 +2080,6 @@ struct RGB2Lab_f
         }
         else
         {
-            static const float _a = (softfloat(16) / softfloat(116));
             int i = 0;
 #if CV_SIMD
             const int vsize = v_float32::nlanes;
@@ -2077,11 +2133,9 @@ struct RGB2Lab_f
                     Y[k] = v_fma(R[k], vc3, v_fma(G[k], vc4, B[k]*vc5));
                     Z[k] = v_fma(R[k], vc6, v_fma(G[k], vc7, B[k]*vc8));
 
-                    // use spline interpolation instead of direct calculation
-                    v_float32 vTabScale = vx_setall_f32(LabCbrtTabScale);
-                    FX[k] = splineInterpolate(X[k]*vTabScale, LabCbrtTab, LAB_CBRT_TAB_SIZE);
-                    FY[k] = splineInterpolate(Y[k]*vTabScale, LabCbrtTab, LAB_CBRT_TAB_SIZE);
-                    FZ[k] = splineInterpolate(Z[k]*vTabScale, LabCbrtTab, LAB_CBRT_TAB_SIZE);
+                    FX[k] = v_labCbrt(X[k]);
+                    FY[k] = v_labCbrt(Y[k]);
+                    FZ[k] = v_labCbrt(Z[k]);
                 }
 
                 v_float32 L[nrepeats], a[nrepeats], b[nrepeats];
@@ -2115,9 +2169,9 @@ struct RGB2Lab_f
                 float Y = R*C3 + G*C4 + B*C5;
                 float Z = R*C6 + G*C7 + B*C8;
                 // 7.787f = (29/3)^3/(29*4), 0.008856f = (6/29)^3, 903.3 = (29/3)^3
-                float FX = X > 0.008856f ? cubeRoot(X) : (7.787f * X + _a);
-                float FY = Y > 0.008856f ? cubeRoot(Y) : (7.787f * Y + _a);
-                float FZ = Z > 0.008856f ? cubeRoot(Z) : (7.787f * Z + _a);
+                float FX = labCbrt(X);
+                float FY = labCbrt(Y);
+                float FZ = labCbrt(Z);
 
                 float L = Y > 0.008856f ? (116.f * FY - 16.f) : (903.3f * Y);
                 float a = 500.f * (FX - FY);
@@ -2955,7 +3009,7 @@ struct RGB2Luvfloat
             v_float32 vmun = vx_setall_f32(-un), vmvn = vx_setall_f32(-vn);
             for (int k = 0; k < nrepeats; k++)
             {
-                L[k] = splineInterpolate(Y[k]*vx_setall_f32(LabCbrtTabScale), LabCbrtTab, LAB_CBRT_TAB_SIZE);
+                L[k] = v_labCbrt(Y[k]);
                 // L = 116.f*L - 16.f;
                 L[k] = v_fma(L[k], vx_setall_f32(116.f), vx_setall_f32(-16.f));
 
@@ -2993,7 +3047,7 @@ struct RGB2Luvfloat
             float Y = R*C3 + G*C4 + B*C5;
             float Z = R*C6 + G*C7 + B*C8;
 
-            float L = splineInterpolate(Y*LabCbrtTabScale, LabCbrtTab, LAB_CBRT_TAB_SIZE);
+            float L = labCbrt(Y);
             L = 116.f*L - 16.f;
 
             float d = (4*13) / std::max(X + 15 * Y + 3 * Z, FLT_EPSILON);
@@ -3013,18 +3067,111 @@ struct RGB2Luv_f
 {
     typedef float channel_type;
 
-    RGB2Luv_f( int _srccn, int blueIdx, const float* _coeffs,
+    RGB2Luv_f( int _srccn, int _blueIdx, const float* _coeffs,
                const float* whitept, bool _srgb )
-    : fcvt(_srccn, blueIdx, _coeffs, whitept, _srgb), srccn(_srccn)
-    { }
+    : fcvt(_srccn, _blueIdx, _coeffs, whitept, _srgb), srccn(_srccn), blueIdx(_blueIdx)
+    {
+        useInterpolation = (!_coeffs && !whitept && _srgb && enableRGB2LuvInterpolation &&
+                            useRGB2Luv32fInterpolation());
+    }
 
     void operator()(const float* src, float* dst, int n) const
     {
-        fcvt(src, dst, n);
+        if(useInterpolation)
+            interpolate(src, dst, n);
+        else
+            fcvt(src, dst, n);
+    }
+
+    void interpolate(const float* src, float* dst, int n) const
+    {
+        CV_INSTRUMENT_REGION();
+
+        int i = 0, scn = srccn, bIdx = blueIdx;
+        n *= 3;
+
+        static const float _uRange = (float)uRange/LAB_BASE, _uLow = (float)uLow;
+        static const float _vRange = (float)vRange/LAB_BASE, _vLow = (float)vLow;
+
+#if CV_SIMD
+        if(enablePackedRGB2Luv)
+        {
+            const int vsize = v_float32::nlanes;
+            static const int nPixels = vsize*2;
+            for(; i < n - 3*nPixels; i += 3*nPixels, src += scn*nPixels)
+            {
+                v_float32 rvec0, gvec0, bvec0, rvec1, gvec1, bvec1;
+                if(scn == 3)
+                {
+                    v_load_deinterleave(src + 0*vsize, rvec0, gvec0, bvec0);
+                    v_load_deinterleave(src + 3*vsize, rvec1, gvec1, bvec1);
+                }
+                else // scn == 4
+                {
+                    v_float32 dummy0, dummy1;
+                    v_load_deinterleave(src + 0*vsize, rvec0, gvec0, bvec0, dummy0);
+                    v_load_deinterleave(src + 4*vsize, rvec1, gvec1, bvec1, dummy1);
+                }
+
+                if(bIdx)
+                {
+                    swap(rvec0, bvec0);
+                    swap(rvec1, bvec1);
+                }
+
+                /* int iR = clip(R)*LAB_BASE, iG = clip(G)*LAB_BASE, iB = clip(B)*LAB_BASE; */
+                v_float32 zerof = vx_setzero_f32(), basef = vx_setall_f32(LAB_BASE);
+                #define clipv(r) v_round(v_min(v_max((r), zerof), vx_setall_f32(1.0f))*basef)
+                v_uint16 uirvec = v_pack_u(clipv(rvec0), clipv(rvec1));
+                v_uint16 uigvec = v_pack_u(clipv(gvec0), clipv(gvec1));
+                v_uint16 uibvec = v_pack_u(clipv(bvec0), clipv(bvec1));
+                #undef clipv
+
+                v_uint16 ui_lvec, ui_uvec, ui_vvec;
+                trilinearPackedInterpolate(uirvec, uigvec, uibvec, LABLUVLUTs16.RGB2LuvLUT_s16, ui_lvec, ui_uvec, ui_vvec);
+
+                v_uint32 i_lvec0, i_uvec0, i_vvec0, i_lvec1, i_uvec1, i_vvec1;
+                v_expand(ui_lvec, i_lvec0, i_lvec1);
+                v_expand(ui_uvec, i_uvec0, i_uvec1);
+                v_expand(ui_vvec, i_vvec0, i_vvec1);
+
+                /* L = iL*100/LAB_BASE, u = iu*uRange/LAB_BASE + uLow, v = iv*vRange/LAB_BASE + vLow */
+                v_float32 v100dBase = vx_setall_f32(100.0f/LAB_BASE);
+                v_float32 vuScale = vx_setall_f32(_uRange), vuShift = vx_setall_f32(_uLow);
+                v_float32 vvScale = vx_setall_f32(_vRange), vvShift = vx_setall_f32(_vLow);
+                v_float32 l_vec0 = v_cvt_f32(v_reinterpret_as_s32(i_lvec0))*v100dBase;
+                v_float32 l_vec1 = v_cvt_f32(v_reinterpret_as_s32(i_lvec1))*v100dBase;
+                v_float32 u_vec0 = v_fma(v_cvt_f32(v_reinterpret_as_s32(i_uvec0)), vuScale, vuShift);
+                v_float32 u_vec1 = v_fma(v_cvt_f32(v_reinterpret_as_s32(i_uvec1)), vuScale, vuShift);
+                v_float32 v_vec0 = v_fma(v_cvt_f32(v_reinterpret_as_s32(i_vvec0)), vvScale, vvShift);
+                v_float32 v_vec1 = v_fma(v_cvt_f32(v_reinterpret_as_s32(i_vvec1)), vvScale, vvShift);
+
+                v_store_interleave(dst + i + 0*vsize, l_vec0, u_vec0, v_vec0);
+                v_store_interleave(dst + i + 3*vsize, l_vec1, u_vec1, v_vec1);
+            }
+        }
+#endif // CV_SIMD
+
+        for(; i < n; i += 3, src += scn)
+        {
+            float R = clip(src[bIdx]);
+            float G = clip(src[1]);
+            float B = clip(src[bIdx^2]);
+
+            int iR = cvRound(R*LAB_BASE), iG = cvRound(G*LAB_BASE), iB = cvRound(B*LAB_BASE);
+            int iL, iu, iv;
+            trilinearInterpolate(iR, iG, iB, LABLUVLUTs16.RGB2LuvLUT_s16, iL, iu, iv);
+
+            dst[i] = iL*(100.0f/LAB_BASE);
+            dst[i + 1] = iu*_uRange + _uLow;
+            dst[i + 2] = iv*_vRange + _vLow;
+        }
     }
 
     RGB2Luvfloat fcvt;
     int srccn;
+    int blueIdx;
+    bool useInterpolation;
 };
 
 struct Luv2RGBfloat
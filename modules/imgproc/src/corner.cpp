@@ -234,6 +234,79 @@ static void calcEigenValsVecs( const Mat& _cov, Mat& _dst )
 enum { MINEIGENVAL=0, HARRIS=1, EIGENVALSVECS=2 };
 
 
+// Runs the HAL implementation of Sobel (ksize > 0) or Scharr (ksize <= 0) as these functions do,
+// returns false if there is none
+static bool derivativeHAL( const Mat& src, Mat& dst, Point order, int ksize, double scale, int borderType )
+{
+    dst.create( src.size(), CV_MAKETYPE(CV_32F, src.channels()) );
+
+    Point ofs;
+    Size wsz(src.cols, src.rows);
+    if( !(borderType & BORDER_ISOLATED) )
+        src.locateROI( wsz, ofs );
+
+    int res = ksize > 0 ?
+        cv_hal_sobel( src.ptr(), src.step, dst.ptr(), dst.step, src.cols, src.rows, src.depth(), CV_32F, src.channels(),
+                      ofs.x, ofs.y, wsz.width - src.cols - ofs.x, wsz.height - src.rows - ofs.y,
+                      order.x, order.y, ksize, scale, 0, borderType & ~BORDER_ISOLATED ) :
+        cv_hal_scharr( src.ptr(), src.step, dst.ptr(), dst.step, src.cols, src.rows, src.depth(), CV_32F, src.channels(),
+                       ofs.x, ofs.y, wsz.width - src.cols - ofs.x, wsz.height - src.rows - ofs.y,
+                       order.x, order.y, scale, 0, borderType & ~BORDER_ISOLATED );
+    return res == CV_HAL_ERROR_OK;
+}
+
+static bool haveSepFilterHAL( const Mat& src, const Mat& kx, const Mat& ky, int borderType )
+{
+    cvhalFilter2D* ctx = NULL;
+    if( cv_hal_sepFilterInit( &ctx, src.type(), CV_MAKETYPE(CV_32F, src.channels()), kx.type(),
+                              kx.data, (int)kx.total(), ky.data, (int)ky.total(),
+                              -1, -1, 0, borderType & ~BORDER_ISOLATED ) != CV_HAL_ERROR_OK )
+        return false;
+    cv_hal_sepFilterFree( ctx );
+    return true;
+}
+
+// Computes the Sobel (ksize > 0) or Scharr (ksize <= 0) derivatives of the specified orders
+// in a single pass over the image; the result is the same as of the separate Sobel()/Scharr() calls.
+// The HAL implementations of the derivatives or of the separable filter are used if there are any.
+static void computeDerivatives( const Mat& src, const Point* orders, Mat* dst, int count,
+                                int ksize, double scale, int borderType )
+{
+    if( count > 0 && derivativeHAL( src, dst[0], orders[0], ksize, scale, borderType ) )
+    {
+        for( int i = 1; i < count; i++ )
+        {
+            if( ksize > 0 )
+                Sobel( src, dst[i], CV_32F, orders[i].x, orders[i].y, ksize, scale, 0, borderType );
+            else
+                Scharr( src, dst[i], CV_32F, orders[i].x, orders[i].y, scale, 0, borderType );
+        }
+        return;
+    }
+
+    std::vector<Mat> kx(count), ky(count), d;
+    for( int i = 0; i < count; i++ )
+    {
+        getDerivKernels( kx[i], ky[i], orders[i].x, orders[i].y, ksize, false, CV_32F );
+        if( scale != 1 )
+        {
+            if( orders[i].x == 0 )
+                kx[i] *= scale;
+            else
+                ky[i] *= scale;
+        }
+    }
+    if( count > 0 && haveSepFilterHAL( src, kx[0], ky[0], borderType ) )
+    {
+        for( int i = 0; i < count; i++ )
+            sepFilter2D( src, dst[i], CV_32F, kx[i], ky[i], Point(-1, -1), 0, borderType );
+        return;
+    }
+    sepFilter2DMulti( src, d, CV_32F, kx, ky, Point(-1, -1), 0, borderType );
+    for( int i = 0; i < count; i++ )
+        dst[i] = d[i];
+}
+
 static void
 cornerEigenValsVecs( const Mat& src, Mat& eigenv, int block_size,
                      int aperture_size, int op_type, double k=0.,
@@ -253,17 +326,11 @@ cornerEigenValsVecs( const Mat& src, Mat& eigenv, int block_size,
 
     CV_Assert( src.type() == CV_8UC1 || src.type() == CV_32FC1 );
 
-    Mat Dx, Dy;
-    if( aperture_size > 0 )
-    {
-        Sobel( src, Dx, CV_32F, 1, 0, aperture_size, scale, 0, borderType );
-        Sobel( src, Dy, CV_32F, 0, 1, aperture_size, scale, 0, borderType );
-    }
-    else
-    {
-        Scharr( src, Dx, CV_32F, 1, 0, scale, 0, borderType );
-        Scharr( src, Dy, CV_32F, 0, 1, scale, 0, borderType );
-    }
+    Mat D[2];
+    const Point orders[] = { Point(1, 0), Point(0, 1) };
+    computeDerivatives( src, orders, D, 2, aperture_size, scale, borderType );
+    const Mat& Dx = D[0];
+    const Mat& Dy = D[1];
 
     Size size = src.size();
     Mat cov( size, CV_32FC3 );
@@ -679,15 +746,13 @@ void cv::preCornerDetect( InputArray _src, OutputArray _dst, int ksize, int bord
     CV_OCL_RUN( _src.dims() <= 2 && _dst.isUMat(),
                 ocl_preCornerDetect(_src, _dst, ksize, borderType, CV_MAT_DEPTH(type)))
 
-    Mat Dx, Dy, D2x, D2y, Dxy, src = _src.getMat();
+    Mat D[5], src = _src.getMat();
     _dst.create( src.size(), CV_32FC1 );
     Mat dst = _dst.getMat();
 
-    Sobel( src, Dx, CV_32F, 1, 0, ksize, 1, 0, borderType );
-    Sobel( src, Dy, CV_32F, 0, 1, ksize, 1, 0, borderType );
-    Sobel( src, D2x, CV_32F, 2, 0, ksize, 1, 0, borderType );
-    Sobel( src, D2y, CV_32F, 0, 2, ksize, 1, 0, borderType );
-    Sobel( src, Dxy, CV_32F, 1, 1, ksize, 1, 0, borderType );
+    const Point orders[] = { Point(1, 0), Point(0, 1), Point(2, 0), Point(0, 2), Point(1, 1) };
+    computeDerivatives( src, orders, D, 5, ksize, 1, borderType );
+    const Mat &Dx = D[0], &Dy = D[1], &D2x = D[2], &D2y = D[3], &Dxy = D[4];
 
     double factor = 1 << (ksize - 1);
     if( src.depth() == CV_8U )
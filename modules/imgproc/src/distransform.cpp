@@ -40,6 +40,7 @@
 //
 //M*/
 #include "precomp.hpp"
+#include "opencv2/core/hal/intrin.hpp"
 
 namespace cv
 {
@@ -50,7 +51,7 @@ static const int DIST_MAX   = (INT_MAX >> 2);
 #define  CV_FLT_TO_FIX(x,n)  cvRound((x)*(1<<(n)))
 
 static void
-initTopBottom( Mat& temp, int border )
+initBorders( Mat& temp, int border )
 {
     Size size = temp.size();
     for( int i = 0; i < border; i++ )
@@ -64,208 +65,265 @@ initTopBottom( Mat& temp, int border )
             tbottom[j] = INIT_DIST0;
         }
     }
-}
 
+    for( int i = border; i < size.height - border; i++ )
+    {
+        int* tmp = temp.ptr<int>(i);
+        for( int j = 0; j < border; j++ )
+            tmp[j] = tmp[size.width - j - 1] = INIT_DIST0;
+    }
+}
 
-static void
-distanceTransform_3x3( const Mat& _src, Mat& _temp, Mat& _dist, const float* metrics )
+/*
+ Chamfer scans are run over skewed tiles in the wavefront order. The pixel of the forward scan
+ depends on the pixels to the left in the same row and on the previous row up to 'reach' pixels
+ to the right. The tile boundaries are shifted left by 'reach' pixels with every row, so a tile
+ depends only on the tile to the left and on the previous tile row; the tiles (r, c) with the same
+ 2*r + c are independent and are processed in parallel. The backward scan is the mirrored one.
+ The result is the same as of the plain raster scan.
+*/
+static const int DT_TILE_HEIGHT = 64;
+static const int DT_TILE_WIDTH = 256;
+
+template<typename RowOp>
+class DTWavefrontInvoker : public ParallelLoopBody
 {
-    const int BORDER = 1;
-    int i, j;
-    const unsigned int HV_DIST = CV_FLT_TO_FIX( metrics[0], DIST_SHIFT );
-    const unsigned int DIAG_DIST = CV_FLT_TO_FIX( metrics[1], DIST_SHIFT );
-    const float scale = 1.f/(1 << DIST_SHIFT);
-
-    const uchar* src = _src.ptr();
-    int* temp = _temp.ptr<int>();
-    float* dist = _dist.ptr<float>();
-    int srcstep = (int)(_src.step/sizeof(src[0]));
-    int step = (int)(_temp.step/sizeof(temp[0]));
-    int dststep = (int)(_dist.step/sizeof(dist[0]));
-    Size size = _src.size();
-
-    initTopBottom( _temp, BORDER );
-
-    // forward pass
-    for( i = 0; i < size.height; i++ )
+public:
+    DTWavefrontInvoker( const RowOp& _op, Size _size, bool _forward, int _reach, int _wave )
+        : op(_op), size(_size), forward(_forward), reach(_reach), wave(_wave)
     {
-        const uchar* s = src + i*srcstep;
-        unsigned int* tmp = (unsigned int*)(temp + (i+BORDER)*step) + BORDER;
-
-        for( j = 0; j < BORDER; j++ )
-            tmp[-j-1] = tmp[size.width + j] = INIT_DIST0;
-
-        for( j = 0; j < size.width; j++ )
-        {
-            if( !s[j] )
-                tmp[j] = 0;
-            else
-            {
-                unsigned int t0 = tmp[j-step-1] + DIAG_DIST;
-                unsigned int t = tmp[j-step] + HV_DIST;
-                if( t0 > t ) t0 = t;
-                t = tmp[j-step+1] + DIAG_DIST;
-                if( t0 > t ) t0 = t;
-                t = tmp[j-1] + HV_DIST;
-                if( t0 > t ) t0 = t;
-                tmp[j] = t0;
-            }
-        }
     }
 
-    // backward pass
-    for( i = size.height - 1; i >= 0; i-- )
+    void operator()(const Range& range) const CV_OVERRIDE
     {
-        float* d = (float*)(dist + i*dststep);
-        unsigned int* tmp = (unsigned int*)(temp + (i+BORDER)*step) + BORDER;
-
-        for( j = size.width - 1; j >= 0; j-- )
+        for( int r = range.start; r < range.end; r++ )
         {
-            unsigned int t0 = tmp[j];
-            if( t0 > HV_DIST )
+            int c = wave - r*2;
+            int y0 = r*DT_TILE_HEIGHT, y1 = std::min(y0 + DT_TILE_HEIGHT, size.height);
+
+            for( int y = y0; y < y1; y++ )
             {
-                unsigned int t = tmp[j+step+1] + DIAG_DIST;
-                if( t0 > t ) t0 = t;
-                t = tmp[j+step] + HV_DIST;
-                if( t0 > t ) t0 = t;
-                t = tmp[j+step-1] + DIAG_DIST;
-                if( t0 > t ) t0 = t;
-                t = tmp[j+1] + HV_DIST;
-                if( t0 > t ) t0 = t;
-                tmp[j] = t0;
+                int shift = reach*(y - y0);
+                int x0 = std::max(c*DT_TILE_WIDTH - shift, 0);
+                int x1 = std::min((c + 1)*DT_TILE_WIDTH - shift, size.width);
+                if( x0 >= x1 )
+                    continue;
+                if( forward )
+                    op(y, x0, x1);
+                else
+                    op(size.height - 1 - y, size.width - x1, size.width - x0);
             }
-            t0 = (t0 > DIST_MAX) ? DIST_MAX : t0;
-            d[j] = (float)(t0 * scale);
         }
     }
-}
 
+private:
+    const RowOp& op;
+    Size size;
+    bool forward;
+    int reach, wave;
+};
 
-static void
-distanceTransform_5x5( const Mat& _src, Mat& _temp, Mat& _dist, const float* metrics )
+template<typename RowOp>
+static void runChamferScan( const RowOp& op, Size size, bool forward, int reach )
 {
-    const int BORDER = 2;
-    int i, j;
-    const unsigned int HV_DIST = CV_FLT_TO_FIX( metrics[0], DIST_SHIFT );
-    const unsigned int DIAG_DIST = CV_FLT_TO_FIX( metrics[1], DIST_SHIFT );
-    const unsigned int LONG_DIST = CV_FLT_TO_FIX( metrics[2], DIST_SHIFT );
-    const float scale = 1.f/(1 << DIST_SHIFT);
+    // the tiles of the next tile row must not depend on more than one tile of the previous one
+    CV_DbgAssert( DT_TILE_WIDTH >= reach*DT_TILE_HEIGHT );
 
-    const uchar* src = _src.ptr();
-    int* temp = _temp.ptr<int>();
-    float* dist = _dist.ptr<float>();
-    int srcstep = (int)(_src.step/sizeof(src[0]));
-    int step = (int)(_temp.step/sizeof(temp[0]));
-    int dststep = (int)(_dist.step/sizeof(dist[0]));
-    Size size = _src.size();
+    if( size.width < DT_TILE_WIDTH*2 || size.height < DT_TILE_HEIGHT*2 )
+    {
+        for( int y = 0; y < size.height; y++ )
+            op(forward ? y : size.height - 1 - y, 0, size.width);
+        return;
+    }
 
-    initTopBottom( _temp, BORDER );
+    int ntx = (size.width + reach*(DT_TILE_HEIGHT - 1) + DT_TILE_WIDTH - 1)/DT_TILE_WIDTH;
+    int nty = (size.height + DT_TILE_HEIGHT - 1)/DT_TILE_HEIGHT;
+    int nwaves = (nty - 1)*2 + ntx;
 
-    // forward pass
-    for( i = 0; i < size.height; i++ )
+    for( int w = 0; w < nwaves; w++ )
     {
-        const uchar* s = src + i*srcstep;
-        unsigned int* tmp = (unsigned int*)(temp + (i+BORDER)*step) + BORDER;
+        int r0 = std::max(w - ntx + 2, 0)/2, r1 = std::min(w/2, nty - 1);
+        parallel_for_(Range(r0, r1 + 1), DTWavefrontInvoker<RowOp>(op, size, forward, reach, w));
+    }
+}
 
-        for( j = 0; j < BORDER; j++ )
-            tmp[-j-1] = tmp[size.width + j] = INIT_DIST0;
+// Forward chamfer scan of the row segment. The minimum over the previous rows doesn't depend on
+// the order of the pixels and is vectorized, the neighbor from the same row is added afterwards
+struct DTChamferForward
+{
+    DTChamferForward( const Mat& _src, Mat& _temp, int _border, const unsigned* _metrics )
+        : src(_src), temp(_temp), border(_border),
+          HV_DIST(_metrics[0]), DIAG_DIST(_metrics[1]), LONG_DIST(_metrics[2])
+    {
+    }
 
-        for( j = 0; j < size.width; j++ )
+    void operator()( int i, int j0, int j1 ) const
+    {
+        const uchar* s = src.ptr(i);
+        unsigned* tmp = temp.ptr<unsigned>(i + border) + border;
+        const unsigned* prev = tmp - temp.step/sizeof(tmp[0]);
+        const unsigned* prev2 = prev - temp.step/sizeof(tmp[0]);
+        int j = j0;
+
+#if CV_SIMD
+        const v_uint32 v_hv = vx_setall_u32(HV_DIST), v_diag = vx_setall_u32(DIAG_DIST);
+        const v_uint32 v_long = vx_setall_u32(LONG_DIST), v_zero = vx_setzero_u32();
+        for( ; j <= j1 - v_uint32::nlanes; j += v_uint32::nlanes )
+        {
+            v_uint32 t0 = v_min(vx_load(prev + j - 1) + v_diag, vx_load(prev + j) + v_hv);
+            t0 = v_min(t0, vx_load(prev + j + 1) + v_diag);
+            if( border == 2 )
+            {
+                t0 = v_min(t0, v_min(vx_load(prev2 + j - 1), vx_load(prev2 + j + 1)) + v_long);
+                t0 = v_min(t0, v_min(vx_load(prev + j - 2), vx_load(prev + j + 2)) + v_long);
+            }
+            v_store(tmp + j, v_select(vx_load_expand_q(s + j) == v_zero, v_zero, t0));
+        }
+#endif
+        for( ; j < j1; j++ )
         {
             if( !s[j] )
                 tmp[j] = 0;
             else
             {
-                unsigned int t0 = tmp[j-step*2-1] + LONG_DIST;
-                unsigned int t = tmp[j-step*2+1] + LONG_DIST;
-                if( t0 > t ) t0 = t;
-                t = tmp[j-step-2] + LONG_DIST;
-                if( t0 > t ) t0 = t;
-                t = tmp[j-step-1] + DIAG_DIST;
-                if( t0 > t ) t0 = t;
-                t = tmp[j-step] + HV_DIST;
-                if( t0 > t ) t0 = t;
-                t = tmp[j-step+1] + DIAG_DIST;
-                if( t0 > t ) t0 = t;
-                t = tmp[j-step+2] + LONG_DIST;
+                unsigned int t0 = prev[j-1] + DIAG_DIST;
+                unsigned int t = prev[j] + HV_DIST;
                 if( t0 > t ) t0 = t;
-                t = tmp[j-1] + HV_DIST;
+                t = prev[j+1] + DIAG_DIST;
                 if( t0 > t ) t0 = t;
+                if( border == 2 )
+                {
+                    t = std::min(prev2[j-1], prev2[j+1]) + LONG_DIST;
+                    if( t0 > t ) t0 = t;
+                    t = std::min(prev[j-2], prev[j+2]) + LONG_DIST;
+                    if( t0 > t ) t0 = t;
+                }
                 tmp[j] = t0;
             }
         }
+
+        unsigned int t0 = tmp[j0-1];
+        for( j = j0; j < j1; j++ )
+        {
+            unsigned int t = t0 + HV_DIST;
+            t0 = tmp[j];
+            if( t0 > t )
+                tmp[j] = t0 = t;
+        }
     }
 
-    // backward pass
-    for( i = size.height - 1; i >= 0; i-- )
+    const Mat& src;
+    Mat& temp;
+    int border;
+    unsigned HV_DIST, DIAG_DIST, LONG_DIST;
+};
+
+// Backward chamfer scan of the row segment, also converts the result to float.
+// Any neighbor is not closer than HV_DIST, so the pixels with t0 <= HV_DIST are never changed
+struct DTChamferBackward
+{
+    DTChamferBackward( Mat& _temp, Mat& _dist, int _border, const unsigned* _metrics )
+        : temp(_temp), dist(_dist), border(_border),
+          HV_DIST(_metrics[0]), DIAG_DIST(_metrics[1]), LONG_DIST(_metrics[2])
     {
-        float* d = (float*)(dist + i*dststep);
-        unsigned int* tmp = (unsigned int*)(temp + (i+BORDER)*step) + BORDER;
+    }
 
-        for( j = size.width - 1; j >= 0; j-- )
+    void operator()( int i, int j0, int j1 ) const
+    {
+        const float scale = 1.f/(1 << DIST_SHIFT);
+        float* d = dist.ptr<float>(i);
+        unsigned* tmp = temp.ptr<unsigned>(i + border) + border;
+        const unsigned* next = tmp + temp.step/sizeof(tmp[0]);
+        const unsigned* next2 = next + temp.step/sizeof(tmp[0]);
+        int j = j0;
+
+#if CV_SIMD
+        const v_uint32 v_hv = vx_setall_u32(HV_DIST), v_diag = vx_setall_u32(DIAG_DIST);
+        const v_uint32 v_long = vx_setall_u32(LONG_DIST);
+        for( ; j <= j1 - v_uint32::nlanes; j += v_uint32::nlanes )
+        {
+            v_uint32 t0 = v_min(vx_load(tmp + j), vx_load(next + j) + v_hv);
+            t0 = v_min(t0, v_min(vx_load(next + j - 1), vx_load(next + j + 1)) + v_diag);
+            if( border == 2 )
+            {
+                t0 = v_min(t0, v_min(vx_load(next2 + j - 1), vx_load(next2 + j + 1)) + v_long);
+                t0 = v_min(t0, v_min(vx_load(next + j - 2), vx_load(next + j + 2)) + v_long);
+            }
+            v_store(tmp + j, t0);
+        }
+#endif
+        for( ; j < j1; j++ )
         {
             unsigned int t0 = tmp[j];
-            if( t0 > HV_DIST )
+            unsigned int t = next[j+1] + DIAG_DIST;
+            if( t0 > t ) t0 = t;
+            t = next[j] + HV_DIST;
+            if( t0 > t ) t0 = t;
+            t = next[j-1] + DIAG_DIST;
+            if( t0 > t ) t0 = t;
+            if( border == 2 )
             {
-                unsigned int t = tmp[j+step*2+1] + LONG_DIST;
+                t = std::min(next2[j-1], next2[j+1]) + LONG_DIST;
                 if( t0 > t ) t0 = t;
-                t = tmp[j+step*2-1] + LONG_DIST;
-                if( t0 > t ) t0 = t;
-                t = tmp[j+step+2] + LONG_DIST;
+                t = std::min(next[j-2], next[j+2]) + LONG_DIST;
                 if( t0 > t ) t0 = t;
-                t = tmp[j+step+1] + DIAG_DIST;
-                if( t0 > t ) t0 = t;
-                t = tmp[j+step] + HV_DIST;
-                if( t0 > t ) t0 = t;
-                t = tmp[j+step-1] + DIAG_DIST;
-                if( t0 > t ) t0 = t;
-                t = tmp[j+step-2] + LONG_DIST;
-                if( t0 > t ) t0 = t;
-                t = tmp[j+1] + HV_DIST;
-                if( t0 > t ) t0 = t;
-                tmp[j] = t0;
             }
-            t0 = (t0 > DIST_MAX) ? DIST_MAX : t0;
-            d[j] = (float)(t0 * scale);
+            tmp[j] = t0;
+        }
+
+        unsigned int t0 = tmp[j1];
+        for( j = j1 - 1; j >= j0; j-- )
+        {
+            unsigned int t = t0 + HV_DIST;
+            t0 = tmp[j];
+            if( t0 > t )
+                tmp[j] = t0 = t;
+            d[j] = (float)(std::min(t0, (unsigned)DIST_MAX) * scale);
         }
     }
-}
 
+    Mat& temp;
+    Mat& dist;
+    int border;
+    unsigned HV_DIST, DIAG_DIST, LONG_DIST;
+};
 
 static void
-distanceTransformEx_5x5( const Mat& _src, Mat& _temp, Mat& _dist, Mat& _labels, const float* metrics )
+distanceTransformChamfer( const Mat& _src, Mat& _temp, Mat& _dist, const float* metrics, int maskSize )
 {
-    const int BORDER = 2;
+    const int border = maskSize == CV_DIST_MASK_3 ? 1 : 2;
+    unsigned fixMetrics[3] =
+    {
+        (unsigned)CV_FLT_TO_FIX( metrics[0], DIST_SHIFT ),
+        (unsigned)CV_FLT_TO_FIX( metrics[1], DIST_SHIFT ),
+        (unsigned)CV_FLT_TO_FIX( metrics[2], DIST_SHIFT )
+    };
 
-    int i, j;
-    const unsigned int HV_DIST = CV_FLT_TO_FIX( metrics[0], DIST_SHIFT );
-    const unsigned int DIAG_DIST = CV_FLT_TO_FIX( metrics[1], DIST_SHIFT );
-    const unsigned int LONG_DIST = CV_FLT_TO_FIX( metrics[2], DIST_SHIFT );
-    const float scale = 1.f/(1 << DIST_SHIFT);
+    initBorders( _temp, border );
 
-    const uchar* src = _src.ptr();
-    int* temp = _temp.ptr<int>();
-    float* dist = _dist.ptr<float>();
-    int* labels = _labels.ptr<int>();
-    int srcstep = (int)(_src.step/sizeof(src[0]));
-    int step = (int)(_temp.step/sizeof(temp[0]));
-    int dststep = (int)(_dist.step/sizeof(dist[0]));
-    int lstep = (int)(_labels.step/sizeof(labels[0]));
-    Size size = _src.size();
+    runChamferScan( DTChamferForward(_src, _temp, border, fixMetrics), _src.size(), true, border );
+    runChamferScan( DTChamferBackward(_temp, _dist, border, fixMetrics), _src.size(), false, border );
+}
 
-    initTopBottom( _temp, BORDER );
 
-    // forward pass
-    for( i = 0; i < size.height; i++ )
+struct DTChamferLabelsForward
+{
+    DTChamferLabelsForward( const Mat& _src, Mat& _temp, Mat& _labels, const unsigned* _metrics )
+        : src(_src), temp(_temp), labels(_labels),
+          HV_DIST(_metrics[0]), DIAG_DIST(_metrics[1]), LONG_DIST(_metrics[2])
     {
-        const uchar* s = src + i*srcstep;
-        unsigned int* tmp = (unsigned int*)(temp + (i+BORDER)*step) + BORDER;
-        int* lls = (int*)(labels + i*lstep);
-
-        for( j = 0; j < BORDER; j++ )
-            tmp[-j-1] = tmp[size.width + j] = INIT_DIST0;
+    }
 
-        for( j = 0; j < size.width; j++ )
+    void operator()( int i, int j0, int j1 ) const
+    {
+        const int BORDER = 2;
+        const uchar* s = src.ptr(i);
+        unsigned* tmp = temp.ptr<unsigned>(i + BORDER) + BORDER;
+        int* lls = labels.ptr<int>(i);
+        int step = (int)(temp.step/sizeof(tmp[0]));
+        int lstep = (int)(labels.step/sizeof(lls[0]));
+
+        for( int j = j0; j < j1; j++ )
         {
             if( !s[j] )
             {
@@ -332,14 +390,31 @@ distanceTransformEx_5x5( const Mat& _src, Mat& _temp, Mat& _dist, Mat& _labels,
         }
     }
 
-    // backward pass
-    for( i = size.height - 1; i >= 0; i-- )
+    const Mat& src;
+    Mat& temp;
+    Mat& labels;
+    unsigned HV_DIST, DIAG_DIST, LONG_DIST;
+};
+
+struct DTChamferLabelsBackward
+{
+    DTChamferLabelsBackward( Mat& _temp, Mat& _dist, Mat& _labels, const unsigned* _metrics )
+        : temp(_temp), dist(_dist), labels(_labels),
+          HV_DIST(_metrics[0]), DIAG_DIST(_metrics[1]), LONG_DIST(_metrics[2])
     {
-        float* d = (float*)(dist + i*dststep);
-        unsigned int* tmp = (unsigned int*)(temp + (i+BORDER)*step) + BORDER;
-        int* lls = (int*)(labels + i*lstep);
+    }
 
-        for( j = size.width - 1; j >= 0; j-- )
+    void operator()( int i, int j0, int j1 ) const
+    {
+        const int BORDER = 2;
+        const float scale = 1.f/(1 << DIST_SHIFT);
+        float* d = dist.ptr<float>(i);
+        unsigned* tmp = temp.ptr<unsigned>(i + BORDER) + BORDER;
+        int* lls = labels.ptr<int>(i);
+        int step = (int)(temp.step/sizeof(tmp[0]));
+        int lstep = (int)(labels.step/sizeof(lls[0]));
+
+        for( int j = j1 - 1; j >= j0; j-- )
         {
             unsigned int t0 = tmp[j];
             int l0 = lls[j];
@@ -400,6 +475,28 @@ distanceTransformEx_5x5( const Mat& _src, Mat& _temp, Mat& _dist, Mat& _labels,
             d[j] = (float)(t0 * scale);
         }
     }
+
+    Mat& temp;
+    Mat& dist;
+    Mat& labels;
+    unsigned HV_DIST, DIAG_DIST, LONG_DIST;
+};
+
+static void
+distanceTransformEx_5x5( const Mat& _src, Mat& _temp, Mat& _dist, Mat& _labels, const float* metrics )
+{
+    const int BORDER = 2;
+    unsigned fixMetrics[3] =
+    {
+        (unsigned)CV_FLT_TO_FIX( metrics[0], DIST_SHIFT ),
+        (unsigned)CV_FLT_TO_FIX( metrics[1], DIST_SHIFT ),
+        (unsigned)CV_FLT_TO_FIX( metrics[2], DIST_SHIFT )
+    };
+
+    initBorders( _temp, BORDER );
+
+    runChamferScan( DTChamferLabelsForward(_src, _temp, _labels, fixMetrics), _src.size(), true, BORDER );
+    runChamferScan( DTChamferLabelsBackward(_temp, _dist, _labels, fixMetrics), _src.size(), false, BORDER );
 }
 
 
@@ -448,12 +545,13 @@ static void getDistanceTransformMask( int maskType, float *metrics )
 
 struct DTColumnInvoker : ParallelLoopBody
 {
-    DTColumnInvoker( const Mat* _src, Mat* _dst, const int* _sat_tab, const float* _sqr_tab)
+    DTColumnInvoker( const Mat* _src, Mat* _dst, const int* _sat_tab, const float* _sqr_tab, Mat* _labels = 0 )
     {
         src = _src;
         dst = _dst;
         sat_tab = _sat_tab + src->rows*2 + 1;
         sqr_tab = _sqr_tab;
+        labels = _labels;
     }
 
     void operator()(const Range& range) const CV_OVERRIDE
@@ -477,11 +575,32 @@ struct DTColumnInvoker : ParallelLoopBody
             }
 
             dist = m-1;
-            for( j = 0; j < m; j++, dptr += dstep )
+            if( !labels )
             {
-                dist = dist + 1 - sat_tab[dist - d[j]];
-                d[j] = dist;
-                dptr[0] = sqr_tab[dist];
+                for( j = 0; j < m; j++, dptr += dstep )
+                {
+                    dist = dist + 1 - sat_tab[dist - d[j]];
+                    d[j] = dist;
+                    dptr[0] = sqr_tab[dist];
+                }
+            }
+            else
+            {
+                // labels contain the seeds at the zero pixels. Each pixel takes the label of
+                // the nearest zero pixel of the column, which is either below the current row
+                // or is a zero pixel above it, whose label is kept, so it's done in-place
+                int* lptr = labels->ptr<int>() + i;
+                size_t lstep = labels->step/sizeof(lptr[0]);
+                int nearest = m;
+                for( j = 0; j < m; j++, dptr += dstep )
+                {
+                    int below = sat_tab[dist - d[j]];
+                    dist = dist + 1 - below;
+                    if( below > 0 )
+                        nearest = j + d[j];
+                    dptr[0] = sqr_tab[dist];
+                    lptr[j*lstep] = nearest < m ? lptr[nearest*lstep] : 0;
+                }
             }
         }
     }
@@ -490,15 +609,17 @@ struct DTColumnInvoker : ParallelLoopBody
     Mat* dst;
     const int* sat_tab;
     const float* sqr_tab;
+    Mat* labels;
 };
 
 struct DTRowInvoker : ParallelLoopBody
 {
-    DTRowInvoker( Mat* _dst, const float* _sqr_tab, const float* _inv_tab )
+    DTRowInvoker( Mat* _dst, const float* _sqr_tab, const float* _inv_tab, Mat* _labels = 0 )
     {
         dst = _dst;
         sqr_tab = _sqr_tab;
         inv_tab = _inv_tab;
+        labels = _labels;
     }
 
     void operator()(const Range& range) const CV_OVERRIDE
@@ -506,16 +627,21 @@ struct DTRowInvoker : ParallelLoopBody
         const float inf = 1e15f;
         int i, i1 = range.start, i2 = range.end;
         int n = dst->cols;
-        AutoBuffer<uchar> _buf((n+2)*2*sizeof(float) + (n+2)*sizeof(int));
+        AutoBuffer<uchar> _buf((n+2)*2*sizeof(float) + (n+2)*sizeof(int)*2);
         float* f = (float*)_buf.data();
         float* z = f + n;
         int* v = alignPtr((int*)(z + n + 1), sizeof(int));
+        int* lbuf = v + n + 1;
 
         for( i = i1; i < i2; i++ )
         {
             float* d = dst->ptr<float>(i);
+            int* lls = labels ? labels->ptr<int>(i) : 0;
             int p, q, k;
 
+            if( lls )
+                memcpy(lbuf, lls, n*sizeof(lls[0]));
+
             v[0] = 0;
             z[0] = -inf;
             z[1] = inf;
@@ -547,6 +673,8 @@ struct DTRowInvoker : ParallelLoopBody
                     k++;
                 p = v[k];
                 d[q] = std::sqrt(sqr_tab[std::abs(q - p)] + f[p]);
+                if( lls )
+                    lls[q] = lbuf[p];
             }
         }
     }
@@ -554,10 +682,11 @@ struct DTRowInvoker : ParallelLoopBody
     Mat* dst;
     const float* sqr_tab;
     const float* inv_tab;
+    Mat* labels;
 };
 
 static void
-trueDistTrans( const Mat& src, Mat& dst )
+trueDistTrans( const Mat& src, Mat& dst, Mat* labels = 0 )
 {
     const float inf = 1e15f;
 
@@ -581,7 +710,7 @@ trueDistTrans( const Mat& src, Mat& dst )
     for( ; i <= m*3; i++ )
         sat_tab[i] = i - shift;
 
-    cv::parallel_for_(cv::Range(0, n), cv::DTColumnInvoker(&src, &dst, sat_tab, sqr_tab), src.total()/(double)(1<<16));
+    cv::parallel_for_(cv::Range(0, n), cv::DTColumnInvoker(&src, &dst, sat_tab, sqr_tab, labels), src.total()/(double)(1<<16));
 
     // stage 2: compute modified distance transform for each row
     float* inv_tab = sqr_tab + n;
@@ -593,7 +722,7 @@ trueDistTrans( const Mat& src, Mat& dst )
         sqr_tab[i] = (float)(i*i);
     }
 
-    cv::parallel_for_(cv::Range(0, m), cv::DTRowInvoker(&dst, sqr_tab, inv_tab));
+    cv::parallel_for_(cv::Range(0, m), cv::DTRowInvoker(&dst, sqr_tab, inv_tab, labels));
 }
 
 
@@ -710,6 +839,31 @@ static void distanceTransform_L1_8U(InputArray _src, OutputArray _dst)
 
     distanceATS_L1_8u(src, dst);
 }
+
+// marks the zero pixels or their connected components with distinct labels
+static void initDistanceLabels( const Mat& src, Mat& labels, int labelType )
+{
+    labels.setTo(Scalar::all(0));
+
+    if( labelType == CV_DIST_LABEL_CCOMP )
+    {
+        Mat zpix = src == 0;
+        connectedComponents(zpix, labels, 8, CV_32S, CCL_WU);
+    }
+    else
+    {
+        int k = 1;
+        for( int i = 0; i < src.rows; i++ )
+        {
+            const uchar* srcptr = src.ptr(i);
+            int* labelptr = labels.ptr<int>(i);
+
+            for( int j = 0; j < src.cols; j++ )
+                if( srcptr[j] == 0 )
+                    labelptr[j] = k++;
+        }
+    }
+}
 }
 
 // Wrapper function for distance transform group
@@ -732,7 +886,8 @@ void cv::distanceTransform( InputArray _src, OutputArray _dst, OutputArray _labe
 
         _labels.create(src.size(), CV_32S);
         labels = _labels.getMat();
-        maskSize = CV_DIST_MASK_5;
+        if( distType != CV_DIST_L2 || maskSize != CV_DIST_MASK_PRECISE )
+            maskSize = CV_DIST_MASK_5;
     }
 
     float _mask[5] = {0};
@@ -742,11 +897,15 @@ void cv::distanceTransform( InputArray _src, OutputArray _dst, OutputArray _labe
 
     if( distType == CV_DIST_C || distType == CV_DIST_L1 )
         maskSize = !need_labels ? CV_DIST_MASK_3 : CV_DIST_MASK_5;
-    else if( distType == CV_DIST_L2 && need_labels )
-        maskSize = CV_DIST_MASK_5;
 
     if( maskSize == CV_DIST_MASK_PRECISE )
     {
+        if( need_labels )
+        {
+            initDistanceLabels( src, labels, labelType );
+            trueDistTrans( src, dst, &labels );
+            return;
+        }
 
 #ifdef HAVE_IPP
         CV_IPP_CHECK()
@@ -808,7 +967,7 @@ void cv::distanceTransform( InputArray _src, OutputArray _dst, OutputArray _labe
             }
 #endif
 
-            distanceTransform_3x3(src, temp, dst, _mask);
+            distanceTransformChamfer(src, temp, dst, _mask, maskSize);
         }
         else
         {
@@ -825,33 +984,13 @@ void cv::distanceTransform( InputArray _src, OutputArray _dst, OutputArray _labe
             }
 #endif
 
-            distanceTransform_5x5(src, temp, dst, _mask);
+            distanceTransformChamfer(src, temp, dst, _mask, maskSize);
         }
     }
     else
     {
-        labels.setTo(Scalar::all(0));
-
-        if( labelType == CV_DIST_LABEL_CCOMP )
-        {
-            Mat zpix = src == 0;
-            connectedComponents(zpix, labels, 8, CV_32S, CCL_WU);
-        }
-        else
-        {
-            int k = 1;
-            for( int i = 0; i < src.rows; i++ )
-            {
-                const uchar* srcptr = src.ptr(i);
-                int* labelptr = labels.ptr<int>(i);
-
-                for( int j = 0; j < src.cols; j++ )
-                    if( srcptr[j] == 0 )
-                        labelptr[j] = k++;
-            }
-        }
-
-       distanceTransformEx_5x5( src, temp, dst, labels, _mask );
+        initDistanceLabels( src, labels, labelType );
+        distanceTransformEx_5x5( src, temp, dst, labels, _mask );
     }
 }
 
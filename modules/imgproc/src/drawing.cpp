@@ -60,7 +60,8 @@ struct PolyEdge
 static void
 CollectPolyEdges( Mat& img, const Point2l* v, int npts,
                   std::vector<PolyEdge>& edges, const void* color, int line_type,
-                  int shift, Point offset=Point() );
+                  int shift, Point offset=Point(),
+                  std::vector<std::pair<Point, Point> >* outline=0 );
 
 static void
 FillEdgeCollection( Mat& img, std::vector<PolyEdge>& edges, const void* color );
@@ -1259,7 +1260,8 @@ FillConvexPoly( Mat& img, const Point2l* v, int npts, const void* color, int lin
 
 static void
 CollectPolyEdges( Mat& img, const Point2l* v, int count, std::vector<PolyEdge>& edges,
-                  const void* color, int line_type, int shift, Point offset )
+                  const void* color, int line_type, int shift, Point offset,
+                  std::vector<std::pair<Point, Point> >* outline )
 {
     int i, delta = offset.y + ((1 << shift) >> 1);
     Point2l pt0 = v[count-1], pt1;
@@ -1282,7 +1284,11 @@ CollectPolyEdges( Mat& img, const Point2l* v, int count, std::vector<PolyEdge>&
             t0.y = pt0.y; t1.y = pt1.y;
             t0.x = (pt0.x + (XY_ONE >> 1)) >> XY_SHIFT;
             t1.x = (pt1.x + (XY_ONE >> 1)) >> XY_SHIFT;
-            Line( img, t0, t1, color, line_type );
+            // the outline segments are drawn later by the caller if it collects them
+            if( outline )
+                outline->push_back(std::make_pair(Point(t0), Point(t1)));
+            else
+                Line( img, t0, t1, color, line_type );
         }
         else
         {
@@ -1472,6 +1478,143 @@ FillEdgeCollection( Mat& img, std::vector<PolyEdge>& edges, const void* color )
 }
 
 
+/******** Batch of polygons **********/
+
+// The polygon of fillPolyBatch with the outline and the edges prepared once
+struct BatchPolygon
+{
+    BatchPolygon() : ymin(INT_MAX), ymax(INT_MIN) {}
+
+    std::vector<PolyEdge> edges; // sorted by y0
+    std::vector<std::pair<Point, Point> > outline;
+    int ymin, ymax;
+    double color[4];
+};
+
+// Draws the polygons of the batch in order within the image rows [range.start, range.end).
+// Every pixel is produced the same way as by Line() and FillEdgeCollection(), only the rows
+// outside of the range are skipped, so the row stripes are independent
+class FillPolyBatchInvoker : public ParallelLoopBody
+{
+public:
+    FillPolyBatchInvoker( Mat& _img, const std::vector<BatchPolygon>& _polys, int _connectivity )
+        : img(_img), polys(_polys), connectivity(_connectivity)
+    {
+    }
+
+    virtual void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        std::vector<const PolyEdge*> active;
+        std::vector<int64> xs;
+
+        for( size_t i = 0; i < polys.size(); i++ )
+        {
+            const BatchPolygon& poly = polys[i];
+            if( poly.ymax < range.start || poly.ymin >= range.end )
+                continue;
+            drawOutline( poly, range );
+            fillEdges( poly, range, active, xs );
+        }
+    }
+
+private:
+    void drawOutline( const BatchPolygon& poly, const Range& range ) const
+    {
+        const uchar* color = (const uchar*)poly.color;
+        int pix_size = (int)img.elemSize();
+
+        for( size_t i = 0; i < poly.outline.size(); i++ )
+        {
+            Point pt0 = poly.outline[i].first, pt1 = poly.outline[i].second;
+            if( std::max(pt0.y, pt1.y) < range.start || std::min(pt0.y, pt1.y) >= range.end )
+                continue;
+
+            LineIterator iterator(Rect(0, 0, img.cols, img.rows), pt0, pt1, connectivity, true);
+            bool inside = false;
+            for( int k = 0; k < iterator.count; k++, ++iterator )
+            {
+                Point p = iterator.pos();
+                if( p.y < range.start || p.y >= range.end )
+                {
+                    // the line is monotonic in y
+                    if( inside )
+                        break;
+                    continue;
+                }
+                inside = true;
+                uchar* ptr = img.ptr(p.y, p.x);
+                if( pix_size == 1 )
+                    ptr[0] = color[0];
+                else if( pix_size == 3 )
+                {
+                    ptr[0] = color[0];
+                    ptr[1] = color[1];
+                    ptr[2] = color[2];
+                }
+                else
+                    memcpy( ptr, color, pix_size );
+            }
+        }
+    }
+
+    void fillEdges( const BatchPolygon& poly, const Range& range,
+                    std::vector<const PolyEdge*>& active, std::vector<int64>& xs ) const
+    {
+        const std::vector<PolyEdge>& edges = poly.edges;
+        int pix_size = (int)img.elemSize();
+        int y = std::max(range.start, 0), y_end = std::min(range.end, img.rows);
+        size_t next = 0;
+
+        active.clear();
+        for( ; y < y_end; y++ )
+        {
+            size_t k = 0;
+            for( size_t j = 0; j < active.size(); j++ )
+                if( active[j]->y1 > y )
+                    active[k++] = active[j];
+            active.resize(k);
+
+            for( ; next < edges.size() && edges[next].y0 <= y; next++ )
+                if( edges[next].y1 > y )
+                    active.push_back(&edges[next]);
+
+            if( active.empty() )
+            {
+                if( next == edges.size() )
+                    break;
+                continue;
+            }
+
+            // the span ends are the same as of the active edge list of FillEdgeCollection
+            xs.resize(active.size());
+            for( size_t j = 0; j < active.size(); j++ )
+                xs[j] = active[j]->x + (y - active[j]->y0)*active[j]->dx;
+            std::sort(xs.begin(), xs.end());
+
+            uchar* timg = img.ptr(y);
+            for( size_t j = 0; j + 1 < xs.size(); j += 2 )
+            {
+                int x1 = (int)((xs[j] + XY_ONE - 1) >> XY_SHIFT);
+                int x2 = (int)(xs[j + 1] >> XY_SHIFT);
+
+                if( x1 < img.cols && x2 >= 0 )
+                {
+                    if( x1 < 0 )
+                        x1 = 0;
+                    if( x2 >= img.cols )
+                        x2 = img.cols - 1;
+                    ICV_HLINE( timg, x1, x2, poly.color, pix_size );
+                }
+            }
+        }
+    }
+
+    Mat& img;
+    const std::vector<BatchPolygon>& polys;
+    int connectivity;
+};
+
+
 /* draws simple or filled circle */
 static void
 Circle( Mat& img, Point center, int radius, const void* color, int fill )
@@ -2438,6 +2581,70 @@ void cv::polylines(InputOutputArray img, InputArrayOfArrays pts,
     polylines(img, (const Point**)ptsptr, npts, (int)ncontours, isClosed, color, thickness, lineType, shift);
 }
 
+void cv::fillPolyBatch(InputOutputArray _img, InputArrayOfArrays pts,
+                       const std::vector<Scalar>& colors, int lineType, int shift, Point offset)
+{
+    CV_INSTRUMENT_REGION();
+
+    bool manyContours = pts.kind() == _InputArray::STD_VECTOR_VECTOR ||
+                        pts.kind() == _InputArray::STD_VECTOR_MAT;
+    int i, npolys = manyContours ? (int)pts.total() : 1;
+    if( npolys == 0 )
+        return;
+
+    Mat img = _img.getMat();
+
+    CV_Assert( colors.size() == 1 || colors.size() == (size_t)npolys );
+    CV_Assert( 0 <= shift && shift <= XY_SHIFT );
+
+    if( lineType == CV_AA && img.depth() != CV_8U )
+        lineType = 8;
+
+    std::vector<BatchPolygon> polys(lineType == CV_AA ? 0 : npolys);
+    std::vector<PolyEdge> edges;
+    std::vector<Point2l> v;
+
+    for( i = 0; i < npolys; i++ )
+    {
+        Mat p = pts.getMat(manyContours ? i : -1);
+        if( p.total() == 0 )
+            continue;
+        CV_Assert(p.checkVector(2, CV_32S) >= 0);
+        const Point* ptsi = p.ptr<Point>();
+        int n = p.rows*p.cols*p.channels()/2;
+        v.assign(ptsi, ptsi + n);
+
+        double buf[4];
+        scalarToRawData(colors[colors.size() == 1 ? 0 : i], buf, img.type(), 0);
+
+        if( lineType == CV_AA )
+        {
+            // the antialiased outlines blend with the pixels drawn before, so keep the order
+            edges.clear();
+            CollectPolyEdges(img, v.data(), n, edges, buf, lineType, shift, offset);
+            FillEdgeCollection(img, edges, buf);
+            continue;
+        }
+
+        BatchPolygon& poly = polys[i];
+        memcpy(poly.color, buf, sizeof(buf));
+        CollectPolyEdges(img, v.data(), n, poly.edges, buf, lineType, shift, offset, &poly.outline);
+        std::sort(poly.edges.begin(), poly.edges.end(), CmpEdges());
+        for( size_t j = 0; j < poly.outline.size(); j++ )
+        {
+            poly.ymin = std::min(poly.ymin, std::min(poly.outline[j].first.y, poly.outline[j].second.y));
+            poly.ymax = std::max(poly.ymax, std::max(poly.outline[j].first.y, poly.outline[j].second.y));
+        }
+    }
+
+    if( lineType != CV_AA )
+    {
+        int connectivity = lineType == 0 ? 8 : lineType == 1 ? 4 : lineType;
+        parallel_for_(Range(0, img.rows), FillPolyBatchInvoker(img, polys, connectivity),
+                      std::max(img.rows/64, 1));
+    }
+}
+
 namespace
 {
 using namespace cv;
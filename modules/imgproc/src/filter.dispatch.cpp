@@ -46,12 +46,14 @@
 #undef CV_LOG_STRIP_LEVEL
 #define CV_LOG_STRIP_LEVEL CV_LOG_LEVEL_DEBUG + 1
 #include <opencv2/core/utils/logger.hpp>
+#include <opencv2/core/utils/configuration.private.hpp>
 
 #include "opencv2/core/opencl/ocl_defs.hpp"
 #include "opencl_kernels_imgproc.hpp"
 #include "hal_replacement.hpp"
 #include "opencv2/core/hal/intrin.hpp"
 #include "filter.hpp"
+#include <list>
 
 #include "filter.simd.hpp"
 #include "filter.simd_declarations.hpp" // defines CV_CPU_DISPATCH_MODES_ALL=AVX2,...,BASELINE based on CMakeLists.txt content
@@ -1385,6 +1387,94 @@ static bool replacementSepFilter(int stype, int dtype, int ktype,
     return success;
 }
 
+// Parameters of a separable linear filter, which identify the FilterEngine built for it
+struct SepFilterPlanKey
+{
+    SepFilterPlanKey(int _stype, int _dtype, int _ktype,
+                     const uchar* kernelx_data, int kernelx_len,
+                     const uchar* kernely_data, int kernely_len,
+                     Point _anchor, double _delta, int _borderType)
+        : stype(_stype), dtype(_dtype), ktype(_ktype), anchor(_anchor), delta(_delta), borderType(_borderType),
+          kernelX(kernelx_data, kernelx_data + kernelx_len*CV_ELEM_SIZE(_ktype)),
+          kernelY(kernely_data, kernely_data + kernely_len*CV_ELEM_SIZE(_ktype))
+    {
+    }
+
+    bool operator==(const SepFilterPlanKey& k) const
+    {
+        return stype == k.stype && dtype == k.dtype && ktype == k.ktype && anchor == k.anchor &&
+               memcmp(&delta, &k.delta, sizeof(delta)) == 0 && borderType == k.borderType &&
+               kernelX == k.kernelX && kernelY == k.kernelY;
+    }
+
+    Ptr<FilterEngine> create() const
+    {
+        // the filters may keep the kernel headers, so they must own the data
+        Mat kx = Mat(Size((int)(kernelX.size()/CV_ELEM_SIZE(ktype)), 1), ktype, (void*)&kernelX[0]).clone();
+        Mat ky = Mat(Size((int)(kernelY.size()/CV_ELEM_SIZE(ktype)), 1), ktype, (void*)&kernelY[0]).clone();
+        return createSeparableLinearFilter(stype, dtype, kx, ky, anchor, delta, borderType);
+    }
+
+    int stype, dtype, ktype;
+    Point anchor;
+    double delta;
+    int borderType;
+    std::vector<uchar> kernelX, kernelY;
+};
+
+// Keeps the recently used separable filter engines, so that the repeated calls with the same kernels
+// (e.g. Sobel or GaussianBlur in a video loop) don't rebuild the row/column filters and the buffers.
+// An engine is owned by a single caller between acquire() and release(), so it is never shared
+// between threads. The size is controlled by OPENCV_IMGPROC_SEPFILTER_PLAN_CACHE_SIZE (0 disables it).
+class SepFilterPlanCache
+{
+public:
+    static SepFilterPlanCache& getInstance()
+    {
+        static SepFilterPlanCache* instance = new SepFilterPlanCache();
+        return *instance;
+    }
+
+    Ptr<FilterEngine> acquire(const SepFilterPlanKey& key)
+    {
+        if (maxSize > 0)
+        {
+            AutoLock lock(mutex);
+            for (std::list<Entry>::iterator it = entries.begin(); it != entries.end(); ++it)
+            {
+                if (it->first == key)
+                {
+                    Ptr<FilterEngine> f = it->second;
+                    entries.erase(it);
+                    return f;
+                }
+            }
+        }
+        return key.create();
+    }
+
+    void release(const SepFilterPlanKey& key, const Ptr<FilterEngine>& f)
+    {
+        if (maxSize == 0)
+            return;
+        AutoLock lock(mutex);
+        entries.push_front(Entry(key, f));
+        if (entries.size() > maxSize)
+            entries.pop_back();
+    }
+
+private:
+    SepFilterPlanCache()
+    {
+        maxSize = utils::getConfigurationParameterSizeT("OPENCV_IMGPROC_SEPFILTER_PLAN_CACHE_SIZE", 16);
+    }
+
+    typedef std::pair<SepFilterPlanKey, Ptr<FilterEngine> > Entry;
+    Mutex mutex;
+    std::list<Entry> entries;
+    size_t maxSize;
+};
+
 static void ocvSepFilter(int stype, int dtype, int ktype,
                          uchar* src_data, size_t src_step, uchar* dst_data, size_t dst_step,
                          int width, int height, int full_width, int full_height,
@@ -1393,16 +1483,57 @@ static void ocvSepFilter(int stype, int dtype, int ktype,
                          uchar * kernely_data, int kernely_len,
                          int anchor_x, int anchor_y, double delta, int borderType)
 {
-    Mat kernelX(Size(kernelx_len, 1), ktype, kernelx_data);
-    Mat kernelY(Size(kernely_len, 1), ktype, kernely_data);
-    Ptr<FilterEngine> f = createSeparableLinearFilter(stype, dtype, kernelX, kernelY,
-                                                      Point(anchor_x, anchor_y),
-                                                      delta, borderType & ~BORDER_ISOLATED);
+    SepFilterPlanKey key(stype, dtype, ktype, kernelx_data, kernelx_len, kernely_data, kernely_len,
+                         Point(anchor_x, anchor_y), delta, borderType & ~BORDER_ISOLATED);
+    SepFilterPlanCache& cache = SepFilterPlanCache::getInstance();
+    Ptr<FilterEngine> f = cache.acquire(key);
     Mat src(Size(width, height), stype, src_data, src_step);
     Mat dst(Size(width, height), dtype, dst_data, dst_step);
     f->apply(src, dst, Size(full_width, full_height), Point(offset_x, offset_y));
+    cache.release(key, f);
 }
 
+// Applies several separable filters to the same source band by band
+class SepFilterMultiInvoker : public ParallelLoopBody
+{
+public:
+    SepFilterMultiInvoker(const Mat& _src, std::vector<Mat>& _dst, const std::vector<SepFilterPlanKey>& _keys,
+                          Size _wsz, Point _ofs, int _bandHeight)
+        : src(_src), dst(_dst), keys(_keys), wsz(_wsz), ofs(_ofs), bandHeight(_bandHeight)
+    {
+    }
+
+    virtual void operator()(const Range& range) const CV_OVERRIDE
+    {
+        SepFilterPlanCache& cache = SepFilterPlanCache::getInstance();
+        std::vector<Ptr<FilterEngine> > f(keys.size());
+        for (size_t k = 0; k < keys.size(); k++)
+            f[k] = cache.acquire(keys[k]);
+
+        for (int band = range.start; band < range.end; band++)
+        {
+            int y0 = band*bandHeight, y1 = std::min(y0 + bandHeight, src.rows);
+            Mat srcBand = src.rowRange(y0, y1);
+            for (size_t k = 0; k < keys.size(); k++)
+            {
+                Mat dstBand = dst[k].rowRange(y0, y1);
+                f[k]->apply(srcBand, dstBand, wsz, Point(ofs.x, ofs.y + y0));
+            }
+        }
+
+        for (size_t k = 0; k < keys.size(); k++)
+            cache.release(keys[k], f[k]);
+    }
+
+private:
+    const Mat& src;
+    std::vector<Mat>& dst;
+    const std::vector<SepFilterPlanKey>& keys;
+    Size wsz;
+    Point ofs;
+    int bandHeight;
+};
+
 //===================================================================
 //       HAL functions
 //===================================================================
@@ -1596,6 +1727,74 @@ void sepFilter2D(InputArray _src, OutputArray _dst, int ddepth,
                      anchor.x, anchor.y, delta, borderType & ~BORDER_ISOLATED);
 }
 
+void sepFilter2DMulti(InputArray _src, OutputArrayOfArrays _dst, int ddepth,
+                      InputArrayOfArrays _kernelsX, InputArrayOfArrays _kernelsY, Point anchor,
+                      double delta, int borderType)
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_Assert(!_src.empty());
+    CV_Assert(_kernelsX.isMatVector() && _kernelsY.isMatVector());
+
+    std::vector<Mat> kernelsX, kernelsY;
+    _kernelsX.getMatVector(kernelsX);
+    _kernelsY.getMatVector(kernelsY);
+    CV_CheckEQ(kernelsX.size(), kernelsY.size(), "Number of the row and the column kernels must be the same");
+
+    Mat src = _src.getMat();
+    if( ddepth < 0 )
+        ddepth = src.depth();
+    int dtype = CV_MAKETYPE(ddepth, src.channels());
+    int nfilters = (int)kernelsX.size();
+
+    Point ofs;
+    Size wsz(src.cols, src.rows);
+    if( (borderType & BORDER_ISOLATED) == 0 )
+        src.locateROI( wsz, ofs );
+
+    std::vector<SepFilterPlanKey> keys;
+    for( int k = 0; k < nfilters; k++ )
+    {
+        Mat kx = kernelsX[k], ky = kernelsY[k];
+        CV_Assert( !kx.empty() && !ky.empty() && kx.type() == ky.type() && kx.type() == kernelsX[0].type() &&
+                   (kx.cols == 1 || kx.rows == 1) && (ky.cols == 1 || ky.rows == 1) );
+        if( !kx.isContinuous() )
+            kx = kx.clone();
+        if( !ky.isContinuous() )
+            ky = ky.clone();
+        keys.push_back(SepFilterPlanKey(src.type(), dtype, kx.type(),
+                                        kx.ptr(), (int)kx.total(), ky.ptr(), (int)ky.total(),
+                                        anchor, delta, borderType & ~BORDER_ISOLATED));
+    }
+
+    _dst.create(nfilters, 1, dtype);
+    std::vector<Mat> dst(nfilters);
+    for( int k = 0; k < nfilters; k++ )
+    {
+        _dst.create(src.size(), dtype, k);
+        dst[k] = _dst.getMat(k);
+    }
+    if( nfilters == 0 )
+        return;
+
+    // The bands are filtered independently, so the source must not be overwritten by any of the outputs
+    for( int k = 0; k < nfilters; k++ )
+    {
+        if( dst[k].datastart < src.dataend && src.datastart < dst[k].dataend )
+        {
+            Mat whole = src;
+            whole.adjustROI(ofs.y, wsz.height - src.rows - ofs.y, ofs.x, wsz.width - src.cols - ofs.x);
+            src = whole.clone()(Rect(ofs, src.size()));
+            break;
+        }
+    }
+
+    // The bands are small enough to stay in L2 cache while all the filters are applied
+    int bandHeight = std::max(32, (int)((1 << 17)/std::max(src.cols*src.elemSize(), (size_t)1)));
+    int nbands = (src.rows + bandHeight - 1)/bandHeight;
+    parallel_for_(Range(0, nbands), SepFilterMultiInvoker(src, dst, keys, wsz, ofs, bandHeight));
+}
+
 } // namespace
 
 CV_IMPL void
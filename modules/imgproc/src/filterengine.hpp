@@ -358,6 +358,11 @@ CV_EXPORTS Ptr<FilterEngine> createMorphologyFilter(int op, int type, InputArray
                                                     int columnBorderType = -1,
                                                     const Scalar& borderValue = morphologyDefaultBorderValue());
 
+//! erosion, dilation, opening, closing, gradient, top hat and black hat with the kernels which are unions
+//! of rectangles (rectangles, crosses, ellipses). Returns false if the kernel is small or not supported
+bool morphLargeKernel(int op, const Mat& src, Mat& dst, const Mat& kernel, Point anchor, int iterations,
+                      int borderType, const Scalar& borderValue);
+
 static inline Point normalizeAnchor( Point anchor, Size ksize )
 {
    if( anchor.x == -1 )
@@ -41,6 +41,7 @@
 //M*/
 
 #include "precomp.hpp"
+#include "opencv2/core/hal/intrin.hpp"
 
 #if defined(__GNUC__) && (__GNUC__ == 4) && (__GNUC_MINOR__ == 8)
 # pragma GCC diagnostic ignored "-Warray-bounds"
@@ -125,6 +126,59 @@ ConnectedComp::ConnectedComp()
 
 // Simple Floodfill (repainting single-color connected component)
 
+// Repaints the run of val0-colored pixels that starts at x and goes to the right;
+// returns the position of the first pixel that is not repainted.
+template<typename _Tp>
+static inline int ffRepaintRight( _Tp* img, int x, int width, const _Tp& val0, const _Tp& newVal )
+{
+    for( ; x < width && img[x] == val0; x++ )
+        img[x] = newVal;
+    return x;
+}
+
+// The same as ffRepaintRight(), but goes to the left
+template<typename _Tp>
+static inline int ffRepaintLeft( _Tp* img, int x, const _Tp& val0, const _Tp& newVal )
+{
+    for( ; x >= 0 && img[x] == val0; x-- )
+        img[x] = newVal;
+    return x;
+}
+
+static inline int ffRepaintRight( uchar* img, int x, int width, const uchar& val0, const uchar& newVal )
+{
+#if CV_SIMD
+    const int VECSZ = v_uint8::nlanes;
+    v_uint8 v_val0 = vx_setall_u8(val0), v_newVal = vx_setall_u8(newVal);
+    for( ; x <= width - VECSZ; x += VECSZ )
+    {
+        if( !v_check_all(vx_load(img + x) == v_val0) )
+            break;
+        v_store(img + x, v_newVal);
+    }
+#endif
+    for( ; x < width && img[x] == val0; x++ )
+        img[x] = newVal;
+    return x;
+}
+
+static inline int ffRepaintLeft( uchar* img, int x, const uchar& val0, const uchar& newVal )
+{
+#if CV_SIMD
+    const int VECSZ = v_uint8::nlanes;
+    v_uint8 v_val0 = vx_setall_u8(val0), v_newVal = vx_setall_u8(newVal);
+    for( ; x >= VECSZ - 1; x -= VECSZ )
+    {
+        if( !v_check_all(vx_load(img + x - (VECSZ - 1)) == v_val0) )
+            break;
+        v_store(img + x - (VECSZ - 1), v_newVal);
+    }
+#endif
+    for( ; x >= 0 && img[x] == val0; x-- )
+        img[x] = newVal;
+    return x;
+}
+
 template<typename _Tp>
 static void
 floodFill_CnIR( Mat& image, Point seed,
@@ -144,11 +198,8 @@ floodFill_CnIR( Mat& image, Point seed,
     _Tp val0 = img[L];
     img[L] = newVal;
 
-    while( ++R < roi.width && img[R] == val0 )
-        img[R] = newVal;
-
-    while( --L >= 0 && img[L] == val0 )
-        img[L] = newVal;
+    R = ffRepaintRight( img, R + 1, roi.width, val0, newVal );
+    L = ffRepaintLeft( img, L - 1, val0, newVal );
 
     XMax = --R;
     XMin = ++L;
@@ -192,13 +243,9 @@ floodFill_CnIR( Mat& image, Point seed,
             {
                 if( (unsigned)i < (unsigned)roi.width && img[i] == val0 )
                 {
-                    int j = i;
                     img[i] = newVal;
-                    while( --j >= 0 && img[j] == val0 )
-                        img[j] = newVal;
-
-                    while( ++i < roi.width && img[i] == val0 )
-                        img[i] = newVal;
+                    int j = ffRepaintLeft( img, i - 1, val0, newVal );
+                    i = ffRepaintRight( img, i + 1, roi.width, val0, newVal );
 
                     ICV_PUSH( YC + dir, j+1, i-1, L, R, -dir );
                 }
@@ -276,6 +323,140 @@ typedef DiffC3<Vec3i> Diff32sC3;
 typedef DiffC1<float> Diff32fC1;
 typedef DiffC3<Vec3f> Diff32fC3;
 
+// Fixed range mode: marks the run of unmasked pixels that are within the range around val0,
+// starting at x and going to the right; returns the position of the first pixel that stops the run.
+// The mask has a non-zero border, so the run always stops at the image boundary.
+template<typename _Tp, typename _MTp, class Diff>
+static inline int ffMarkRight( const _Tp* img, _MTp* mask, int x, int width,
+                               const Diff& diff, const _Tp& val0, _MTp newMaskVal )
+{
+    CV_UNUSED(width);
+    for( ; !mask[x] && diff( img + x, &val0 ); x++ )
+        mask[x] = newMaskVal;
+    return x;
+}
+
+// The same as ffMarkRight(), but goes to the left
+template<typename _Tp, typename _MTp, class Diff>
+static inline int ffMarkLeft( const _Tp* img, _MTp* mask, int x,
+                              const Diff& diff, const _Tp& val0, _MTp newMaskVal )
+{
+    for( ; !mask[x] && diff( img + x, &val0 ); x-- )
+        mask[x] = newMaskVal;
+    return x;
+}
+
+#if CV_SIMD
+// Lanes of the 16-byte blocks which are not masked yet and fall into [lower, upper] for all channels
+static inline v_uint8 ffInRange( const uchar* img, const uchar* mask, const v_uint8& lower, const v_uint8& upper )
+{
+    v_uint8 v = vx_load(img);
+    return (v >= lower) & (v <= upper) & (vx_load(mask) == vx_setzero_u8());
+}
+
+static inline v_uint8 ffInRange( const Vec3b* img, const uchar* mask, const v_uint8 (&lower)[3], const v_uint8 (&upper)[3] )
+{
+    v_uint8 b, g, r;
+    v_load_deinterleave((const uchar*)img, b, g, r);
+    return (b >= lower[0]) & (b <= upper[0]) & (g >= lower[1]) & (g <= upper[1]) &
+           (r >= lower[2]) & (r <= upper[2]) & (vx_load(mask) == vx_setzero_u8());
+}
+#endif
+
+static inline int ffMarkRight( const uchar* img, uchar* mask, int x, int width,
+                               const Diff8uC1& diff, const uchar& val0, uchar newMaskVal )
+{
+#if CV_SIMD
+    const int VECSZ = v_uint8::nlanes;
+    v_uint8 lower = vx_setall_u8(saturate_cast<uchar>((int)val0 - (int)diff.lo));
+    v_uint8 upper = vx_setall_u8(saturate_cast<uchar>((int)val0 - (int)diff.lo + (int)diff.interval));
+    v_uint8 v_newMaskVal = vx_setall_u8(newMaskVal);
+    for( ; x <= width - VECSZ; x += VECSZ )
+    {
+        if( !v_check_all(ffInRange(img + x, mask + x, lower, upper)) )
+            break;
+        v_store(mask + x, v_newMaskVal);
+    }
+#else
+    CV_UNUSED(width);
+#endif
+    for( ; !mask[x] && diff( img + x, &val0 ); x++ )
+        mask[x] = newMaskVal;
+    return x;
+}
+
+static inline int ffMarkLeft( const uchar* img, uchar* mask, int x,
+                              const Diff8uC1& diff, const uchar& val0, uchar newMaskVal )
+{
+#if CV_SIMD
+    const int VECSZ = v_uint8::nlanes;
+    v_uint8 lower = vx_setall_u8(saturate_cast<uchar>((int)val0 - (int)diff.lo));
+    v_uint8 upper = vx_setall_u8(saturate_cast<uchar>((int)val0 - (int)diff.lo + (int)diff.interval));
+    v_uint8 v_newMaskVal = vx_setall_u8(newMaskVal);
+    for( ; x >= VECSZ - 1; x -= VECSZ )
+    {
+        int x0 = x - (VECSZ - 1);
+        if( !v_check_all(ffInRange(img + x0, mask + x0, lower, upper)) )
+            break;
+        v_store(mask + x0, v_newMaskVal);
+    }
+#endif
+    for( ; !mask[x] && diff( img + x, &val0 ); x-- )
+        mask[x] = newMaskVal;
+    return x;
+}
+
+static inline int ffMarkRight( const Vec3b* img, uchar* mask, int x, int width,
+                               const Diff8uC3& diff, const Vec3b& val0, uchar newMaskVal )
+{
+#if CV_SIMD
+    const int VECSZ = v_uint8::nlanes;
+    v_uint8 lower[3], upper[3];
+    for( int k = 0; k < 3; k++ )
+    {
+        lower[k] = vx_setall_u8(saturate_cast<uchar>((int)val0[k] - (int)diff.lo[k]));
+        upper[k] = vx_setall_u8(saturate_cast<uchar>((int)val0[k] - (int)diff.lo[k] + (int)diff.interval[k]));
+    }
+    v_uint8 v_newMaskVal = vx_setall_u8(newMaskVal);
+    for( ; x <= width - VECSZ; x += VECSZ )
+    {
+        if( !v_check_all(ffInRange(img + x, mask + x, lower, upper)) )
+            break;
+        v_store(mask + x, v_newMaskVal);
+    }
+#else
+    CV_UNUSED(width);
+#endif
+    for( ; !mask[x] && diff( img + x, &val0 ); x++ )
+        mask[x] = newMaskVal;
+    return x;
+}
+
+static inline int ffMarkLeft( const Vec3b* img, uchar* mask, int x,
+                              const Diff8uC3& diff, const Vec3b& val0, uchar newMaskVal )
+{
+#if CV_SIMD
+    const int VECSZ = v_uint8::nlanes;
+    v_uint8 lower[3], upper[3];
+    for( int k = 0; k < 3; k++ )
+    {
+        lower[k] = vx_setall_u8(saturate_cast<uchar>((int)val0[k] - (int)diff.lo[k]));
+        upper[k] = vx_setall_u8(saturate_cast<uchar>((int)val0[k] - (int)diff.lo[k] + (int)diff.interval[k]));
+    }
+    v_uint8 v_newMaskVal = vx_setall_u8(newMaskVal);
+    for( ; x >= VECSZ - 1; x -= VECSZ )
+    {
+        int x0 = x - (VECSZ - 1);
+        if( !v_check_all(ffInRange(img + x0, mask + x0, lower, upper)) )
+            break;
+        v_store(mask + x0, v_newMaskVal);
+    }
+#endif
+    for( ; !mask[x] && diff( img + x, &val0 ); x-- )
+        mask[x] = newMaskVal;
+    return x;
+}
+
 template<typename _Tp, typename _MTp, typename _WTp, class Diff>
 static void
 floodFillGrad_CnIR( Mat& image, Mat& msk,
@@ -288,7 +469,7 @@ floodFillGrad_CnIR( Mat& image, Mat& msk,
     _Tp* img = (_Tp*)(pImage + step*seed.y);
     uchar* pMask = msk.ptr() + maskStep + sizeof(_MTp);
     _MTp* mask = (_MTp*)(pMask + maskStep*seed.y);
-    int i, L, R;
+    int i, L, R, width = image.cols;
     int area = 0;
     int XMin, XMax, YMin = seed.y, YMax = seed.y;
     int _8_connectivity = (flags & 255) == 8;
@@ -305,11 +486,8 @@ floodFillGrad_CnIR( Mat& image, Mat& msk,
 
     if( fixedRange )
     {
-        while( !mask[R + 1] && diff( img + (R+1), &val0 ))
-            mask[++R] = newMaskVal;
-
-        while( !mask[L - 1] && diff( img + (L-1), &val0 ))
-            mask[--L] = newMaskVal;
+        R = ffMarkRight( img, mask, R + 1, width, diff, val0, newMaskVal ) - 1;
+        L = ffMarkLeft( img, mask, L - 1, diff, val0, newMaskVal ) + 1;
     }
     else
     {
@@ -363,13 +541,9 @@ floodFillGrad_CnIR( Mat& image, Mat& msk,
                 {
                     if( !mask[i] && diff( img + i, &val0 ))
                     {
-                        int j = i;
                         mask[i] = newMaskVal;
-                        while( !mask[--j] && diff( img + j, &val0 ))
-                            mask[j] = newMaskVal;
-
-                        while( !mask[++i] && diff( img + i, &val0 ))
-                            mask[i] = newMaskVal;
+                        int j = ffMarkLeft( img, mask, i - 1, diff, val0, newMaskVal );
+                        i = ffMarkRight( img, mask, i + 1, width, diff, val0, newMaskVal );
 
                         ICV_PUSH( YC + dir, j+1, i-1, L, R, -dir );
                     }
@@ -455,12 +629,15 @@ floodFillGrad_CnIR( Mat& image, Mat& msk,
 *                                    External Functions                                  *
 \****************************************************************************************/
 
-int cv::floodFill( InputOutputArray _image, InputOutputArray _mask,
-                  Point seedPoint, Scalar newVal, Rect* rect,
-                  Scalar loDiff, Scalar upDiff, int flags )
+namespace cv
 {
-    CV_INSTRUMENT_REGION();
 
+// maskOutput == false means that the caller doesn't need the mask,
+// so single-color regions may be repainted without it
+static int floodFill_( InputOutputArray _image, InputOutputArray _mask,
+                       Point seedPoint, Scalar newVal, Rect* rect,
+                       Scalar loDiff, Scalar upDiff, int flags, bool maskOutput )
+{
     ConnectedComp comp;
     std::vector<FFillSegment> buffer;
 
@@ -494,21 +671,7 @@ int cv::floodFill( InputOutputArray _image, InputOutputArray _mask,
     if( connectivity != 0 && connectivity != 4 && connectivity != 8 )
         CV_Error( CV_StsBadFlag, "Connectivity must be 4, 0(=4) or 8" );
 
-    if( _mask.empty() )
-    {
-        _mask.create( size.height + 2, size.width + 2, CV_8UC1 );
-        _mask.setTo(0);
-    }
-
-    mask = _mask.getMat();
-    CV_CheckTypeEQ( mask.type(), CV_8U, "" );
-    CV_CheckEQ( mask.rows, size.height + 2, "" );
-    CV_CheckEQ( mask.cols, size.width + 2, "" );
-
-    Mat mask_inner = mask( Rect(1, 1, mask.cols - 2, mask.rows - 2) );
-    copyMakeBorder( mask_inner, mask, 1, 1, 1, 1, BORDER_ISOLATED | BORDER_CONSTANT, Scalar(1) );
-
-    bool is_simple = mask.empty() && (flags & FLOODFILL_MASK_ONLY) == 0;
+    bool is_simple = !maskOutput && _mask.empty() && (flags & FLOODFILL_MASK_ONLY) == 0;
 
     for( i = 0; i < cn; i++ )
     {
@@ -557,6 +720,20 @@ int cv::floodFill( InputOutputArray _image, InputOutputArray _mask,
         }
     }
 
+    if( _mask.empty() )
+    {
+        _mask.create( size.height + 2, size.width + 2, CV_8UC1 );
+        _mask.setTo(0);
+    }
+
+    mask = _mask.getMat();
+    CV_CheckTypeEQ( mask.type(), CV_8U, "" );
+    CV_CheckEQ( mask.rows, size.height + 2, "" );
+    CV_CheckEQ( mask.cols, size.width + 2, "" );
+
+    Mat mask_inner = mask( Rect(1, 1, mask.cols - 2, mask.rows - 2) );
+    copyMakeBorder( mask_inner, mask, 1, 1, 1, 1, BORDER_ISOLATED | BORDER_CONSTANT, Scalar(1) );
+
     if( depth == CV_8U )
         for( i = 0; i < cn; i++ )
         {
@@ -618,6 +795,17 @@ int cv::floodFill( InputOutputArray _image, InputOutputArray _mask,
     return comp.area;
 }
 
+}
+
+int cv::floodFill( InputOutputArray _image, InputOutputArray _mask,
+                  Point seedPoint, Scalar newVal, Rect* rect,
+                  Scalar loDiff, Scalar upDiff, int flags )
+{
+    CV_INSTRUMENT_REGION();
+
+    return floodFill_(_image, _mask, seedPoint, newVal, rect, loDiff, upDiff, flags, true);
+}
+
 
 int cv::floodFill( InputOutputArray _image, Point seedPoint,
                   Scalar newVal, Rect* rect,
@@ -626,7 +814,7 @@ int cv::floodFill( InputOutputArray _image, Point seedPoint,
     CV_INSTRUMENT_REGION();
 
     Mat mask;
-    return floodFill(_image, mask, seedPoint, newVal, rect, loDiff, upDiff, flags);
+    return floodFill_(_image, mask, seedPoint, newVal, rect, loDiff, upDiff, flags, false);
 }
 
 
@@ -69,6 +69,7 @@ public:
 
     void initLearning();
     void addSample( int ci, const Vec3d color );
+    void addSamples( int ci, const double sum[3], const double prod[3][3], int count );
     void endLearning();
 
 private:
@@ -175,6 +176,18 @@ void GMM::addSample( int ci, const Vec3d color )
     totalSampleCount++;
 }
 
+void GMM::addSamples( int ci, const double sum[3], const double prod[3][3], int count )
+{
+    for( int i = 0; i < 3; i++ )
+    {
+        sums[ci][i] += sum[i];
+        for( int j = 0; j < 3; j++ )
+            prods[ci][i][j] += prod[i][j];
+    }
+    sampleCounts[ci] += count;
+    totalSampleCount += count;
+}
+
 void GMM::endLearning()
 {
     for( int ci = 0; ci < componentsCount; ci++ )
@@ -234,39 +247,65 @@ void GMM::calcInverseCovAndDeterm(int ci, const double singularFix)
 } // namespace
 
 /*
-  Calculate beta - parameter of GrabCut algorithm.
-  beta = 1/(2*avg(sqr(||color[i] - color[j]||)))
+  Sums of squared color differences of the neighbor pixels, separately for every row.
 */
-static double calcBeta( const Mat& img )
+class BetaSumsInvoker : public ParallelLoopBody
 {
-    double beta = 0;
-    for( int y = 0; y < img.rows; y++ )
+public:
+    BetaSumsInvoker( const Mat& _img, std::vector<double>& _rowSums ) : img(_img), rowSums(_rowSums) {}
+
+    void operator()( const Range& range ) const CV_OVERRIDE
     {
-        for( int x = 0; x < img.cols; x++ )
+        for( int y = range.start; y < range.end; y++ )
         {
-            Vec3d color = img.at<Vec3b>(y,x);
-            if( x>0 ) // left
-            {
-                Vec3d diff = color - (Vec3d)img.at<Vec3b>(y,x-1);
-                beta += diff.dot(diff);
-            }
-            if( y>0 && x>0 ) // upleft
-            {
-                Vec3d diff = color - (Vec3d)img.at<Vec3b>(y-1,x-1);
-                beta += diff.dot(diff);
-            }
-            if( y>0 ) // up
+            double beta = 0;
+            for( int x = 0; x < img.cols; x++ )
             {
-                Vec3d diff = color - (Vec3d)img.at<Vec3b>(y-1,x);
-                beta += diff.dot(diff);
-            }
-            if( y>0 && x<img.cols-1) // upright
-            {
-                Vec3d diff = color - (Vec3d)img.at<Vec3b>(y-1,x+1);
-                beta += diff.dot(diff);
+                Vec3d color = img.at<Vec3b>(y,x);
+                if( x>0 ) // left
+                {
+                    Vec3d diff = color - (Vec3d)img.at<Vec3b>(y,x-1);
+                    beta += diff.dot(diff);
+                }
+                if( y>0 && x>0 ) // upleft
+                {
+                    Vec3d diff = color - (Vec3d)img.at<Vec3b>(y-1,x-1);
+                    beta += diff.dot(diff);
+                }
+                if( y>0 ) // up
+                {
+                    Vec3d diff = color - (Vec3d)img.at<Vec3b>(y-1,x);
+                    beta += diff.dot(diff);
+                }
+                if( y>0 && x<img.cols-1) // upright
+                {
+                    Vec3d diff = color - (Vec3d)img.at<Vec3b>(y-1,x+1);
+                    beta += diff.dot(diff);
+                }
             }
+            rowSums[y] = beta;
         }
     }
+
+private:
+    const Mat& img;
+    std::vector<double>& rowSums;
+};
+
+/*
+  Calculate beta - parameter of GrabCut algorithm.
+  beta = 1/(2*avg(sqr(||color[i] - color[j]||)))
+*/
+static double calcBeta( const Mat& img )
+{
+    std::vector<double> rowSums(img.rows);
+    parallel_for_( Range(0, img.rows), BetaSumsInvoker(img, rowSums) );
+
+    // the rows are summed up in order, so the result doesn't depend on the number of threads
+    double beta = 0;
+    for( int y = 0; y < img.rows; y++ )
+        beta += rowSums[y];
+
     if( beta <= std::numeric_limits<double>::epsilon() )
         beta = 0;
     else
@@ -279,48 +318,67 @@ static double calcBeta( const Mat& img )
   Calculate weights of noterminal vertices of graph.
   beta and gamma - parameters of GrabCut algorithm.
  */
-static void calcNWeights( const Mat& img, Mat& leftW, Mat& upleftW, Mat& upW, Mat& uprightW, double beta, double gamma )
+class NWeightsInvoker : public ParallelLoopBody
 {
-    const double gammaDivSqrt2 = gamma / std::sqrt(2.0f);
-    leftW.create( img.rows, img.cols, CV_64FC1 );
-    upleftW.create( img.rows, img.cols, CV_64FC1 );
-    upW.create( img.rows, img.cols, CV_64FC1 );
-    uprightW.create( img.rows, img.cols, CV_64FC1 );
-    for( int y = 0; y < img.rows; y++ )
+public:
+    NWeightsInvoker( const Mat& _img, Mat& _leftW, Mat& _upleftW, Mat& _upW, Mat& _uprightW, double _beta, double _gamma )
+        : img(_img), leftW(_leftW), upleftW(_upleftW), upW(_upW), uprightW(_uprightW), beta(_beta), gamma(_gamma)
     {
-        for( int x = 0; x < img.cols; x++ )
+    }
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        const double gammaDivSqrt2 = gamma / std::sqrt(2.0f);
+        for( int y = range.start; y < range.end; y++ )
         {
-            Vec3d color = img.at<Vec3b>(y,x);
-            if( x-1>=0 ) // left
-            {
-                Vec3d diff = color - (Vec3d)img.at<Vec3b>(y,x-1);
-                leftW.at<double>(y,x) = gamma * exp(-beta*diff.dot(diff));
-            }
-            else
-                leftW.at<double>(y,x) = 0;
-            if( x-1>=0 && y-1>=0 ) // upleft
-            {
-                Vec3d diff = color - (Vec3d)img.at<Vec3b>(y-1,x-1);
-                upleftW.at<double>(y,x) = gammaDivSqrt2 * exp(-beta*diff.dot(diff));
-            }
-            else
-                upleftW.at<double>(y,x) = 0;
-            if( y-1>=0 ) // up
-            {
-                Vec3d diff = color - (Vec3d)img.at<Vec3b>(y-1,x);
-                upW.at<double>(y,x) = gamma * exp(-beta*diff.dot(diff));
-            }
-            else
-                upW.at<double>(y,x) = 0;
-            if( x+1<img.cols && y-1>=0 ) // upright
+            for( int x = 0; x < img.cols; x++ )
             {
-                Vec3d diff = color - (Vec3d)img.at<Vec3b>(y-1,x+1);
-                uprightW.at<double>(y,x) = gammaDivSqrt2 * exp(-beta*diff.dot(diff));
+                Vec3d color = img.at<Vec3b>(y,x);
+                if( x-1>=0 ) // left
+                {
+                    Vec3d diff = color - (Vec3d)img.at<Vec3b>(y,x-1);
+                    leftW.at<double>(y,x) = gamma * exp(-beta*diff.dot(diff));
+                }
+                else
+                    leftW.at<double>(y,x) = 0;
+                if( x-1>=0 && y-1>=0 ) // upleft
+                {
+                    Vec3d diff = color - (Vec3d)img.at<Vec3b>(y-1,x-1);
+                    upleftW.at<double>(y,x) = gammaDivSqrt2 * exp(-beta*diff.dot(diff));
+                }
+                else
+                    upleftW.at<double>(y,x) = 0;
+                if( y-1>=0 ) // up
+                {
+                    Vec3d diff = color - (Vec3d)img.at<Vec3b>(y-1,x);
+                    upW.at<double>(y,x) = gamma * exp(-beta*diff.dot(diff));
+                }
+                else
+                    upW.at<double>(y,x) = 0;
+                if( x+1<img.cols && y-1>=0 ) // upright
+                {
+                    Vec3d diff = color - (Vec3d)img.at<Vec3b>(y-1,x+1);
+                    uprightW.at<double>(y,x) = gammaDivSqrt2 * exp(-beta*diff.dot(diff));
+                }
+                else
+                    uprightW.at<double>(y,x) = 0;
             }
-            else
-                uprightW.at<double>(y,x) = 0;
         }
     }
+
+private:
+    const Mat& img;
+    Mat &leftW, &upleftW, &upW, &uprightW;
+    double beta, gamma;
+};
+
+static void calcNWeights( const Mat& img, Mat& leftW, Mat& upleftW, Mat& upW, Mat& uprightW, double beta, double gamma )
+{
+    leftW.create( img.rows, img.cols, CV_64FC1 );
+    upleftW.create( img.rows, img.cols, CV_64FC1 );
+    upW.create( img.rows, img.cols, CV_64FC1 );
+    uprightW.create( img.rows, img.cols, CV_64FC1 );
+    parallel_for_( Range(0, img.rows), NWeightsInvoker(img, leftW, upleftW, upW, uprightW, beta, gamma) );
 }
 
 /*
@@ -364,8 +422,9 @@ static void initMaskWithRect( Mat& mask, Size imgSize, Rect rect )
 
 /*
   Initialize GMM background and foreground models using kmeans algorithm.
+  Only every step-th pixel of every step-th row is used.
 */
-static void initGMMs( const Mat& img, const Mat& mask, GMM& bgdGMM, GMM& fgdGMM )
+static void initGMMs( const Mat& img, const Mat& mask, GMM& bgdGMM, GMM& fgdGMM, int step = 1 )
 {
     const int kMeansItCount = 10;
     const int kMeansType = KMEANS_PP_CENTERS;
@@ -373,9 +432,9 @@ static void initGMMs( const Mat& img, const Mat& mask, GMM& bgdGMM, GMM& fgdGMM
     Mat bgdLabels, fgdLabels;
     std::vector<Vec3f> bgdSamples, fgdSamples;
     Point p;
-    for( p.y = 0; p.y < img.rows; p.y++ )
+    for( p.y = 0; p.y < img.rows; p.y += step )
     {
-        for( p.x = 0; p.x < img.cols; p.x++ )
+        for( p.x = 0; p.x < img.cols; p.x += step )
         {
             if( mask.at<uchar>(p) == GC_BGD || mask.at<uchar>(p) == GC_PR_BGD )
                 bgdSamples.push_back( (Vec3f)img.at<Vec3b>(p) );
@@ -383,6 +442,12 @@ static void initGMMs( const Mat& img, const Mat& mask, GMM& bgdGMM, GMM& fgdGMM
                 fgdSamples.push_back( (Vec3f)img.at<Vec3b>(p) );
         }
     }
+    if( step > 1 && (bgdSamples.empty() || fgdSamples.empty()) )
+    {
+        // one of the regions is too small for the downscaled image
+        initGMMs( img, mask, bgdGMM, fgdGMM, 1 );
+        return;
+    }
     CV_Assert( !bgdSamples.empty() && !fgdSamples.empty() );
     {
         Mat _bgdSamples( (int)bgdSamples.size(), 3, CV_32FC1, &bgdSamples[0][0] );
@@ -413,52 +478,176 @@ static void initGMMs( const Mat& img, const Mat& mask, GMM& bgdGMM, GMM& fgdGMM
 /*
   Assign GMMs components for each pixel.
 */
-static void assignGMMsComponents( const Mat& img, const Mat& mask, const GMM& bgdGMM, const GMM& fgdGMM, Mat& compIdxs )
+class GMMsComponentsInvoker : public ParallelLoopBody
 {
-    Point p;
-    for( p.y = 0; p.y < img.rows; p.y++ )
+public:
+    GMMsComponentsInvoker( const Mat& _img, const Mat& _mask, const GMM& _bgdGMM, const GMM& _fgdGMM, Mat& _compIdxs )
+        : img(_img), mask(_mask), bgdGMM(_bgdGMM), fgdGMM(_fgdGMM), compIdxs(_compIdxs)
     {
-        for( p.x = 0; p.x < img.cols; p.x++ )
+    }
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        for( int y = range.start; y < range.end; y++ )
         {
-            Vec3d color = img.at<Vec3b>(p);
-            compIdxs.at<int>(p) = mask.at<uchar>(p) == GC_BGD || mask.at<uchar>(p) == GC_PR_BGD ?
-                bgdGMM.whichComponent(color) : fgdGMM.whichComponent(color);
+            const Vec3b* colors = img.ptr<Vec3b>(y);
+            const uchar* m = mask.ptr(y);
+            int* idxs = compIdxs.ptr<int>(y);
+            for( int x = 0; x < img.cols; x++ )
+            {
+                Vec3d color = colors[x];
+                idxs[x] = m[x] == GC_BGD || m[x] == GC_PR_BGD ?
+                    bgdGMM.whichComponent(color) : fgdGMM.whichComponent(color);
+            }
         }
     }
+
+private:
+    const Mat& img;
+    const Mat& mask;
+    const GMM& bgdGMM;
+    const GMM& fgdGMM;
+    Mat& compIdxs;
+};
+
+static void assignGMMsComponents( const Mat& img, const Mat& mask, const GMM& bgdGMM, const GMM& fgdGMM, Mat& compIdxs )
+{
+    parallel_for_( Range(0, img.rows), GMMsComponentsInvoker(img, mask, bgdGMM, fgdGMM, compIdxs) );
 }
 
+/*
+  Sums of the samples of the background (0) and foreground (1) GMMs components over a band of rows.
+*/
+struct GMMsSampleSums
+{
+    double sums[2][GMM::componentsCount][3];
+    double prods[2][GMM::componentsCount][3][3];
+    int counts[2][GMM::componentsCount];
+};
+
+class GMMsSampleSumsInvoker : public ParallelLoopBody
+{
+public:
+    GMMsSampleSumsInvoker( const Mat& _img, const Mat& _mask, const Mat& _compIdxs,
+                           std::vector<GMMsSampleSums>& _bands, int _bandRows )
+        : img(_img), mask(_mask), compIdxs(_compIdxs), bands(_bands), bandRows(_bandRows)
+    {
+    }
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        for( int b = range.start; b < range.end; b++ )
+        {
+            GMMsSampleSums& s = bands[b];
+            memset( &s, 0, sizeof(s) );
+            int y1 = std::min( (b + 1)*bandRows, img.rows );
+            for( int y = b*bandRows; y < y1; y++ )
+            {
+                const Vec3b* colors = img.ptr<Vec3b>(y);
+                const uchar* m = mask.ptr(y);
+                const int* idxs = compIdxs.ptr<int>(y);
+                for( int x = 0; x < img.cols; x++ )
+                {
+                    int k = m[x] == GC_BGD || m[x] == GC_PR_BGD ? 0 : 1, ci = idxs[x];
+                    Vec3d color = colors[x];
+                    double* sum = s.sums[k][ci];
+                    double (*prod)[3] = s.prods[k][ci];
+                    sum[0] += color[0]; sum[1] += color[1]; sum[2] += color[2];
+                    prod[0][0] += color[0]*color[0]; prod[0][1] += color[0]*color[1]; prod[0][2] += color[0]*color[2];
+                    prod[1][0] += color[1]*color[0]; prod[1][1] += color[1]*color[1]; prod[1][2] += color[1]*color[2];
+                    prod[2][0] += color[2]*color[0]; prod[2][1] += color[2]*color[1]; prod[2][2] += color[2]*color[2];
+                    s.counts[k][ci]++;
+                }
+            }
+        }
+    }
+
+private:
+    const Mat& img;
+    const Mat& mask;
+    const Mat& compIdxs;
+    std::vector<GMMsSampleSums>& bands;
+    int bandRows;
+};
+
 /*
   Learn GMMs parameters.
 */
 static void learnGMMs( const Mat& img, const Mat& mask, const Mat& compIdxs, GMM& bgdGMM, GMM& fgdGMM )
 {
+    const int bandRows = 16;
+    std::vector<GMMsSampleSums> bands( (img.rows + bandRows - 1)/bandRows );
+    parallel_for_( Range(0, (int)bands.size()), GMMsSampleSumsInvoker(img, mask, compIdxs, bands, bandRows) );
+
+    // the bands are merged in order, so the result doesn't depend on the number of threads
     bgdGMM.initLearning();
     fgdGMM.initLearning();
-    Point p;
-    for( int ci = 0; ci < GMM::componentsCount; ci++ )
+    for( size_t b = 0; b < bands.size(); b++ )
     {
-        for( p.y = 0; p.y < img.rows; p.y++ )
+        for( int ci = 0; ci < GMM::componentsCount; ci++ )
         {
-            for( p.x = 0; p.x < img.cols; p.x++ )
+            bgdGMM.addSamples( ci, bands[b].sums[0][ci], bands[b].prods[0][ci], bands[b].counts[0][ci] );
+            fgdGMM.addSamples( ci, bands[b].sums[1][ci], bands[b].prods[1][ci], bands[b].counts[1][ci] );
+        }
+    }
+    bgdGMM.endLearning();
+    fgdGMM.endLearning();
+}
+
+/*
+  Calculate weights of terminal edges: (from source, to sink) for each pixel.
+*/
+class TermWeightsInvoker : public ParallelLoopBody
+{
+public:
+    TermWeightsInvoker( const Mat& _img, const Mat& _mask, const GMM& _bgdGMM, const GMM& _fgdGMM,
+                        double _lambda, Mat& _termW )
+        : img(_img), mask(_mask), bgdGMM(_bgdGMM), fgdGMM(_fgdGMM), lambda(_lambda), termW(_termW)
+    {
+    }
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        for( int y = range.start; y < range.end; y++ )
+        {
+            const Vec3b* colors = img.ptr<Vec3b>(y);
+            const uchar* m = mask.ptr(y);
+            Vec2d* tw = termW.ptr<Vec2d>(y);
+            for( int x = 0; x < img.cols; x++ )
             {
-                if( compIdxs.at<int>(p) == ci )
+                if( m[x] == GC_PR_BGD || m[x] == GC_PR_FGD )
                 {
-                    if( mask.at<uchar>(p) == GC_BGD || mask.at<uchar>(p) == GC_PR_BGD )
-                        bgdGMM.addSample( ci, img.at<Vec3b>(p) );
-                    else
-                        fgdGMM.addSample( ci, img.at<Vec3b>(p) );
+                    Vec3b color = colors[x];
+                    tw[x] = Vec2d( -log( bgdGMM(color) ), -log( fgdGMM(color) ) );
                 }
+                else if( m[x] == GC_BGD )
+                    tw[x] = Vec2d( 0, lambda );
+                else // GC_FGD
+                    tw[x] = Vec2d( lambda, 0 );
             }
         }
     }
-    bgdGMM.endLearning();
-    fgdGMM.endLearning();
+
+private:
+    const Mat& img;
+    const Mat& mask;
+    const GMM& bgdGMM;
+    const GMM& fgdGMM;
+    double lambda;
+    Mat& termW;
+};
+
+static void calcTermWeights( const Mat& img, const Mat& mask, const GMM& bgdGMM, const GMM& fgdGMM,
+                             double lambda, Mat& termW )
+{
+    termW.create( img.size(), CV_64FC2 );
+    parallel_for_( Range(0, img.rows), TermWeightsInvoker(img, mask, bgdGMM, fgdGMM, lambda, termW) );
 }
 
 /*
   Construct GCGraph
 */
-static void constructGCGraph( const Mat& img, const Mat& mask, const GMM& bgdGMM, const GMM& fgdGMM, double lambda,
+static void constructGCGraph( const Mat& img, const Mat& termW,
                        const Mat& leftW, const Mat& upleftW, const Mat& upW, const Mat& uprightW,
                        GCGraph<double>& graph )
 {
@@ -472,26 +661,10 @@ static void constructGCGraph( const Mat& img, const Mat& mask, const GMM& bgdGMM
         {
             // add node
             int vtxIdx = graph.addVtx();
-            Vec3b color = img.at<Vec3b>(p);
 
             // set t-weights
-            double fromSource, toSink;
-            if( mask.at<uchar>(p) == GC_PR_BGD || mask.at<uchar>(p) == GC_PR_FGD )
-            {
-                fromSource = -log( bgdGMM(color) );
-                toSink = -log( fgdGMM(color) );
-            }
-            else if( mask.at<uchar>(p) == GC_BGD )
-            {
-                fromSource = 0;
-                toSink = lambda;
-            }
-            else // GC_FGD
-            {
-                fromSource = lambda;
-                toSink = 0;
-            }
-            graph.addTermWeights( vtxIdx, fromSource, toSink );
+            Vec2d tw = termW.at<Vec2d>(p);
+            graph.addTermWeights( vtxIdx, tw[0], tw[1] );
 
             // set n-weights
             if( p.x>0 )
@@ -518,6 +691,24 @@ static void constructGCGraph( const Mat& img, const Mat& mask, const GMM& bgdGMM
     }
 }
 
+/*
+  Update t-weights of the graph solved on the previous iteration. The n-weights don't change
+  between the iterations, so the flow found before stays valid and maxFlow() continues from it.
+*/
+static void updateGCGraph( const Mat& termW, const Mat& prevTermW, GCGraph<double>& graph )
+{
+    for( int y = 0; y < termW.rows; y++ )
+    {
+        const Vec2d* tw = termW.ptr<Vec2d>(y);
+        const Vec2d* prev = prevTermW.ptr<Vec2d>(y);
+        for( int x = 0; x < termW.cols; x++ )
+        {
+            if( tw[x] != prev[x] )
+                graph.addTermWeights( y*termW.cols + x, tw[x][0] - prev[x][0], tw[x][1] - prev[x][1] );
+        }
+    }
+}
+
 /*
   Estimate segmentation using MaxFlow algorithm
 */
@@ -559,13 +750,18 @@ void cv::grabCut( InputArray _img, InputOutputArray _mask, Rect rect,
     GMM bgdGMM( bgdModel ), fgdGMM( fgdModel );
     Mat compIdxs( img.size(), CV_32SC1 );
 
+    bool downscaledInit = (mode & GC_INIT_DOWNSCALED) != 0;
+    mode &= ~GC_INIT_DOWNSCALED;
+
     if( mode == GC_INIT_WITH_RECT || mode == GC_INIT_WITH_MASK )
     {
         if( mode == GC_INIT_WITH_RECT )
             initMaskWithRect( mask, img.size(), rect );
         else // flag == GC_INIT_WITH_MASK
             checkMask( img, mask );
-        initGMMs( img, mask, bgdGMM, fgdGMM );
+        // about 64K samples are enough for kmeans to find the initial components
+        int step = downscaledInit ? std::max( cvFloor(std::sqrt(img.total()/65536.)), 1 ) : 1;
+        initGMMs( img, mask, bgdGMM, fgdGMM, step );
     }
 
     if( iterCount <= 0)
@@ -584,13 +780,20 @@ void cv::grabCut( InputArray _img, InputOutputArray _mask, Rect rect,
     Mat leftW, upleftW, upW, uprightW;
     calcNWeights( img, leftW, upleftW, upW, uprightW, beta, gamma );
 
+    // the graph is built once, the next iterations only update its t-weights
+    GCGraph<double> graph;
+    Mat termW, prevTermW;
     for( int i = 0; i < iterCount; i++ )
     {
-        GCGraph<double> graph;
         assignGMMsComponents( img, mask, bgdGMM, fgdGMM, compIdxs );
         if( mode != GC_EVAL_FREEZE_MODEL )
             learnGMMs( img, mask, compIdxs, bgdGMM, fgdGMM );
-        constructGCGraph(img, mask, bgdGMM, fgdGMM, lambda, leftW, upleftW, upW, uprightW, graph );
+        calcTermWeights( img, mask, bgdGMM, fgdGMM, lambda, termW );
+        if( i == 0 )
+            constructGCGraph( img, termW, leftW, upleftW, upW, uprightW, graph );
+        else
+            updateGCGraph( termW, prevTermW, graph );
         estimateSegmentation( graph, mask );
+        std::swap( termW, prevTermW );
     }
 }
@@ -80,6 +80,69 @@ createTrigTable( int numangle, double min_theta, double theta_step,
     }
 }
 
+// Computes the accumulator indices of the point (x, y) for all the angles, adding ofs to them
+static inline void
+computeLineRhos( int x, int y, int numangle, const float* tabCos, const float* tabSin,
+                 int ofs, int* rbuf )
+{
+    int n = 0;
+#if CV_SIMD
+    const int VECSZ = v_float32::nlanes;
+    v_float32 vx = vx_setall_f32((float)x), vy = vx_setall_f32((float)y);
+    v_int32 vofs = vx_setall_s32(ofs);
+    for( ; n <= numangle - VECSZ; n += VECSZ )
+        v_store(rbuf + n, v_round(vx * vx_load(tabCos + n) + vy * vx_load(tabSin + n)) + vofs);
+#endif
+    for( ; n < numangle; n++ )
+        rbuf[n] = cvRound( x * tabCos[n] + y * tabSin[n] ) + ofs;
+}
+
+// Fills the accumulator rows of the standard Hough transform; the threads process
+// different angles, so they never update the same accumulator cells
+class HoughLinesAccumInvoker : public ParallelLoopBody
+{
+public:
+    HoughLinesAccumInvoker( const std::vector<float>& _xs, const std::vector<float>& _ys,
+                            const float* _tabSin, const float* _tabCos, int* _accum, int _numrho ) :
+        xs(_xs), ys(_ys), tabSin(_tabSin), tabCos(_tabCos), accum(_accum), numrho(_numrho)
+    {
+    }
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        const int npoints = (int)xs.size();
+        const float* x = xs.empty() ? 0 : &xs[0];
+        const float* y = ys.empty() ? 0 : &ys[0];
+        for( int n = range.start; n < range.end; n++ )
+        {
+            int* adata = accum + (n+1) * (numrho+2) + 1 + (numrho - 1) / 2;
+            const float c = tabCos[n], s = tabSin[n];
+            int k = 0;
+#if CV_SIMD
+            const int VECSZ = v_float32::nlanes;
+            int CV_DECL_ALIGNED(CV_SIMD_WIDTH) rbuf[VECSZ];
+            v_float32 vc = vx_setall_f32(c), vs = vx_setall_f32(s);
+            for( ; k <= npoints - VECSZ; k += VECSZ )
+            {
+                v_store_aligned(rbuf, v_round(vx_load(x + k) * vc + vx_load(y + k) * vs));
+                for( int l = 0; l < VECSZ; l++ )
+                    adata[rbuf[l]]++;
+            }
+#endif
+            for( ; k < npoints; k++ )
+                adata[cvRound( x[k] * c + y[k] * s )]++;
+        }
+    }
+
+private:
+    const std::vector<float>& xs;
+    const std::vector<float>& ys;
+    const float* tabSin;
+    const float* tabCos;
+    int* accum;
+    int numrho;
+};
+
 static void
 findLocalMaximums( int numrho, int numangle, int threshold,
                    const int *accum, std::vector<int>& sort_buf )
@@ -172,17 +235,18 @@ HoughLinesStandard( InputArray src, OutputArray lines, int type,
                      irho, tabSin, tabCos);
 
     // stage 1. fill accumulator
+    std::vector<float> xs, ys;
     for( i = 0; i < height; i++ )
         for( j = 0; j < width; j++ )
         {
             if( image[i * step + j] != 0 )
-                for(int n = 0; n < numangle; n++ )
-                {
-                    int r = cvRound( j * tabCos[n] + i * tabSin[n] );
-                    r += (numrho - 1) / 2;
-                    accum[(n+1) * (numrho+2) + r+1]++;
-                }
+            {
+                xs.push_back((float)j);
+                ys.push_back((float)i);
+            }
         }
+    parallel_for_(Range(0, numangle), HoughLinesAccumInvoker(xs, ys, tabSin, tabCos, accum, numrho),
+                  (double)xs.size() * numangle / (1 << 16));
 
     // stage 2. find local maximums
     findLocalMaximums( numrho, numangle, threshold, accum, _sort_buf );
@@ -460,11 +524,14 @@ HoughLinesSDiv( InputArray image, OutputArray lines, int type,
 *                              Probabilistic Hough Transform                             *
 \****************************************************************************************/
 
+// keepBorderSegments: the segments ending within lineGap from the image border are kept regardless of their length,
+// they may continue in the neighbor image tile
 static void
 HoughLinesProbabilistic( Mat& image,
                          float rho, float theta, int threshold,
                          int lineLength, int lineGap,
-                         std::vector<Vec4i>& lines, int linesMax )
+                         std::vector<Vec4i>& lines, int linesMax,
+                         bool keepBorderSegments = false )
 {
     Point pt;
     float irho = 1 / rho;
@@ -479,7 +546,7 @@ HoughLinesProbabilistic( Mat& image,
     int numrho = cvRound(((width + height) * 2 + 1) / rho);
 
 #if defined HAVE_IPP && IPP_VERSION_X100 >= 810 && !IPP_DISABLE_HOUGH
-    CV_IPP_CHECK()
+    if (!keepBorderSegments && CV_IPP_CHECK_COND)
     {
         IppiSize srcSize = { width, height };
         IppPointPolar delta = { rho, theta };
@@ -510,13 +577,16 @@ HoughLinesProbabilistic( Mat& image,
     Mat accum = Mat::zeros( numangle, numrho, CV_32SC1 );
     Mat mask( height, width, CV_8UC1 );
     std::vector<float> trigtab(numangle*2);
+    std::vector<int> rbuf(numangle);
 
     for( int n = 0; n < numangle; n++ )
     {
-        trigtab[n*2] = (float)(cos((double)n*theta) * irho);
-        trigtab[n*2+1] = (float)(sin((double)n*theta) * irho);
+        trigtab[n] = (float)(cos((double)n*theta) * irho);
+        trigtab[numangle + n] = (float)(sin((double)n*theta) * irho);
     }
-    const float* ttab = &trigtab[0];
+    const float* tabCos = &trigtab[0];
+    const float* tabSin = &trigtab[numangle];
+    int* rtab = &rbuf[0];
     uchar* mdata0 = mask.ptr();
     std::vector<Point> nzloc;
 
@@ -561,11 +631,10 @@ HoughLinesProbabilistic( Mat& image,
             continue;
 
         // update accumulator, find the most probable line
+        computeLineRhos( j, i, numangle, tabCos, tabSin, (numrho - 1) / 2, rtab );
         for( int n = 0; n < numangle; n++, adata += numrho )
         {
-            int r = cvRound( j * ttab[n*2] + i * ttab[n*2+1] );
-            r += (numrho - 1) / 2;
-            int val = ++adata[r];
+            int val = ++adata[rtab[n]];
             if( max_val < val )
             {
                 max_val = val;
@@ -579,8 +648,8 @@ HoughLinesProbabilistic( Mat& image,
 
         // from the current point walk in each direction
         // along the found line and extract the line segment
-        a = -ttab[max_n*2+1];
-        b = ttab[max_n*2];
+        a = -tabSin[max_n];
+        b = tabCos[max_n];
         x0 = j;
         y0 = i;
         if( fabs(a) > fabs(b) )
@@ -645,6 +714,9 @@ HoughLinesProbabilistic( Mat& image,
 
         good_line = std::abs(line_end[1].x - line_end[0].x) >= lineLength ||
                     std::abs(line_end[1].y - line_end[0].y) >= lineLength;
+        for( k = 0; k < 2 && keepBorderSegments && !good_line; k++ )
+            good_line = std::min(std::min(line_end[k].x, width - 1 - line_end[k].x),
+                                 std::min(line_end[k].y, height - 1 - line_end[k].y)) <= lineGap;
 
         for( k = 0; k < 2; k++ )
         {
@@ -682,12 +754,9 @@ HoughLinesProbabilistic( Mat& image,
                     if( good_line )
                     {
                         adata = accum.ptr<int>();
+                        computeLineRhos( j1, i1, numangle, tabCos, tabSin, (numrho - 1) / 2, rtab );
                         for( int n = 0; n < numangle; n++, adata += numrho )
-                        {
-                            int r = cvRound( j1 * ttab[n*2] + i1 * ttab[n*2+1] );
-                            r += (numrho - 1) / 2;
-                            adata[r]--;
-                        }
+                            adata[rtab[n]]--;
                     }
                     *mdata = 0;
                 }
@@ -931,6 +1000,169 @@ void HoughLinesP(InputArray _image, OutputArray _lines,
     Mat(lines).copyTo(_lines);
 }
 
+// distance from the point to the line through the segment
+static double
+distanceToSegmentLine( const Vec4i& s, Point pt )
+{
+    Point2d d(s[2] - s[0], s[3] - s[1]);
+    double len = std::sqrt(d.dot(d));
+    if( len == 0 )
+        return cv::norm(pt - Point(s[0], s[1]));
+    return std::abs(d.x*(pt.y - s[1]) - d.y*(pt.x - s[0])) / len;
+}
+
+// max distance (in pixels) from the ends of the shorter piece to the line through the longer one
+// for the pieces to be joined. The ends of the pieces are quantized to the pixel grid, so the pieces
+// of the same segment found in the neighbor tiles lie 1 pixel or so off each other's line.
+static const double HOUGH_TILE_JOIN_TOLERANCE = 2.;
+
+// checks if the segments found in the neighbor tiles are the pieces of the same segment:
+// two of their ends are within the gap and both lie on the line through the longer one
+static bool
+canJoinSegments( const Vec4i& a, const Vec4i& b, int lineGap )
+{
+    bool close = false;
+    for( int i = 0; i < 4 && !close; i += 2 )
+        for( int j = 0; j < 4 && !close; j += 2 )
+            close = std::max(std::abs(a[i] - b[j]), std::abs(a[i+1] - b[j+1])) <= lineGap + 1;
+    if( !close )
+        return false;
+    Point2i da(a[2] - a[0], a[3] - a[1]), db(b[2] - b[0], b[3] - b[1]);
+    bool aIsLonger = da.dot(da) >= db.dot(db);
+    const Vec4i& l = aIsLonger ? a : b;
+    const Vec4i& s = aIsLonger ? b : a;
+    return distanceToSegmentLine(l, Point(s[0], s[1])) <= HOUGH_TILE_JOIN_TOLERANCE &&
+           distanceToSegmentLine(l, Point(s[2], s[3])) <= HOUGH_TILE_JOIN_TOLERANCE;
+}
+
+// every tile runs the sequential transform with its own accumulator, mask and random sequence,
+// so the result doesn't depend on the number of threads
+class HoughLinesPTileInvoker : public ParallelLoopBody
+{
+public:
+    HoughLinesPTileInvoker( const Mat& _image, Size _tileSize, int _ntx, float _rho, float _theta,
+                            int _threshold, int _lineLength, int _lineGap,
+                            std::vector<std::vector<Vec4i> >& _tileLines ) :
+        image(_image), tileSize(_tileSize), ntx(_ntx), rho(_rho), theta(_theta), threshold(_threshold),
+        lineLength(_lineLength), lineGap(_lineGap), tileLines(_tileLines)
+    {
+    }
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        for( int t = range.start; t < range.end; t++ )
+        {
+            Rect roi(t % ntx * tileSize.width, t / ntx * tileSize.height, tileSize.width, tileSize.height);
+            roi &= Rect(0, 0, image.cols, image.rows);
+            Mat tile = image(roi);
+            std::vector<Vec4i>& lines = tileLines[t];
+            HoughLinesProbabilistic(tile, rho, theta, threshold, lineLength, lineGap, lines, INT_MAX, true);
+            for( size_t k = 0; k < lines.size(); k++ )
+                lines[k] += Vec4i(roi.x, roi.y, roi.x, roi.y);
+        }
+    }
+
+private:
+    const Mat& image;
+    Size tileSize;
+    int ntx;
+    float rho, theta;
+    int threshold, lineLength, lineGap;
+    std::vector<std::vector<Vec4i> >& tileLines;
+};
+
+void HoughLinesPTiled(InputArray _image, OutputArray _lines,
+                      double rho, double theta, int threshold,
+                      double minLineLength, double maxGap, Size tileSize )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat image = _image.getMat();
+    CV_Assert( image.type() == CV_8UC1 );
+    CV_Assert( tileSize.width > 0 && tileSize.height > 0 );
+
+    const int lineLength = cvRound(minLineLength), lineGap = cvRound(maxGap);
+    const int ntx = divUp(image.cols, tileSize.width), nty = divUp(image.rows, tileSize.height);
+    const int ntiles = ntx*nty;
+
+    std::vector<std::vector<Vec4i> > tileLines(ntiles);
+    parallel_for_(Range(0, ntiles), HoughLinesPTileInvoker(image, tileSize, ntx, (float)rho, (float)theta,
+                                                           threshold, lineLength, lineGap, tileLines));
+
+    std::vector<Vec4i> segs;
+    std::vector<int> tileStart(ntiles + 1, 0);
+    for( int t = 0; t < ntiles; t++ )
+    {
+        tileStart[t] = (int)segs.size();
+        segs.insert(segs.end(), tileLines[t].begin(), tileLines[t].end());
+    }
+    tileStart[ntiles] = (int)segs.size();
+
+    // join the pieces of the segments crossing the tile borders. The root of every group is its first piece,
+    // so the groups don't depend on the order of the joins.
+    const int nsegs = (int)segs.size();
+    std::vector<int> parent(nsegs);
+    for( int i = 0; i < nsegs; i++ )
+        parent[i] = i;
+    static const int nbx[] = { 1, -1, 0, 1 }, nby[] = { 0, 1, 1, 1 };
+    for( int t = 0; t < ntiles; t++ )
+    {
+        int tx = t % ntx, ty = t / ntx;
+        for( int nb = 0; nb < 4; nb++ )
+        {
+            int ux = tx + nbx[nb], uy = ty + nby[nb];
+            if( ux < 0 || ux >= ntx || uy >= nty )
+                continue;
+            int u = uy*ntx + ux;
+            for( int i = tileStart[t]; i < tileStart[t+1]; i++ )
+                for( int j = tileStart[u]; j < tileStart[u+1]; j++ )
+                {
+                    if( !canJoinSegments(segs[i], segs[j], lineGap) )
+                        continue;
+                    int ri = i, rj = j;
+                    while( parent[ri] != ri )
+                        ri = parent[ri];
+                    while( parent[rj] != rj )
+                        rj = parent[rj];
+                    parent[std::max(ri, rj)] = std::min(ri, rj);
+                }
+        }
+    }
+
+    // the joined segment connects the two farthest ends of its pieces
+    std::vector<std::vector<Point> > groupEnds(nsegs);
+    for( int i = 0; i < nsegs; i++ )
+    {
+        int r = i;
+        while( parent[r] != r )
+            r = parent[r];
+        groupEnds[r].push_back(Point(segs[i][0], segs[i][1]));
+        groupEnds[r].push_back(Point(segs[i][2], segs[i][3]));
+    }
+    std::vector<Vec4i> lines;
+    for( int r = 0; r < nsegs; r++ )
+    {
+        const std::vector<Point>& ends = groupEnds[r];
+        if( ends.empty() )
+            continue;
+        Vec4i best(ends[0].x, ends[0].y, ends[1].x, ends[1].y);
+        int bestDist = -1;
+        for( size_t i = 0; i < ends.size(); i++ )
+            for( size_t j = i + 1; j < ends.size(); j++ )
+            {
+                Point d = ends[j] - ends[i];
+                if( d.dot(d) > bestDist )
+                {
+                    bestDist = d.dot(d);
+                    best = Vec4i(ends[i].x, ends[i].y, ends[j].x, ends[j].y);
+                }
+            }
+        if( std::abs(best[2] - best[0]) >= lineLength || std::abs(best[3] - best[1]) >= lineLength )
+            lines.push_back(best);
+    }
+    Mat(lines).copyTo(_lines);
+}
+
 void HoughLinesPointSet( InputArray _point, OutputArray _lines, int lines_max, int threshold,
                          double min_rho, double max_rho, double rho_step,
                          double min_theta, double max_theta, double theta_step )
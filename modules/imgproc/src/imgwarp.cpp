@@ -1659,14 +1659,9 @@ private:
 
 #endif
 
-}
-
-void cv::remap( InputArray _src, OutputArray _dst,
-                InputArray _map1, InputArray _map2,
-                int interpolation, int borderType, const Scalar& borderValue )
+static void getRemapFunctions(int interpolation, int depth, int cn,
+                              RemapNNFunc& nnfunc, RemapFunc& ifunc, const void*& ctab)
 {
-    CV_INSTRUMENT_REGION();
-
     static RemapNNFunc nn_tab[] =
     {
         remapNearest<uchar>, remapNearest<schar>, remapNearest<ushort>, remapNearest<short>,
@@ -1700,6 +1695,43 @@ void cv::remap( InputArray _src, OutputArray _dst,
         remapLanczos4<Cast<double, double>, float, 1>, 0
     };
 
+    nnfunc = 0;
+    ifunc = 0;
+    ctab = 0;
+    bool fixpt = depth == CV_8U;
+
+    if( interpolation == INTER_NEAREST )
+    {
+        nnfunc = nn_tab[depth];
+        CV_Assert( nnfunc != 0 );
+    }
+    else
+    {
+        if( interpolation == INTER_LINEAR )
+            ifunc = linear_tab[depth];
+        else if( interpolation == INTER_CUBIC ){
+            ifunc = cubic_tab[depth];
+            CV_Assert( cn <= 4 );
+        }
+        else if( interpolation == INTER_LANCZOS4 ){
+            ifunc = lanczos4_tab[depth];
+            CV_Assert( cn <= 4 );
+        }
+        else
+            CV_Error( CV_StsBadArg, "Unknown interpolation method" );
+        CV_Assert( ifunc != 0 );
+        ctab = initInterTab2D( interpolation, fixpt );
+    }
+}
+
+}
+
+void cv::remap( InputArray _src, OutputArray _dst,
+                InputArray _map1, InputArray _map2,
+                int interpolation, int borderType, const Scalar& borderValue )
+{
+    CV_INSTRUMENT_REGION();
+
     CV_Assert( !_map1.empty() );
     CV_Assert( _map2.empty() || (_map2.size() == _map1.size()));
 
@@ -1775,31 +1807,8 @@ void cv::remap( InputArray _src, OutputArray _dst,
     RemapNNFunc nnfunc = 0;
     RemapFunc ifunc = 0;
     const void* ctab = 0;
-    bool fixpt = depth == CV_8U;
     bool planar_input = false;
-
-    if( interpolation == INTER_NEAREST )
-    {
-        nnfunc = nn_tab[depth];
-        CV_Assert( nnfunc != 0 );
-    }
-    else
-    {
-        if( interpolation == INTER_LINEAR )
-            ifunc = linear_tab[depth];
-        else if( interpolation == INTER_CUBIC ){
-            ifunc = cubic_tab[depth];
-            CV_Assert( _src.channels() <= 4 );
-        }
-        else if( interpolation == INTER_LANCZOS4 ){
-            ifunc = lanczos4_tab[depth];
-            CV_Assert( _src.channels() <= 4 );
-        }
-        else
-            CV_Error( CV_StsBadArg, "Unknown interpolation method" );
-        CV_Assert( ifunc != 0 );
-        ctab = initInterTab2D( interpolation, fixpt );
-    }
+    getRemapFunctions(interpolation, depth, src.channels(), nnfunc, ifunc, ctab);
 
     const Mat *m1 = &map1, *m2 = &map2;
 
@@ -2148,6 +2157,406 @@ void cv::convertMaps( InputArray _map1, InputArray _map2,
     }
 }
 
+/****************************************************************************************\
+*                                  Tiled (cache-blocked) remap                          *
+\****************************************************************************************/
+
+namespace cv
+{
+
+struct TiledRemap::Impl
+{
+    struct Tile
+    {
+        Rect roi;       // tile in the destination image
+        int bx, by;     // base source coordinate, in 1/INTER_TAB_SIZE pixel units
+        Rect footprint; // source pixels referenced by the tile (not clipped)
+        bool packed;    // 16-bit deltas (2 values per pixel) or raw XY + A (3 values per pixel)
+        size_t ofs;     // offset of the tile data in 'data'
+    };
+
+    Size size;
+    Size tileSize;
+    bool nninterpolation;
+    std::vector<Tile> tiles;
+    std::vector<ushort> data;
+};
+
+static inline unsigned interleaveBits16(int v)
+{
+    unsigned x = (unsigned)v & 0xffff;
+    x = (x | (x << 8)) & 0x00ff00ff;
+    x = (x | (x << 4)) & 0x0f0f0f0f;
+    x = (x | (x << 2)) & 0x33333333;
+    x = (x | (x << 1)) & 0x55555555;
+    return x;
+}
+
+static inline void prefetchRemapFootprint(const Mat& src, const Rect& footprint)
+{
+#if defined __GNUC__ || defined __clang__
+    const int CACHE_LINE = 64;
+    Rect r = footprint & Rect(0, 0, src.cols, src.rows);
+    size_t esz = src.elemSize(), rowBytes = r.width*esz;
+    // don't thrash the cache with the footprints of strongly minifying maps
+    if( r.empty() || rowBytes*r.height > (size_t)(1 << 16) )
+        return;
+    for( int y = r.y; y < r.y + r.height; y++ )
+    {
+        const uchar* p = src.ptr(y, r.x);
+        for( size_t i = 0; i < rowBytes; i += CACHE_LINE )
+            __builtin_prefetch(p + i);
+    }
+#else
+    CV_UNUSED(src); CV_UNUSED(footprint);
+#endif
+}
+
+class TiledRemapInvoker :
+    public ParallelLoopBody
+{
+public:
+    TiledRemapInvoker(const Mat& _src, Mat& _dst, const TiledRemap::Impl& _impl,
+                      int _borderType, const Scalar& _borderValue,
+                      RemapNNFunc _nnfunc, RemapFunc _ifunc, const void* _ctab) :
+        ParallelLoopBody(), src(&_src), dst(&_dst), impl(&_impl),
+        borderType(_borderType), borderValue(_borderValue),
+        nnfunc(_nnfunc), ifunc(_ifunc), ctab(_ctab)
+    {
+    }
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        const std::vector<TiledRemap::Impl::Tile>& tiles = impl->tiles;
+        Mat _bufxy(impl->tileSize, CV_16SC2), _bufa;
+        if( !nnfunc )
+            _bufa.create(impl->tileSize, CV_16UC1);
+
+        for( int i = range.start; i < range.end; i++ )
+        {
+            const TiledRemap::Impl::Tile& tile = tiles[i];
+            if( i + 1 < range.end )
+                prefetchRemapFootprint(*src, tiles[i + 1].footprint);
+
+            int bcols = tile.roi.width, brows = tile.roi.height;
+            Mat bufxy(_bufxy, Rect(0, 0, bcols, brows)), bufa;
+            if( !nnfunc )
+                bufa = Mat(_bufa, Rect(0, 0, bcols, brows));
+
+            const ushort* S = &impl->data[tile.ofs];
+            for( int y1 = 0; y1 < brows; y1++ )
+            {
+                short* XY = bufxy.ptr<short>(y1);
+                ushort* A = nnfunc ? 0 : bufa.ptr<ushort>(y1);
+                int x1 = 0;
+
+                if( tile.packed )
+                {
+                    const ushort* sD = S + y1*bcols*2;
+                    if( nnfunc )
+                    {
+                        for( ; x1 < bcols; x1++ )
+                        {
+                            XY[x1*2] = (short)((tile.bx + sD[x1*2] + INTER_TAB_SIZE/2) >> INTER_BITS);
+                            XY[x1*2+1] = (short)((tile.by + sD[x1*2+1] + INTER_TAB_SIZE/2) >> INTER_BITS);
+                        }
+                        continue;
+                    }
+                    #if CV_SIMD128
+                    {
+                        v_int32x4 v_bx = v_setall_s32(tile.bx), v_by = v_setall_s32(tile.by);
+                        v_int32x4 v_mask = v_setall_s32(INTER_TAB_SIZE - 1);
+                        int span = v_uint16x8::nlanes;
+                        for( ; x1 <= bcols - span; x1 += span )
+                        {
+                            v_uint16x8 v_dx, v_dy;
+                            v_load_deinterleave(sD + x1*2, v_dx, v_dy);
+                            v_uint32x4 v_dx0, v_dx1, v_dy0, v_dy1;
+                            v_expand(v_dx, v_dx0, v_dx1);
+                            v_expand(v_dy, v_dy0, v_dy1);
+                            v_int32x4 v_sx0 = v_reinterpret_as_s32(v_dx0) + v_bx;
+                            v_int32x4 v_sx1 = v_reinterpret_as_s32(v_dx1) + v_bx;
+                            v_int32x4 v_sy0 = v_reinterpret_as_s32(v_dy0) + v_by;
+                            v_int32x4 v_sy1 = v_reinterpret_as_s32(v_dy1) + v_by;
+                            v_uint16x8 v_fx = v_reinterpret_as_u16(v_pack(v_sx0 & v_mask, v_sx1 & v_mask));
+                            v_uint16x8 v_fy = v_reinterpret_as_u16(v_pack(v_sy0 & v_mask, v_sy1 & v_mask));
+                            v_store(A + x1, v_shl<INTER_BITS>(v_fy) | v_fx);
+                            v_int16x8 v_ix = v_pack(v_shr<INTER_BITS>(v_sx0), v_shr<INTER_BITS>(v_sx1));
+                            v_int16x8 v_iy = v_pack(v_shr<INTER_BITS>(v_sy0), v_shr<INTER_BITS>(v_sy1));
+                            v_store_interleave(XY + x1*2, v_ix, v_iy);
+                        }
+                    }
+                    #endif
+                    for( ; x1 < bcols; x1++ )
+                    {
+                        int sx = tile.bx + sD[x1*2], sy = tile.by + sD[x1*2+1];
+                        XY[x1*2] = (short)(sx >> INTER_BITS);
+                        XY[x1*2+1] = (short)(sy >> INTER_BITS);
+                        A[x1] = (ushort)((sy & (INTER_TAB_SIZE-1))*INTER_TAB_SIZE + (sx & (INTER_TAB_SIZE-1)));
+                    }
+                }
+                else
+                {
+                    const ushort* sD = S + y1*bcols*3;
+                    for( ; x1 < bcols; x1++ )
+                    {
+                        short ix = (short)sD[x1*3], iy = (short)sD[x1*3+1];
+                        int a = sD[x1*3+2];
+                        if( nnfunc )
+                        {
+                            int sx = ix*INTER_TAB_SIZE + (a & (INTER_TAB_SIZE-1)) + INTER_TAB_SIZE/2;
+                            int sy = iy*INTER_TAB_SIZE + (a >> INTER_BITS) + INTER_TAB_SIZE/2;
+                            XY[x1*2] = saturate_cast<short>(sx >> INTER_BITS);
+                            XY[x1*2+1] = saturate_cast<short>(sy >> INTER_BITS);
+                        }
+                        else
+                        {
+                            XY[x1*2] = ix;
+                            XY[x1*2+1] = iy;
+                            A[x1] = (ushort)a;
+                        }
+                    }
+                }
+            }
+
+            Mat dpart(*dst, tile.roi);
+            if( nnfunc )
+                nnfunc(*src, dpart, bufxy, borderType, borderValue);
+            else
+                ifunc(*src, dpart, bufxy, bufa, ctab, borderType, borderValue);
+        }
+    }
+
+private:
+    const Mat* src;
+    Mat* dst;
+    const TiledRemap::Impl* impl;
+    int borderType;
+    Scalar borderValue;
+    RemapNNFunc nnfunc;
+    RemapFunc ifunc;
+    const void* ctab;
+};
+
+TiledRemap::TiledRemap()
+{
+}
+
+TiledRemap::TiledRemap(InputArray map1, InputArray map2, bool nninterpolation, Size tileSize)
+{
+    create(map1, map2, nninterpolation, tileSize);
+}
+
+void TiledRemap::create(InputArray _map1, InputArray _map2, bool nninterpolation, Size tileSize)
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat map1 = _map1.getMat(), map2 = _map2.getMat();
+    CV_Assert( !map1.empty() );
+    CV_Assert( map2.empty() || map2.size() == map1.size() );
+    CV_Assert( tileSize.width > 0 && tileSize.height > 0 );
+
+    const Mat *m1 = &map1, *m2 = &map2;
+    bool fixpt = false;
+    if( (map1.type() == CV_16SC2 && (map2.type() == CV_16UC1 || map2.type() == CV_16SC1 || map2.empty())) ||
+        (map2.type() == CV_16SC2 && (map1.type() == CV_16UC1 || map1.type() == CV_16SC1 || map1.empty())) )
+    {
+        if( map1.type() != CV_16SC2 )
+            std::swap(m1, m2);
+        fixpt = true;
+    }
+    else
+    {
+        CV_Assert( (map1.type() == CV_32FC2 && map2.empty()) ||
+                   (map1.type() == CV_32FC1 && map2.type() == CV_32FC1) );
+    }
+    bool planar_input = !fixpt && m1->channels() == 1;
+    Size size = m1->size();
+    CV_Assert( size.width < SHRT_MAX && size.height < SHRT_MAX );
+    tileSize.width = std::min(tileSize.width, size.width);
+    tileSize.height = std::min(tileSize.height, size.height);
+
+    if( nninterpolation && fixpt && !m2->empty() )
+        initInterTab2D( INTER_LINEAR, false ); // NNDeltaTab_i
+
+    std::shared_ptr<Impl> p = std::make_shared<Impl>();
+    p->size = size;
+    p->tileSize = tileSize;
+    p->nninterpolation = nninterpolation;
+
+    // absolute source coordinates of the current tile, in 1/INTER_TAB_SIZE pixel units
+    std::vector<int> bufX(tileSize.area()), bufY(tileSize.area());
+    std::vector<std::pair<unsigned, int> > order;
+
+    for( int y = 0; y < size.height; y += tileSize.height )
+    {
+        for( int x = 0; x < size.width; x += tileSize.width )
+        {
+            int bcols = std::min(tileSize.width, size.width - x);
+            int brows = std::min(tileSize.height, size.height - y);
+            int minX = INT_MAX, minY = INT_MAX, maxX = INT_MIN, maxY = INT_MIN;
+
+            for( int y1 = 0; y1 < brows; y1++ )
+            {
+                int* X = &bufX[y1*bcols];
+                int* Y = &bufY[y1*bcols];
+                for( int x1 = 0; x1 < bcols; x1++ )
+                {
+                    int ix, iy, fx = 0, fy = 0;
+                    if( fixpt )
+                    {
+                        const short* sXY = m1->ptr<short>(y + y1) + (x + x1)*2;
+                        ix = sXY[0];
+                        iy = sXY[1];
+                        if( !m2->empty() )
+                        {
+                            int a = m2->ptr<ushort>(y + y1)[x + x1] & (INTER_TAB_SIZE2-1);
+                            if( nninterpolation )
+                            {
+                                ix += NNDeltaTab_i[a][0];
+                                iy += NNDeltaTab_i[a][1];
+                            }
+                            else
+                            {
+                                fx = a & (INTER_TAB_SIZE-1);
+                                fy = a >> INTER_BITS;
+                            }
+                        }
+                    }
+                    else
+                    {
+                        float sx, sy;
+                        if( planar_input )
+                        {
+                            sx = m1->ptr<float>(y + y1)[x + x1];
+                            sy = m2->ptr<float>(y + y1)[x + x1];
+                        }
+                        else
+                        {
+                            const float* sXY = m1->ptr<float>(y + y1) + (x + x1)*2;
+                            sx = sXY[0];
+                            sy = sXY[1];
+                        }
+                        if( nninterpolation )
+                        {
+                            ix = saturate_cast<short>(sx);
+                            iy = saturate_cast<short>(sy);
+                        }
+                        else
+                        {
+                            int isx = cvRound(sx*INTER_TAB_SIZE);
+                            int isy = cvRound(sy*INTER_TAB_SIZE);
+                            ix = saturate_cast<short>(isx >> INTER_BITS);
+                            iy = saturate_cast<short>(isy >> INTER_BITS);
+                            fx = isx & (INTER_TAB_SIZE-1);
+                            fy = isy & (INTER_TAB_SIZE-1);
+                        }
+                    }
+                    int sx = ix*INTER_TAB_SIZE + fx, sy = iy*INTER_TAB_SIZE + fy;
+                    X[x1] = sx;
+                    Y[x1] = sy;
+                    minX = std::min(minX, sx); maxX = std::max(maxX, sx);
+                    minY = std::min(minY, sy); maxY = std::max(maxY, sy);
+                }
+            }
+
+            Impl::Tile tile;
+            tile.roi = Rect(x, y, bcols, brows);
+            tile.bx = minX;
+            tile.by = minY;
+            tile.packed = maxX - minX <= USHRT_MAX && maxY - minY <= USHRT_MAX;
+            tile.ofs = p->data.size();
+            // +1 pixel covers the second row/column of the bilinear neighbourhood
+            int fx0 = minX >> INTER_BITS, fy0 = minY >> INTER_BITS;
+            tile.footprint = Rect(fx0, fy0, (maxX >> INTER_BITS) - fx0 + 2, (maxY >> INTER_BITS) - fy0 + 2);
+
+            int n = bcols*brows;
+            if( tile.packed )
+            {
+                p->data.resize(tile.ofs + n*2);
+                ushort* D = &p->data[tile.ofs];
+                for( int i = 0; i < n; i++ )
+                {
+                    D[i*2] = (ushort)(bufX[i] - minX);
+                    D[i*2+1] = (ushort)(bufY[i] - minY);
+                }
+            }
+            else
+            {
+                p->data.resize(tile.ofs + n*3);
+                ushort* D = &p->data[tile.ofs];
+                for( int i = 0; i < n; i++ )
+                {
+                    D[i*3] = (ushort)(short)(bufX[i] >> INTER_BITS);
+                    D[i*3+1] = (ushort)(short)(bufY[i] >> INTER_BITS);
+                    D[i*3+2] = (ushort)((bufY[i] & (INTER_TAB_SIZE-1))*INTER_TAB_SIZE + (bufX[i] & (INTER_TAB_SIZE-1)));
+                }
+            }
+
+            // Z-order of the footprint center on the grid of source tiles
+            int cx = std::max(tile.footprint.x + tile.footprint.width/2, 0) / tileSize.width;
+            int cy = std::max(tile.footprint.y + tile.footprint.height/2, 0) / tileSize.height;
+            unsigned key = interleaveBits16(cx) | (interleaveBits16(cy) << 1);
+            order.push_back(std::make_pair(key, (int)p->tiles.size()));
+            p->tiles.push_back(tile);
+        }
+    }
+
+    std::sort(order.begin(), order.end());
+    std::vector<Impl::Tile> tiles(order.size());
+    for( size_t i = 0; i < order.size(); i++ )
+        tiles[i] = p->tiles[order[i].second];
+    p->tiles.swap(tiles);
+
+    impl = p;
+}
+
+void TiledRemap::apply(InputArray _src, OutputArray _dst, int interpolation,
+                       int borderType, const Scalar& borderValue) const
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_Assert( !empty() );
+    Mat src = _src.getMat();
+    CV_Assert( !src.empty() && src.dims <= 2 );
+    CV_Assert( src.cols < SHRT_MAX && src.rows < SHRT_MAX );
+    _dst.create( impl->size, src.type() );
+    Mat dst = _dst.getMat();
+
+    if( dst.data == src.data )
+        src = src.clone();
+
+    if( interpolation == INTER_AREA )
+        interpolation = INTER_LINEAR;
+
+    RemapNNFunc nnfunc = 0;
+    RemapFunc ifunc = 0;
+    const void* ctab = 0;
+    getRemapFunctions(interpolation, src.depth(), src.channels(), nnfunc, ifunc, ctab);
+
+    TiledRemapInvoker invoker(src, dst, *impl, borderType, borderValue, nnfunc, ifunc, ctab);
+    parallel_for_(Range(0, (int)impl->tiles.size()), invoker, dst.total()/(double)(1<<16));
+}
+
+Size TiledRemap::size() const
+{
+    return impl ? impl->size : Size();
+}
+
+bool TiledRemap::empty() const
+{
+    return !impl || impl->tiles.empty();
+}
+
+size_t TiledRemap::getByteSize() const
+{
+    if( !impl )
+        return 0;
+    return impl->data.size()*sizeof(impl->data[0]) + impl->tiles.size()*sizeof(Impl::Tile);
+}
+
+}
+
 
 namespace cv
 {
@@ -40,6 +40,7 @@
 //M*/
 
 #include "precomp.hpp"
+#include "opencv2/core/hal/intrin.hpp"
 #include <vector>
 
 /////////////////////////////////////////////////////////////////////////////////////////
@@ -229,7 +230,9 @@ public:
     int compareSegments(const Size& size, InputArray lines1, InputArray lines2, InputOutputArray _image = noArray()) CV_OVERRIDE;
 
 private:
+    // The buffers below are kept between detect() calls and reused for the images of the same size
     Mat image;
+    Mat blurred_image;
     Mat scaled_image;
     Mat_<double> angles;     // in rads
     Mat_<double> modgrad;
@@ -267,6 +270,7 @@ private:
     };
 
     std::vector<normPoint> ordered_points;
+    std::vector<int> bin_counts;
 
     struct rect
     {
@@ -279,6 +283,9 @@ private:
         double p;                 // probability of a point with angle within 'prec'
     };
 
+    std::vector<RegionPoint> reg_points;
+    std::vector<rect> candidates;   // rectangles of the regions found, validated all together
+
     LineSegmentDetectorImpl& operator= (const LineSegmentDetectorImpl&); // to quiet MSVC
 
 /**
@@ -380,13 +387,6 @@ private:
  * @return      Whether the point is aligned.
  */
     bool isAligned(int x, int y, const double& theta, const double& prec) const;
-
-public:
-    // Compare norm
-    static inline bool compare_norm( const normPoint& n1, const normPoint& n2 )
-    {
-        return (n1.norm > n2.norm);
-    }
 };
 
 /////////////////////////////////////////////////////////////////////////////////////////
@@ -452,14 +452,13 @@ void LineSegmentDetectorImpl::flsd(std::vector<Vec4f>& lines,
 
     if(SCALE != 1)
     {
-        Mat gaussian_img;
         const double sigma = (SCALE < 1)?(SIGMA_SCALE / SCALE):(SIGMA_SCALE);
         const double sprec = 3;
         const unsigned int h =  (unsigned int)(ceil(sigma * sqrt(2 * sprec * log(10.0))));
         Size ksize(1 + 2 * h, 1 + 2 * h); // kernel size
-        GaussianBlur(image, gaussian_img, ksize, sigma);
+        GaussianBlur(image, blurred_image, ksize, sigma);
         // Scale image to needed size
-        resize(gaussian_img, scaled_image, Size(), SCALE, SCALE, INTER_LINEAR_EXACT);
+        resize(blurred_image, scaled_image, Size(), SCALE, SCALE, INTER_LINEAR_EXACT);
         ll_angle(rho, N_BINS);
     }
     else
@@ -473,67 +472,193 @@ void LineSegmentDetectorImpl::flsd(std::vector<Vec4f>& lines,
 
     // // Initialize region only when needed
     // Mat region = Mat::zeros(scaled_image.size(), CV_8UC1);
-    used = Mat_<uchar>::zeros(scaled_image.size()); // zeros = NOTUSED
-    std::vector<RegionPoint> reg;
+    used.create(scaled_image.size());
+    used.setTo(NOTUSED);
+    candidates.clear();
 
-    // Search for line segments
+    // Search for line segments. The regions are grown serially: every region marks its pixels
+    // as used, so the result depends on the order of the seeds
     for(size_t i = 0, points_size = ordered_points.size(); i < points_size; ++i)
     {
         const Point2i& point = ordered_points[i].p;
         if((used.at<uchar>(point) == NOTUSED) && (angles.at<double>(point) != NOTDEF))
         {
             double reg_angle;
-            region_grow(ordered_points[i].p, reg, reg_angle, prec);
+            region_grow(ordered_points[i].p, reg_points, reg_angle, prec);
 
             // Ignore small regions
-            if(reg.size() < min_reg_size) { continue; }
+            if(reg_points.size() < min_reg_size) { continue; }
 
             // Construct rectangular approximation for the region
             rect rec;
-            region2rect(reg, reg_angle, prec, p, rec);
+            region2rect(reg_points, reg_angle, prec, p, rec);
 
-            double log_nfa = -1;
             if(doRefine > LSD_REFINE_NONE)
             {
                 // At least REFINE_STANDARD lvl.
-                if(!refine(reg, reg_angle, prec, p, rec, DENSITY_TH)) { continue; }
+                if(!refine(reg_points, reg_angle, prec, p, rec, DENSITY_TH)) { continue; }
+            }
+            candidates.push_back(rec);
+        }
+    }
+
+    // The NFA of a rectangle depends only on the gradient angles, so the candidates are
+    // validated in parallel; the lines are stored in the order they were found
+    std::vector<double> log_nfas(candidates.size(), -1);
+    if(doRefine >= LSD_REFINE_ADV)
+    {
+        parallel_for_(Range(0, (int)candidates.size()), [&](const Range& range)
+        {
+            for(int i = range.start; i < range.end; ++i)
+                log_nfas[i] = rect_improve(candidates[i]);
+        });
+    }
+
+    for(size_t i = 0; i < candidates.size(); ++i)
+    {
+        rect& rec = candidates[i];
+        double log_nfa = log_nfas[i];
+        if(doRefine >= LSD_REFINE_ADV && log_nfa <= LOG_EPS) { continue; }
+
+        // Found new line
+
+        // Add the offset
+        rec.x1 += 0.5; rec.y1 += 0.5;
+        rec.x2 += 0.5; rec.y2 += 0.5;
+
+        // scale the result values if a sub-sampling was performed
+        if(SCALE != 1)
+        {
+            rec.x1 /= SCALE; rec.y1 /= SCALE;
+            rec.x2 /= SCALE; rec.y2 /= SCALE;
+            rec.width /= SCALE;
+        }
+
+        //Store the relevant data
+        lines.push_back(Vec4f(float(rec.x1), float(rec.y1), float(rec.x2), float(rec.y2)));
+        if(w_needed) widths.push_back(rec.width);
+        if(p_needed) precisions.push_back(rec.p);
+        if(n_needed && doRefine >= LSD_REFINE_ADV) nfas.push_back(log_nfa);
+    }
+}
 
-                if(doRefine >= LSD_REFINE_ADV)
+namespace {
+
+// Computes the gradient norms and angles of the rows [range.start, range.end) and the maximal norm
+// of every stripe of rows
+class LSDGradientInvoker : public ParallelLoopBody
+{
+public:
+    LSDGradientInvoker(const Mat& _src, Mat_<double>& _angles, Mat_<double>& _modgrad,
+                       double _threshold, int _nstripes, std::vector<double>& _maxGrad)
+        : src(_src), angles(_angles), modgrad(_modgrad), threshold(_threshold),
+          nstripes(_nstripes), maxGrad(_maxGrad)
+    {
+    }
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        const int width = src.cols - 1, height = src.rows - 1;
+        AutoBuffer<float> _buf(width*3 + 3);
+        float *gxbuf = _buf.data(), *mgybuf = gxbuf + width + 1, *angbuf = mgybuf + width + 1;
+        AutoBuffer<int> _n2buf(width + 1);
+        int* n2buf = _n2buf.data();
+
+        for(int stripe = range.start; stripe < range.end; ++stripe)
+        {
+            double max_grad = -1;
+            int y0 = height*stripe/nstripes, y1 = height*(stripe + 1)/nstripes;
+            for(int y = y0; y < y1; ++y)
+            {
+                const uchar* row = src.ptr<uchar>(y);
+                const uchar* next_row = src.ptr<uchar>(y + 1);
+                double* angles_row = angles.ptr<double>(y);
+                double* modgrad_row = modgrad.ptr<double>(y);
+
+                int x = 0;
+#if CV_SIMD
+                const int vlanes = v_int16::nlanes;
+                for(; x <= width - vlanes; x += vlanes)
                 {
-                    // Compute NFA
-                    log_nfa = rect_improve(rec);
-                    if(log_nfa <= LOG_EPS) { continue; }
+                    v_int16 a = v_reinterpret_as_s16(vx_load_expand(row + x));
+                    v_int16 b = v_reinterpret_as_s16(vx_load_expand(row + x + 1));
+                    v_int16 c = v_reinterpret_as_s16(vx_load_expand(next_row + x));
+                    v_int16 d = v_reinterpret_as_s16(vx_load_expand(next_row + x + 1));
+                    v_int16 DA = d - a, BC = b - c;
+                    v_int16 gx = DA + BC, mgy = BC - DA;
+                    v_int32 gx0, gx1, mgy0, mgy1;
+                    v_expand(gx, gx0, gx1);
+                    v_expand(mgy, mgy0, mgy1);
+                    v_store(n2buf + x, gx0*gx0 + mgy0*mgy0);
+                    v_store(n2buf + x + vlanes/2, gx1*gx1 + mgy1*mgy1);
+                    v_store(gxbuf + x, v_cvt_f32(gx0));
+                    v_store(gxbuf + x + vlanes/2, v_cvt_f32(gx1));
+                    v_store(mgybuf + x, v_cvt_f32(mgy0));
+                    v_store(mgybuf + x + vlanes/2, v_cvt_f32(mgy1));
+                }
+#endif
+                for(; x < width; ++x)
+                {
+                    int DA = next_row[x + 1] - row[x];
+                    int BC = row[x + 1] - next_row[x];
+                    int gx = DA + BC;    // gradient x component
+                    int gy = DA - BC;    // gradient y component
+                    n2buf[x] = gx * gx + gy * gy;
+                    gxbuf[x] = float(gx);
+                    mgybuf[x] = float(-gy);
                 }
-            }
-            // Found new line
 
-            // Add the offset
-            rec.x1 += 0.5; rec.y1 += 0.5;
-            rec.x2 += 0.5; rec.y2 += 0.5;
+                // gradient angles, the same as fastAtan2(gx, -gy)
+                hal::fastAtan32f(gxbuf, mgybuf, angbuf, width, true);
 
-            // scale the result values if a sub-sampling was performed
-            if(SCALE != 1)
-            {
-                rec.x1 /= SCALE; rec.y1 /= SCALE;
-                rec.x2 /= SCALE; rec.y2 /= SCALE;
-                rec.width /= SCALE;
-            }
+                x = 0;
+#if CV_SIMD_64F
+                const int dlanes = v_float64::nlanes;
+                for(; x <= width - dlanes*2; x += dlanes*2)
+                {
+                    v_int32 n2 = vx_load(n2buf + x);
+                    v_store(modgrad_row + x, v_sqrt(v_cvt_f64(n2)*vx_setall_f64(0.25)));
+                    v_store(modgrad_row + x + dlanes, v_sqrt(v_cvt_f64_high(n2)*vx_setall_f64(0.25)));
+                }
+#endif
+                for(; x < width; ++x)
+                    modgrad_row[x] = std::sqrt(n2buf[x] / 4.0); // gradient norm
 
-            //Store the relevant data
-            lines.push_back(Vec4f(float(rec.x1), float(rec.y1), float(rec.x2), float(rec.y2)));
-            if(w_needed) widths.push_back(rec.width);
-            if(p_needed) precisions.push_back(rec.p);
-            if(n_needed && doRefine >= LSD_REFINE_ADV) nfas.push_back(log_nfa);
+                for(x = 0; x < width; ++x)
+                {
+                    double norm = modgrad_row[x];
+                    if (norm <= threshold)  // norm too small, gradient no defined
+                    {
+                        angles_row[x] = NOTDEF;
+                    }
+                    else
+                    {
+                        angles_row[x] = angbuf[x] * DEG_TO_RADS;  // gradient angle computation
+                        if (norm > max_grad) { max_grad = norm; }
+                    }
+                }
+            }
+            maxGrad[stripe] = max_grad;
         }
     }
-}
+
+private:
+    const Mat& src;
+    Mat_<double>& angles;
+    Mat_<double>& modgrad;
+    double threshold;
+    int nstripes;
+    std::vector<double>& maxGrad;
+};
+
+} // namespace
 
 void LineSegmentDetectorImpl::ll_angle(const double& threshold,
                                    const unsigned int& n_bins)
 {
     //Initialize data
-    angles = Mat_<double>(scaled_image.size());
-    modgrad = Mat_<double>(scaled_image.size());
+    angles.create(scaled_image.size());
+    modgrad.create(scaled_image.size());
 
     img_width = scaled_image.cols;
     img_height = scaled_image.rows;
@@ -543,38 +668,31 @@ void LineSegmentDetectorImpl::ll_angle(const double& threshold,
     angles.col(img_width - 1).setTo(NOTDEF);
 
     // Computing gradient for remaining pixels
-    double max_grad = -1;
+    int nstripes = std::max(std::min(img_height - 1, getNumThreads()*4), 1);
+    std::vector<double> stripe_max_grad(nstripes, -1);
+    parallel_for_(Range(0, nstripes), LSDGradientInvoker(scaled_image, angles, modgrad, threshold,
+                                                         nstripes, stripe_max_grad));
+    double max_grad = *std::max_element(stripe_max_grad.begin(), stripe_max_grad.end());
+
+    // Compute histogram of gradient values
+    double bin_coef = (max_grad > 0) ? double(n_bins - 1) / max_grad : 0; // If all image is smooth, max_grad <= 0
+    bin_counts.assign(n_bins + 1, 0);
     for(int y = 0; y < img_height - 1; ++y)
     {
-        const uchar* scaled_image_row = scaled_image.ptr<uchar>(y);
-        const uchar* next_scaled_image_row = scaled_image.ptr<uchar>(y+1);
-        double* angles_row = angles.ptr<double>(y);
-        double* modgrad_row = modgrad.ptr<double>(y);
-        for(int x = 0; x < img_width-1; ++x)
-        {
-            int DA = next_scaled_image_row[x + 1] - scaled_image_row[x];
-            int BC = scaled_image_row[x + 1] - next_scaled_image_row[x];
-            int gx = DA + BC;    // gradient x component
-            int gy = DA - BC;    // gradient y component
-            double norm = std::sqrt((gx * gx + gy * gy) / 4.0); // gradient norm
-
-            modgrad_row[x] = norm;    // store gradient
-
-            if (norm <= threshold)  // norm too small, gradient no defined
-            {
-                angles_row[x] = NOTDEF;
-            }
-            else
-            {
-                angles_row[x] = fastAtan2(float(gx), float(-gy)) * DEG_TO_RADS;  // gradient angle computation
-                if (norm > max_grad) { max_grad = norm; }
-            }
-
-        }
+        const double* modgrad_row = modgrad.ptr<double>(y);
+        for(int x = 0; x < img_width - 1; ++x)
+            bin_counts[int(modgrad_row[x] * bin_coef)]++;
     }
 
-    // Compute histogram of gradient values
-    double bin_coef = (max_grad > 0) ? double(n_bins - 1) / max_grad : 0; // If all image is smooth, max_grad <= 0
+    // Bucket sort: the points of the larger norms go first, the points of the same bin in the raster order
+    int start = 0;
+    for(int i = (int)n_bins; i >= 0; --i)
+    {
+        int count = bin_counts[i];
+        bin_counts[i] = start;
+        start += count;
+    }
+    ordered_points.resize(start);
     for(int y = 0; y < img_height - 1; ++y)
     {
         const double* modgrad_row = modgrad.ptr<double>(y);
@@ -584,12 +702,9 @@ void LineSegmentDetectorImpl::ll_angle(const double& threshold,
             int i = int(modgrad_row[x] * bin_coef);
             _point.p = Point(x, y);
             _point.norm = i;
-            ordered_points.push_back(_point);
+            ordered_points[bin_counts[i]++] = _point;
         }
     }
-
-    // Sort
-    std::sort(ordered_points.begin(), ordered_points.end(), compare_norm);
 }
 
 void LineSegmentDetectorImpl::region_grow(const Point2i& s, std::vector<RegionPoint>& reg,
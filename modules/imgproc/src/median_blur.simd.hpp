@@ -491,6 +491,205 @@ medianBlur_8u_Om( const Mat& _src, Mat& _dst, int m )
 }
 
 
+/**
+ * Median filter with large apertures for 16-bit images (Huang's sliding window).
+ *
+ * The window histogram has two tiers: 256 coarse buckets for the high bytes and 65536 fine bins.
+ * The window moves in a zigzag over a band of rows, so every step adds and removes a single
+ * row or column of the aperture, and the median is tracked incrementally from its previous
+ * position instead of being searched from scratch. The source is expected to be padded by ksize/2
+ * pixels on the left and on the right; the rows outside the image are replicated.
+ */
+class MedianBlur16uInvoker : public ParallelLoopBody
+{
+public:
+    MedianBlur16uInvoker(const Mat& _src, Mat& _dst, int _ksize, int _bandHeight)
+        : src(_src), dst(_dst), ksize(_ksize), bandHeight(_bandHeight)
+    {
+    }
+
+    // Window histogram of one channel together with the current median position
+    struct Hist
+    {
+        ushort* coarse;
+        ushort* fine;
+        int cb;         // coarse bucket of the median
+        int cbelow;     // number of pixels in the buckets below cb
+        int fv;         // position of the median within the bucket cb
+        int fbelow;     // number of pixels of the bucket cb below fv
+
+        void reset()
+        {
+            cb = cbelow = fv = fbelow = 0;
+        }
+
+        inline void add(int v)
+        {
+            coarse[v >> 8]++;
+            fine[v]++;
+            if( (v >> 8) < cb )
+                cbelow++;
+            else if( (v >> 8) == cb && (v & 255) < fv )
+                fbelow++;
+        }
+
+        inline void remove(int v)
+        {
+            coarse[v >> 8]--;
+            fine[v]--;
+            if( (v >> 8) < cb )
+                cbelow--;
+            else if( (v >> 8) == cb && (v & 255) < fv )
+                fbelow--;
+        }
+
+        // returns the value with rank t (0-based) in the window
+        inline int median(int t)
+        {
+            int cb0 = cb;
+            while( cbelow > t )
+                cbelow -= coarse[--cb];
+            while( cbelow + coarse[cb] <= t )
+                cbelow += coarse[cb++];
+            const ushort* f = fine + (cb << 8);
+            if( cb != cb0 )
+                fv = fbelow = 0;
+            int r = t - cbelow;
+            while( fbelow > r )
+                fbelow -= f[--fv];
+            while( fbelow + f[fv] <= r )
+                fbelow += f[fv++];
+            return (cb << 8) + fv;
+        }
+    };
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        const int cn = src.channels(), r = ksize/2, width = dst.cols, height = dst.rows;
+        const int t = ksize*ksize/2;
+        std::vector<ushort> buf((256 + 65536)*cn, (ushort)0);
+        Hist h[4];
+        for( int c = 0; c < cn; c++ )
+        {
+            h[c].coarse = &buf[(256 + 65536)*c];
+            h[c].fine = h[c].coarse + 256;
+        }
+        std::vector<const ushort*> rows(ksize);
+
+        for( int band = range.start; band < range.end; band++ )
+        {
+            int y0 = band*bandHeight, y1 = std::min(y0 + bandHeight, height);
+            for( int k = 0; k < ksize; k++ )
+                rows[k] = src.ptr<ushort>(std::min(std::max(y0 - r + k, 0), height - 1));
+
+            // the window covers the columns [x, x + ksize) of the padded source
+            int x = 0;
+            for( int c = 0; c < cn; c++ )
+            {
+                h[c].reset();
+                for( int k = 0; k < ksize; k++ )
+                    for( int j = 0; j < ksize; j++ )
+                        h[c].add(rows[k][j*cn + c]);
+            }
+
+            for( int y = y0; y < y1; y++ )
+            {
+                if( y > y0 )
+                {
+                    // move the window one row down
+                    const ushort* top = rows[0];
+                    for( int k = 0; k < ksize - 1; k++ )
+                        rows[k] = rows[k + 1];
+                    const ushort* bottom = rows[ksize - 1] = src.ptr<ushort>(std::min(y + r, height - 1));
+                    for( int j = x*cn; j < (x + ksize)*cn; j += cn )
+                        for( int c = 0; c < cn; c++ )
+                        {
+                            h[c].remove(top[j + c]);
+                            h[c].add(bottom[j + c]);
+                        }
+                }
+
+                ushort* D = dst.ptr<ushort>(y);
+                const int dir = (y - y0) % 2 == 0 ? 1 : -1;
+                for( ;; )
+                {
+                    for( int c = 0; c < cn; c++ )
+                        D[x*cn + c] = (ushort)h[c].median(t);
+
+                    if( (dir > 0 && x == width - 1) || (dir < 0 && x == 0) )
+                        break;
+
+                    // move the window one column to the left or to the right
+                    int jout = (dir > 0 ? x : x + ksize - 1)*cn;
+                    int jin = (dir > 0 ? x + ksize : x - 1)*cn;
+                    for( int k = 0; k < ksize; k++ )
+                        for( int c = 0; c < cn; c++ )
+                        {
+                            h[c].remove(rows[k][jout + c]);
+                            h[c].add(rows[k][jin + c]);
+                        }
+                    x += dir;
+                }
+            }
+
+            // clear the histograms for the next band
+            for( int c = 0; c < cn; c++ )
+                for( int k = 0; k < ksize; k++ )
+                    for( int j = x; j < x + ksize; j++ )
+                        h[c].remove(rows[k][j*cn + c]);
+        }
+    }
+
+private:
+    const Mat& src;
+    Mat& dst;
+    int ksize;
+    int bandHeight;
+};
+
+static void
+medianBlur_16u_Om( const Mat& _src, Mat& _dst, int ksize )
+{
+    CV_INSTRUMENT_REGION();
+
+    CV_CheckLE(ksize, 255, "Too big aperture for the 16-bit median filter");
+    CV_Assert(_src.channels() <= 4);
+    // every band starts with the full aperture, so it should be noticeably higher than the aperture
+    int bandHeight = std::max(ksize*4, 32);
+    int nbands = (_dst.rows + bandHeight - 1)/bandHeight;
+    parallel_for_(Range(0, nbands), MedianBlur16uInvoker(_src, _dst, ksize, bandHeight));
+}
+
+// Both histogram-based 8-bit filters process the columns independently,
+// so the image is split into vertical stripes which are filtered in parallel
+class MedianBlur8uInvoker : public ParallelLoopBody
+{
+public:
+    MedianBlur8uInvoker(const Mat& _src, Mat& _dst, int _ksize, int _stripeWidth, bool _useO1)
+        : src(_src), dst(_dst), ksize(_ksize), stripeWidth(_stripeWidth), useO1(_useO1)
+    {
+    }
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        int x0 = range.start*stripeWidth, x1 = std::min(range.end*stripeWidth, dst.cols);
+        Mat srcStripe = src.colRange(x0, x1 + ksize - 1);
+        Mat dstStripe = dst.colRange(x0, x1);
+        if( useO1 )
+            medianBlur_8u_O1(srcStripe, dstStripe, ksize);
+        else
+            medianBlur_8u_Om(srcStripe, dstStripe, ksize);
+    }
+
+private:
+    const Mat& src;
+    Mat& dst;
+    int ksize;
+    int stripeWidth;
+    bool useO1;
+};
+
+
 namespace {
 
 struct MinMax8u
@@ -877,14 +1076,21 @@ void medianBlur(const Mat& src0, /*const*/ Mat& dst, int ksize)
         cv::copyMakeBorder( src0, src, 0, 0, ksize/2, ksize/2, BORDER_REPLICATE|BORDER_ISOLATED);
 
         int cn = src0.channels();
-        CV_Assert( src.depth() == CV_8U && (cn == 1 || cn == 3 || cn == 4) );
+        CV_Assert( (src.depth() == CV_8U || src.depth() == CV_16U) && (cn == 1 || cn == 3 || cn == 4) );
+
+        if( src.depth() == CV_16U )
+        {
+            medianBlur_16u_Om( src, dst, ksize );
+            return;
+        }
 
         double img_size_mp = (double)(src0.total())/(1 << 20);
-        if( ksize <= 3 + (img_size_mp < 1 ? 12 : img_size_mp < 4 ? 6 : 2)*
-            (CV_SIMD ? 1 : 3))
-            medianBlur_8u_Om( src, dst, ksize );
-        else
-            medianBlur_8u_O1( src, dst, ksize );
+        bool useO1 = ksize > 3 + (img_size_mp < 1 ? 12 : img_size_mp < 4 ? 6 : 2)*
+            (CV_SIMD ? 1 : 3);
+        // the stripes are wide enough to amortize the initialization of the histograms
+        int stripeWidth = std::max(ksize*8, 128);
+        int nstripes = (dst.cols + stripeWidth - 1)/stripeWidth;
+        parallel_for_(Range(0, nstripes), MedianBlur8uInvoker(src, dst, ksize, stripeWidth, useO1));
     }
 }
 
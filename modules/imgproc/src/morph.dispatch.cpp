@@ -444,9 +444,16 @@ static void ocvMorph(int op, int src_type, int dst_type,
     Mat kernel(Size(kernel_width, kernel_height), kernel_type, kernel_data, kernel_step);
     Point anchor(anchor_x, anchor_y);
     Vec<double, 4> borderVal(borderValue);
-    Ptr<FilterEngine> f = createMorphologyFilter(op, src_type, kernel, anchor, borderType, borderType, borderVal);
     Mat src(Size(width, height), src_type, src_data, src_step);
     Mat dst(Size(width, height), dst_type, dst_data, dst_step);
+
+    // the large kernels, if the pixels outside of the image are not used
+    if (roi_x == 0 && roi_y == 0 && roi_width == width && roi_height == height &&
+        (iterations == 1 || (roi_x2 == 0 && roi_y2 == 0 && roi_width2 == width && roi_height2 == height)) &&
+        src_type == dst_type && morphLargeKernel(op, src, dst, kernel, anchor, iterations, borderType, borderVal))
+        return;
+
+    Ptr<FilterEngine> f = createMorphologyFilter(op, src_type, kernel, anchor, borderType, borderType, borderVal);
     {
         Point ofs(roi_x, roi_y);
         Size wsz(roi_width, roi_height);
@@ -1154,6 +1161,19 @@ static bool ipp_morphologyEx(int op, InputArray _src, OutputArray _dst,
 #endif
 #endif
 
+// true if the HAL replaces the erosion or dilation, the single pass implementation must not bypass it then
+static bool isHalMorphImplemented(int op, const Mat& src, const Mat& kernel, Point anchor,
+                                  int borderType, const Scalar& borderValue, int iterations)
+{
+    cvhalFilter2D* ctx;
+    if (cv_hal_morphInit(&ctx, op, src.type(), src.type(), src.cols, src.rows,
+                         kernel.type(), kernel.data, kernel.step, kernel.cols, kernel.rows,
+                         anchor.x, anchor.y, borderType, borderValue.val, iterations, false, false) != CV_HAL_ERROR_OK)
+        return false;
+    cv_hal_morphFree(ctx);
+    return true;
+}
+
 void morphologyEx( InputArray _src, OutputArray _dst, int op,
                        InputArray _kernel, Point anchor, int iterations,
                        int borderType, const Scalar& borderValue )
@@ -1185,6 +1205,29 @@ void morphologyEx( InputArray _src, OutputArray _dst, int op,
     //CV_IPP_RUN_FAST(ipp_morphologyEx(op, src, dst, kernel, anchor, iterations, borderType, borderValue));
 #endif
 
+    // opening, closing and gradient in a single pass over the image
+    if ((op == MORPH_OPEN || op == MORPH_CLOSE || op == MORPH_GRADIENT || op == MORPH_TOPHAT || op == MORPH_BLACKHAT) &&
+        iterations > 0 && (!src.isSubmatrix() || (borderType & BORDER_ISOLATED)))
+    {
+        Mat k = kernel;
+        Point a = normalizeAnchor(anchor, kernel.size());
+        if (iterations > 1 && countNonZero(kernel) == kernel.rows*kernel.cols)
+        {
+            // the same as in morphOp()
+            a = Point(a.x*iterations, a.y*iterations);
+            k = getStructuringElement(MORPH_RECT,
+                                      Size(kernel.cols + (iterations-1)*(kernel.cols-1),
+                                           kernel.rows + (iterations-1)*(kernel.rows-1)), a);
+            iterations = 1;
+        }
+        int bt = borderType & ~BORDER_ISOLATED;
+        if (iterations == 1 &&
+            !isHalMorphImplemented(MORPH_ERODE, src, k, a, bt, borderValue, 1) &&
+            !isHalMorphImplemented(MORPH_DILATE, src, k, a, bt, borderValue, 1) &&
+            morphLargeKernel(op, src, dst, k, a, 1, bt, borderValue))
+            return;
+    }
+
     switch( op )
     {
     case MORPH_ERODE:
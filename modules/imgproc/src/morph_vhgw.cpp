@@ -0,0 +1,442 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+#include "opencv2/core/hal/intrin.hpp"
+
+/*
+ * Erosion and dilation with the large structuring elements.
+ *
+ * The kernel is represented as a union of rectangles (a rectangle, a cross and an ellipse are such
+ * unions), the results of the rectangles are combined by min/max. Every rectangle is separable:
+ * the vertical pass uses the van Herk/Gil-Werman algorithm (M. van Herk, "A fast algorithm for
+ * local minimum and maximum filters on rectangular and octagonal kernels", 1992; J. Gil, M. Werman,
+ * "Computing 2-D min, median, and max filters", 1993), i.e. 3 min/max operations per pixel for any
+ * kernel height, vectorized along the rows. The van Herk/Gil-Werman recurrences run sequentially
+ * along the row, so the horizontal pass uses log2(width) + 1 vectorized min/max of the shifted rows
+ * instead.
+ *
+ * The image is processed by the independent stripes of rows. The opening, closing and
+ * morphological gradient are computed stripe by stripe without the full size intermediate image.
+ */
+
+namespace cv
+{
+
+namespace
+{
+
+// Processes the beginning of the rows, returns the number of the processed elements
+template<typename T> struct MorphRowVec
+{
+    static int minmax(bool, const T*, const T*, T*, int) { return 0; }
+};
+
+#if CV_SIMD
+template<typename T, typename VT> struct MorphRowVecImpl
+{
+    static int minmax(bool isMax, const T* a, const T* b, T* d, int n)
+    {
+        const int vlanes = VT::nlanes;
+        int x = 0;
+        if (isMax)
+        {
+            for (; x <= n - vlanes; x += vlanes)
+                v_store(d + x, v_max(vx_load(a + x), vx_load(b + x)));
+        }
+        else
+        {
+            for (; x <= n - vlanes; x += vlanes)
+                v_store(d + x, v_min(vx_load(a + x), vx_load(b + x)));
+        }
+        return x;
+    }
+};
+
+template<> struct MorphRowVec<uchar> : MorphRowVecImpl<uchar, v_uint8> {};
+template<> struct MorphRowVec<ushort> : MorphRowVecImpl<ushort, v_uint16> {};
+template<> struct MorphRowVec<short> : MorphRowVecImpl<short, v_int16> {};
+template<> struct MorphRowVec<float> : MorphRowVecImpl<float, v_float32> {};
+#if CV_SIMD_64F
+template<> struct MorphRowVec<double> : MorphRowVecImpl<double, v_float64> {};
+#endif
+#endif
+
+// d = min(a, b) or max(a, b) elementwise; d may be the same as a, b may follow a in the same buffer
+template<typename T>
+static void minmaxRow(bool isMax, const T* a, const T* b, T* d, int n)
+{
+    int x = MorphRowVec<T>::minmax(isMax, a, b, d, n);
+    if (isMax)
+    {
+        for (; x < n; x++)
+            d[x] = std::max(a[x], b[x]);
+    }
+    else
+    {
+        for (; x < n; x++)
+            d[x] = std::min(a[x], b[x]);
+    }
+}
+
+// Represents the kernel as a union of rectangles. Every row of the kernel must contain a single run
+// of the non-zero elements, and the rows containing the run of any row must go in succession
+static bool decomposeMorphKernel(const Mat& kernel, std::vector<Rect>& rects)
+{
+    if (kernel.type() != CV_8U)
+        return false;
+
+    const int rows = kernel.rows, cols = kernel.cols;
+    std::vector<int> j1(rows), j2(rows);
+    for (int i = 0; i < rows; i++)
+    {
+        const uchar* k = kernel.ptr<uchar>(i);
+        int j = 0;
+        for (; j < cols && !k[j]; j++)
+            ;
+        j1[i] = j;
+        for (; j < cols && k[j]; j++)
+            ;
+        j2[i] = j;
+        for (; j < cols && !k[j]; j++)
+            ;
+        if (j < cols)
+            return false;
+    }
+
+    rects.clear();
+    for (int i = 0; i < rows; i++)
+    {
+        if (j1[i] == j2[i])
+            continue;
+        int i0 = i, i1 = i + 1;
+        for (; i0 > 0 && j1[i0 - 1] <= j1[i] && j2[i0 - 1] >= j2[i]; i0--)
+            ;
+        for (; i1 < rows && j1[i1] <= j1[i] && j2[i1] >= j2[i]; i1++)
+            ;
+        for (int k = 0; k < rows; k++)
+            if ((k < i0 || k >= i1) && j1[k] <= j1[i] && j2[k] >= j2[i])
+                return false;
+
+        Rect r(j1[i], i0, j2[i] - j1[i], i1 - i0);
+        bool covered = false;
+        for (size_t k = 0; k < rects.size() && !covered; k++)
+            covered = (rects[k] & r) == r;
+        if (covered)
+            continue;
+        // drop the rectangles covered by the new one
+        size_t n = 0;
+        for (size_t k = 0; k < rects.size(); k++)
+            if ((rects[k] & r) != rects[k])
+                rects[n++] = rects[k];
+        rects.resize(n);
+        rects.push_back(r);
+    }
+    return !rects.empty();
+}
+
+// The number of the row operations per pixel, the same as for the separable or 2D morphology filters
+static int morphRectCost(const Rect& r)
+{
+    int cost = 1;
+    if (r.width > 1)
+    {
+        for (int s = 1; s*2 <= r.width; s *= 2)
+            cost++;
+        cost++;
+    }
+    if (r.height > 1)
+        cost += 3;
+    return cost;
+}
+
+template<typename T>
+class MorphStripeInvoker : public ParallelLoopBody
+{
+public:
+    MorphStripeInvoker(const Mat& _src, Mat& _dst, int _op, const std::vector<Rect>& _rects, Size _ksize,
+                       Point _anchor, int _borderType, const Scalar& _borderValue, int _stripeHeight)
+        : src(_src), dst(_dst), op(_op), rects(_rects), ksize(_ksize), anchor(_anchor),
+          borderType(_borderType), stripeHeight(_stripeHeight)
+    {
+        cn = src.channels();
+        width = src.cols;
+        height = src.rows;
+        padWidth = width + ksize.width - 1;
+
+        // the source pixel of every pixel of the padded rows, -1 for the constant border
+        xofs.resize(padWidth);
+        for (int x = 0; x < padWidth; x++)
+            xofs[x] = borderInterpolate(x - anchor.x, width, borderType);
+
+        // the rows of the constant border; the default one is neutral for min/max,
+        // so the floating-point images get the infinities and their own infinities are kept at the border
+        bool isDefault = _borderValue == morphologyDefaultBorderValue();
+        const T maxVal = std::numeric_limits<T>::is_integer ? std::numeric_limits<T>::max() : std::numeric_limits<T>::infinity();
+        const T minVal = std::numeric_limits<T>::is_integer ? std::numeric_limits<T>::min() : -std::numeric_limits<T>::infinity();
+        T erodeVal[4], dilateVal[4];
+        for (int c = 0; c < cn; c++)
+        {
+            erodeVal[c] = isDefault ? maxVal : saturate_cast<T>(_borderValue[c]);
+            dilateVal[c] = isDefault ? minVal : saturate_cast<T>(_borderValue[c]);
+        }
+        erodeBorder.resize((size_t)padWidth*cn);
+        dilateBorder.resize((size_t)padWidth*cn);
+        for (int x = 0; x < padWidth; x++)
+            for (int c = 0; c < cn; c++)
+            {
+                erodeBorder[x*cn + c] = erodeVal[c];
+                dilateBorder[x*cn + c] = dilateVal[c];
+            }
+    }
+
+    virtual void operator()(const Range& range) const CV_OVERRIDE
+    {
+        for (int stripe = range.start; stripe < range.end; stripe++)
+        {
+            int y0 = stripe*stripeHeight, y1 = std::min(y0 + stripeHeight, height);
+            if (op == MORPH_ERODE || op == MORPH_DILATE)
+            {
+                morphRows(op == MORPH_DILATE, src, 0, y0, y1, dst, 0);
+            }
+            else if (op == MORPH_GRADIENT)
+            {
+                Mat temp(y1 - y0, width, src.type());
+                morphRows(true, src, 0, y0, y1, dst, 0);
+                morphRows(false, src, 0, y0, y1, temp, y0);
+                Mat d = dst.rowRange(y0, y1);
+                subtract(d, temp, d);
+            }
+            else
+            {
+                // the rows of the intermediate image the second pass needs
+                int ymin = height, ymax = -1;
+                for (int y = y0 - anchor.y; y < y1 + ksize.height - 1 - anchor.y; y++)
+                {
+                    int r = borderInterpolate(y, height, borderType);
+                    if (r >= 0)
+                    {
+                        ymin = std::min(ymin, r);
+                        ymax = std::max(ymax, r);
+                    }
+                }
+                Mat temp;
+                if (ymax >= ymin)
+                {
+                    temp.create(ymax - ymin + 1, width, src.type());
+                    morphRows(op == MORPH_CLOSE, src, 0, ymin, ymax + 1, temp, ymin);
+                }
+                morphRows(op == MORPH_OPEN, temp, ymin, y0, y1, dst, 0);
+            }
+        }
+    }
+
+private:
+    // Computes the rows [y0, y1) of the erosion or dilation. The source row y is img.row(y - imgOfs),
+    // the destination row y is out.row(y - outOfs)
+    void morphRows(bool isMax, const Mat& img, int imgOfs, int y0, int y1, Mat& out, int outOfs) const
+    {
+        const int n = y1 - y0, nrows = n + ksize.height - 1;
+        const int rowLen = width*cn, padLen = padWidth*cn;
+        const T* borderRow = isMax ? &dilateBorder[0] : &erodeBorder[0];
+
+        AutoBuffer<T> _buf((size_t)nrows*padLen + (size_t)nrows*rowLen*3 + padLen);
+        T* pbuf = _buf.data();
+        T* hbuf = pbuf + (size_t)nrows*padLen;
+        T* gbuf = hbuf + (size_t)nrows*rowLen;
+        T* sbuf = gbuf + (size_t)nrows*rowLen;
+        T* tmp = sbuf + (size_t)nrows*rowLen;
+        AutoBuffer<const T*> _rows(nrows*4);
+        const T** prows = _rows.data();
+        const T** hrows = prows + nrows;
+        const T** grows = hrows + nrows;
+        const T** srows = grows + nrows;
+
+        // the source rows with the left and right borders
+        for (int i = 0; i < nrows; i++)
+        {
+            int r = borderInterpolate(y0 - anchor.y + i, height, borderType);
+            if (r < 0)
+            {
+                prows[i] = borderRow;
+                continue;
+            }
+            const T* s = img.ptr<T>(r - imgOfs);
+            T* p = pbuf + (size_t)i*padLen;
+            for (int x = 0; x < padWidth; x++)
+            {
+                if (x == anchor.x)
+                {
+                    memcpy(p + x*cn, s, rowLen*sizeof(T));
+                    x += width - 1;
+                    continue;
+                }
+                int sx = xofs[x];
+                for (int c = 0; c < cn; c++)
+                    p[x*cn + c] = sx >= 0 ? s[sx*cn + c] : borderRow[c];
+            }
+            prows[i] = p;
+        }
+
+        for (size_t k = 0; k < rects.size(); k++)
+        {
+            const Rect& rect = rects[k];
+            const int nr = n + rect.height - 1;
+
+            // horizontal pass: min/max of the runs of 1, 2, 4, ... pixels
+            for (int i = 0; i < nr; i++)
+            {
+                const T* p = prows[rect.y + i];
+                if (p == borderRow)
+                {
+                    hrows[i] = borderRow;
+                    continue;
+                }
+                p += rect.x*cn;
+                if (rect.width == 1)
+                {
+                    hrows[i] = p;
+                    continue;
+                }
+                int len = (width + rect.width - 2)*cn, s = 2;
+                minmaxRow(isMax, p, p + cn, tmp, len);
+                for (; s*2 <= rect.width; s *= 2)
+                {
+                    len -= s*cn;
+                    minmaxRow(isMax, tmp, tmp + s*cn, tmp, len);
+                }
+                T* h = hbuf + (size_t)i*rowLen;
+                minmaxRow(isMax, tmp, tmp + (rect.width - s)*cn, h, rowLen);
+                hrows[i] = h;
+            }
+
+            // vertical pass: prefix (g) and suffix (s) min/max within the blocks of rect.height rows
+            const int kh = rect.height;
+            if (kh > 1)
+            {
+                for (int b = 0; b < nr; b += kh)
+                {
+                    int e = std::min(b + kh, nr);
+                    grows[b] = hrows[b];
+                    for (int i = b + 1; i < e; i++)
+                    {
+                        T* g = gbuf + (size_t)i*rowLen;
+                        minmaxRow(isMax, grows[i - 1], hrows[i], g, rowLen);
+                        grows[i] = g;
+                    }
+                    srows[e - 1] = hrows[e - 1];
+                    for (int i = e - 2; i >= b; i--)
+                    {
+                        T* s = sbuf + (size_t)i*rowLen;
+                        minmaxRow(isMax, srows[i + 1], hrows[i], s, rowLen);
+                        srows[i] = s;
+                    }
+                }
+            }
+
+            for (int y = 0; y < n; y++)
+            {
+                T* d = out.ptr<T>(y0 + y - outOfs);
+                if (kh == 1)
+                {
+                    if (k == 0)
+                        memcpy(d, hrows[y], rowLen*sizeof(T));
+                    else
+                        minmaxRow(isMax, d, hrows[y], d, rowLen);
+                }
+                else if (k == 0)
+                    minmaxRow(isMax, srows[y], grows[y + kh - 1], d, rowLen);
+                else
+                {
+                    minmaxRow(isMax, d, srows[y], d, rowLen);
+                    minmaxRow(isMax, d, grows[y + kh - 1], d, rowLen);
+                }
+            }
+        }
+    }
+
+    const Mat& src;
+    Mat& dst;
+    int op;
+    const std::vector<Rect>& rects;
+    Size ksize;
+    Point anchor;
+    int borderType, stripeHeight;
+    int cn, width, height, padWidth;
+    std::vector<int> xofs;
+    std::vector<T> erodeBorder, dilateBorder;
+};
+
+template<typename T>
+static void morphLargeKernel_(int op, const Mat& src, Mat& dst, const std::vector<Rect>& rects, Size ksize,
+                              Point anchor, int borderType, const Scalar& borderValue)
+{
+    // the stripes overlap by ksize.height - 1 rows (2*(ksize.height - 1) for the opening and closing)
+    int stripeHeight = std::max(ksize.height*4, 64);
+    int nstripes = (src.rows + stripeHeight - 1)/stripeHeight;
+    parallel_for_(Range(0, nstripes), MorphStripeInvoker<T>(src, dst, op, rects, ksize, anchor,
+                                                            borderType, borderValue, stripeHeight));
+}
+
+} // namespace
+
+bool morphLargeKernel(int op, const Mat& _src, Mat& dst, const Mat& kernel, Point anchor, int iterations,
+                      int borderType, const Scalar& borderValue)
+{
+    CV_INSTRUMENT_REGION();
+
+    int depth = _src.depth();
+    if ((depth != CV_8U && depth != CV_16U && depth != CV_16S && depth != CV_32F && depth != CV_64F) ||
+        _src.dims > 2 || _src.channels() > 4 || iterations < 1 ||
+        (borderType != BORDER_CONSTANT && borderType != BORDER_REPLICATE &&
+         borderType != BORDER_REFLECT && borderType != BORDER_REFLECT_101))
+        return false;
+    if ((op != MORPH_ERODE && op != MORPH_DILATE && iterations > 1) ||
+        (op != MORPH_ERODE && op != MORPH_DILATE && op != MORPH_OPEN && op != MORPH_CLOSE &&
+         op != MORPH_GRADIENT && op != MORPH_TOPHAT && op != MORPH_BLACKHAT))
+        return false;
+
+    std::vector<Rect> rects;
+    if (!decomposeMorphKernel(kernel, rects))
+        return false;
+
+    // the row and column filters are used for the rectangular kernels, the 2D filter otherwise
+    int nz = countNonZero(kernel);
+    int cost = nz == kernel.rows*kernel.cols ? kernel.rows + kernel.cols : nz;
+    int newCost = rects.size() > 1 ? 2 : 1;
+    for (size_t i = 0; i < rects.size(); i++)
+        newCost += morphRectCost(rects[i]);
+    if (newCost*2 > cost)
+        return false;
+
+    Mat src = _src;
+    if (src.data < dst.dataend && dst.data < src.dataend)
+        src = _src.clone();
+    dst.create(src.size(), src.type());
+
+    int mainOp = op == MORPH_TOPHAT ? MORPH_OPEN : op == MORPH_BLACKHAT ? MORPH_CLOSE : op;
+    Mat res = mainOp == op ? dst : Mat(src.size(), src.type());
+    for (int i = 0; i < iterations; i++)
+    {
+        const Mat& s = i == 0 ? src : res.clone();
+        if (depth == CV_8U)
+            morphLargeKernel_<uchar>(mainOp, s, res, rects, kernel.size(), anchor, borderType, borderValue);
+        else if (depth == CV_16U)
+            morphLargeKernel_<ushort>(mainOp, s, res, rects, kernel.size(), anchor, borderType, borderValue);
+        else if (depth == CV_16S)
+            morphLargeKernel_<short>(mainOp, s, res, rects, kernel.size(), anchor, borderType, borderValue);
+        else if (depth == CV_32F)
+            morphLargeKernel_<float>(mainOp, s, res, rects, kernel.size(), anchor, borderType, borderValue);
+        else
+            morphLargeKernel_<double>(mainOp, s, res, rects, kernel.size(), anchor, borderType, borderValue);
+    }
+
+    if (op == MORPH_TOPHAT)
+        subtract(src, res, dst);
+    else if (op == MORPH_BLACKHAT)
+        subtract(res, src, dst);
+    return true;
+}
+
+} // namespace cv
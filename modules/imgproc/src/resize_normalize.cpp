@@ -0,0 +1,342 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+#include "opencv2/core/hal/intrin.hpp"
+
+namespace cv
+{
+
+namespace
+{
+
+// Separable interpolation table: every destination index has 'ksize' (source index, weight) taps
+struct ResizeTab
+{
+    int ksize;
+    std::vector<int> ofs;
+    std::vector<float> alpha;
+};
+
+// Same coordinate mapping as resize() with INTER_LINEAR
+static void computeLinearTab(int ssize, int dsize, ResizeTab& tab)
+{
+    double scale = (double)ssize/dsize;
+    tab.ksize = 2;
+    tab.ofs.resize(dsize*2);
+    tab.alpha.resize(dsize*2);
+    for( int dx = 0; dx < dsize; dx++ )
+    {
+        float fx = (float)((dx + 0.5)*scale - 0.5);
+        int sx = cvFloor(fx);
+        fx -= sx;
+        if( sx < 0 )
+            fx = 0, sx = 0;
+        if( sx >= ssize - 1 )
+            fx = 0, sx = ssize - 1;
+        tab.ofs[dx*2] = sx;
+        tab.ofs[dx*2+1] = std::min(sx + 1, ssize - 1);
+        tab.alpha[dx*2] = 1.f - fx;
+        tab.alpha[dx*2+1] = fx;
+    }
+}
+
+// Same coordinate mapping as resize() with INTER_AREA when the image is enlarged along any axis:
+// the destination pixel takes the source pixel it starts in and the part of the next one it covers
+static void computeAreaUpTab(int ssize, int dsize, ResizeTab& tab)
+{
+    double inv_scale = (double)dsize/ssize, scale = 1./inv_scale;
+    tab.ksize = 2;
+    tab.ofs.resize(dsize*2);
+    tab.alpha.resize(dsize*2);
+    for( int dx = 0; dx < dsize; dx++ )
+    {
+        int sx = cvFloor(dx*scale);
+        float fx = (float)((dx + 1) - (sx + 1)*inv_scale);
+        fx = fx <= 0 ? 0.f : fx - cvFloor(fx);
+        if( sx >= ssize - 1 )
+            fx = 0, sx = ssize - 1;
+        tab.ofs[dx*2] = sx;
+        tab.ofs[dx*2+1] = std::min(sx + 1, ssize - 1);
+        tab.alpha[dx*2] = 1.f - fx;
+        tab.alpha[dx*2+1] = fx;
+    }
+}
+
+// Same pixel coverage as resize() with INTER_AREA (downscaling only)
+static void computeAreaTab(int ssize, int dsize, ResizeTab& tab)
+{
+    double scale = (double)ssize/dsize;
+    std::vector<std::vector<std::pair<int, float> > > taps(dsize);
+    int ksize = 1;
+    for( int dx = 0; dx < dsize; dx++ )
+    {
+        double fsx1 = dx*scale;
+        double fsx2 = fsx1 + scale;
+        double cellWidth = std::min(scale, ssize - fsx1);
+
+        int sx1 = cvCeil(fsx1), sx2 = cvFloor(fsx2);
+        sx2 = std::min(sx2, ssize - 1);
+        sx1 = std::min(sx1, sx2);
+
+        std::vector<std::pair<int, float> >& t = taps[dx];
+        if( sx1 - fsx1 > 1e-3 )
+            t.push_back(std::make_pair(sx1 - 1, (float)((sx1 - fsx1)/cellWidth)));
+        for( int sx = sx1; sx < sx2; sx++ )
+            t.push_back(std::make_pair(sx, (float)(1./cellWidth)));
+        if( fsx2 - sx2 > 1e-3 )
+            t.push_back(std::make_pair(sx2, (float)(std::min(std::min(fsx2 - sx2, 1.), cellWidth)/cellWidth)));
+        ksize = std::max(ksize, (int)t.size());
+    }
+
+    tab.ksize = ksize;
+    tab.ofs.resize(dsize*ksize);
+    tab.alpha.resize(dsize*ksize);
+    for( int dx = 0; dx < dsize; dx++ )
+    {
+        const std::vector<std::pair<int, float> >& t = taps[dx];
+        for( int k = 0; k < ksize; k++ )
+        {
+            bool valid = k < (int)t.size();
+            tab.ofs[dx*ksize + k] = valid ? t[k].first : t.back().first;
+            tab.alpha[dx*ksize + k] = valid ? t[k].second : 0.f;
+        }
+    }
+}
+
+class CvtResizeNormalizeInvoker : public ParallelLoopBody
+{
+public:
+    CvtResizeNormalizeInvoker(const Mat& _src, Mat& _dst, Size _ssize, int _cn,
+                              int _yuvPlanes, int _uIdx, bool _swapBlue, bool _swapOutput,
+                              const ResizeTab& _xtab, const ResizeTab& _ytab,
+                              const float* _scale, const float* _bias) :
+        ParallelLoopBody(), src(&_src), dst(&_dst), ssize(_ssize), cn(_cn),
+        yuvPlanes(_yuvPlanes), uIdx(_uIdx), swapBlue(_swapBlue), swapOutput(_swapOutput),
+        xtab(&_xtab), ytab(&_ytab), scale(_scale), bias(_bias)
+    {
+    }
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        const int swidth = ssize.width, rowlen = swidth*cn;
+        const int dwidth = dst->size[3];
+        const int ky = ytab->ksize, kx = xtab->ksize;
+
+        // converted rows are cached in pairs (YUV 4:2:0 shares one chroma row between two rows)
+        const int npairs = ky/2 + 2;
+        AutoBuffer<uchar> _cache(yuvPlanes ? npairs*2*rowlen + swidth : 1);
+        std::vector<int> cachedPair(npairs, -1);
+        uchar* uvbuf = _cache.data() + npairs*2*rowlen;
+
+        AutoBuffer<float> _vbuf(rowlen), _hbuf(dwidth);
+        float* vbuf = _vbuf.data();
+        float* hbuf = _hbuf.data();
+        AutoBuffer<const uchar*> _rows(ky);
+        const uchar** rows = _rows.data();
+
+        for( int dy = range.start; dy < range.end; dy++ )
+        {
+            const int* yofs = &ytab->ofs[dy*ky];
+            const float* beta = &ytab->alpha[dy*ky];
+
+            for( int k = 0; k < ky; k++ )
+                rows[k] = getRow(yofs[k], _cache.data(), cachedPair, uvbuf);
+
+            // vertical pass
+            int x = 0;
+#if CV_SIMD
+            {
+                const int step = v_float32::nlanes;
+                for( ; x <= rowlen - step; x += step )
+                {
+                    v_float32 s = v_cvt_f32(v_reinterpret_as_s32(vx_load_expand_q(rows[0] + x))) * vx_setall_f32(beta[0]);
+                    for( int k = 1; k < ky; k++ )
+                        s = v_fma(v_cvt_f32(v_reinterpret_as_s32(vx_load_expand_q(rows[k] + x))), vx_setall_f32(beta[k]), s);
+                    v_store(vbuf + x, s);
+                }
+            }
+#endif
+            for( ; x < rowlen; x++ )
+            {
+                float s = rows[0][x]*beta[0];
+                for( int k = 1; k < ky; k++ )
+                    s += rows[k][x]*beta[k];
+                vbuf[x] = s;
+            }
+
+            // horizontal pass, normalization and planar store
+            for( int c = 0; c < cn; c++ )
+            {
+                int oc = swapOutput ? cn - 1 - c : c;
+                float a = scale[oc], b = bias[oc];
+                float* D = dst->depth() == CV_32F ? dst->ptr<float>(0, oc) + (size_t)dy*dwidth : hbuf;
+                for( int dx = 0; dx < dwidth; dx++ )
+                {
+                    const int* xofs = &xtab->ofs[dx*kx];
+                    const float* alpha = &xtab->alpha[dx*kx];
+                    float s = vbuf[xofs[0]*cn + c]*alpha[0];
+                    for( int k = 1; k < kx; k++ )
+                        s += vbuf[xofs[k]*cn + c]*alpha[k];
+                    D[dx] = s*a + b;
+                }
+                if( D == hbuf )
+                {
+                    Mat drow(1, dwidth, dst->depth(), dst->ptr(0, oc) + (size_t)dy*dwidth*dst->elemSize1());
+                    Mat(1, dwidth, CV_32F, hbuf).convertTo(drow, dst->depth());
+                }
+            }
+        }
+    }
+
+private:
+    const uchar* getRow(int sy, uchar* cache, std::vector<int>& cachedPair, uchar* uvbuf) const
+    {
+        if( !yuvPlanes )
+            return src->ptr(sy);
+
+        const int swidth = ssize.width, rowlen = swidth*cn;
+        const int npairs = (int)cachedPair.size();
+        int pair = sy >> 1, slot = pair % npairs;
+        uchar* dpair = cache + (size_t)slot*2*rowlen;
+        if( cachedPair[slot] != pair )
+        {
+            const uchar* y = src->ptr(pair*2);
+            size_t ystep = src->step;
+            if( yuvPlanes == 2 )
+            {
+                const uchar* uv = src->ptr(ssize.height + pair);
+                hal::cvtTwoPlaneYUVtoBGR(y, ystep, uv, ystep, dpair, rowlen, swidth, 2, cn, swapBlue, uIdx);
+            }
+            else
+            {
+                // gather the chroma rows of the three-plane layout (see cvtThreePlaneYUVtoBGR)
+                const int height = ssize.height, stride = (int)src->step;
+                const uchar* u = src->ptr(height);
+                const uchar* v = src->ptr(height + height/4) + (swidth/2)*((height % 4)/2);
+                int ustepIdx = 0, vstepIdx = height % 4 == 2 ? 1 : 0;
+                if( uIdx == 1 )
+                {
+                    std::swap(u, v);
+                    std::swap(ustepIdx, vstepIdx);
+                }
+                const int uvsteps[2] = { swidth/2, stride - swidth/2 };
+                const uchar* u1 = u + (size_t)(pair/2)*stride + ((pair & 1) ? uvsteps[ustepIdx & 1] : 0);
+                const uchar* v1 = v + (size_t)(pair/2)*stride + ((pair & 1) ? uvsteps[vstepIdx & 1] : 0);
+                for( int i = 0; i < swidth/2; i++ )
+                {
+                    uvbuf[i*2] = u1[i];
+                    uvbuf[i*2+1] = v1[i];
+                }
+                hal::cvtTwoPlaneYUVtoBGR(y, ystep, uvbuf, swidth, dpair, rowlen, swidth, 2, cn, swapBlue, 0);
+            }
+            cachedPair[slot] = pair;
+        }
+        return dpair + (sy & 1)*rowlen;
+    }
+
+    const Mat* src;
+    Mat* dst;
+    Size ssize;
+    int cn;
+    int yuvPlanes;
+    int uIdx;
+    bool swapBlue;
+    bool swapOutput;
+    const ResizeTab* xtab;
+    const ResizeTab* ytab;
+    const float* scale;
+    const float* bias;
+};
+
+} // namespace
+
+void cvtResizeNormalize( InputArray _src, OutputArray _dst, int code, Size dsize,
+                         int interpolation, const Scalar& mean, const Scalar& scale, int ddepth )
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat src = _src.getMat();
+    CV_Assert( !src.empty() && src.dims == 2 );
+    CV_CheckType( src.type(), src.type() == CV_8UC1 || src.type() == CV_8UC3, "" );
+    CV_CheckDepth( ddepth, ddepth == CV_32F || ddepth == CV_16F, "" );
+    CV_Check( interpolation, interpolation == INTER_LINEAR || interpolation == INTER_AREA, "" );
+
+    int cn = src.channels(), yuvPlanes = 0, uIdx = 0;
+    bool swapBlue = false, swapOutput = false;
+    Size ssize = src.size();
+
+    switch( code )
+    {
+    case COLOR_BGR2RGB:
+        CV_CheckEQ( cn, 3, "" );
+        swapOutput = true;
+        break;
+    case COLOR_YUV2BGR_NV21: case COLOR_YUV2RGB_NV21:
+        uIdx = 1;
+        /* fallthrough */
+    case COLOR_YUV2BGR_NV12: case COLOR_YUV2RGB_NV12:
+        yuvPlanes = 2;
+        swapBlue = code == COLOR_YUV2RGB_NV12 || code == COLOR_YUV2RGB_NV21;
+        break;
+    case COLOR_YUV2BGR_YV12: case COLOR_YUV2RGB_YV12:
+        uIdx = 1;
+        /* fallthrough */
+    case COLOR_YUV2BGR_IYUV: case COLOR_YUV2RGB_IYUV:
+        yuvPlanes = 3;
+        swapBlue = code == COLOR_YUV2RGB_IYUV || code == COLOR_YUV2RGB_YV12;
+        break;
+    default:
+        if( code >= 0 )
+            CV_Error( CV_StsBadFlag, "Unknown/unsupported color conversion code" );
+    }
+
+    if( yuvPlanes )
+    {
+        CV_CheckEQ( cn, 1, "" );
+        CV_Assert( src.cols % 2 == 0 && src.rows % 3 == 0 );
+        ssize = Size(src.cols, src.rows*2/3);
+        CV_Assert( ssize.height % 2 == 0 );
+        cn = 3;
+    }
+    CV_Assert( cn <= 4 );
+
+    if( dsize.empty() )
+        dsize = ssize;
+
+    ResizeTab xtab, ytab;
+    if( interpolation == INTER_AREA && ssize.width >= dsize.width && ssize.height >= dsize.height )
+    {
+        computeAreaTab(ssize.width, dsize.width, xtab);
+        computeAreaTab(ssize.height, dsize.height, ytab);
+    }
+    else if( interpolation == INTER_AREA )
+    {
+        // resize() uses this mapping for both axes, even if one of them is reduced
+        computeAreaUpTab(ssize.width, dsize.width, xtab);
+        computeAreaUpTab(ssize.height, dsize.height, ytab);
+    }
+    else
+    {
+        computeLinearTab(ssize.width, dsize.width, xtab);
+        computeLinearTab(ssize.height, dsize.height, ytab);
+    }
+
+    float fscale[4], fbias[4];
+    for( int c = 0; c < 4; c++ )
+    {
+        fscale[c] = (float)scale[c];
+        fbias[c] = (float)(-mean[c]*scale[c]);
+    }
+
+    int sz[] = { 1, cn, dsize.height, dsize.width };
+    _dst.create(4, sz, ddepth);
+    Mat dst = _dst.getMat();
+
+    CvtResizeNormalizeInvoker invoker(src, dst, ssize, cn, yuvPlanes, uIdx, swapBlue, swapOutput,
+                                      xtab, ytab, fscale, fbias);
+    parallel_for_(Range(0, dsize.height), invoker, dst.total()/(double)(1<<16));
+}
+
+} // namespace cv
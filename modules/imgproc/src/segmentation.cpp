@@ -41,6 +41,7 @@
 //M*/
 
 #include "precomp.hpp"
+#include "opencv2/core/hal/intrin.hpp"
 
 /****************************************************************************************\
 *                                       Watershed                                        *
@@ -53,7 +54,7 @@ struct WSNode
 {
     int next;
     int mask_ofs;
-    int img_ofs;
+    int diff_ofs;
 };
 
 // Queue for WSNodes
@@ -82,6 +83,111 @@ allocWSNodes( std::vector<WSNode>& storage )
     return sz;
 }
 
+// Computes the highest absolute channel difference between horizontally (hdiff(y, x) is the
+// difference between (x, y) and (x+1, y)) and vertically (vdiff(y, x) is the difference between
+// (x, y) and (x, y+1)) adjacent pixels
+class WSDiffInvoker : public ParallelLoopBody
+{
+public:
+    WSDiffInvoker(const Mat& _src, Mat& _hdiff, Mat& _vdiff) :
+        src(&_src), hdiff(&_hdiff), vdiff(&_vdiff)
+    {
+    }
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        const int width = src->cols, height = src->rows;
+        for( int i = range.start; i < range.end; i++ )
+        {
+            const uchar* ptr = src->ptr<uchar>(i);
+            const uchar* next = i + 1 < height ? src->ptr<uchar>(i + 1) : ptr;
+            uchar* hd = hdiff->ptr<uchar>(i);
+            uchar* vd = vdiff->ptr<uchar>(i);
+
+            int j = 0;
+#if CV_SIMD
+            const int VECSZ = v_uint8::nlanes;
+            for( ; j <= width - VECSZ - 1; j += VECSZ )
+            {
+                v_uint8 b0, g0, r0, b1, g1, r1, b2, g2, r2;
+                v_load_deinterleave(ptr + j*3, b0, g0, r0);
+                v_load_deinterleave(ptr + j*3 + 3, b1, g1, r1);
+                v_load_deinterleave(next + j*3, b2, g2, r2);
+                v_store(hd + j, v_max(v_max(v_absdiff(b0, b1), v_absdiff(g0, g1)), v_absdiff(r0, r1)));
+                v_store(vd + j, v_max(v_max(v_absdiff(b0, b2), v_absdiff(g0, g2)), v_absdiff(r0, r2)));
+            }
+#endif
+            for( ; j < width; j++ )
+            {
+                const uchar* p = ptr + j*3;
+                const uchar* q = j + 1 < width ? p + 3 : p;
+                const uchar* n = next + j*3;
+                hd[j] = (uchar)std::max(std::max(std::abs(p[0] - q[0]), std::abs(p[1] - q[1])), std::abs(p[2] - q[2]));
+                vd[j] = (uchar)std::max(std::max(std::abs(p[0] - n[0]), std::abs(p[1] - n[1])), std::abs(p[2] - n[2]));
+            }
+        }
+    }
+
+private:
+    const Mat* src;
+    Mat* hdiff;
+    Mat* vdiff;
+};
+
+// Initial phase of watershed: collects the unlabeled pixels adjacent to the markers
+// together with the smallest difference to these markers, in the row-major order
+class WSInitInvoker : public ParallelLoopBody
+{
+public:
+    WSInitInvoker(const Mat& _markers, const Mat& _hdiff, const Mat& _vdiff, int _nstripes,
+                  std::vector<std::vector<Vec2i> >& _stripes) :
+        markers(&_markers), hdiff(&_hdiff), vdiff(&_vdiff), nstripes(_nstripes), stripes(&_stripes)
+    {
+    }
+
+    virtual void operator() (const Range& range) const CV_OVERRIDE
+    {
+        const int height = markers->rows, width = markers->cols;
+        const int mstep = (int)(markers->step/sizeof(int));
+        for( int s = range.start; s < range.end; s++ )
+        {
+            std::vector<Vec2i>& pts = (*stripes)[s];
+            int i0 = std::max(1, (int)((int64)height*s/nstripes));
+            int i1 = std::min(height - 1, (int)((int64)height*(s + 1)/nstripes));
+            for( int i = i0; i < i1; i++ )
+            {
+                const int* m = markers->ptr<int>(i);
+                const uchar* hd = hdiff->ptr<uchar>(i);
+                const uchar* vd = vdiff->ptr<uchar>(i);
+                const uchar* vdprev = vdiff->ptr<uchar>(i - 1);
+                for( int j = 1; j < width - 1; j++ )
+                {
+                    if( m[j] > 0 || (m[j-1] <= 0 && m[j+1] <= 0 && m[j-mstep] <= 0 && m[j+mstep] <= 0) )
+                        continue;
+                    // Find smallest difference to adjacent markers
+                    int idx = 256;
+                    if( m[j-1] > 0 )
+                        idx = hd[j-1];
+                    if( m[j+1] > 0 )
+                        idx = std::min(idx, (int)hd[j]);
+                    if( m[j-mstep] > 0 )
+                        idx = std::min(idx, (int)vdprev[j]);
+                    if( m[j+mstep] > 0 )
+                        idx = std::min(idx, (int)vd[j]);
+                    pts.push_back(Vec2i(idx, i*width + j));
+                }
+            }
+        }
+    }
+
+private:
+    const Mat* markers;
+    const Mat* hdiff;
+    const Mat* vdiff;
+    int nstripes;
+    std::vector<std::vector<Vec2i> >* stripes;
+};
+
 }
 
 
@@ -108,17 +214,9 @@ void cv::watershed( InputArray _src, InputOutputArray _markers )
     // Non-empty queue with highest priority
     int active_queue;
     int i, j;
-    // Color differences
-    int db, dg, dr;
-    int subs_tab[513];
 
-    // MAX(a,b) = b + MAX(a-b,0)
-    #define ws_max(a,b) ((b) + subs_tab[(a)-(b)+NQ])
-    // MIN(a,b) = a - MAX(a-b,0)
-    #define ws_min(a,b) ((a) - subs_tab[(a)-(b)+NQ])
-
-    // Create a new node with offsets mofs and iofs in queue idx
-    #define ws_push(idx,mofs,iofs)          \
+    // Create a new node with offsets mofs and dofs in queue idx
+    #define ws_push(idx,mofs,dofs)          \
     {                                       \
         if( !free_node )                    \
             free_node = allocWSNodes( storage );\
@@ -126,7 +224,7 @@ void cv::watershed( InputArray _src, InputOutputArray _markers )
         free_node = storage[free_node].next;\
         storage[node].next = 0;             \
         storage[node].mask_ofs = mofs;      \
-        storage[node].img_ofs = iofs;       \
+        storage[node].diff_ofs = dofs;      \
         if( q[idx].last )                   \
             storage[q[idx].last].next=node; \
         else                                \
@@ -135,7 +233,7 @@ void cv::watershed( InputArray _src, InputOutputArray _markers )
     }
 
     // Get next node from queue idx
-    #define ws_pop(idx,mofs,iofs)           \
+    #define ws_pop(idx,mofs,dofs)           \
     {                                       \
         node = q[idx].first;                \
         q[idx].first = storage[node].next;  \
@@ -144,81 +242,51 @@ void cv::watershed( InputArray _src, InputOutputArray _markers )
         storage[node].next = free_node;     \
         free_node = node;                   \
         mofs = storage[node].mask_ofs;      \
-        iofs = storage[node].img_ofs;       \
-    }
-
-    // Get highest absolute channel difference in diff
-    #define c_diff(ptr1,ptr2,diff)           \
-    {                                        \
-        db = std::abs((ptr1)[0] - (ptr2)[0]);\
-        dg = std::abs((ptr1)[1] - (ptr2)[1]);\
-        dr = std::abs((ptr1)[2] - (ptr2)[2]);\
-        diff = ws_max(db,dg);                \
-        diff = ws_max(diff,dr);              \
-        CV_Assert( 0 <= diff && diff <= 255 );  \
+        dofs = storage[node].diff_ofs;      \
     }
 
     CV_Assert( src.type() == CV_8UC3 && dst.type() == CV_32SC1 );
     CV_Assert( src.size() == dst.size() );
 
-    // Current pixel in input image
-    const uchar* img = src.ptr();
-    // Step size to next row in input image
-    int istep = int(src.step/sizeof(img[0]));
+    // Highest absolute channel differences between the adjacent pixels
+    Mat hdiff(size, CV_8UC1), vdiff(size, CV_8UC1);
+    parallel_for_(Range(0, size.height), WSDiffInvoker(src, hdiff, vdiff), src.total()/(double)(1 << 16));
+    const uchar* hd = hdiff.ptr();
+    const uchar* vd = vdiff.ptr();
+    const int dstep = size.width;
 
     // Current pixel in mask image
     int* mask = dst.ptr<int>();
     // Step size to next row in mask image
     int mstep = int(dst.step / sizeof(mask[0]));
 
-    for( i = 0; i < 256; i++ )
-        subs_tab[i] = 0;
-    for( i = 256; i <= 512; i++ )
-        subs_tab[i] = i - 256;
-
     // draw a pixel-wide border of dummy "watershed" (i.e. boundary) pixels
     for( j = 0; j < size.width; j++ )
         mask[j] = mask[j + mstep*(size.height-1)] = WSHED;
 
-    // initial phase: put all the neighbor pixels of each marker to the ordered queue -
-    // determine the initial boundaries of the basins
     for( i = 1; i < size.height-1; i++ )
     {
-        img += istep; mask += mstep;
-        mask[0] = mask[size.width-1] = WSHED; // boundary pixels
-
+        int* m = mask + i*mstep;
+        m[0] = m[size.width-1] = WSHED; // boundary pixels
         for( j = 1; j < size.width-1; j++ )
-        {
-            int* m = mask + j;
-            if( m[0] < 0 ) m[0] = 0;
-            if( m[0] == 0 && (m[-1] > 0 || m[1] > 0 || m[-mstep] > 0 || m[mstep] > 0) )
-            {
-                // Find smallest difference to adjacent markers
-                const uchar* ptr = img + j*3;
-                int idx = 256, t;
-                if( m[-1] > 0 )
-                    c_diff( ptr, ptr - 3, idx );
-                if( m[1] > 0 )
-                {
-                    c_diff( ptr, ptr + 3, t );
-                    idx = ws_min( idx, t );
-                }
-                if( m[-mstep] > 0 )
-                {
-                    c_diff( ptr, ptr - istep, t );
-                    idx = ws_min( idx, t );
-                }
-                if( m[mstep] > 0 )
-                {
-                    c_diff( ptr, ptr + istep, t );
-                    idx = ws_min( idx, t );
-                }
+            if( m[j] < 0 ) m[j] = 0;
+    }
 
-                // Add to according queue
-                CV_Assert( 0 <= idx && idx <= 255 );
-                ws_push( idx, i*mstep + j, i*istep + j*3 );
-                m[0] = IN_QUEUE;
-            }
+    // initial phase: put all the neighbor pixels of each marker to the ordered queue -
+    // determine the initial boundaries of the basins
+    int nstripes = std::max(1, std::min(size.height/64, getNumThreads()*4));
+    std::vector<std::vector<Vec2i> > stripes(nstripes);
+    parallel_for_(Range(0, nstripes), WSInitInvoker(dst, hdiff, vdiff, nstripes, stripes));
+    for( size_t s = 0; s < stripes.size(); s++ )
+    {
+        for( size_t k = 0; k < stripes[s].size(); k++ )
+        {
+            int idx = stripes[s][k][0], dofs = stripes[s][k][1];
+            int y = dofs / dstep, x = dofs - y*dstep;
+            // Add to according queue
+            CV_Assert( 0 <= idx && idx <= 255 );
+            ws_push( idx, y*mstep + x, dofs );
+            mask[y*mstep + x] = IN_QUEUE;
         }
     }
 
@@ -232,16 +300,13 @@ void cv::watershed( InputArray _src, InputOutputArray _markers )
         return;
 
     active_queue = i;
-    img = src.ptr();
-    mask = dst.ptr<int>();
 
     // recursively fill the basins
     for(;;)
     {
-        int mofs, iofs;
+        int mofs, dofs;
         int lab = 0, t;
         int* m;
-        const uchar* ptr;
 
         // Get non-empty queue with highest priority
         // Exit condition: empty priority queue
@@ -256,11 +321,10 @@ void cv::watershed( InputArray _src, InputOutputArray _markers )
         }
 
         // Get next node
-        ws_pop( active_queue, mofs, iofs );
+        ws_pop( active_queue, mofs, dofs );
 
-        // Calculate pointer to current pixel in input and marker image
+        // Calculate pointer to current pixel in marker image
         m = mask + mofs;
-        ptr = img + iofs;
 
         // Check surrounding pixels for labels
         // to determine label for current pixel
@@ -295,30 +359,30 @@ void cv::watershed( InputArray _src, InputOutputArray _markers )
         // Add adjacent, unlabeled pixels to corresponding queue
         if( m[-1] == 0 )
         {
-            c_diff( ptr, ptr - 3, t );
-            ws_push( t, mofs - 1, iofs - 3 );
-            active_queue = ws_min( active_queue, t );
+            t = hd[dofs - 1];
+            ws_push( t, mofs - 1, dofs - 1 );
+            active_queue = std::min( active_queue, t );
             m[-1] = IN_QUEUE;
         }
         if( m[1] == 0 )
         {
-            c_diff( ptr, ptr + 3, t );
-            ws_push( t, mofs + 1, iofs + 3 );
-            active_queue = ws_min( active_queue, t );
+            t = hd[dofs];
+            ws_push( t, mofs + 1, dofs + 1 );
+            active_queue = std::min( active_queue, t );
             m[1] = IN_QUEUE;
         }
         if( m[-mstep] == 0 )
         {
-            c_diff( ptr, ptr - istep, t );
-            ws_push( t, mofs - mstep, iofs - istep );
-            active_queue = ws_min( active_queue, t );
+            t = vd[dofs - dstep];
+            ws_push( t, mofs - mstep, dofs - dstep );
+            active_queue = std::min( active_queue, t );
             m[-mstep] = IN_QUEUE;
         }
         if( m[mstep] == 0 )
         {
-            c_diff( ptr, ptr + istep, t );
-            ws_push( t, mofs + mstep, iofs + istep );
-            active_queue = ws_min( active_queue, t );
+            t = vd[dofs];
+            ws_push( t, mofs + mstep, dofs + dstep );
+            active_queue = std::min( active_queue, t );
             m[mstep] = IN_QUEUE;
         }
     }
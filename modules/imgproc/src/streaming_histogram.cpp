@@ -0,0 +1,315 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+namespace cv
+{
+
+namespace
+{
+
+// regions smaller than this are binned in a single thread
+const int HIST_PARALLEL_MIN_AREA = 1 << 16;
+
+// Maps the pixel values of the given depth to the bin indices, -1 for the values out of the range.
+// The bins are the same as the ones of calcHist() with the uniform ranges
+static void calcBinTable(int depth, int histSize, double rangeMin, double rangeMax, std::vector<int>& tab)
+{
+    int nvalues = depth == CV_8U ? 256 : 65536;
+    double a = histSize/(rangeMax - rangeMin), b = -a*rangeMin;
+    tab.resize(nvalues);
+    for (int v = 0; v < nvalues; v++)
+    {
+        int idx = cvFloor(v*a + b);
+        tab[v] = v >= rangeMin && v < rangeMax ? std::min(std::max(idx, 0), histSize - 1) : -1;
+    }
+}
+
+// Adds the pixels of the rows [y0, y1) to the per-channel histograms hist[c*histSize + bin]
+template<typename T>
+static void binRows(const Mat& src, const Mat& mask, int y0, int y1, const int* tab, int histSize, int* hist)
+{
+    const int cn = src.channels(), width = src.cols;
+    for (int y = y0; y < y1; y++)
+    {
+        const T* p = src.ptr<T>(y);
+        const uchar* m = mask.empty() ? 0 : mask.ptr<uchar>(y);
+        if (cn == 1 && !m)
+        {
+            int x = 0;
+            for (; x <= width - 4; x += 4)
+            {
+                int b0 = tab[p[x]], b1 = tab[p[x + 1]], b2 = tab[p[x + 2]], b3 = tab[p[x + 3]];
+                if (b0 >= 0) hist[b0]++;
+                if (b1 >= 0) hist[b1]++;
+                if (b2 >= 0) hist[b2]++;
+                if (b3 >= 0) hist[b3]++;
+            }
+            for (; x < width; x++)
+            {
+                int b = tab[p[x]];
+                if (b >= 0) hist[b]++;
+            }
+            continue;
+        }
+        for (int x = 0; x < width; x++, p += cn)
+        {
+            if (m && !m[x])
+                continue;
+            for (int c = 0; c < cn; c++)
+            {
+                int b = tab[p[c]];
+                if (b >= 0)
+                    hist[c*histSize + b]++;
+            }
+        }
+    }
+}
+
+static void binRows(const Mat& src, const Mat& mask, int y0, int y1, const int* tab, int histSize, int* hist)
+{
+    if (src.depth() == CV_8U)
+        binRows<uchar>(src, mask, y0, y1, tab, histSize, hist);
+    else
+        binRows<ushort>(src, mask, y0, y1, tab, histSize, hist);
+}
+
+// Every stripe of rows is binned into its own histogram; they are summed up afterwards
+class HistBinInvoker : public ParallelLoopBody
+{
+public:
+    HistBinInvoker(const Mat& _src, const Mat& _mask, const int* _tab, int _histSize,
+                   int _nstripes, std::vector<int>& _stripeHists)
+        : src(_src), mask(_mask), tab(_tab), histSize(_histSize), nstripes(_nstripes), stripeHists(_stripeHists)
+    {
+    }
+
+    virtual void operator()(const Range& range) const CV_OVERRIDE
+    {
+        const size_t histLen = (size_t)histSize*src.channels();
+        for (int i = range.start; i < range.end; i++)
+        {
+            int* hist = &stripeHists[i*histLen];
+            std::fill(hist, hist + histLen, 0);
+            binRows(src, mask, (int)((int64)src.rows*i/nstripes), (int)((int64)src.rows*(i + 1)/nstripes),
+                    tab, histSize, hist);
+        }
+    }
+
+private:
+    const Mat& src;
+    const Mat& mask;
+    const int* tab;
+    int histSize, nstripes;
+    std::vector<int>& stripeHists;
+};
+
+// Adds (sign = 1) or subtracts (sign = -1) the histogram of src to hist
+static void accumulateHist(const Mat& src, const Mat& mask, const int* tab, int histSize, int sign, int* hist)
+{
+    const size_t histLen = (size_t)histSize*src.channels();
+    if (src.empty())
+        return;
+    int nstripes = src.total() < (size_t)HIST_PARALLEL_MIN_AREA ? 1 :
+                   std::min(std::max(getNumThreads(), 1)*2, src.rows);
+    std::vector<int> stripeHists(histLen*nstripes);
+    if (nstripes == 1)
+        binRows(src, mask, 0, src.rows, tab, histSize, &stripeHists[0]);
+    else
+        parallel_for_(Range(0, nstripes), HistBinInvoker(src, mask, tab, histSize, nstripes, stripeHists));
+    for (int i = 0; i < nstripes; i++)
+    {
+        const int* h = &stripeHists[i*histLen];
+        for (size_t j = 0; j < histLen; j++)
+            hist[j] += sign*h[j];
+    }
+}
+
+// Splits a \ b into at most 4 rectangles: the full-width strips above and below b and the parts
+// to the left and to the right of b
+static int rectDifference(const Rect& a, const Rect& b, Rect* parts)
+{
+    Rect r = a & b;
+    int n = 0;
+    if (r.empty())
+    {
+        parts[n++] = a;
+        return n;
+    }
+    if (r.y > a.y)
+        parts[n++] = Rect(a.x, a.y, a.width, r.y - a.y);
+    if (a.br().y > r.br().y)
+        parts[n++] = Rect(a.x, r.br().y, a.width, a.br().y - r.br().y);
+    if (r.x > a.x)
+        parts[n++] = Rect(a.x, r.y, r.x - a.x, r.height);
+    if (a.br().x > r.br().x)
+        parts[n++] = Rect(r.br().x, r.y, a.br().x - r.br().x, r.height);
+    return n;
+}
+
+class StreamingHistogramImpl CV_FINAL : public StreamingHistogram
+{
+public:
+    StreamingHistogramImpl(int _histSize, double _rangeMin, double _rangeMax)
+        : histSize(_histSize), rangeMin(_rangeMin), rangeMax(_rangeMax), type(-1), tabDepth(-1), hasWindow(false)
+    {
+        CV_CheckGT(histSize, 0, "");
+        CV_CheckLT(rangeMin, rangeMax, "");
+    }
+
+    void add(InputArray image, InputArray mask) CV_OVERRIDE
+    {
+        update(image, mask, 1);
+    }
+
+    void remove(InputArray image, InputArray mask) CV_OVERRIDE
+    {
+        update(image, mask, -1);
+    }
+
+    void setWindow(InputArray _image, Rect window) CV_OVERRIDE
+    {
+        Mat image = _image.getMat();
+        CV_Assert(window.x >= 0 && window.y >= 0 && window.width >= 0 && window.height >= 0 &&
+                  window.br().x <= image.cols && window.br().y <= image.rows);
+        if (!hasWindow || image.type() != type || image.size() != windowImageSize ||
+            (curWindow & window).empty())
+        {
+            reset();
+            update(image(window), noArray(), 1);
+        }
+        else
+        {
+            Rect parts[4];
+            int n = rectDifference(curWindow, window, parts);
+            for (int i = 0; i < n; i++)
+                update(image(parts[i]), noArray(), -1);
+            n = rectDifference(window, curWindow, parts);
+            for (int i = 0; i < n; i++)
+                update(image(parts[i]), noArray(), 1);
+        }
+        hasWindow = true;
+        curWindow = window;
+        windowImageSize = image.size();
+    }
+
+    void reset() CV_OVERRIDE
+    {
+        hist.clear();
+        type = -1;
+        hasWindow = false;
+    }
+
+    void getHist(OutputArray _hist) const CV_OVERRIDE
+    {
+        int cn = type < 0 ? 1 : CV_MAT_CN(type);
+        Mat h(cn, histSize, CV_32S);
+        if (hist.empty())
+            h.setTo(Scalar::all(0));
+        else
+            std::copy(hist.begin(), hist.end(), h.ptr<int>());
+        transpose(h, _hist);
+    }
+
+    int getHistSize() const CV_OVERRIDE { return histSize; }
+
+private:
+    void update(InputArray _image, InputArray _mask, int sign)
+    {
+        Mat image = _image.getMat(), mask = _mask.getMat();
+        int depth = image.depth(), cn = image.channels();
+        CV_CheckType(image.type(), (depth == CV_8U || depth == CV_16U) && cn <= 4, "");
+        CV_Assert(image.dims <= 2);
+        if (!mask.empty())
+        {
+            CV_CheckType(mask.type(), mask.type() == CV_8UC1, "");
+            CV_Assert(mask.size() == image.size());
+        }
+
+        if (type != image.type())
+        {
+            CV_Assert(type < 0 && "the histogram must be reset before switching to images of another type");
+            type = image.type();
+            if (tabDepth != depth)
+            {
+                calcBinTable(depth, histSize, rangeMin, rangeMax, tab);
+                tabDepth = depth;
+            }
+            hist.assign((size_t)histSize*cn, 0);
+        }
+        accumulateHist(image, mask, &tab[0], histSize, sign, &hist[0]);
+    }
+
+    int histSize;
+    double rangeMin, rangeMax;
+    int type, tabDepth;
+    std::vector<int> tab, hist;
+    bool hasWindow;
+    Rect curWindow;
+    Size windowImageSize;
+};
+
+// Every tile is binned by a single thread into its own row of the output
+class TileHistInvoker : public ParallelLoopBody
+{
+public:
+    TileHistInvoker(const Mat& _src, Mat& _hist, Size _grid, const int* _tab, int _histSize)
+        : src(_src), hist(_hist), grid(_grid), tab(_tab), histSize(_histSize)
+    {
+    }
+
+    virtual void operator()(const Range& range) const CV_OVERRIDE
+    {
+        for (int t = range.start; t < range.end; t++)
+        {
+            int ty = t / grid.width, tx = t % grid.width;
+            int x0 = (int)((int64)src.cols*tx/grid.width), x1 = (int)((int64)src.cols*(tx + 1)/grid.width);
+            int y0 = (int)((int64)src.rows*ty/grid.height), y1 = (int)((int64)src.rows*(ty + 1)/grid.height);
+            int* h = hist.ptr<int>(t);
+            std::fill(h, h + hist.cols, 0);
+            Mat tile = src(Range(y0, y1), Range(x0, x1));
+            binRows(tile, Mat(), 0, tile.rows, tab, histSize, h);
+        }
+    }
+
+private:
+    const Mat& src;
+    Mat& hist;
+    Size grid;
+    const int* tab;
+    int histSize;
+};
+
+} // namespace
+
+Ptr<StreamingHistogram> createStreamingHistogram(int histSize, double rangeMin, double rangeMax)
+{
+    return makePtr<StreamingHistogramImpl>(histSize, rangeMin, rangeMax);
+}
+
+void calcTileHistograms(InputArray _src, OutputArray _hist, Size tileGridSize,
+                        int histSize, double rangeMin, double rangeMax)
+{
+    CV_INSTRUMENT_REGION();
+
+    Mat src = _src.getMat();
+    int depth = src.depth(), cn = src.channels();
+    CV_CheckType(src.type(), (depth == CV_8U || depth == CV_16U) && cn <= 4, "");
+    CV_Assert(src.dims <= 2);
+    CV_CheckGT(histSize, 0, "");
+    CV_CheckLT(rangeMin, rangeMax, "");
+    CV_Assert(tileGridSize.width > 0 && tileGridSize.height > 0 &&
+              tileGridSize.width <= src.cols && tileGridSize.height <= src.rows);
+
+    std::vector<int> tab;
+    calcBinTable(depth, histSize, rangeMin, rangeMax, tab);
+
+    int ntiles = tileGridSize.area();
+    _hist.create(ntiles, histSize*cn, CV_32S);
+    Mat hist = _hist.getMat();
+    parallel_for_(Range(0, ntiles), TileHistInvoker(src, hist, tileGridSize, &tab[0], histSize));
+}
+
+} // namespace cv
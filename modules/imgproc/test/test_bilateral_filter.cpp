@@ -289,4 +289,64 @@ namespace opencv_test { namespace {
         test.safe_run();
     }
 
+    TEST(Imgproc_FastBilateralFilter, constant_image)
+    {
+        Mat src(97, 131, CV_8UC3, Scalar(17, 130, 240)), dst;
+        fastBilateralFilter(src, dst, 20, 8);
+        ASSERT_EQ(src.type(), dst.type());
+        EXPECT_EQ(0, cvtest::norm(src, dst, NORM_INF));
+    }
+
+    TEST(Imgproc_FastBilateralFilter, preserves_step_edge)
+    {
+        Mat src(120, 160, CV_32FC1, Scalar(10.f)), dst;
+        src.colRange(80, 160).setTo(200.f);
+        Mat noise(src.size(), CV_32FC1);
+        randn(noise, 0, 4);
+        src += noise;
+        fastBilateralFilter(src, dst, 30, 10);
+        // the sides don't mix, but the noise is smoothed
+        EXPECT_LE(cvtest::norm(dst.colRange(0, 78), Mat(120, 78, CV_32FC1, Scalar(10.f)), NORM_INF), 6);
+        EXPECT_LE(cvtest::norm(dst.colRange(82, 160), Mat(120, 78, CV_32FC1, Scalar(200.f)), NORM_INF), 6);
+        EXPECT_LT(cvtest::norm(dst.colRange(0, 78), Mat(120, 78, CV_32FC1, Scalar(10.f)), NORM_L2),
+                  cvtest::norm(src.colRange(0, 78), Mat(120, 78, CV_32FC1, Scalar(10.f)), NORM_L2)*0.5);
+    }
+
+    TEST(Imgproc_FastBilateralFilter, small_sigmas)
+    {
+        // the grid would have a cell per pixel and 56 intensity levels
+        Mat src(480, 640, CV_8UC3), ref, dst;
+        randu(src, 0, 256);
+        bilateralFilter(src, ref, -1, 5, 0.5);
+        fastBilateralFilter(src, dst, 5, 0.5);
+        EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+    }
+
+    typedef testing::TestWithParam<int> Imgproc_FastBilateralFilter_Accuracy;
+
+    TEST_P(Imgproc_FastBilateralFilter_Accuracy, compare_with_bilateralFilter)
+    {
+        const int type = GetParam();
+        Mat src(240, 320, type);
+        // smooth content with edges, as bilateral filtering is meant for
+        Mat base(src.size(), CV_MAKETYPE(CV_32F, src.channels()), Scalar::all(60));
+        rectangle(base, Rect(40, 30, 150, 120), Scalar(200, 180, 190), FILLED);
+        circle(base, Point(230, 160), 50, Scalar(120, 90, 220), FILLED);
+        Mat noise(src.size(), base.type());
+        randn(noise, 0, 6);
+        base += noise;
+        base.convertTo(src, type);
+
+        Mat ref, dst;
+        bilateralFilter(src, ref, -1, 25, 6);
+        fastBilateralFilter(src, dst, 25, 6);
+        ASSERT_EQ(type, dst.type());
+        double range = src.depth() == CV_8U ? 255 : 256;
+        EXPECT_GE(cv::PSNR(ref, dst, range), 30.) << typeToString(type);
+        EXPECT_LE(cvtest::norm(ref, dst, NORM_L1)/ref.total()/ref.channels(), 3.);
+    }
+
+    INSTANTIATE_TEST_CASE_P(/**/, Imgproc_FastBilateralFilter_Accuracy,
+        testing::Values(CV_8UC1, CV_8UC3, CV_32FC1, CV_32FC3));
+
 }} // namespace
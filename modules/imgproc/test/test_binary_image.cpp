@@ -0,0 +1,173 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "test_precomp.hpp"
+
+namespace opencv_test { namespace {
+
+static Mat randomMask(Size size, double density, RNG& rng)
+{
+    Mat noise(size, CV_32F), mask;
+    rng.fill(noise, RNG::UNIFORM, 0, 1);
+    cv::threshold(noise, mask, 1 - density, 255, THRESH_BINARY);
+    mask.convertTo(mask, CV_8U);
+    return mask;
+}
+
+TEST(Imgproc_BinaryImage, pack_unpack)
+{
+    RNG& rng = TS::ptr()->get_rng();
+    const Size sizes[] = { Size(1, 1), Size(31, 7), Size(32, 5), Size(33, 9), Size(257, 63) };
+    for (size_t i = 0; i < sizeof(sizes)/sizeof(sizes[0]); i++)
+    {
+        Mat mask = randomMask(sizes[i], 0.5, rng), unpacked;
+        BinaryImage bin;
+        packBinary(mask, bin);
+        ASSERT_EQ(sizes[i], bin.size());
+        EXPECT_EQ(cv::countNonZero(mask), cv::countNonZero(bin));
+        unpackBinary(bin, unpacked);
+        EXPECT_EQ(0, cvtest::norm(mask, unpacked, NORM_INF));
+
+        // the inverted image must not set the bits past the width
+        BinaryImage inv;
+        bitwise_not(bin, inv);
+        EXPECT_EQ(sizes[i].area(), cv::countNonZero(bin) + cv::countNonZero(inv));
+    }
+}
+
+TEST(Imgproc_BinaryImage, pack_threshold)
+{
+    RNG& rng = TS::ptr()->get_rng();
+    Mat src(37, 101, CV_8U), ref, unpacked;
+    rng.fill(src, RNG::UNIFORM, 0, 256);
+    const double thresholds[] = { -1, 0, 100.5, 127, 254, 255 };
+    for (size_t i = 0; i < sizeof(thresholds)/sizeof(thresholds[0]); i++)
+    {
+        BinaryImage bin;
+        packBinary(src, bin, thresholds[i]);
+        unpackBinary(bin, unpacked);
+        Mat f;
+        src.convertTo(f, CV_32F);
+        cv::compare(f, thresholds[i], ref, CMP_GT);
+        EXPECT_EQ(0, cvtest::norm(ref, unpacked, NORM_INF)) << "thresh=" << thresholds[i];
+
+        BinaryImage bin32f;
+        packBinary(f, bin32f, thresholds[i]);
+        EXPECT_EQ(0, cvtest::norm(bin.bits, bin32f.bits, NORM_INF)) << "thresh=" << thresholds[i];
+    }
+}
+
+TEST(Imgproc_BinaryImage, bitwise)
+{
+    RNG& rng = TS::ptr()->get_rng();
+    Mat a = randomMask(Size(77, 31), 0.5, rng), b = randomMask(Size(77, 31), 0.3, rng), ref, unpacked;
+    BinaryImage ba, bb, bd;
+    packBinary(a, ba);
+    packBinary(b, bb);
+
+    bitwise_and(ba, bb, bd);
+    unpackBinary(bd, unpacked);
+    cv::bitwise_and(a, b, ref);
+    EXPECT_EQ(0, cvtest::norm(ref, unpacked, NORM_INF));
+
+    bitwise_or(ba, bb, bd);
+    unpackBinary(bd, unpacked);
+    cv::bitwise_or(a, b, ref);
+    EXPECT_EQ(0, cvtest::norm(ref, unpacked, NORM_INF));
+
+    bitwise_xor(ba, bb, bd);
+    unpackBinary(bd, unpacked);
+    cv::bitwise_xor(a, b, ref);
+    EXPECT_EQ(0, cvtest::norm(ref, unpacked, NORM_INF));
+
+    bitwise_not(ba, ba);
+    unpackBinary(ba, unpacked);
+    cv::bitwise_not(a, ref);
+    EXPECT_EQ(0, cvtest::norm(ref, unpacked, NORM_INF));
+}
+
+typedef testing::TestWithParam<tuple<int, Size, Size> > Imgproc_BinaryImage_Morph;
+
+TEST_P(Imgproc_BinaryImage_Morph, compare_with_8u)
+{
+    const int shape = get<0>(GetParam());
+    const Size ksize = get<1>(GetParam()), size = get<2>(GetParam());
+    RNG& rng = TS::ptr()->get_rng();
+    Mat kernel = getStructuringElement(shape, ksize);
+    const Point anchors[] = { Point(-1, -1), Point(0, 0), Point(ksize.width - 1, ksize.height/3) };
+
+    for (int iter = 0; iter < 3; iter++)
+    {
+        Mat mask = randomMask(size, iter == 0 ? 0.1 : iter == 1 ? 0.5 : 0.9, rng);
+        BinaryImage bin, res;
+        packBinary(mask, bin);
+        for (size_t i = 0; i < sizeof(anchors)/sizeof(anchors[0]); i++)
+        {
+            Mat ref, unpacked;
+            cv::erode(mask, ref, kernel, anchors[i]);
+            erode(bin, res, kernel, anchors[i]);
+            unpackBinary(res, unpacked);
+            EXPECT_EQ(0, cvtest::norm(ref, unpacked, NORM_INF)) << "erode, anchor=" << anchors[i];
+
+            cv::dilate(mask, ref, kernel, anchors[i]);
+            dilate(bin, res, kernel, anchors[i]);
+            unpackBinary(res, unpacked);
+            EXPECT_EQ(0, cvtest::norm(ref, unpacked, NORM_INF)) << "dilate, anchor=" << anchors[i];
+        }
+
+        // in-place
+        Mat ref, unpacked;
+        cv::dilate(mask, ref, kernel);
+        dilate(bin, bin, kernel);
+        unpackBinary(bin, unpacked);
+        EXPECT_EQ(0, cvtest::norm(ref, unpacked, NORM_INF)) << "in-place dilate";
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_BinaryImage_Morph, testing::Combine(
+    testing::Values((int)MORPH_RECT, (int)MORPH_ELLIPSE, (int)MORPH_CROSS),
+    testing::Values(Size(3, 3), Size(1, 7), Size(45, 3), Size(21, 21)),
+    testing::Values(Size(17, 13), Size(200, 150))
+));
+
+TEST(Imgproc_BinaryImage, connectedComponents)
+{
+    RNG& rng = TS::ptr()->get_rng();
+    for (int iter = 0; iter < 6; iter++)
+    {
+        int connectivity = iter % 2 ? 4 : 8;
+        Mat mask = randomMask(Size(131, 97), 0.2 + 0.15*iter, rng), ref, labels;
+        BinaryImage bin;
+        packBinary(mask, bin);
+
+        int nref = cv::connectedComponents(mask, ref, connectivity, CV_32S, CCL_WU);
+        int n = connectedComponents(bin, labels, connectivity, CV_32S);
+        ASSERT_EQ(nref, n);
+        EXPECT_EQ(0, cvtest::norm(ref, labels, NORM_INF));
+
+        n = connectedComponents(bin, labels, connectivity, CV_16U);
+        ASSERT_EQ(nref, n);
+        labels.convertTo(labels, CV_32S);
+        EXPECT_EQ(0, cvtest::norm(ref, labels, NORM_INF));
+    }
+}
+
+TEST(Imgproc_BinaryImage, findContours)
+{
+    RNG& rng = TS::ptr()->get_rng();
+    Mat mask = randomMask(Size(64, 48), 0.4, rng);
+    BinaryImage bin;
+    packBinary(mask, bin);
+
+    std::vector<std::vector<Point> > ref, contours;
+    std::vector<Vec4i> refHierarchy, hierarchy;
+    cv::findContours(mask, ref, refHierarchy, RETR_TREE, CHAIN_APPROX_SIMPLE);
+    findContours(bin, contours, hierarchy, RETR_TREE, CHAIN_APPROX_SIMPLE);
+    ASSERT_EQ(ref.size(), contours.size());
+    EXPECT_EQ(refHierarchy, hierarchy);
+    for (size_t i = 0; i < ref.size(); i++)
+        EXPECT_EQ(ref[i], contours[i]);
+}
+
+}} // namespace
@@ -1855,6 +1855,120 @@ TEST(Imgproc_ColorLuv, Overflow_21112)
     EXPECT_LE(cvtest::norm(255.f*rgbf, rgb_converted, NORM_INF), 1e-5);
 }
 
+static void referenceRGB2LabLuv32f(const Mat& src, Mat& dst, bool srgb, bool luv)
+{
+    const double xn = (double)Xn, zn = (double)Zn;
+    const double dn = xn + 15 + 3*zn, un = 4*xn/dn, vn = 9/dn;
+    dst.create(src.size(), CV_32FC3);
+    for (int y = 0; y < src.rows; y++)
+        for (int x = 0; x < src.cols; x++)
+        {
+            Vec3f bgr = src.at<Vec3f>(y, x);
+            double rgb[3] = { bgr[2], bgr[1], bgr[0] }, xyz[3] = { 0, 0, 0 };
+            for (int c = 0; c < 3; c++)
+            {
+                rgb[c] = std::min(std::max(rgb[c], 0.), 1.);
+                if (srgb)
+                    rgb[c] = rgb[c] <= 0.04045 ? rgb[c]/12.92 : std::pow((rgb[c] + 0.055)/1.055, 2.4);
+            }
+            for (int i = 0; i < 3; i++)
+                for (int c = 0; c < 3; c++)
+                    xyz[i] += (double)RGB2XYZ[i*3 + c]*rgb[c];
+            double fy = xyz[1] > 0.008856 ? std::cbrt(xyz[1]) : 7.787*xyz[1] + 16./116;
+            double L = 116*fy - 16;
+            Vec3f& d = dst.at<Vec3f>(y, x);
+            d[0] = (float)L;
+            if (luv)
+            {
+                double den = std::max(xyz[0] + 15*xyz[1] + 3*xyz[2], (double)FLT_EPSILON);
+                d[1] = (float)(13*L*(4*xyz[0]/den - un));
+                d[2] = (float)(13*L*(9*xyz[1]/den - vn));
+            }
+            else
+            {
+                double tx = xyz[0]/xn, tz = xyz[2]/zn;
+                double fx = tx > 0.008856 ? std::cbrt(tx) : 7.787*tx + 16./116;
+                double fz = tz > 0.008856 ? std::cbrt(tz) : 7.787*tz + 16./116;
+                d[0] = (float)(xyz[1] > 0.008856 ? L : 903.3*xyz[1]);
+                d[1] = (float)(500*(fx - fy));
+                d[2] = (float)(200*(fy - fz));
+            }
+        }
+}
+
+typedef testing::TestWithParam<int> Imgproc_ColorLabLuv_32F;
+
+TEST_P(Imgproc_ColorLabLuv_32F, compare_with_double_reference)
+{
+    const int code = GetParam();
+    const bool srgb = code == COLOR_BGR2Luv || code == COLOR_BGR2Lab;
+    const bool luv = code == COLOR_BGR2Luv || code == COLOR_LBGR2Luv;
+    const Size sz(107, 16);  // unaligned size to run both SIMD and generic code
+    Mat src(sz, CV_32FC3), ref, dst;
+    randu(src, -0.1, 1.1);
+    // dark colors to check the linear part of the curve
+    randu(src.rowRange(0, 4), 0, 0.02);
+
+    referenceRGB2LabLuv32f(src, ref, srgb, luv);
+    cvtColor(src, dst, code);
+    // 32f sRGB->Lab goes through the trilinear LUT, the others are computed directly
+    EXPECT_LE(cvtest::norm(ref, dst, NORM_INF), code == COLOR_BGR2Lab ? 0.5 : 1e-3);
+}
+
+TEST_P(Imgproc_ColorLabLuv_32F, tail_matches_simd_body)
+{
+    const int code = GetParam();
+    Mat src(1, 67, CV_32FC3), dst;
+    randu(src, -0.1, 1.1);
+    randu(src.colRange(0, 16), 0, 0.02);
+    cvtColor(src, dst, code);
+    for (int x = 0; x < src.cols; x++)
+    {
+        // a single pixel is converted by the scalar code, the SIMD one uses FMA, so they are not bit-exact
+        Mat pix;
+        cvtColor(src.col(x), pix, code);
+        EXPECT_LE(cvtest::norm(dst.col(x), pix, NORM_INF), 1e-4) << "x=" << x;
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_ColorLabLuv_32F,
+    testing::Values((int)COLOR_LBGR2Lab, (int)COLOR_BGR2Lab, (int)COLOR_LBGR2Luv, (int)COLOR_BGR2Luv));
+
+// NULL removes the variable
+static void setRGB2Luv32fInterpolation(const char* value)
+{
+#ifdef _WIN32
+    _putenv_s("OPENCV_IMGPROC_RGB2LUV_32F_INTERPOLATION", value ? value : "");
+#else
+    if (value)
+        setenv("OPENCV_IMGPROC_RGB2LUV_32F_INTERPOLATION", value, 1);
+    else
+        unsetenv("OPENCV_IMGPROC_RGB2LUV_32F_INTERPOLATION");
+#endif
+}
+
+TEST(Imgproc_ColorLuv, rgb2luv_32f_interpolation)
+{
+    const Size sz(107, 16);  // unaligned size to run both SIMD and generic code
+    Mat src(sz, CV_32FC3), ref, exact, interpolated;
+    randu(src, -0.1, 1.1);
+    randu(src.rowRange(0, 4), 0, 0.02);
+    referenceRGB2LabLuv32f(src, ref, true, true);
+
+    const char* prev = getenv("OPENCV_IMGPROC_RGB2LUV_32F_INTERPOLATION");
+    const std::string prevValue = prev ? prev : "";
+    setRGB2Luv32fInterpolation("0");
+    cvtColor(src, exact, COLOR_BGR2Luv);
+    setRGB2Luv32fInterpolation("1");
+    cvtColor(src, interpolated, COLOR_BGR2Luv);
+    setRGB2Luv32fInterpolation(prev ? prevValue.c_str() : NULL);
+
+    EXPECT_LE(cvtest::norm(ref, exact, NORM_INF), 1e-3);
+    // the same accuracy as the one of 32f sRGB->Lab going through the same kind of LUT
+    EXPECT_LE(cvtest::norm(ref, interpolated, NORM_INF), 0.5);
+    EXPECT_GT(cvtest::norm(exact, interpolated, NORM_INF), 0) << "the LUT is not used";
+}
+
 TEST(Imgproc_ColorBayer, regression)
 {
     cvtest::TS* ts = cvtest::TS::ptr();
@@ -302,4 +302,163 @@ BIGDATA_TEST(Imgproc_DistanceTransform, large_image_12218)
     EXPECT_EQ(nz, (size.height*size.width / 2));
 }
 
+// plain raster chamfer scans with the same fixed-point arithmetic and the same order of
+// the neighbors as the library uses to pick the labels
+static void referenceChamferDT(const Mat& src, Mat& dist, Mat* labels, int distType, int maskSize)
+{
+    const int dx[] = { -1, 1, -2, -1, 0, 1, 2, -1 }, dy[] = { -2, -2, -1, -1, -1, -1, -1, 0 };
+    const float metricsC[] = { 1.f, 1.f, 2.f }, metricsL1[] = { 1.f, 2.f, 3.f };
+    const float metricsL2_3[] = { 0.955f, 1.3693f, 0.f }, metricsL2_5[] = { 1.f, 1.4f, 2.1969f };
+    const float* metrics = distType == DIST_C ? metricsC : distType == DIST_L1 ? metricsL1 :
+                           maskSize == DIST_MASK_3 ? metricsL2_3 : metricsL2_5;
+    unsigned cost[8];
+    for (int k = 0; k < 8; k++)
+    {
+        int d = std::abs(dx[k]) + std::abs(dy[k]);
+        cost[k] = (unsigned)cvRound(metrics[d == 1 ? 0 : d == 2 ? 1 : 2]*65536);
+    }
+    const unsigned hv = cost[4];
+    const int b = 2;
+    Mat_<int> t(src.rows + b*2, src.cols + b*2, INT_MAX);
+    Mat_<int> l(t.size(), 0);
+    if (labels)
+        labels->copyTo(l(Rect(b, b, src.cols, src.rows)));
+
+    for (int y = 0; y < src.rows; y++)
+        for (int x = 0; x < src.cols; x++)
+        {
+            if (!src.at<uchar>(y, x))
+            {
+                t(y + b, x + b) = 0;
+                continue;
+            }
+            unsigned t0 = INT_MAX;
+            int l0 = 0;
+            for (int k = 0; k < 8; k++)
+            {
+                if (maskSize == DIST_MASK_3 && std::abs(dx[k]) + std::abs(dy[k]) == 3)
+                    continue;
+                unsigned v = (unsigned)t(y + b + dy[k], x + b + dx[k]) + cost[k];
+                if (t0 > v)
+                    t0 = v, l0 = l(y + b + dy[k], x + b + dx[k]);
+            }
+            t(y + b, x + b) = (int)t0;
+            l(y + b, x + b) = l0;
+        }
+
+    dist.create(src.size(), CV_32F);
+    for (int y = src.rows - 1; y >= 0; y--)
+        for (int x = src.cols - 1; x >= 0; x--)
+        {
+            unsigned t0 = (unsigned)t(y + b, x + b);
+            if (t0 > hv)
+            {
+                for (int k = 0; k < 8; k++)
+                {
+                    if (maskSize == DIST_MASK_3 && std::abs(dx[k]) + std::abs(dy[k]) == 3)
+                        continue;
+                    unsigned v = (unsigned)t(y + b - dy[k], x + b - dx[k]) + cost[k];
+                    if (t0 > v)
+                        t0 = v, l(y + b, x + b) = l(y + b - dy[k], x + b - dx[k]);
+                }
+                t(y + b, x + b) = (int)t0;
+            }
+            dist.at<float>(y, x) = (float)(std::min(t0, (unsigned)(INT_MAX >> 2))*(1.f/65536));
+        }
+    if (labels)
+        l(Rect(b, b, src.cols, src.rows)).copyTo(*labels);
+}
+
+static Mat makeDistTransformInput(Size size, int nzeros, RNG& rng)
+{
+    Mat src(size, CV_8UC1, Scalar(255));
+    for (int i = 0; i < nzeros; i++)
+        src.at<uchar>(rng.uniform(0, size.height), rng.uniform(0, size.width)) = 0;
+    line(src, Point(10, size.height - 5), Point(size.width - 20, 30), Scalar(0), 1);
+    return src;
+}
+
+typedef testing::TestWithParam<tuple<int, int> > Imgproc_DistanceTransform_Chamfer;
+
+TEST_P(Imgproc_DistanceTransform_Chamfer, compare_with_reference)
+{
+    const int distType = get<0>(GetParam()), maskSize = get<1>(GetParam());
+    RNG& rng = theRNG();
+    // large enough to be processed by tiles
+    Mat src = makeDistTransformInput(Size(1237, 421), 60, rng);
+
+    Mat dst, ref;
+    distanceTransform(src, dst, distType, maskSize);
+    referenceChamferDT(src, ref, NULL, distType, distType == DIST_L2 ? maskSize : DIST_MASK_3);
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+
+    Mat labels, refLabels(src.size(), CV_32S, Scalar(0));
+    distanceTransform(src, dst, labels, distType, maskSize, DIST_LABEL_PIXEL);
+    for (int y = 0, k = 1; y < src.rows; y++)
+        for (int x = 0; x < src.cols; x++)
+            if (!src.at<uchar>(y, x))
+                refLabels.at<int>(y, x) = k++;
+    referenceChamferDT(src, ref, &refLabels, distType, DIST_MASK_5);
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(refLabels, labels, NORM_INF));
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_DistanceTransform_Chamfer, testing::Combine(
+    testing::Values((int)DIST_C, (int)DIST_L1, (int)DIST_L2),
+    testing::Values((int)DIST_MASK_3, (int)DIST_MASK_5)
+));
+
+TEST(Imgproc_DistanceTransform, precise_labels_pixel)
+{
+    RNG& rng = theRNG();
+    Mat src = makeDistTransformInput(Size(311, 207), 40, rng);
+
+    Mat dst, ref, labels;
+    distanceTransform(src, ref, DIST_L2, DIST_MASK_PRECISE);
+    distanceTransform(src, dst, labels, DIST_L2, DIST_MASK_PRECISE, DIST_LABEL_PIXEL);
+    ASSERT_EQ(CV_32SC1, labels.type());
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+
+    std::vector<Point> zeros(1);
+    for (int y = 0; y < src.rows; y++)
+        for (int x = 0; x < src.cols; x++)
+            if (!src.at<uchar>(y, x))
+                zeros.push_back(Point(x, y));
+
+    for (int y = 0; y < src.rows; y++)
+        for (int x = 0; x < src.cols; x++)
+        {
+            int l = labels.at<int>(y, x);
+            ASSERT_TRUE(l > 0 && l < (int)zeros.size()) << "(" << x << ", " << y << ")";
+            Point d = zeros[l] - Point(x, y);
+            ASSERT_NEAR(std::sqrt((double)d.dot(d)), dst.at<float>(y, x), 1e-3) << "(" << x << ", " << y << ")";
+        }
+}
+
+TEST(Imgproc_DistanceTransform, precise_labels_ccomp)
+{
+    Mat src(240, 320, CV_8UC1, Scalar(255));
+    circle(src, Point(60, 50), 12, Scalar(0), FILLED);
+    rectangle(src, Rect(200, 30, 40, 20), Scalar(0), FILLED);
+    line(src, Point(20, 220), Point(300, 180), Scalar(0), 2);
+    src.at<uchar>(150, 160) = 0;
+
+    Mat dst, labels, ccomp;
+    distanceTransform(src, dst, labels, DIST_L2, DIST_MASK_PRECISE, DIST_LABEL_CCOMP);
+    int ncomp = connectedComponents(src == 0, ccomp, 8, CV_32S);
+    ASSERT_EQ(5, ncomp);
+
+    for (int k = 1; k < ncomp; k++)
+    {
+        Mat distk;
+        distanceTransform(ccomp != k, distk, DIST_L2, DIST_MASK_PRECISE);
+        Mat diff = cv::abs(distk - dst), mask = labels == k;
+        EXPECT_GT(countNonZero(mask), 0) << "k=" << k;
+        double maxDiff = 0;
+        minMaxLoc(diff, NULL, &maxDiff, NULL, NULL, mask);
+        EXPECT_LE(maxDiff, 1e-3) << "k=" << k;
+    }
+    EXPECT_EQ(0, countNonZero(labels == 0));
+}
+
 }} // namespace
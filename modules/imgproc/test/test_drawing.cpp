@@ -680,4 +680,59 @@ TEST(Drawing, fillpoly_circle)
     EXPECT_LT(diff_fp3, 1.);
 }
 
+static std::vector<std::vector<Point> > makeRandomPolygons(RNG& rng, Size size, int count, int shift)
+{
+    std::vector<std::vector<Point> > polys(count);
+    for (int i = 0; i < count; i++)
+    {
+        int n = rng.uniform(3, 12);
+        // some of the polygons are partially or completely outside of the image
+        Point center(rng.uniform(-size.width/8, size.width*9/8), rng.uniform(-size.height/8, size.height*9/8));
+        int radius = rng.uniform(2, size.width/4);
+        for (int k = 0; k < n; k++)
+        {
+            Point p = center + Point(rng.uniform(-radius, radius), rng.uniform(-radius, radius));
+            polys[i].push_back(Point(p.x << shift, p.y << shift) + Point(rng.uniform(0, 1 << shift), rng.uniform(0, 1 << shift)));
+        }
+    }
+    return polys;
+}
+
+typedef testing::TestWithParam<tuple<int, int, int> > Drawing_FillPolyBatch;
+
+TEST_P(Drawing_FillPolyBatch, same_as_fillPoly)
+{
+    const int type = get<0>(GetParam()), lineType = get<1>(GetParam()), shift = get<2>(GetParam());
+    RNG& rng = theRNG();
+    const Size size(517, 389);
+    std::vector<std::vector<Point> > polys = makeRandomPolygons(rng, size, 300, shift);
+    polys.push_back(std::vector<Point>());
+    std::vector<Scalar> colors(polys.size());
+    for (size_t i = 0; i < colors.size(); i++)
+        colors[i] = Scalar(rng.uniform(0, 256), rng.uniform(0, 256), rng.uniform(0, 256));
+    const Point offset(3, -5);
+
+    Mat ref(size, type, Scalar::all(0)), dst = ref.clone();
+    for (size_t i = 0; i < polys.size(); i++)
+        if (!polys[i].empty())
+            fillPoly(ref, std::vector<std::vector<Point> >(1, polys[i]), colors[i], lineType, shift, offset);
+    fillPolyBatch(dst, polys, colors, lineType, shift, offset);
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+
+    // a single color for the whole batch
+    ref.setTo(Scalar::all(0));
+    dst.setTo(Scalar::all(0));
+    for (size_t i = 0; i < polys.size(); i++)
+        if (!polys[i].empty())
+            fillPoly(ref, std::vector<std::vector<Point> >(1, polys[i]), Scalar::all(200), lineType, shift, offset);
+    fillPolyBatch(dst, polys, std::vector<Scalar>(1, Scalar::all(200)), lineType, shift, offset);
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Drawing_FillPolyBatch, testing::Combine(
+    testing::Values(CV_8UC1, CV_8UC3, CV_32FC1),
+    testing::Values((int)LINE_4, (int)LINE_8, (int)LINE_AA),
+    testing::Values(0, 3)
+));
+
 }} // namespace
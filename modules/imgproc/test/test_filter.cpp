@@ -2366,5 +2366,286 @@ TEST(Imgproc_GaussianBlur, regression_11303)
     EXPECT_LE(cv::norm(src, dst, NORM_L2), 1e-3);
 }
 
+typedef testing::TestWithParam<tuple<perf::MatType, int, int> > Imgproc_SepFilter2DMulti;
+
+TEST_P(Imgproc_SepFilter2DMulti, bitexact_with_sepFilter2D)
+{
+    const int type = get<0>(GetParam());
+    const int ddepth = get<1>(GetParam());
+    const int borderType = get<2>(GetParam());
+
+    // a submatrix of a bigger image, so that the pixels outside the ROI are used
+    Mat big(421, 389, type);
+    randu(big, 0, 256);
+    Mat src = big(Rect(7, 5, 350, 400));
+
+    std::vector<Mat> kx, ky;
+    for (int i = 0; i < 5; i++)
+    {
+        Mat x, y;
+        if (i < 4)
+            getDerivKernels(x, y, i % 2, i / 2 % 2 + (i == 0), i < 2 ? 3 : 5, false, CV_32F);
+        else
+        {
+            x = getGaussianKernel(7, 1.5, CV_32F);
+            y = getGaussianKernel(9, 2.0, CV_32F);
+        }
+        kx.push_back(x);
+        ky.push_back(y);
+    }
+
+    std::vector<Mat> dst;
+    sepFilter2DMulti(src, dst, ddepth, kx, ky, Point(-1, -1), 3, borderType);
+    ASSERT_EQ(kx.size(), dst.size());
+    for (size_t i = 0; i < kx.size(); i++)
+    {
+        Mat ref;
+        sepFilter2D(src, ref, ddepth, kx[i], ky[i], Point(-1, -1), 3, borderType);
+        ASSERT_EQ(ref.type(), dst[i].type());
+        EXPECT_EQ(0, cvtest::norm(ref, dst[i], NORM_INF)) << "kernel " << i;
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_SepFilter2DMulti, testing::Combine(
+    testing::Values(CV_8UC1, CV_8UC3, CV_32FC1),
+    testing::Values(-1, CV_32F),
+    testing::Values((int)BORDER_REFLECT_101, (int)BORDER_CONSTANT, (int)(BORDER_REPLICATE | BORDER_ISOLATED))
+));
+
+TEST(Imgproc_SepFilter2D, reuse_with_different_sizes)
+{
+    // the filter engines are cached between the calls, the result must not depend on the previous ones
+    Mat kx = getGaussianKernel(5, 1.2, CV_32F), ky = getGaussianKernel(3, 0.8, CV_32F);
+    RNG& rng = theRNG();
+    for (int iter = 0; iter < 6; iter++)
+    {
+        Mat src(rng.uniform(1, 300), rng.uniform(1, 300), CV_32FC1), dst, ref;
+        randu(src, -100, 100);
+        sepFilter2D(src, dst, -1, kx, ky);
+
+        Mat kx2d = kx * ky.t(), kernel;
+        cv::transpose(kx2d, kernel);
+        cv::filter2D(src, ref, -1, kernel);
+        EXPECT_LE(cvtest::norm(ref, dst, NORM_INF), 1e-3) << src.size();
+    }
+}
+
+TEST(Imgproc_SepFilter2D, multi_inplace)
+{
+    Mat src(200, 150, CV_32FC1);
+    randu(src, 0, 1);
+    std::vector<Mat> kx(2), ky(2);
+    getDerivKernels(kx[0], ky[0], 1, 0, 3, false, CV_32F);
+    getDerivKernels(kx[1], ky[1], 0, 1, 3, false, CV_32F);
+
+    Mat dx, dy;
+    Sobel(src, dx, CV_32F, 1, 0);
+    Sobel(src, dy, CV_32F, 0, 1);
+
+    std::vector<Mat> dst(2);
+    dst[0] = src;
+    sepFilter2DMulti(src, dst, -1, kx, ky);
+    EXPECT_EQ(0, cvtest::norm(dx, dst[0], NORM_INF));
+    EXPECT_EQ(0, cvtest::norm(dy, dst[1], NORM_INF));
+}
+
+template<typename T>
+static void referenceMedianBlur(const Mat& src, Mat& dst, int ksize)
+{
+    const int cn = src.channels(), r = ksize/2;
+    dst.create(src.size(), src.type());
+    std::vector<T> buf(ksize*ksize);
+    for (int y = 0; y < src.rows; y++)
+        for (int x = 0; x < src.cols; x++)
+            for (int c = 0; c < cn; c++)
+            {
+                int k = 0;
+                for (int dy = -r; dy <= r; dy++)
+                {
+                    const T* row = src.ptr<T>(std::min(std::max(y + dy, 0), src.rows - 1));
+                    for (int dx = -r; dx <= r; dx++)
+                        buf[k++] = row[std::min(std::max(x + dx, 0), src.cols - 1)*cn + c];
+                }
+                std::nth_element(buf.begin(), buf.begin() + k/2, buf.end());
+                dst.ptr<T>(y)[x*cn + c] = buf[k/2];
+            }
+}
+
+typedef testing::TestWithParam<tuple<perf::MatType, int, Size> > Imgproc_MedianBlur_Large;
+
+TEST_P(Imgproc_MedianBlur_Large, compare_with_reference)
+{
+    const int type = get<0>(GetParam());
+    const int ksize = get<1>(GetParam());
+    const Size sz = get<2>(GetParam());
+
+    Mat src(sz, type), dst, ref;
+    // smooth areas with noise, like in depth maps
+    Mat small(sz.height/16 + 1, sz.width/16 + 1, type);
+    randu(small, 0, CV_MAT_DEPTH(type) == CV_8U ? 256 : 65536);
+    resize(small, src, sz, 0, 0, INTER_LINEAR);
+    Mat noise(sz, type);
+    randu(noise, 0, CV_MAT_DEPTH(type) == CV_8U ? 16 : 4096);
+    cv::add(src, noise, src);
+
+    if (CV_MAT_DEPTH(type) == CV_8U)
+        referenceMedianBlur<uchar>(src, ref, ksize);
+    else
+        referenceMedianBlur<ushort>(src, ref, ksize);
+    medianBlur(src, dst, ksize);
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+
+    // in-place
+    medianBlur(src, src, ksize);
+    EXPECT_EQ(0, cvtest::norm(ref, src, NORM_INF));
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_MedianBlur_Large, testing::Combine(
+    testing::Values(CV_8UC1, CV_8UC3, CV_16UC1, CV_16UC4),
+    testing::Values(7, 15, 21),
+    testing::Values(Size(331, 217), Size(17, 300))
+));
+
+template<typename T>
+static void referenceMorph(const Mat& src, Mat& dst, bool isMax, const Mat& kernel, Point anchor,
+                           int borderType, const Scalar& borderValue)
+{
+    const int cn = src.channels();
+    Scalar bval = borderValue;
+    if (borderType == BORDER_CONSTANT && borderValue == morphologyDefaultBorderValue())
+        bval = Scalar::all(isMax ? (double)std::numeric_limits<T>::lowest() : (double)std::numeric_limits<T>::max());
+    Mat padded;
+    cv::copyMakeBorder(src, padded, anchor.y, kernel.rows - 1 - anchor.y, anchor.x, kernel.cols - 1 - anchor.x,
+                   borderType, bval);
+    dst.create(src.size(), src.type());
+    for (int y = 0; y < src.rows; y++)
+        for (int x = 0; x < src.cols; x++)
+            for (int c = 0; c < cn; c++)
+            {
+                T v = isMax ? std::numeric_limits<T>::lowest() : std::numeric_limits<T>::max();
+                for (int i = 0; i < kernel.rows; i++)
+                {
+                    const T* row = padded.ptr<T>(y + i);
+                    for (int j = 0; j < kernel.cols; j++)
+                        if (kernel.at<uchar>(i, j))
+                            v = isMax ? std::max(v, row[(x + j)*cn + c]) : std::min(v, row[(x + j)*cn + c]);
+                }
+                dst.ptr<T>(y)[x*cn + c] = v;
+            }
+}
+
+static void referenceMorph(const Mat& src, Mat& dst, bool isMax, const Mat& kernel, Point anchor,
+                           int borderType, const Scalar& borderValue)
+{
+    if (src.depth() == CV_8U)
+        referenceMorph<uchar>(src, dst, isMax, kernel, anchor, borderType, borderValue);
+    else if (src.depth() == CV_16S)
+        referenceMorph<short>(src, dst, isMax, kernel, anchor, borderType, borderValue);
+    else
+        referenceMorph<float>(src, dst, isMax, kernel, anchor, borderType, borderValue);
+}
+
+typedef testing::TestWithParam<tuple<perf::MatType, int, Size> > Imgproc_Morphology_LargeKernel;
+
+TEST_P(Imgproc_Morphology_LargeKernel, compare_with_reference)
+{
+    const int type = get<0>(GetParam());
+    const int shape = get<1>(GetParam());
+    const Size ksize = get<2>(GetParam());
+    RNG& rng = theRNG();
+
+    Mat src(Size(rng.uniform(40, 120), rng.uniform(ksize.height/2 + 1, 150)), type);
+    randu(src, -100, 356);
+    Point anchor(rng.uniform(0, ksize.width), rng.uniform(0, ksize.height));
+    Mat kernel = getStructuringElement(shape, ksize, shape == MORPH_CROSS ? anchor : Point(-1, -1));
+
+    const int borderTypes[] = { BORDER_CONSTANT, BORDER_REPLICATE, BORDER_REFLECT, BORDER_REFLECT_101 };
+    for (int b = 0; b < 5; b++)
+    {
+        int borderType = borderTypes[b % 4];
+        Scalar borderValue = b == 4 ? Scalar::all(17) : morphologyDefaultBorderValue();
+        SCOPED_TRACE(cv::format("borderType=%d", borderType));
+
+        Mat erodeRef, dilateRef, dst;
+        referenceMorph(src, erodeRef, false, kernel, anchor, borderType, borderValue);
+        referenceMorph(src, dilateRef, true, kernel, anchor, borderType, borderValue);
+
+        erode(src, dst, kernel, anchor, 1, borderType, borderValue);
+        EXPECT_EQ(0, cvtest::norm(erodeRef, dst, NORM_INF));
+        dilate(src, dst, kernel, anchor, 1, borderType, borderValue);
+        EXPECT_EQ(0, cvtest::norm(dilateRef, dst, NORM_INF));
+
+        Mat ref;
+        referenceMorph(erodeRef, ref, true, kernel, anchor, borderType, borderValue);
+        morphologyEx(src, dst, MORPH_OPEN, kernel, anchor, 1, borderType, borderValue);
+        EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+        morphologyEx(src, dst, MORPH_TOPHAT, kernel, anchor, 1, borderType, borderValue);
+        EXPECT_EQ(0, cvtest::norm(src - ref, dst, NORM_INF));
+
+        referenceMorph(dilateRef, ref, false, kernel, anchor, borderType, borderValue);
+        morphologyEx(src, dst, MORPH_CLOSE, kernel, anchor, 1, borderType, borderValue);
+        EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+
+        morphologyEx(src, dst, MORPH_GRADIENT, kernel, anchor, 1, borderType, borderValue);
+        EXPECT_EQ(0, cvtest::norm(dilateRef - erodeRef, dst, NORM_INF));
+
+        // in-place
+        dst = src.clone();
+        erode(dst, dst, kernel, anchor, 1, borderType, borderValue);
+        EXPECT_EQ(0, cvtest::norm(erodeRef, dst, NORM_INF));
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_Morphology_LargeKernel, testing::Combine(
+    testing::Values(CV_8UC1, CV_8UC3, CV_16SC1, CV_32FC2),
+    testing::Values((int)MORPH_RECT, (int)MORPH_ELLIPSE, (int)MORPH_CROSS),
+    testing::Values(Size(51, 51), Size(23, 9), Size(1, 31))
+));
+
+TEST(Imgproc_Morphology_Large, iterations)
+{
+    Mat src(97, 83, CV_8UC1);
+    randu(src, 0, 256);
+    const int shapes[] = { MORPH_RECT, MORPH_ELLIPSE };
+    for (int i = 0; i < 2; i++)
+    {
+        SCOPED_TRACE(cv::format("shape=%d", shapes[i]));
+        // the rectangles are merged into a bigger one, the ellipse is applied several times
+        Mat kernel = getStructuringElement(shapes[i], Size(21, 15));
+        const Point anchor(10, 7);
+        for (int b = 0; b < 2; b++)
+        {
+            const int borderType = b == 0 ? BORDER_CONSTANT : BORDER_REFLECT_101;
+            Mat erodeRef = src.clone(), dilateRef = src.clone(), dst;
+            for (int it = 0; it < 3; it++)
+            {
+                referenceMorph(erodeRef.clone(), erodeRef, false, kernel, anchor, borderType, morphologyDefaultBorderValue());
+                referenceMorph(dilateRef.clone(), dilateRef, true, kernel, anchor, borderType, morphologyDefaultBorderValue());
+            }
+            cv::erode(src, dst, kernel, anchor, 3, borderType);
+            EXPECT_EQ(0, cvtest::norm(erodeRef, dst, NORM_INF)) << "borderType=" << borderType;
+            cv::dilate(src, dst, kernel, anchor, 3, borderType);
+            EXPECT_EQ(0, cvtest::norm(dilateRef, dst, NORM_INF)) << "borderType=" << borderType;
+        }
+    }
+}
+
+TEST(Imgproc_Morphology_Large, float_infinity)
+{
+    // the default constant border is neutral for the infinite pixels as well
+    const float inf = std::numeric_limits<float>::infinity();
+    Mat kernel = getStructuringElement(MORPH_ELLIPSE, Size(51, 51)), dst;
+    Mat src(70, 90, CV_32FC1, Scalar::all(inf));
+    cv::erode(src, dst, kernel);
+    EXPECT_EQ(0, countNonZero(dst != src));
+    morphologyEx(src, dst, MORPH_CLOSE, kernel);
+    EXPECT_EQ(0, countNonZero(dst != src));
+
+    src.setTo(-inf);
+    cv::dilate(src, dst, kernel);
+    EXPECT_EQ(0, countNonZero(dst != src));
+    morphologyEx(src, dst, MORPH_OPEN, kernel);
+    EXPECT_EQ(0, countNonZero(dst != src));
+}
 
 }} // namespace
@@ -541,5 +541,55 @@ TEST(Imgproc_FloodFill, maskValue)
     ASSERT_EQ(1, cvtest::norm(mask.rowRange(1, n-1).colRange(1, n-1), NORM_INF));
 }
 
+TEST(Imgproc_FloodFill, maskless_matches_masked)
+{
+    RNG& rng = theRNG();
+    for (int iter = 0; iter < 40; iter++)
+    {
+        const int cn = iter % 2 ? 3 : 1;
+        const int connectivity = iter % 4 < 2 ? 4 : 8;
+        const bool fixedRange = iter % 8 >= 4;
+        Size sz(rng.uniform(1, 200), rng.uniform(1, 200));
+        // blocks of equal values with a few steps between them
+        Mat small(std::max(sz.height/8, 1), std::max(sz.width/8, 1), CV_8UC(cn)), img;
+        randu(small, 0, 3);
+        resize(small, img, sz, 0, 0, INTER_NEAREST);
+
+        Point seed(rng.uniform(0, sz.width), rng.uniform(0, sz.height));
+        Scalar newVal = Scalar::all(rng.uniform(100, 256));
+        Scalar diff = iter % 3 == 0 ? Scalar() : Scalar::all(1);
+        int flags = connectivity | (fixedRange ? FLOODFILL_FIXED_RANGE : 0);
+
+        Mat img1 = img.clone(), img2 = img.clone(), mask;
+        Rect r1, r2;
+        int area1 = floodFill(img1, mask, seed, newVal, &r1, diff, diff, flags);
+        int area2 = floodFill(img2, seed, newVal, &r2, diff, diff, flags);
+        EXPECT_EQ(area1, area2) << "iter=" << iter;
+        EXPECT_EQ(r1, r2) << "iter=" << iter;
+        ASSERT_EQ(0, cvtest::norm(img1, img2, NORM_INF)) << "iter=" << iter;
+    }
+}
+
+TEST(Imgproc_FloodFill, fixed_range_wide_rows)
+{
+    Mat img(37, 517, CV_8UC3, Scalar(10, 20, 30));
+    for (int x = 0; x < img.cols; x += 71)
+        img.at<Vec3b>(18, x) = Vec3b(10, 20, 33);
+    img.col(300).setTo(Scalar(10, 24, 30));
+
+    Mat mask, ref = img.clone();
+    int area = floodFill(img, mask, Point(5, 18), Scalar(0, 0, 255), NULL,
+                         Scalar::all(3), Scalar::all(3), 4 | FLOODFILL_FIXED_RANGE);
+    // everything but the column 300 is within the range
+    EXPECT_EQ(300*img.rows, area);
+    EXPECT_EQ(area, countNonZero(mask(Rect(1, 1, img.cols, img.rows))));
+    for (int y = 0; y < img.rows; y++)
+        for (int x = 0; x < img.cols; x++)
+        {
+            Vec3b expected = x < 300 ? Vec3b(0, 0, 255) : ref.at<Vec3b>(y, x);
+            ASSERT_EQ(expected, img.at<Vec3b>(y, x)) << Point(x, y);
+        }
+}
+
 }} // namespace
 /* End of file. */
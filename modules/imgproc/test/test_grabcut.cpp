@@ -41,6 +41,7 @@
 //M*/
 
 #include "test_precomp.hpp"
+#include "opencv2/imgproc/detail/gcgraph.hpp"
 
 namespace opencv_test { namespace {
 
@@ -175,4 +176,129 @@ TEST(Imgproc_GrabCut, repeatability)
     EXPECT_EQ(0, countNonZero(mask_2 != mask_3));
 }
 
+static double gcCutCost( detail::GCGraph<double>& graph, int rows, int cols,
+                         const std::vector<double>& sourceW, const std::vector<double>& sinkW,
+                         const Mat& rightW, const Mat& downW )
+{
+    double cost = 0;
+    for( int y = 0; y < rows; y++ )
+        for( int x = 0; x < cols; x++ )
+        {
+            int i = y*cols + x;
+            bool s = graph.inSourceSegment(i);
+            cost += s ? sinkW[i] : sourceW[i];
+            if( x + 1 < cols && s != graph.inSourceSegment(i + 1) )
+                cost += rightW.at<double>(y, x);
+            if( y + 1 < rows && s != graph.inSourceSegment(i + cols) )
+                cost += downW.at<double>(y, x);
+        }
+    return cost;
+}
+
+TEST(Imgproc_GrabCut, incremental_maxflow)
+{
+    const int rows = 37, cols = 53, n = rows*cols;
+    RNG& rng = theRNG();
+    Mat rightW(rows, cols, CV_64F), downW(rows, cols, CV_64F);
+    rng.fill(rightW, RNG::UNIFORM, 0, 10);
+    rng.fill(downW, RNG::UNIFORM, 0, 10);
+
+    std::vector<double> sourceW(n), sinkW(n);
+    detail::GCGraph<double> graph(n, 4*n);
+    for( int i = 0; i < n; i++ )
+    {
+        sourceW[i] = rng.uniform(0., 20.);
+        sinkW[i] = rng.uniform(0., 20.);
+        graph.addVtx();
+        graph.addTermWeights(i, sourceW[i], sinkW[i]);
+    }
+    for( int y = 0; y < rows; y++ )
+        for( int x = 0; x < cols; x++ )
+        {
+            int i = y*cols + x;
+            if( x + 1 < cols )
+                graph.addEdges(i, i + 1, rightW.at<double>(y, x), rightW.at<double>(y, x));
+            if( y + 1 < rows )
+                graph.addEdges(i, i + cols, downW.at<double>(y, x), downW.at<double>(y, x));
+        }
+    double flow = graph.maxFlow();
+    EXPECT_NEAR(flow, gcCutCost(graph, rows, cols, sourceW, sinkW, rightW, downW), 1e-6*flow);
+
+    for( int iter = 0; iter < 3; iter++ )
+    {
+        // change the terminal weights of a part of the vertices, both up and down
+        detail::GCGraph<double> fresh(n, 4*n);
+        for( int i = 0; i < n; i++ )
+        {
+            if( rng.uniform(0, 3) == 0 )
+            {
+                double s = rng.uniform(0., 20.), t = rng.uniform(0., 20.);
+                graph.addTermWeights(i, s - sourceW[i], t - sinkW[i]);
+                sourceW[i] = s;
+                sinkW[i] = t;
+            }
+            fresh.addVtx();
+            fresh.addTermWeights(i, sourceW[i], sinkW[i]);
+        }
+        for( int y = 0; y < rows; y++ )
+            for( int x = 0; x < cols; x++ )
+            {
+                int i = y*cols + x;
+                if( x + 1 < cols )
+                    fresh.addEdges(i, i + 1, rightW.at<double>(y, x), rightW.at<double>(y, x));
+                if( y + 1 < rows )
+                    fresh.addEdges(i, i + cols, downW.at<double>(y, x), downW.at<double>(y, x));
+            }
+        graph.maxFlow();
+        double minCut = fresh.maxFlow();
+        EXPECT_NEAR(minCut, gcCutCost(graph, rows, cols, sourceW, sinkW, rightW, downW), 1e-6*minCut)
+            << "iter=" << iter;
+    }
+}
+
+static void makeGrabCutScene( Size size, Mat& img, Mat& gt, Rect& rect )
+{
+    img.create(size, CV_8UC3);
+    randn(img, Scalar(160, 120, 60), Scalar::all(12));
+    gt = Mat::zeros(size, CV_8UC1);
+    Point center(size.width/2, size.height/2);
+    Size axes(size.width/4, size.height/5);
+    ellipse(gt, center, axes, 20, 0, 360, Scalar(1), FILLED);
+    Mat fgd(size, CV_8UC3);
+    randn(fgd, Scalar(40, 90, 200), Scalar::all(12));
+    fgd.copyTo(img, gt);
+    rect = Rect(size.width/8, size.height/8, size.width*3/4, size.height*3/4);
+}
+
+TEST(Imgproc_GrabCut, synthetic_scene)
+{
+    Mat img, gt, mask, bgdModel, fgdModel;
+    Rect rect;
+    makeGrabCutScene(Size(320, 240), img, gt, rect);
+
+    theRNG().state = 12378213;
+    grabCut(img, mask, rect, bgdModel, fgdModel, 3, GC_INIT_WITH_RECT);
+    EXPECT_LT(countNonZero((mask & 1) != gt), (int)gt.total()/200);
+
+    // further iterations go on from the previous result
+    grabCut(img, mask, rect, bgdModel, fgdModel, 2, GC_EVAL);
+    EXPECT_LT(countNonZero((mask & 1) != gt), (int)gt.total()/200);
+}
+
+TEST(Imgproc_GrabCut, downscaled_init)
+{
+    Mat img, gt, mask1, mask2, bgdModel1, fgdModel1, bgdModel2, fgdModel2;
+    Rect rect;
+    makeGrabCutScene(Size(1200, 900), img, gt, rect);
+
+    theRNG().state = 12378213;
+    grabCut(img, mask1, rect, bgdModel1, fgdModel1, 2, GC_INIT_WITH_RECT);
+    theRNG().state = 12378213;
+    grabCut(img, mask2, rect, bgdModel2, fgdModel2, 2, GC_INIT_WITH_RECT | GC_INIT_DOWNSCALED);
+
+    EXPECT_LT(countNonZero((mask1 & 1) != gt), (int)gt.total()/200);
+    EXPECT_LT(countNonZero((mask2 & 1) != gt), (int)gt.total()/200);
+    EXPECT_LT(countNonZero((mask1 & 1) != (mask2 & 1)), (int)gt.total()/500);
+}
+
 }} // namespace
@@ -2026,5 +2026,102 @@ TEST(Imgproc_Hist_Calc, IPP_ranges_with_nonequal_exponent_21595)
     ASSERT_EQ(histogram_u.at<float>(2), 4.f) << "1 not counts correctly, res: " << histogram_u.at<float>(2);
 }
 
+// per-channel histogram computed with calcHist, as histSize x cn CV_32S
+static Mat referenceChannelHist(const Mat& img, int histSize, float rangeMin, float rangeMax)
+{
+    Mat res(histSize, img.channels(), CV_32S);
+    float range[] = { rangeMin, rangeMax };
+    const float* ranges[] = { range };
+    for (int c = 0; c < img.channels(); c++)
+    {
+        Mat h;
+        calcHist(&img, 1, &c, noArray(), h, 1, &histSize, ranges);
+        h.convertTo(res.col(c), CV_32S);
+    }
+    return res;
+}
+
+typedef testing::TestWithParam<tuple<int, int> > Imgproc_StreamingHistogram_Window;
+
+TEST_P(Imgproc_StreamingHistogram_Window, compare_with_calcHist)
+{
+    const int type = get<0>(GetParam());
+    const int histSize = get<1>(GetParam());
+    const float rangeMax = CV_MAT_DEPTH(type) == CV_8U ? 256.f : 4096.f;
+    Mat img(173, 291, type);
+    randu(img, 0, rangeMax + 100);  // some values are out of the range
+
+    Ptr<StreamingHistogram> sh = createStreamingHistogram(histSize, 10, rangeMax);
+    Rect window(3, 5, 61, 47);
+    const Point moves[] = { Point(1, 0), Point(7, 0), Point(0, 1), Point(-3, 9), Point(40, 40),
+                            Point(-100, 0), Point(5, -60) };
+    for (int i = -1; i < (int)(sizeof(moves)/sizeof(moves[0])); i++)
+    {
+        if (i >= 0)
+        {
+            window += moves[i];
+            window &= Rect(0, 0, img.cols - 10, img.rows - 10);
+        }
+        sh->setWindow(img, window);
+        Mat hist;
+        sh->getHist(hist);
+        Mat ref = referenceChannelHist(img(window), histSize, 10, rangeMax);
+        ASSERT_EQ(CV_32SC1, hist.type());
+        EXPECT_EQ(0, cvtest::norm(ref, hist, NORM_INF)) << "step " << i;
+    }
+
+    // a new frame
+    sh->reset();
+    sh->add(img);
+    sh->remove(img(Rect(0, 0, img.cols, img.rows/2)));
+    Mat hist;
+    sh->getHist(hist);
+    EXPECT_EQ(0, cvtest::norm(referenceChannelHist(img.rowRange(img.rows/2, img.rows), histSize, 10, rangeMax),
+                              hist, NORM_INF));
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_StreamingHistogram_Window, testing::Combine(
+    testing::Values(CV_8UC1, CV_8UC3, CV_16UC1, CV_16UC2),
+    testing::Values(256, 37)
+));
+
+TEST(Imgproc_StreamingHistogram, mask_and_large_image)
+{
+    Mat img(1024, 768, CV_8UC1), mask(img.size(), CV_8UC1);
+    randu(img, 0, 256);
+    randu(mask, 0, 2);
+    Ptr<StreamingHistogram> sh = createStreamingHistogram(64);
+    sh->add(img, mask);
+    Mat hist, ref;
+    sh->getHist(hist);
+    float range[] = { 0, 256 };
+    const float* ranges[] = { range };
+    int histSize = 64, channel = 0;
+    calcHist(&img, 1, &channel, mask, ref, 1, &histSize, ranges);
+    ref.convertTo(ref, CV_32S);
+    EXPECT_EQ(0, cvtest::norm(ref, hist, NORM_INF));
+}
+
+TEST(Imgproc_CalcTileHistograms, compare_with_calcHist)
+{
+    Mat img(203, 317, CV_16UC3);
+    randu(img, 0, 65536);
+    const Size grid(5, 3);
+    const int histSize = 50;
+    Mat hist;
+    calcTileHistograms(img, hist, grid, histSize, 0, 65536);
+    ASSERT_EQ(grid.area(), hist.rows);
+    ASSERT_EQ(histSize*3, hist.cols);
+    for (int ty = 0; ty < grid.height; ty++)
+        for (int tx = 0; tx < grid.width; tx++)
+        {
+            Range rows(img.rows*ty/grid.height, img.rows*(ty + 1)/grid.height);
+            Range cols(img.cols*tx/grid.width, img.cols*(tx + 1)/grid.width);
+            Mat ref = referenceChannelHist(img(rows, cols), histSize, 0, 65536);
+            Mat tileHist = hist.row(ty*grid.width + tx).reshape(1, 3).t();
+            EXPECT_EQ(0, cvtest::norm(ref, tileHist, NORM_INF)) << "tile " << tx << ", " << ty;
+        }
+}
+
 }} // namespace
 /* End Of File */
@@ -349,4 +349,141 @@ INSTANTIATE_TEST_CASE_P( Imgproc, HoughLinesPointSetTest, testing::Combine(testi
                                                                            testing::Values( (CV_PI / 2.0f), (CV_PI * 5.0f / 12.0f) )
                                                                            ));
 
+// straightforward version of the standard Hough transform
+static void referenceHoughLines(const Mat& img, std::vector<Vec3f>& lines, double rho, double theta, int threshold)
+{
+    int numangle = cvRound(CV_PI / theta);
+    int numrho = cvRound(((img.cols + img.rows) * 2 + 1) / rho);
+    Mat accum = Mat::zeros(numangle + 2, numrho + 2, CV_32SC1);
+    std::vector<float> tabSin(numangle), tabCos(numangle);
+    float ang = 0.f;
+    for (int n = 0; n < numangle; ang += (float)theta, n++)
+    {
+        tabSin[n] = (float)(sin((double)ang) * (1 / (float)rho));
+        tabCos[n] = (float)(cos((double)ang) * (1 / (float)rho));
+    }
+    for (int i = 0; i < img.rows; i++)
+        for (int j = 0; j < img.cols; j++)
+            if (img.at<uchar>(i, j))
+                for (int n = 0; n < numangle; n++)
+                {
+                    int r = cvRound(j * tabCos[n] + i * tabSin[n]) + (numrho - 1) / 2;
+                    accum.at<int>(n + 1, r + 1)++;
+                }
+
+    std::vector<std::pair<int, Point> > found;
+    for (int n = 1; n <= numangle; n++)
+        for (int r = 1; r <= numrho; r++)
+        {
+            int v = accum.at<int>(n, r);
+            if (v > threshold && v > accum.at<int>(n, r - 1) && v >= accum.at<int>(n, r + 1) &&
+                v > accum.at<int>(n - 1, r) && v >= accum.at<int>(n + 1, r))
+                found.push_back(std::make_pair(-v, Point(r, n)));
+        }
+    // sort by votes, then by the accumulator index
+    std::stable_sort(found.begin(), found.end(), [](const std::pair<int, Point>& a, const std::pair<int, Point>& b)
+    {
+        return a.first < b.first || (a.first == b.first && (a.second.y < b.second.y ||
+                                     (a.second.y == b.second.y && a.second.x < b.second.x)));
+    });
+    lines.clear();
+    for (size_t k = 0; k < found.size(); k++)
+    {
+        int r = found[k].second.x - 1, n = found[k].second.y - 1;
+        lines.push_back(Vec3f((r - (numrho - 1) * 0.5f) * (float)rho, n * (float)theta, (float)-found[k].first));
+    }
+}
+
+TEST(Imgproc_HoughLines, compare_with_reference)
+{
+    RNG& rng = theRNG();
+    for (int iter = 0; iter < 5; iter++)
+    {
+        Mat img = Mat::zeros(rng.uniform(50, 400), rng.uniform(50, 400), CV_8UC1);
+        for (int k = 0; k < 10; k++)
+            line(img, Point(rng.uniform(0, img.cols), rng.uniform(0, img.rows)),
+                 Point(rng.uniform(0, img.cols), rng.uniform(0, img.rows)), Scalar(255));
+        Mat noise(img.size(), CV_8UC1);
+        randu(noise, 0, 100);
+        img.setTo(255, noise == 0);
+
+        double rho = iter % 2 ? 1.0 : 1.5, theta = CV_PI / (iter % 2 ? 180 : 97);
+        std::vector<Vec3f> lines, ref;
+        HoughLines(img, lines, rho, theta, 20);
+        referenceHoughLines(img, ref, rho, theta, 20);
+        ASSERT_EQ(ref.size(), lines.size()) << "iter=" << iter;
+        for (size_t k = 0; k < ref.size(); k++)
+            ASSERT_EQ(ref[k], lines[k]) << "iter=" << iter << " k=" << k;
+    }
+}
+
+TEST(Imgproc_HoughLinesP, finds_drawn_segments)
+{
+    Mat img = Mat::zeros(300, 400, CV_8UC1);
+    line(img, Point(20, 30), Point(380, 30), Scalar(255));
+    line(img, Point(50, 280), Point(50, 60), Scalar(255));
+    line(img, Point(100, 100), Point(300, 250), Scalar(255));
+
+    std::vector<Vec4i> lines, lines2;
+    HoughLinesP(img, lines, 1, CV_PI / 180, 50, 100, 5);
+    ASSERT_EQ(3u, lines.size());
+    HoughLinesP(img, lines2, 1, CV_PI / 180, 50, 100, 5);
+    EXPECT_EQ(lines, lines2);
+
+    const Vec4i expected[] = { Vec4i(20, 30, 380, 30), Vec4i(50, 280, 50, 60), Vec4i(100, 100, 300, 250) };
+    for (int e = 0; e < 3; e++)
+    {
+        bool found = false;
+        for (size_t k = 0; k < lines.size() && !found; k++)
+        {
+            Point a(lines[k][0], lines[k][1]), b(lines[k][2], lines[k][3]);
+            Point ea(expected[e][0], expected[e][1]), eb(expected[e][2], expected[e][3]);
+            found = (cv::norm(a - ea) <= 3 && cv::norm(b - eb) <= 3) || (cv::norm(a - eb) <= 3 && cv::norm(b - ea) <= 3);
+        }
+        EXPECT_TRUE(found) << expected[e];
+    }
+}
+
+TEST(Imgproc_HoughLinesPTiled, joins_pieces_for_any_threads)
+{
+    Mat img = Mat::zeros(600, 800, CV_8UC1);
+    // the segments cross the borders of the 256x256 tiles, the diagonal one passes the tile corners
+    line(img, Point(20, 30), Point(700, 30), Scalar(255));
+    line(img, Point(300, 580), Point(300, 40), Scalar(255));
+    line(img, Point(40, 40), Point(570, 570), Scalar(255));
+    Mat noise(img.size(), CV_8UC1);
+    theRNG().state = 12345;
+    randu(noise, 0, 300);
+    img.setTo(255, noise == 0);
+
+    const int nthreads = getNumThreads();
+    const int threads[] = { 1, 4, nthreads };
+    std::vector<Vec4i> lines;
+    for (int i = 0; i < 3; i++)
+    {
+        setNumThreads(threads[i]);
+        std::vector<Vec4i> lines_i;
+        HoughLinesPTiled(img, lines_i, 1, CV_PI / 180, 50, 100, 5);
+        if (i == 0)
+            lines = lines_i;
+        else
+            EXPECT_EQ(lines, lines_i) << "threads=" << threads[i];
+    }
+    setNumThreads(nthreads);
+
+    ASSERT_EQ(3u, lines.size());
+    const Vec4i expected[] = { Vec4i(20, 30, 700, 30), Vec4i(300, 580, 300, 40), Vec4i(40, 40, 570, 570) };
+    for (int e = 0; e < 3; e++)
+    {
+        bool found = false;
+        for (size_t k = 0; k < lines.size() && !found; k++)
+        {
+            Point a(lines[k][0], lines[k][1]), b(lines[k][2], lines[k][3]);
+            Point ea(expected[e][0], expected[e][1]), eb(expected[e][2], expected[e][3]);
+            found = (cv::norm(a - ea) <= 3 && cv::norm(b - eb) <= 3) || (cv::norm(a - eb) <= 3 && cv::norm(b - ea) <= 3);
+        }
+        EXPECT_TRUE(found) << expected[e];
+    }
+}
+
 }} // namespace
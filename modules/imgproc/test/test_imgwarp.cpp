@@ -1659,5 +1659,94 @@ TEST(Imgproc_warpPolar, identity)
 #endif
 }
 
+static void makeRadialDistortionMap(Size dsize, Size ssize, double k1, Mat& map)
+{
+    map.create(dsize, CV_32FC2);
+    double cx = (dsize.width - 1)*0.5, cy = (dsize.height - 1)*0.5;
+    double sx = (ssize.width - 1)/(double)std::max(dsize.width - 1, 1);
+    double sy = (ssize.height - 1)/(double)std::max(dsize.height - 1, 1);
+    double r0 = std::max(cx, cy);
+    for (int y = 0; y < dsize.height; y++)
+    {
+        Point2f* m = map.ptr<Point2f>(y);
+        for (int x = 0; x < dsize.width; x++)
+        {
+            double dx = (x - cx)/r0, dy = (y - cy)/r0;
+            double k = 1 + k1*(dx*dx + dy*dy);
+            m[x] = Point2f((float)((cx + dx*k*r0)*sx), (float)((cy + dy*k*r0)*sy));
+        }
+    }
+}
+
+typedef testing::TestWithParam<tuple<int, int, int> > Imgproc_TiledRemap;
+
+TEST_P(Imgproc_TiledRemap, bitexact_with_remap)
+{
+    const int type = get<0>(GetParam());
+    const int interpolation = get<1>(GetParam());
+    const int borderType = get<2>(GetParam());
+
+    RNG& rng = theRNG();
+    Mat src(Size(317, 211), type);
+    rng.fill(src, RNG::UNIFORM, 0, 255);
+    Scalar borderValue(11, 22, 33, 44);
+
+    Mat map32fc2;
+    makeRadialDistortionMap(Size(283, 197), src.size(), 0.35, map32fc2);
+    std::vector<Mat> xy;
+    split(map32fc2, xy);
+    const bool nn = interpolation == INTER_NEAREST;
+    Mat map16s, map16u;
+    convertMaps(map32fc2, noArray(), map16s, map16u, CV_16SC2, nn);
+
+    for (int mapKind = 0; mapKind < 3; mapKind++)
+    {
+        SCOPED_TRACE(cv::format("mapKind=%d", mapKind));
+        Mat m1 = mapKind == 0 ? map32fc2 : mapKind == 1 ? xy[0] : map16s;
+        Mat m2 = mapKind == 0 ? Mat() : mapKind == 1 ? xy[1] : map16u;
+
+        Mat ref, dst;
+        remap(src, ref, m1, m2, interpolation, borderType, borderValue);
+
+        TiledRemap tiled(m1, m2, nn, Size(16, 8));
+        ASSERT_FALSE(tiled.empty());
+        ASSERT_EQ(map32fc2.size(), tiled.size());
+        EXPECT_LE(tiled.getByteSize(), map32fc2.total()*map32fc2.elemSize());
+
+        if (borderType == BORDER_TRANSPARENT)
+        {
+            ref = Mat(m1.size(), type, Scalar::all(7));
+            dst = ref.clone();
+            remap(src, ref, m1, m2, interpolation, borderType, borderValue);
+        }
+        tiled.apply(src, dst, interpolation, borderType, borderValue);
+        EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_TiledRemap, testing::Combine(
+    testing::Values(CV_8UC1, CV_8UC3, CV_16UC1, CV_32FC1, CV_32FC4),
+    testing::Values((int)INTER_NEAREST, (int)INTER_LINEAR, (int)INTER_CUBIC, (int)INTER_LANCZOS4),
+    testing::Values((int)BORDER_CONSTANT, (int)BORDER_REFLECT_101, (int)BORDER_TRANSPARENT)
+));
+
+TEST(Imgproc_TiledRemapRaw, wide_footprint)
+{
+    // random map: most of the tiles don't fit 16-bit deltas and use the raw representation
+    Mat src(2500, 2500, CV_8UC1);
+    randu(src, 0, 256);
+    Mat mapx(100, 130, CV_32FC1), mapy(100, 130, CV_32FC1);
+    randu(mapx, -10.f, 2510.f);
+    randu(mapy, -10.f, 2510.f);
+    mapx.at<float>(5, 5) = -1e6f;
+    mapy.at<float>(7, 3) = 1e6f;
+
+    Mat ref, dst;
+    remap(src, ref, mapx, mapy, INTER_LINEAR, BORDER_REPLICATE);
+    TiledRemap tiled(mapx, mapy);
+    tiled.apply(src, dst, INTER_LINEAR, BORDER_REPLICATE);
+    EXPECT_EQ(0, cvtest::norm(ref, dst, NORM_INF));
+}
+
 }} // namespace
 /* End of file. */
@@ -402,4 +402,36 @@ TEST_F(Imgproc_LSD_Common, compareSegmentsVec4i)
     ASSERT_EQ(result2, 11);
 }
 
+TEST_F(Imgproc_LSD_Common, reuseDetector)
+{
+    Ptr<LineSegmentDetector> detector = createLineSegmentDetector(LSD_REFINE_ADV);
+    for (int i = 0; i < EPOCHS; ++i)
+    {
+        if (i % 2 == 0)
+            GenerateRotatedRect(test_image);
+        else
+            GenerateLines(test_image, i);
+        // the buffers of the detector are reallocated for the images of another size
+        if (i % 3 == 0)
+            resize(test_image, test_image, Size(), 0.75, 0.5, INTER_LINEAR_EXACT);
+
+        std::vector<double> width, prec, nfa;
+        detector->detect(test_image, lines, width, prec, nfa);
+
+        std::vector<Vec4f> lines_ref;
+        std::vector<double> width_ref, prec_ref, nfa_ref;
+        createLineSegmentDetector(LSD_REFINE_ADV)->detect(test_image, lines_ref, width_ref, prec_ref, nfa_ref);
+
+        ASSERT_FALSE(lines.empty());
+        ASSERT_EQ(lines_ref.size(), lines.size());
+        for (size_t j = 0; j < lines.size(); ++j)
+        {
+            EXPECT_EQ(lines_ref[j], lines[j]);
+            EXPECT_EQ(width_ref[j], width[j]);
+            EXPECT_EQ(prec_ref[j], prec[j]);
+            EXPECT_EQ(nfa_ref[j], nfa[j]);
+        }
+    }
+}
+
 }} // namespace
@@ -0,0 +1,95 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "test_precomp.hpp"
+
+namespace opencv_test { namespace {
+
+static void referenceCvtResizeNormalize(const Mat& src, Mat& blob, int code, Size dsize, int interpolation,
+                                        const Scalar& mean, const Scalar& scale)
+{
+    Mat img, f;
+    if (code >= 0)
+        cvtColor(src, img, code);
+    else
+        img = src;
+    img.convertTo(f, CV_32F);
+    resize(f, f, dsize, 0, 0, interpolation);
+    int cn = f.channels();
+    int sz[] = { 1, cn, dsize.height, dsize.width };
+    blob.create(4, sz, CV_32F);
+    std::vector<Mat> planes(cn);
+    for (int c = 0; c < cn; c++)
+        planes[c] = Mat(dsize, CV_32F, blob.ptr<float>(0, c));
+    split(f, planes);
+    for (int c = 0; c < cn; c++)
+        planes[c] = (planes[c] - mean[c])*scale[c];
+}
+
+typedef testing::TestWithParam<tuple<int, Size, int> > Imgproc_CvtResizeNormalize_Accuracy;
+
+TEST_P(Imgproc_CvtResizeNormalize_Accuracy, compare_with_reference)
+{
+    const int code = get<0>(GetParam());
+    const Size dsize = get<1>(GetParam());
+    const int interpolation = get<2>(GetParam());
+    const Size ssize(322, 246);
+    const bool yuv = code != -1 && code != COLOR_BGR2RGB;
+
+    Mat src(yuv ? Size(ssize.width, ssize.height*3/2) : ssize, yuv ? CV_8UC1 : CV_8UC3);
+    randu(src, 0, 256);
+    Scalar mean(104, 117, 123), scale(1/58.4, 1/57.1, 1/57.4);
+
+    Mat ref, dst;
+    referenceCvtResizeNormalize(src, ref, code, dsize, interpolation, mean, scale);
+    cvtResizeNormalize(src, dst, code, dsize, interpolation, mean, scale);
+
+    ASSERT_EQ(CV_32F, dst.type());
+    ASSERT_EQ(ref.size, dst.size);
+    EXPECT_LE(cvtest::norm(ref, dst, NORM_INF), 1e-4);
+
+    Mat dst16f, dst32f;
+    cvtResizeNormalize(src, dst16f, code, dsize, interpolation, mean, scale, CV_16F);
+    ASSERT_EQ(CV_16F, dst16f.type());
+    dst16f.convertTo(dst32f, CV_32F);
+    EXPECT_LE(cvtest::norm(ref, dst32f, NORM_INF), 1e-2);
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgproc_CvtResizeNormalize_Accuracy, testing::Combine(
+    testing::Values(-1, (int)COLOR_BGR2RGB, (int)COLOR_YUV2BGR_NV12, (int)COLOR_YUV2RGB_NV21,
+                    (int)COLOR_YUV2BGR_I420, (int)COLOR_YUV2RGB_YV12),
+    testing::Values(Size(224, 224), Size(161, 123), Size(400, 300), Size(500, 200)),
+    testing::Values((int)INTER_LINEAR, (int)INTER_AREA)
+));
+
+TEST(Imgproc_CvtResizeNormalize, same_size_is_cvtColor)
+{
+    Mat src(Size(64, 48*3/2), CV_8UC1);
+    randu(src, 0, 256);
+    Mat bgr, blob;
+    cvtColor(src, bgr, COLOR_YUV2BGR_NV12);
+    cvtResizeNormalize(src, blob, COLOR_YUV2BGR_NV12, Size());
+    ASSERT_EQ(4, blob.dims);
+    for (int c = 0; c < 3; c++)
+    {
+        Mat plane(bgr.size(), CV_32F, blob.ptr<float>(0, c)), ch;
+        extractChannel(bgr, ch, c);
+        ch.convertTo(ch, CV_32F);
+        EXPECT_EQ(0, cvtest::norm(ch, plane, NORM_INF)) << "c=" << c;
+    }
+}
+
+TEST(Imgproc_CvtResizeNormalize, area_downscale_above_64x)
+{
+    Mat src(Size(96, 4000), CV_8UC3);
+    randu(src, 0, 256);
+    Scalar mean(104, 117, 123), scale(1/58.4, 1/57.1, 1/57.4);
+    Mat ref, dst;
+    referenceCvtResizeNormalize(src, ref, COLOR_BGR2RGB, Size(48, 32), INTER_AREA, mean, scale);
+    cvtResizeNormalize(src, dst, COLOR_BGR2RGB, Size(48, 32), INTER_AREA, mean, scale);
+    ASSERT_EQ(ref.size, dst.size);
+    EXPECT_LE(cvtest::norm(ref, dst, NORM_INF), 1e-4);
+}
+
+}} // namespace
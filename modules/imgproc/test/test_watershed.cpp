@@ -128,3 +128,104 @@ TEST(Imgproc_Watershed, regression) { CV_WatershedTest test; test.safe_run(); }
 }} // namespace
 
 #endif
+
+namespace opencv_test { namespace {
+
+static int wsDiff(const Mat& img, Point a, Point b)
+{
+    Vec3b p = img.at<Vec3b>(a), q = img.at<Vec3b>(b);
+    return std::max(std::max(std::abs(p[0] - q[0]), std::abs(p[1] - q[1])), std::abs(p[2] - q[2]));
+}
+
+// straightforward version of the Meyer flooding with 256 FIFO queues
+static void referenceWatershed(const Mat& img, Mat& markers)
+{
+    const int IN_QUEUE = -2, WSHED = -1;
+    const Point nb[] = { Point(-1, 0), Point(1, 0), Point(0, -1), Point(0, 1) };
+    std::vector<std::deque<Point> > q(256);
+    const int w = img.cols, h = img.rows;
+
+    markers.row(0).setTo(WSHED);
+    markers.row(h - 1).setTo(WSHED);
+    markers.col(0).setTo(WSHED);
+    markers.col(w - 1).setTo(WSHED);
+    for (int y = 1; y < h - 1; y++)
+        for (int x = 1; x < w - 1; x++)
+            markers.at<int>(y, x) = std::max(markers.at<int>(y, x), 0);
+
+    for (int y = 1; y < h - 1; y++)
+        for (int x = 1; x < w - 1; x++)
+        {
+            Point p(x, y);
+            if (markers.at<int>(p) != 0)
+                continue;
+            int idx = 256;
+            for (int k = 0; k < 4; k++)
+                if (markers.at<int>(p + nb[k]) > 0)
+                    idx = std::min(idx, wsDiff(img, p, p + nb[k]));
+            if (idx < 256)
+            {
+                q[idx].push_back(p);
+                markers.at<int>(p) = IN_QUEUE;
+            }
+        }
+
+    for (;;)
+    {
+        int active = 0;
+        while (active < 256 && q[active].empty())
+            active++;
+        if (active == 256)
+            break;
+        Point p = q[active].front();
+        q[active].pop_front();
+
+        int lab = 0;
+        for (int k = 0; k < 4; k++)
+        {
+            int t = markers.at<int>(p + nb[k]);
+            if (t > 0)
+                lab = lab == 0 || lab == t ? t : WSHED;
+        }
+        ASSERT_NE(0, lab);
+        markers.at<int>(p) = lab;
+        if (lab == WSHED)
+            continue;
+        for (int k = 0; k < 4; k++)
+        {
+            Point n = p + nb[k];
+            if (markers.at<int>(n) == 0)
+            {
+                q[wsDiff(img, p, n)].push_back(n);
+                markers.at<int>(n) = IN_QUEUE;
+            }
+        }
+    }
+}
+
+TEST(Imgproc_Watershed, compare_with_reference)
+{
+    RNG& rng = theRNG();
+    for (int iter = 0; iter < 10; iter++)
+    {
+        Size sz(rng.uniform(3, 300), rng.uniform(3, 300));
+        Mat img(sz, CV_8UC3), smooth;
+        randu(img, 0, 256);
+        GaussianBlur(img, smooth, Size(), rng.uniform(0.5, 4.0));
+
+        Mat markers = Mat::zeros(sz, CV_32SC1);
+        int nlabels = rng.uniform(1, 20);
+        for (int i = 0; i < nlabels; i++)
+            circle(markers, Point(rng.uniform(0, sz.width), rng.uniform(0, sz.height)),
+                   rng.uniform(0, 5), Scalar(i + 1), FILLED);
+        // negative values are treated as unknown pixels
+        markers.at<int>(rng.uniform(0, sz.height), rng.uniform(0, sz.width)) = -5;
+
+        Mat ref = markers.clone();
+        referenceWatershed(smooth, ref);
+        watershed(smooth, markers);
+        ASSERT_EQ(0, cvtest::norm(ref, markers, NORM_INF)) << "size=" << sz << " iter=" << iter;
+    }
+}
+
+}} // namespace